@@ -561,6 +561,14 @@ static PGbind *new_PGbind(int argc, char **argv)
     fprintf(pg->hfile, "extern \"C\" {\n");
     fprintf(pg->hfile, "#endif\n\n");
     fprintf(pg->hfile, "typedef int Logical;\n\n");
+/*
+ * Plotting contexts (see sys/grctx.c in the PGPLOT library).
+ */
+    fprintf(pg->hfile, "typedef struct PGcontext PGcontext;\n");
+    fprintf(pg->hfile, "PGcontext *cpgnctx(void);\n");
+    fprintf(pg->hfile, "void cpgsctx(PGcontext *ctx);\n");
+    fprintf(pg->hfile, "PGcontext *cpgqctx(void);\n");
+    fprintf(pg->hfile, "void cpgdctx(PGcontext *ctx);\n\n");
   };
 /*
  * Return the initialized container.
@@ -982,6 +990,12 @@ static int write_wrapper(Sysattr *sys, Function *fn)
   };
   write_symbol(wfile, sys, fn->name+1);
   fprintf(wfile, "();\n");
+/*
+ * Declare the functions that lock the library and select the device of
+ * the calling thread's plotting context.
+ */
+  fprintf(wfile, "extern void grctx_begin(void);\n");
+  fprintf(wfile, "extern void grctx_end(void);\n");
 /*
  * Write the function declaration.
  */
@@ -1059,6 +1073,7 @@ static int write_wrapper(Sysattr *sys, Function *fn)
 /*
  * Cache the return value of the fortran call.
  */
+  fprintf(wfile, "  grctx_begin();\n");
   fprintf(wfile, "  %s", fn->type==DAT_VOID ? "":"r_value = ");
 /*
  * Write the system-specific symbol used to call the FORTRAN procedure.
@@ -1139,6 +1154,7 @@ static int write_wrapper(Sysattr *sys, Function *fn)
  * Terminate the function call.
  */
   fprintf(wfile, ");\n");
+  fprintf(wfile, "  grctx_end();\n");
 /*
  * Perform required post-call operations.
  */
@@ -40,8 +40,11 @@ C-----------------------------------------------------------------------
       PARAMETER (TYPE='CC (DEC LJ250 Color Companion printer)')
       BYTE       CTAB(3, 256), FF
       LOGICAL    HIRES, INIT, LANDSCAPE
-      INTEGER*4  BUFFER, BX, BY, I, IC, IER, GRFMEM, GRGMEM
-      INTEGER*4  LUN, MAXCOL, NPICT
+      INTEGER*4  BX, BY, I, IC, IER, GRFMEM, GRGMEM
+      INTEGER*4  LUN, MAXCOL, NB, NBITS, NPICT
+C Note: for 32-bit operating systems, the following declaration
+C may be changed to INTEGER*4:
+      INTEGER*8  BUFFER
       REAL*4     XBUF(4)
       CHARACTER  DEFNAM*12, MODE*20, MSG*10
       PARAMETER  (FF = 12)
@@ -243,8 +246,16 @@ C                                       plot buffer.
       END IF
       BX = INT (XBUF(1)) + 1
       BY = (INT (XBUF(2)) / 6 + 1) * 6
+C                                       Pack 2 pixels per byte when only
+C                                       colors 0-7 can be used.
+      IF (HIRES) THEN
+         NBITS = 4
+      ELSE
+         NBITS = 8
+      END IF
+      NB = (BX * NBITS + 7) / 8
 C                                       Allocate a plot buffer.      
-      IER = GRGMEM (BX * BY, BUFFER)
+      IER = GRGMEM (NB * BY, BUFFER)
 C                                       Check for error and clean up
 C                                       if one was found.
       IF (IER .NE. 1) THEN
@@ -256,7 +267,7 @@ C                                       Increment the page number.
 C                                       Eject the page from the printer.
       IF (NPICT .GT. 1) WRITE (LUN) FF
 C                                       Zero out the plot buffer.
-      CALL GRCC04 (BX * BY, %VAL(BUFFER))
+      CALL GRBMCL (NB * BY, %VAL(BUFFER))
       RETURN
 C
 C--- IFUNC = 12, Draw line ---------------------------------------------
@@ -275,7 +286,7 @@ C                                       Apply any needed tranformation.
          XBUF(4) = RBUF(4)
       END IF
 C                                       Draw the point into the bitmap.
-      CALL GRCC00 (1, XBUF, IC, BX, BY, %VAL (BUFFER))
+      CALL GRCC00 (1, XBUF, IC, NBITS, NB, BY, %VAL (BUFFER))
       RETURN
 C
 C--- IFUNC = 13, Draw dot ----------------------------------------------
@@ -290,16 +301,17 @@ C                                       Apply any needed tranformation.
          XBUF(2) = RBUF(2)
       END IF
 C                                       Draw the point into the bitmap.
-      CALL GRCC00 (0, XBUF, IC, BX, BY, %VAL(BUFFER))
+      CALL GRCC00 (0, XBUF, IC, NBITS, NB, BY, %VAL(BUFFER))
       RETURN
 C
 C--- IFUNC = 14, End picture -------------------------------------------
 C
   140 CONTINUE
 C                                       Write out the bitmap.
-      CALL GRCC01 (LUN, BX, BY, %VAL (BUFFER), MAXCOL, HIRES, CTAB)
+      CALL GRCC01 (LUN, BX, NBITS, NB, BY, %VAL (BUFFER), MAXCOL,
+     1             HIRES, CTAB)
 C                                       Deallocate the plot buffer.
-      IER = GRFMEM (BX * BY, BUFFER)
+      IER = GRFMEM (NB * BY, BUFFER)
 C                                       Check for an error.
       IF (IER .NE. 1) THEN
           CALL GRGMSG (IER)
@@ -388,17 +400,16 @@ C-----------------------------------------------------------------------
 
 C*GRCC00 -- PGPLOT LJ250 driver, draw a colored line
 C+
-      SUBROUTINE GRCC00 (LINE, RBUF, ICOL, BX, BY, BITMAP)
+      SUBROUTINE GRCC00 (LINE, RBUF, ICOL, NBITS, NB, BY, BITMAP)
       IMPLICIT NONE
-      INTEGER*4  BX, BY, ICOL, LINE
-      BYTE       BITMAP(BX, BY)
+      INTEGER*4  NB, BY, ICOL, LINE, NBITS
+      BYTE       BITMAP(NB, BY)
       REAL*4     RBUF(4)
 C
 C Draw a straight line segment from absolute pixel coordinates (RBUF(1),
 C RBUF(2)) to (RBUF(3), RBUF(4)).  The line overwrites the previous 
 C contents of the bitmap with the current color index.  The line is 
-C generated with a Simple Digital Differential Analyser (ref: Newman & 
-C Sproull). 
+C drawn by GRBMLN (grrast.c).
 C
 C Arguments:
 C
@@ -406,58 +417,44 @@ C LINE            I I      =0 for dot, =1 for line.
 C RBUF(1),RBUF(2) I R      Starting point of line.
 C RBUF(3),RBUF(4) I R      Ending point of line.
 C ICOL            I I      Color index
+C NBITS           I I      Bits per pixel in the bitmap (4 or 8).
+C NB, BY          I I      Dimensions of BITMAP (bytes per row, rows).
 C BITMAP        I/O B      (address of) the frame buffer.
 C
-C-----------------------------------------------------------------------
-      INTEGER*4  K, KX, KY, LENGTH
-      REAL*4     D, XINC, XP, YINC, YP
 C-----------------------------------------------------------------------
       IF (LINE .GT. 0) THEN
-         D = MAX (ABS (RBUF(3) - RBUF(1)), ABS (RBUF(4) - RBUF(2)))
-         LENGTH = D
-         IF (LENGTH .EQ. 0) THEN
-            XINC = 0.0
-            YINC = 0.0
-         ELSE
-            XINC = (RBUF(3) - RBUF(1)) / D
-            YINC = (RBUF(4) - RBUF(2)) / D
-         END IF
+         CALL GRBMLN (RBUF(1), RBUF(2), RBUF(3), RBUF(4), ICOL, NBITS,
+     1                NB, BY, BITMAP)
       ELSE
-         LENGTH = 0
-         XINC = 0.0
-         YINC = 0.0
+         CALL GRBMLN (RBUF(1), RBUF(2), RBUF(1), RBUF(2), ICOL, NBITS,
+     1                NB, BY, BITMAP)
       END IF
-      XP = RBUF(1) + 0.5
-      YP = RBUF(2) + 0.5
-      DO K = 0, LENGTH
-         KX = XP
-         KY = (BY - 1) - INT (YP)
-         BITMAP(KX + 1, KY + 1) = ICOL
-         XP = XP + XINC
-         YP = YP + YINC
-      END DO
 C-----------------------------------------------------------------------
       RETURN
       END
 
 C*GRCC01 -- PGPLOT LJ250 driver, copy bitmap to Sixel output file
 C+
-      SUBROUTINE GRCC01 (LUN, BX, BY, BITMAP, NC, HIRES, CTAB)
+      SUBROUTINE GRCC01 (LUN, BX, NBITS, NB, BY, BITMAP, NC, HIRES,
+     1                   CTAB)
       IMPLICIT NONE
       LOGICAL  HIRES
-      INTEGER  BX, BY, LUN, NC
-      BYTE     BITMAP(BX, BY), CTAB(3, 256)
+      INTEGER  BX, BY, LUN, NB, NBITS, NC
+      BYTE     BITMAP(NB, BY), CTAB(3, 256)
 C
 C Arguments:
 C
 C  LUN    (input)  Fortran unit number for output
-C  BX, BY (input)  dimensions of BITMAP (BY MUST be a multiple of 6)
+C  BX     (input)  width of the bitmap in pixels
+C  NBITS  (input)  bits per pixel in the bitmap (4 or 8)
+C  NB, BY (input)  dimensions of BITMAP (BY MUST be a multiple of 6)
 C  BITMAP (input)  the bitmap array
 C  NC     (input)  the maximum color index used in the bitmap
 C  CTAB   (input)  the color table
 C-----------------------------------------------------------------------
       BYTE       ESC
-      INTEGER*4  BUFF, GRCC03, I, IER, J, K, L, GRGMEM, M
+      INTEGER*4  GRCC03, GRFMEM, I, IER, J, K, L, GRGMEM, M
+      INTEGER*8  BUFF, ROW
       CHARACTER  BLUE*3, COL*3, GREEN*3, RED*3
       PARAMETER  (ESC = 27)
 C-----------------------------------------------------------------------
@@ -485,13 +482,17 @@ C                                       Write out the color table.
       END DO
 C                                       Allocate a work array.
       IER = GRGMEM (BX * (NC + 1), BUFF)
+      IF (IER .EQ. 1) IER = GRGMEM (4 * BX, ROW)
 C                                       Check for an error.
       IF (IER .NE. 1) THEN
          CALL GRGMSG (IER)
          CALL GRQUIT ('Failed to allocate temporary buffer.')
       END IF
 C                                       Output the Sixel data.
-      CALL GRCC02 (LUN, BX, BY, BITMAP, NC + 1, %VAL (BUFF))
+      CALL GRCC02 (LUN, BX, NBITS, NB, BY, BITMAP, NC + 1, %VAL (BUFF),
+     1             %VAL (ROW))
+      IER = GRFMEM (BX * (NC + 1), BUFF)
+      IER = GRFMEM (4 * BX, ROW)
 C                                       Turn off Sixel graphics mode.
       WRITE (LUN) ESC, CHAR(92)
 C-----------------------------------------------------------------------
@@ -500,10 +501,11 @@ C-----------------------------------------------------------------------
 
 C*GRCC02 -- PGPLOT LJ250 driver, output the bitmap
 C+
-      SUBROUTINE GRCC02 (LUN, BX, BY, BITMAP, NC, SIXEL)
+      SUBROUTINE GRCC02 (LUN, BX, NBITS, NB, BY, BITMAP, NC, SIXEL,
+     1                   ROW)
       IMPLICIT NONE
-      INTEGER  BX, BY, LUN, NC
-      BYTE     BITMAP(BX, BY), SIXEL(BX, NC)
+      INTEGER  BX, BY, LUN, NB, NBITS, NC, ROW(BX)
+      BYTE     BITMAP(NB, BY), SIXEL(BX, NC)
 C
 C Version 1.0  18-Jun-1989  S. C. Allendorf
 C-----------------------------------------------------------------------
@@ -519,8 +521,10 @@ C                                       Zero out the work array.
          CALL GRCC04 (BX * NC, SIXEL)
 C                                       Create a Sixel line.
          DO J = 1, 6
+            CALL GRBMRW ((I - 1) * 6 + J, NBITS, NB, BY, BITMAP,
+     1                   BX, ROW)
             DO K = 1, BX
-               L = BITMAP(K, (I - 1) * 6 + J) + 1
+               L = ROW(K) + 1
                SIXEL(K, L) = SIXEL(K, L) .OR. QMASK(J)
             END DO
          END DO
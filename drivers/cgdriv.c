@@ -15,6 +15,8 @@
  */
 
 #define DPI 1000            /* set the resoloution to 1000 dpi */
+#define POLYLINE_MAX 4096   /* max vertices in one CGM polyline element */
+#define OUTBUF_SIZE 8192    /* bytes of output buffered between writes */
 #define PAGE_WIDTH 7.8      /* set the page width to 7.8 inches */
 #define PAGE_HEIGHT 10.5    /* set the page height to 10.5 inches */
 
@@ -29,8 +31,6 @@ typedef struct rgb
     BYTE pad;		    /* So structure is aligned */
 } COLOUR;
 
-static int words_bigendian = 0;     /* Machine type (1 = Bigendian) */ 
-
 /*
  * Certain symbols in fcntl.h may not get defined
  * unless the _POSIX_SOURCE feature-test macro is set.
@@ -113,44 +113,47 @@ static void pg_colour_setup(COLOUR *c)
     return;
 }
 
+/*
+ * Output is collected in outbuf and written out a block at a time.
+ * Words are stored big-endian by shifting, so no byte-order test is
+ * needed.
+ */
+static BYTE outbuf[OUTBUF_SIZE];
+static int outlen = 0;      /* Bytes used in outbuf */
+static int out_error = 0;   /* Set if a write has failed */
+static FILE *out_pt = NULL; /* The open metafile, for flush_at_exit() */
+
+static void flush_bytes(FILE *pt)
+{
+    if (outlen > 0 && fwrite(outbuf,1,(size_t)outlen,pt) != (size_t)outlen)
+        out_error = 1;
+    outlen = 0;
+    return;
+}
+
 static int write_byte(FILE *pt,BYTE b)
 {
-    int error = 0; /* clear error flag */
-    if (putc(b,pt) == EOF)
-        error = 1; /* set error flag */
-    return error;
+    if (outlen == OUTBUF_SIZE)
+        flush_bytes(pt);
+    outbuf[outlen++] = b;
+    return out_error;
 }
 
 static int write_word(FILE *pt,WORD w)
 {
-    BYTE *cp;
-    int error;
-    cp=(BYTE*)&w;
-    if (words_bigendian) {
-        write_byte(pt,cp[0]);   /* write in big-endian format */
-        error = write_byte(pt,cp[1]);
-    } else {
-        write_byte(pt,cp[1]);   /* write in big-endian format */
-        error = write_byte(pt,cp[0]);
-    }
-    return error;
+    if (outlen > OUTBUF_SIZE-2)
+        flush_bytes(pt);
+    outbuf[outlen++] = (BYTE)(w >> 8);  /* write in big-endian format */
+    outbuf[outlen++] = (BYTE)w;
+    return out_error;
 }
 
 static void write_float(FILE *pt,float f)
 {
-    BYTE *cp;
-    cp=(BYTE*)&f;
-    if (words_bigendian) {
-        write_byte(pt,cp[0]);   /* write in big-endian format */
-        write_byte(pt,cp[1]);
-        write_byte(pt,cp[2]);
-        write_byte(pt,cp[3]);
-    } else {        
-        write_byte(pt,cp[3]);   /* write in big-endian format */
-        write_byte(pt,cp[2]);
-        write_byte(pt,cp[1]);
-        write_byte(pt,cp[0]);
-    }
+    unsigned int u;         /* the bits of f (32-bit IEEE) */
+    memcpy(&u,&f,sizeof(u));
+    write_word(pt,(WORD)(u >> 16));     /* write in big-endian format */
+    write_word(pt,(WORD)u);
     return;
 }
 
@@ -162,6 +165,9 @@ static FILE* begin_metafile(const char *filename,const char *name)
     pt=fopen(filename,"wb");
     if (pt == NULL)
         return pt;
+    outlen = 0;
+    out_error = 0;
+    out_pt = pt;
     if (length < 30)    /* use short format if possible */
         write_word(pt,(WORD)(0x0020+length+1));
     else {
@@ -308,6 +314,32 @@ static void line_width(FILE *pt,WORD width)
     return;
 }
 
+/*
+ * Attributes are written only when an element that uses them is about
+ * to be drawn and they differ from the values last written (-1 = none
+ * written yet in this picture).
+ */
+static int line_ci = -1;    /* Line colour index last written */
+static int fill_ci = -1;    /* Fill colour index last written */
+static int line_wd = -1;    /* Line width last written */
+
+static void reset_attributes(void)
+{
+    line_ci = -1;
+    fill_ci = -1;
+    line_wd = -1;
+    return;
+}
+
+static void set_fill_colour(FILE *pt,int colourMode,int index,COLOUR colours[])
+{
+    if (index != fill_ci) {
+        fill_colour(pt,colourMode,(BYTE)index,colours);
+        fill_ci = index;
+    }
+    return;
+}
+
 static void interior_style(FILE *pt,WORD style)
 {
     write_word(pt,0x52c2);
@@ -341,6 +373,67 @@ static void line(FILE *pt,WORD x1,WORD y1,WORD x2,WORD y2)
     return;
 }
 
+/*
+ * Connected line segments are collected in pending[] and written as
+ * one polyline element when the chain breaks, the element is full or
+ * any other element is about to be written.
+ */
+static WORD pending[2*POLYLINE_MAX];
+static int npending = 0;    /* WORDs used in pending[] */
+
+static void flush_polyline(FILE *pt)
+{
+    if (npending >= 4)
+        polyline(pt,pending,npending);
+    npending = 0;
+    return;
+}
+
+static void set_line_attributes(FILE *pt,int colourMode,int index,
+                                COLOUR colours[],int width)
+{
+    if (index == line_ci && width == line_wd)
+        return;
+    flush_polyline(pt);     /* pending segments use the old attributes */
+    if (index != line_ci) {
+        line_colour(pt,colourMode,(BYTE)index,colours);
+        line_ci = index;
+    }
+    if (width != line_wd) {
+        line_width(pt,(WORD)width);
+        line_wd = width;
+    }
+    return;
+}
+
+static void add_line(FILE *pt,WORD x1,WORD y1,WORD x2,WORD y2)
+{
+    if (npending == 0 || npending == 2*POLYLINE_MAX ||
+        pending[npending-2] != x1 || pending[npending-1] != y1) {
+        flush_polyline(pt);
+        pending[0] = x1;
+        pending[1] = y1;
+        npending = 2;
+    }
+    pending[npending++] = x2;
+    pending[npending++] = y2;
+    return;
+}
+
+/*
+ * Called by exit(): if the program stops without closing the device,
+ * hand what is buffered to stdio, which exit() then writes out, so the
+ * file ends where it would have without the buffer.
+ */
+static void flush_at_exit(void)
+{
+    if (out_pt != NULL) {
+        flush_polyline(out_pt);
+        flush_bytes(out_pt);
+    }
+    return;
+}
+
 static void polygon(FILE *pt,WORD points[],int length)
 {
     int c;
@@ -382,11 +475,13 @@ static void end_picture(FILE *pt)
 
 static void end_metafile(FILE *pt)
 {
-    int error;
-    error = write_word(pt,0x0040);
-    if (error == 1)
+    write_word(pt,0x0040);
+    flush_bytes(pt);
+    out_pt = NULL;
+    if (fclose(pt) != 0)
+        out_error = 1;
+    if (out_error == 1)
         printf("CGMDRIV:Error writing bytes, file is incomplete\n");
-    fclose(pt);
     return;
 }
 
@@ -440,18 +535,12 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
     static int state = 0;       /* Device state (1 = open) */
     static int picture;         /* Picture number */
     static int colourMode;      /* 0 = indexed, 1 = direct */
-    static int status = 0;      /* Driver status (1 = called) */
+    static int colour = 1;      /* Current colour index */
+    static int exit_set = 0;    /* Set once flush_at_exit is registered */
 
     colourMode = *mode - 1;
-    if (!status) {              /* Check machine type on first call */
-        WORD test = 0x100;
-        BYTE* cp;
-        cp = (BYTE*)&test;
-        if (cp[0] == 1) {
-            words_bigendian = 1;
-        }
-        status = 1;
-    }
+    if (npending > 0 && *ifunc != 12 && *ifunc != 31)
+        flush_polyline(pt);     /* finish any pending polyline first */
     switch(*ifunc) {
 
 /*--- IFUNC=1, Return device name ---------------------------------------*/
@@ -506,7 +595,8 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
         chr[8] = 'Y'; /* Can return color representation */
         chr[9] = 'N'; /* Not used */
         chr[10] = 'N'; /* Not used */
-        *lchr = 11;
+        chr[11] = 'L'; /* Polylines available */
+        *lchr = 12;
         break;
 
 /*--- IFUNC=5, Return default file name ---------------------------------*/
@@ -565,6 +655,8 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
         if (pt != NULL) {
             state = 1;
             picture = 0;
+            if (!exit_set)
+                exit_set = (atexit(flush_at_exit) == 0);
             pg_colour_setup(colours);
             metafile_version(pt);
             metafile_description(pt,desc);
@@ -599,6 +691,7 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
         vdc_extent(pt,0x0000,0x0000,(WORD)(rbuf[0]+0.5),(WORD)(rbuf[1]+0.5));
         scaling_mode(pt,0.0254F); /* 1 VDC pixel = 0.0254mm or 1/1000" */
         begin_picture_body(pt);
+        reset_attributes();
         interior_style(pt,1);
         if (colourMode == 0)    /* add colour table entries if needed */
         {
@@ -611,12 +704,27 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
 /*--- IFUNC=12, Draw line -----------------------------------------------*/
 
     case 12:
-        line(pt,(WORD)(rbuf[0]+0.5),(WORD)(rbuf[1]+0.5),(WORD)(rbuf[2]+0.5),(WORD)(rbuf[3]+0.5));
+        set_line_attributes(pt,colourMode,colour,colours,width);
+        add_line(pt,(WORD)(rbuf[0]+0.5),(WORD)(rbuf[1]+0.5),(WORD)(rbuf[2]+0.5),(WORD)(rbuf[3]+0.5));
         break;
 
+/*--- IFUNC=31, Draw polyline -------------------------------------------*/
+
+    case 31:
+    {
+        int n = *nbuf/2;    /* number of vertices */
+        int c;
+        set_line_attributes(pt,colourMode,colour,colours,width);
+        for (c=1;c<n;c++)   /* joins on to any pending connected segments */
+            add_line(pt,(WORD)(rbuf[2*c-2]+0.5),(WORD)(rbuf[2*c-1]+0.5),
+                     (WORD)(rbuf[2*c]+0.5),(WORD)(rbuf[2*c+1]+0.5));
+    }
+    break;
+
 /*--- IFUNC=13, Draw dot ------------------------------------------------*/
 
     case 13:
+        set_fill_colour(pt,colourMode,colour,colours);
         circle(pt,(WORD)(rbuf[0]+0.5),(WORD)(rbuf[1]+0.5),(WORD)width);
         break;
 
@@ -629,16 +737,15 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
 /*--- IFUNC=15, Select color index --------------------------------------*/
 
     case 15:
-    {
-        int i = (int)(rbuf[0]+0.5);
-        line_colour(pt,colourMode,(BYTE)i,colours);
-        fill_colour(pt,colourMode,(BYTE)i,colours);
-    }  
-    break;
+        colour = (int)(rbuf[0]+0.5);    /* written when next used */
+        break;
 
 /*--- IFUNC=16, Flush buffer. -------------------------------------------*/
 
     case 16:
+        flush_polyline(pt);
+        flush_bytes(pt);
+        fflush(pt);
         break;
 
 /*--- IFUNC=17, Read cursor. --------------------------------------------*/
@@ -673,6 +780,7 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
             points[c] = (WORD)(rbuf[0]+0.5);     /* add points to array */
             points[c+1] = (WORD)(rbuf[1]+0.5);
             if (c==n-2) {   /* final set of points? */
+                set_fill_colour(pt,colourMode,colour,colours);
                 polygon(pt,points,n);   /* if so, create polygon */
                 n = 0;
                 free(points);
@@ -692,6 +800,12 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
         colours[i].b = (int)(255*rbuf[3]+0.5);
         if (colourMode == 0)    /* add colour table entry if needed */
             colour_table(pt,(BYTE)i,colours[i].r,colours[i].g,colours[i].b);
+        else {                  /* direct colours must be written again */
+            if (i == line_ci)
+                line_ci = -1;
+            if (i == fill_ci)
+                fill_ci = -1;
+        }
     }
     break;
 
@@ -701,7 +815,6 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
         width = (int)(rbuf[0]*0.005*DPI+0.5);
         if (width == 0)
             width = 1;
-        line_width(pt,(WORD)width);
         break;
 
 /*--- IFUNC=23, Escape --------------------------------------------------*/
@@ -712,6 +825,7 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
 /*--- IFUNC=24, Rectangle Fill. -----------------------------------------*/
 
     case 24:
+        set_fill_colour(pt,colourMode,colour,colours);
         rectangle(pt,(WORD)(rbuf[0]+0.5),(WORD)(rbuf[1]+0.5),(WORD)(rbuf[2]+0.5),(WORD)(rbuf[3]+0.5));
         break;
 
@@ -725,8 +839,6 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
     case 26:
     {
         int x,y,c,i,oldi,x1;
-        if (width > 1)      /* make sure the width is 1 */
-            line_width(pt,1);
         x = (int)(rbuf[0]+0.5);   /* start co-ordinates */
         y = (int)(rbuf[1]+0.5);
         x1 = 0;     /* set line offset to 0 */
@@ -735,16 +847,14 @@ void CGDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
         {
             i = (int)(rbuf[c+2]+0.5);
             if (i != oldi) {    /* if colour changed then draw line */
-                line_colour(pt,colourMode,(BYTE)oldi,colours);
+                set_line_attributes(pt,colourMode,oldi,colours,1);
                 line(pt,(WORD)(x+x1),(WORD)y,(WORD)(x+c),(WORD)y);
                 x1 = c;     /* reset line offset */
             }
             oldi = i;
         }
-        line_colour(pt,colourMode,(BYTE)oldi,colours);
+        set_line_attributes(pt,colourMode,oldi,colours,1);
         line(pt,(WORD)(x+x1),(WORD)y,(WORD)(x+c),(WORD)y);    /* add final line */
-        if (width > 1) 
-            line_width(pt,(WORD)width);   /* reset width if changed above */ 
     }
     break;
 
@@ -0,0 +1,579 @@
+/*DLDRIV -- PGPLOT display list driver
+ * +
+ *
+ * Supported device: a portable binary file holding the sequence of
+ * primitives that PGPLOT sends to a device driver (the "display list"),
+ * which can be replayed on any other PGPLOT device with PGRDDL without
+ * running the program that made it.
+ *
+ * Device type code: /PGDL.
+ *
+ * Default device name: pgplot.pgdl.
+ *
+ * Default view surface dimensions: 10.0 inches wide by 8.0 inches high
+ * (the size can be changed with PGPAP).
+ *
+ * Resolution: 1000 units per inch. Coordinates are recorded as REAL
+ * values, exactly as PGPLOT computed them.
+ *
+ * Color capability: Color indices 0-255 are accepted and the
+ * representation of all colors may be changed. The colors used are
+ * those of the device on which the file is replayed, except where the
+ * program changed them.
+ *
+ * Input capability: None.
+ *
+ * File format: The file consists of a 16-byte header, the characters
+ * "PGPLOTDL" followed by the format version (1) and a word reserved for
+ * future use, and then a series of records. Each record is a whole
+ * number of 32-bit words: a word giving the record type, a word giving
+ * the number N of words that follow, and then those N words. All words
+ * are little-endian integers or IEEE single-precision REALs, whatever
+ * the byte order of the machine, so the file can be mapped into memory
+ * and read on any machine. Coordinates are device coordinates, already
+ * clipped by PGPLOT. The record types are:
+ *
+ *   1 PAGE     begin picture: x and y size of the view surface, and
+ *              the resolution in x and y (units per inch) (4 REALs);
+ *   2 END      end picture (no words);
+ *   3 CI       set color index (1 integer);
+ *   4 CR       set color representation: index (1 integer), and red,
+ *              green and blue in the range 0-1 (3 REALs);
+ *   5 LS       set line style (1 integer, 1-5);
+ *   6 LW       set line width in units of 0.005 inch (1 integer);
+ *   7 LINE     polyline: x1, y1, x2, y2, ... (2 or more vertices);
+ *   8 DOT      dot: x, y;
+ *   9 POLYGON  filled polygon: x1, y1, x2, y2, ...;
+ *  10 RECT     filled rectangle: x and y of opposite corners (4 REALs);
+ *  11 IMAGE    image: the number of columns NX and rows NY (2
+ *              integers), the clipping rectangle xmin, xmax, ymin,
+ *              ymax, and the matrix [a b c d e f] that maps device (x,y)
+ *              to image coordinates (a*x+c*y+e, b*x+d*y+f) in which
+ *              pixel (i,j) covers i-1...i, j-1...j (10 REALs); then the
+ *              NX*NY color indices, row by row, packed two to a word as
+ *              16-bit integers (low half first);
+ *  12 MARKER   marker shape: the number of strokes and, for each, the
+ *              number of vertices and their (dx,dy) offsets (REALs);
+ *  13 MARKS    the marker shape drawn at each of the points x1, y1, x2,
+ *              y2, ... (REALs).
+ *
+ * Each PAGE record is followed by CR records for the colors that differ
+ * from the PGPLOT defaults, so each picture can be replayed by itself.
+ * Readers should skip records of types they do not recognize.
+ *
+ * Obtaining hardcopy: Replay the file on a hardcopy device with
+ * PGRDDL.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ *-------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PG_PPU
+#define DLDRIV dldriv_
+#define GRWARN grwarn_
+#else
+#define DLDRIV dldriv
+#define GRWARN grwarn
+#endif
+
+void GRWARN(const char *text, int text_len);
+
+#define DL_NAME "PGDL  (PGPLOT display list)"
+#define DL_FILE "pgplot.pgdl"
+#define DL_CAPABILITIES "HNDATRQNYNNLNP"
+#define DL_PPI 1000.0f     /* Units per inch */
+#define DL_WIDTH 10000     /* Default width (units) */
+#define DL_HEIGHT 8000     /* Default height (units) */
+#define DL_MAXDEV 256      /* Number of devices that may be open at once */
+#define DL_BUFSIZE 65536   /* Bytes written to the file at a time */
+
+#define DL_VERSION 1
+
+#define DL_PAGE 1
+#define DL_END 2
+#define DL_CI 3
+#define DL_CR 4
+#define DL_LS 5
+#define DL_LW 6
+#define DL_LINE 7
+#define DL_DOT 8
+#define DL_POLYGON 9
+#define DL_RECT 10
+#define DL_IMAGE 11
+#define DL_MARKER 12
+#define DL_MARKS 13
+
+typedef struct {
+  FILE *fp;
+  unsigned char *buf;    /* Output waiting to be written */
+  size_t nbuf;
+  int error;             /* True once a write has failed */
+  float ctab[256][3];    /* The color representations */
+  float *val;            /* The polygon or image being collected */
+  size_t nval, mval;
+  long npoly;            /* Vertices still to come in the polygon */
+} DlDevice;
+
+static DlDevice *dl_dev[DL_MAXDEV];
+static DlDevice *dl;     /* The selected device */
+
+/*
+ * The default color representations, as in GRSCR.
+ */
+static const float dl_default[16][3] = {
+  {0.00f, 0.00f, 0.00f}, {1.00f, 1.00f, 1.00f}, {1.00f, 0.00f, 0.00f},
+  {0.00f, 1.00f, 0.00f}, {0.00f, 0.00f, 1.00f}, {0.00f, 1.00f, 1.00f},
+  {1.00f, 0.00f, 1.00f}, {1.00f, 1.00f, 0.00f}, {1.00f, 0.50f, 0.00f},
+  {0.50f, 1.00f, 0.00f}, {0.00f, 1.00f, 0.50f}, {0.00f, 0.50f, 1.00f},
+  {0.50f, 0.00f, 1.00f}, {1.00f, 0.00f, 0.50f}, {0.33f, 0.33f, 0.33f},
+  {0.67f, 0.67f, 0.67f}
+};
+
+static void dl_warn(const char *text)
+{
+  GRWARN(text, (int) strlen(text));
+}
+
+static void dl_flush(DlDevice *d)
+{
+  if(d->nbuf > 0 && !d->error &&
+     fwrite(d->buf, 1, d->nbuf, d->fp) != d->nbuf) {
+    dl_warn("error writing PGPLOT display list");
+    d->error = 1;
+  };
+  d->nbuf = 0;
+}
+
+static void dl_word(DlDevice *d, unsigned long w)
+{
+  unsigned char *p;
+  if(d->nbuf + 4 > DL_BUFSIZE)
+    dl_flush(d);
+  p = d->buf + d->nbuf;
+  p[0] = (unsigned char) (w & 0xff);
+  p[1] = (unsigned char) (w >> 8 & 0xff);
+  p[2] = (unsigned char) (w >> 16 & 0xff);
+  p[3] = (unsigned char) (w >> 24 & 0xff);
+  d->nbuf += 4;
+}
+
+static void dl_int(DlDevice *d, long i)
+{
+  dl_word(d, (unsigned long) i & 0xffffffffUL);
+}
+
+static void dl_real(DlDevice *d, float f)
+{
+  unsigned int w;
+  memcpy(&w, &f, 4);
+  dl_word(d, (unsigned long) w);
+}
+
+static void dl_record(DlDevice *d, int type, size_t n)
+{
+  dl_word(d, (unsigned long) type);
+  dl_word(d, (unsigned long) n);
+}
+
+static void dl_reals(DlDevice *d, int type, const float *v, size_t n)
+{
+  size_t i;
+  dl_record(d, type, n);
+  for(i=0; i<n; i++)
+    dl_real(d, v[i]);
+}
+
+/*
+ * Add n values to the polygon or image being collected.
+ */
+static int dl_collect(DlDevice *d, const float *v, size_t n)
+{
+  if(d->nval + n > d->mval) {
+    size_t m = 2 * (d->nval + n);
+    float *val = (float *) realloc(d->val, m * sizeof(float));
+    if(!val)
+      return 1;
+    d->val = val;
+    d->mval = m;
+  };
+  memcpy(d->val + d->nval, v, n * sizeof(float));
+  d->nval += n;
+  return 0;
+}
+
+/*
+ * Write the image that has been collected: 13 values as sent by
+ * PGPLOT, followed by the color indices.
+ */
+static void dl_image(DlDevice *d)
+{
+  size_t nx = (size_t) d->val[1], ny = (size_t) d->val[2];
+  size_t n = nx * ny, i;
+  if(d->nval < 13 || d->nval - 13 < n)
+    n = d->nval < 13 ? 0 : d->nval - 13;
+  dl_record(d, DL_IMAGE, 12 + (nx * ny + 1) / 2);
+  dl_int(d, (long) nx);
+  dl_int(d, (long) ny);
+  for(i=3; i<13; i++)
+    dl_real(d, d->val[i]);
+  for(i=0; i<nx*ny; i+=2) {
+    long c0 = i < n ? (long) d->val[13+i] : 0;
+    long c1 = i+1 < n ? (long) d->val[14+i] : 0;
+    dl_word(d, (unsigned long) (c0 & 0xffff) |
+	    (unsigned long) (c1 & 0xffff) << 16);
+  };
+}
+
+static void dl_open(char *chr, int lchr, float *rbuf)
+{
+  DlDevice *d;
+  char *name;
+  int i, k;
+  rbuf[0] = 0.0f;
+  rbuf[1] = 0.0f;
+  for(k=0; k<DL_MAXDEV && dl_dev[k]; k++)
+    ;
+  if(k >= DL_MAXDEV) {
+    dl_warn("maximum number of devices of type PGDL exceeded");
+    return;
+  };
+  d = (DlDevice *) calloc(1, sizeof(DlDevice));
+  name = (char *) malloc(lchr + 1);
+  if(d)
+    d->buf = (unsigned char *) malloc(DL_BUFSIZE);
+  if(!d || !d->buf || !name) {
+    dl_warn("not enough memory for PGPLOT display list");
+    if(d)
+      free(d->buf);
+    free(d);
+    free(name);
+    return;
+  };
+  memcpy(name, chr, lchr);
+  name[lchr] = '\0';
+  d->fp = fopen(name, "wb");
+  if(!d->fp) {
+    dl_warn("cannot open output file for PGPLOT display list:");
+    dl_warn(name);
+    free(d->buf);
+    free(d);
+    free(name);
+    return;
+  };
+  free(name);
+  for(i=0; i<256; i++)
+    memcpy(d->ctab[i], dl_default[i < 16 ? i : 1], sizeof(d->ctab[i]));
+  memcpy(d->buf, "PGPLOTDL", 8);
+  d->nbuf = 8;
+  dl_word(d, DL_VERSION);
+  dl_word(d, 0);
+  dl_dev[k] = d;
+  dl = d;
+  rbuf[0] = (float) (k + 1);
+  rbuf[1] = 1.0f;
+}
+
+static void dl_close(void)
+{
+  int k;
+  if(!dl)
+    return;
+  dl_flush(dl);
+  if(fclose(dl->fp) != 0 && !dl->error)
+    dl_warn("error writing PGPLOT display list");
+  for(k=0; k<DL_MAXDEV; k++) {
+    if(dl_dev[k] == dl)
+      dl_dev[k] = NULL;
+  };
+  free(dl->buf);
+  free(dl->val);
+  free(dl);
+  dl = NULL;
+}
+
+void DLDRIV(int *ifunc, float *rbuf, int *nbuf, char *chr, int *lchr,
+	    int len)
+{
+  int i;
+  if(!dl && *ifunc > 9 && *ifunc != 29)
+    return;
+  switch(*ifunc) {
+
+/*--- IFUNC = 1, Return device name ------------------------------------*/
+
+  case 1:
+    strncpy(chr, DL_NAME, len);
+    *lchr = (int) strlen(DL_NAME);
+    for(i=*lchr; i<len; i++)
+      chr[i] = ' ';
+    break;
+
+/*--- IFUNC = 2, Return physical min and max for plot device, and range
+               of color indices -----------------------------------------*/
+
+  case 2:
+    rbuf[0] = 0.0f;
+    rbuf[1] = -1.0f;
+    rbuf[2] = 0.0f;
+    rbuf[3] = -1.0f;
+    rbuf[4] = 0.0f;
+    rbuf[5] = 255.0f;
+    *nbuf = 6;
+    break;
+
+/*--- IFUNC = 3, Return device resolution ------------------------------*/
+
+  case 3:
+    rbuf[0] = DL_PPI;
+    rbuf[1] = DL_PPI;
+    rbuf[2] = 1.0f;
+    *nbuf = 3;
+    break;
+
+/*--- IFUNC = 4, Return misc device info -------------------------------*/
+/*    (Hardcopy, No cursor, Dashed lines, Area fill, Thick lines,
+      Rectangle fill, image primitives (Q), No prompt, Query color
+      representation, No markers, No scroll, polyLines, No integer
+      pixel rows, batches of markers (P)) */
+
+  case 4:
+    *lchr = (int) strlen(DL_CAPABILITIES);
+    strncpy(chr, DL_CAPABILITIES, len);
+    break;
+
+/*--- IFUNC = 5, Return default file name ------------------------------*/
+
+  case 5:
+    strncpy(chr, DL_FILE, len);
+    *lchr = (int) strlen(DL_FILE);
+    for(i=*lchr; i<len; i++)
+      chr[i] = ' ';
+    break;
+
+/*--- IFUNC = 6, Return default physical size of plot ------------------*/
+
+  case 6:
+    rbuf[0] = 0.0f;
+    rbuf[1] = (float) (DL_WIDTH - 1);
+    rbuf[2] = 0.0f;
+    rbuf[3] = (float) (DL_HEIGHT - 1);
+    *nbuf = 4;
+    break;
+
+/*--- IFUNC = 7, Return misc defaults ----------------------------------*/
+
+  case 7:
+    rbuf[0] = 8.0f;
+    *nbuf = 1;
+    break;
+
+/*--- IFUNC = 8, Select plot -------------------------------------------*/
+
+  case 8:
+    i = (int) rbuf[1];
+    if(i >= 1 && i <= DL_MAXDEV && dl_dev[i-1])
+      dl = dl_dev[i-1];
+    else
+      dl_warn("internal error: PGDL opcode 8");
+    break;
+
+/*--- IFUNC = 9, Open workstation --------------------------------------*/
+
+  case 9:
+    dl_open(chr, *lchr, rbuf);
+    *nbuf = 2;
+    break;
+
+/*--- IFUNC = 10, Close workstation ------------------------------------*/
+
+  case 10:
+    dl_close();
+    break;
+
+/*--- IFUNC = 11, Begin picture ----------------------------------------*/
+
+  case 11:
+    dl_record(dl, DL_PAGE, 4);
+    dl_real(dl, rbuf[0]);
+    dl_real(dl, rbuf[1]);
+    dl_real(dl, DL_PPI);
+    dl_real(dl, DL_PPI);
+    for(i=0; i<256; i++) {
+      if(memcmp(dl->ctab[i], dl_default[i < 16 ? i : 1],
+		sizeof(dl->ctab[i])) != 0) {
+	dl_record(dl, DL_CR, 4);
+	dl_int(dl, i);
+	dl_real(dl, dl->ctab[i][0]);
+	dl_real(dl, dl->ctab[i][1]);
+	dl_real(dl, dl->ctab[i][2]);
+      };
+    };
+    break;
+
+/*--- IFUNC = 12, Draw line; IFUNC = 31, draw polyline -----------------*/
+
+  case 12:
+    dl_reals(dl, DL_LINE, rbuf, 4);
+    break;
+
+  case 31:
+    if(*nbuf >= 4)
+      dl_reals(dl, DL_LINE, rbuf, (size_t) (*nbuf / 2) * 2);
+    break;
+
+/*--- IFUNC = 13, Draw dot ---------------------------------------------*/
+
+  case 13:
+    dl_reals(dl, DL_DOT, rbuf, 2);
+    break;
+
+/*--- IFUNC = 14, End picture ------------------------------------------*/
+
+  case 14:
+    dl_record(dl, DL_END, 0);
+    break;
+
+/*--- IFUNC = 15, Select color index -----------------------------------*/
+
+  case 15:
+    dl_record(dl, DL_CI, 1);
+    dl_int(dl, (long) rbuf[0]);
+    break;
+
+/*--- IFUNC = 16, Flush buffer -----------------------------------------*/
+
+  case 16:
+    dl_flush(dl);
+    fflush(dl->fp);
+    break;
+
+/*--- IFUNC = 17, Read cursor ------------------------------------------*/
+
+  case 17:
+    dl_warn("PGDL device has no cursor");
+    break;
+
+/*--- IFUNC = 19, Set line style ---------------------------------------*/
+
+  case 19:
+    dl_record(dl, DL_LS, 1);
+    dl_int(dl, (long) rbuf[0]);
+    break;
+
+/*--- IFUNC = 20, Polygon fill -----------------------------------------*/
+/*    (The number of vertices is sent first, then one vertex per call.) */
+
+  case 20:
+    if(dl->npoly == 0) {
+      dl->npoly = (long) rbuf[0];
+      dl->nval = 0;
+    } else {
+      if(dl_collect(dl, rbuf, 2) && !dl->error) {
+	dl_warn("not enough memory for PGPLOT display list");
+	dl->error = 1;
+      };
+      if(--dl->npoly == 0 && dl->nval >= 6)
+	dl_reals(dl, DL_POLYGON, dl->val, dl->nval);
+    };
+    break;
+
+/*--- IFUNC = 21, Set color representation -----------------------------*/
+
+  case 21:
+    i = (int) rbuf[0];
+    if(i >= 0 && i < 256) {
+      dl->ctab[i][0] = rbuf[1];
+      dl->ctab[i][1] = rbuf[2];
+      dl->ctab[i][2] = rbuf[3];
+      dl_record(dl, DL_CR, 4);
+      dl_int(dl, i);
+      dl_real(dl, rbuf[1]);
+      dl_real(dl, rbuf[2]);
+      dl_real(dl, rbuf[3]);
+    };
+    break;
+
+/*--- IFUNC = 22, Set line width ---------------------------------------*/
+
+  case 22:
+    dl_record(dl, DL_LW, 1);
+    dl_int(dl, (long) (rbuf[0] + 0.5f));
+    break;
+
+/*--- IFUNC = 24, Rectangle fill ---------------------------------------*/
+
+  case 24:
+    dl_reals(dl, DL_RECT, rbuf, 4);
+    break;
+
+/*--- IFUNC = 26, Image ------------------------------------------------*/
+/*    (13 values describing the image, then the color indices in any
+      number of calls, then -1.) */
+
+  case 26:
+    if(rbuf[0] == 0.0f) {
+      dl->nval = 0;
+      if(*nbuf >= 13 && dl_collect(dl, rbuf, 13) == 0)
+	break;
+    } else if(rbuf[0] > 0.0f && dl->nval >= 13) {
+      if(dl_collect(dl, rbuf + 1, (size_t) rbuf[0]) == 0)
+	break;
+    } else if(rbuf[0] < 0.0f && dl->nval >= 13) {
+      dl_image(dl);
+      dl->nval = 0;
+      break;
+    } else {
+      break;
+    };
+    if(!dl->error) {
+      dl_warn("not enough memory for PGPLOT display list");
+      dl->error = 1;
+    };
+    break;
+
+/*--- IFUNC = 29, Query color representation ---------------------------*/
+
+  case 29:
+    i = (int) rbuf[0];
+    if(!dl || i < 0 || i > 255)
+      i = 1;
+    rbuf[1] = dl ? dl->ctab[i][0] : dl_default[1][0];
+    rbuf[2] = dl ? dl->ctab[i][1] : dl_default[1][1];
+    rbuf[3] = dl ? dl->ctab[i][2] : dl_default[1][2];
+    *nbuf = 4;
+    break;
+
+/*--- IFUNC = 33, Draw markers -----------------------------------------*/
+/*    (RBUF(1) = 0: the shape; RBUF(1) = 1: positions.) */
+
+  case 33:
+    if(*nbuf > 1)
+      dl_reals(dl, rbuf[0] == 0.0f ? DL_MARKER : DL_MARKS, rbuf + 1,
+	       (size_t) (*nbuf - 1));
+    break;
+
+/*--- IFUNC = 18 (erase alpha screen), 23 (escape), 25 (fill pattern),
+      27 (scaling info): ignored ---------------------------------------*/
+
+  case 18:
+  case 23:
+  case 25:
+  case 27:
+    break;
+
+  default:
+    {
+      char msg[64];
+      sprintf(msg, "Unimplemented function in PGDL device driver: %d",
+	      *ifunc);
+      dl_warn(msg);
+      *nbuf = -1;
+    };
+    break;
+  };
+}
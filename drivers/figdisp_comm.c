@@ -11,6 +11,8 @@
 /* 23-Nov-1992	SNS/CIT	Now uses XSetErrorHandler so that we don't just go */
 /*			away. */
 /*  3-Jun-1994  TJP/CIT Create selection atom if it doesn't exist. */
+/* 17-Oct-2026		Command buffers now go through the server's local */
+/*			data socket when it has one on this host. */
 
 /* The program include files */
 #include "commands.h"
@@ -23,6 +25,11 @@
 #ifndef VMS
 #include <sys/types.h>
 #include <netinet/in.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #endif
 
 /* The X Window include files */
@@ -46,6 +53,7 @@ static Atom lockatom;		/* The atom used for locking */
 static int maxlen;		/* the maximum number of shorts in a transfer */
 static int fd_dispopen=0;	/* if the display connection is open */
 static int xerror=0;		/* an X error occurred. */
+static int sockfd= -1;		/* the local data socket, if connected */
 
 #ifdef VMS
 static unsigned short ntohs(netshort)
@@ -82,6 +90,7 @@ XErrorEvent *err;
 /* 16-Nov-1990	SNS/CIT	Now takes a buffer of shorts (instead of chars). */
 /* 13-Sep-1991	SNS/CIT	Now uses "global" display, window, and incratom */
 /* 23-Sep-1992	SNS/CIT	Now converts the buffer to network order as needed. */
+/* 17-Oct-2026		Now writes the buffer to the data socket if open. */
 
 void figdisp_sendcommand(buffer,len)
 short *buffer;		/* the command buffer */
@@ -97,6 +106,34 @@ int len;		/* number of shorts in the command buffer */
 	if (!fd_dispopen) return;
 	/* convert the buffer to network byte order */
 	figdisp_convbufout(buffer,len);
+#ifndef VMS
+	if (sockfd >= 0)
+	{ /* the whole buffer goes in one piece; the socket paces us */
+		char *cbuf= (char *)buffer;
+
+		len *= 2;
+		while (len > 0)
+		{
+#ifdef MSG_NOSIGNAL
+			itmp=send(sockfd,cbuf,len,MSG_NOSIGNAL);
+#else
+			itmp=write(sockfd,cbuf,len);
+#endif
+			if (itmp < 0)
+			{
+				if (errno == EINTR) continue;
+				fprintf(stderr, "Error on data socket!\n");
+				(void)close(sockfd);
+				sockfd= -1;
+				fd_dispopen=0;
+				return;
+			}
+			cbuf += itmp;
+			len -= itmp;
+		}
+		return;
+	}
+#endif
 	while (len && fd_dispopen)
 	{
 		XNextEvent(display,&event);
@@ -182,6 +219,7 @@ int *len;		/* the number of shorts in the response */
 /* Created: 20-Nov-1990 */
 /* 13-Sep-1991	SNS/CIT	Now uses static display and window */
 /*  6-Nov-1994  MCS/TJP Change uninitialized pointer to 0 */
+/* 17-Oct-2026		Closes the data socket before ending the transfer. */
 
 void figdisp_closecomm()
 {
@@ -191,6 +229,14 @@ void figdisp_closecomm()
 	int sent=0;
 
 	if (!fd_dispopen) return;
+#ifndef VMS
+	/* the server reads the socket to the end before it finishes */
+	if (sockfd >= 0)
+	{
+		(void)close(sockfd);
+		sockfd= -1;
+	}
+#endif
 	while (more)
 	{
 		XNextEvent(display,&event);
@@ -222,6 +268,61 @@ void figdisp_closecomm()
 	return;
 }
 
+#ifndef VMS
+/* The figdisp_opensock routine connects to the server's local data socket */
+/* if the server advertises one on this host.  Otherwise sockfd stays -1 */
+/* and the data go through X selections as before. */
+
+/* Created: 17-Oct-2026 */
+
+static void figdisp_opensock(dev)
+int dev;	/* The figdisp display in use */
+{
+	char name[256];		/* atom name, then our host name */
+	Atom sockatom;		/* the atom of the advertising property */
+	Atom acttype;		/* the actual type of the property */
+	int actform;		/* the actual format of the property */
+	unsigned long nitems;	/* the length of the property */
+	unsigned long bytesleft;	/* bytes not read */
+	char *value=NULL;	/* the property value, "host:path" */
+	char *path;		/* the socket path in value */
+	struct sockaddr_un addr;	/* the socket address */
+
+	/* an X error may have left the last one open */
+	if (sockfd >= 0) (void)close(sockfd);
+	sockfd= -1;
+
+	(void)sprintf(&name[0],"%s_%d_%d",NAME_SOCKATOM,screen,dev);
+	if ((sockatom=XInternAtom(display,&name[0],True)) == None) return;
+	if (XGetWindowProperty(display,dispowner,sockatom,0L,
+		(long)(sizeof(name)+sizeof(addr.sun_path))/4,False,XA_STRING,
+		&acttype,&actform,&nitems,&bytesleft,
+		(unsigned char **)&value) != Success || value == NULL) return;
+
+	/* the socket is only any use if the server is on this host */
+	if (gethostname(&name[0],sizeof(name)) < 0) name[0]='\0';
+	name[sizeof(name)-1]='\0';
+	if (acttype == XA_STRING && !bytesleft &&
+	    (path=strrchr(value,':')) != NULL &&
+	    path-value == strlen(&name[0]) &&
+	    !strncmp(value,&name[0],path-value) &&
+	    strlen(++path) < sizeof(addr.sun_path))
+	{
+		(void)memset((char *)&addr,0,sizeof(addr));
+		addr.sun_family=AF_UNIX;
+		(void)strcpy(addr.sun_path,path);
+		if ((sockfd=socket(AF_UNIX,SOCK_STREAM,0)) >= 0 &&
+		    connect(sockfd,(struct sockaddr *)&addr,sizeof(addr)) < 0)
+		{
+			(void)close(sockfd);
+			sockfd= -1;
+		}
+	}
+	XFree(value);
+	return;
+}
+#endif
+
 /* The figdisp_opencomm routine opens a channel to the display server.  */
 /* Maxbuf is the maxmimum number of shorts in the command buffer that will */
 /* be sent at one time. */
@@ -233,6 +334,7 @@ void figdisp_closecomm()
 /* Created: 13-Sep-1991 */
 /* Modification History: */
 /* 14-Feb-1992	SNS/CIT	Now includes support for multiple devices */
+/* 17-Oct-2026		Now connects to the server's data socket, if any. */
 
 int figdisp_opencomm(maxbuf,dev)
 int maxbuf;
@@ -350,6 +452,9 @@ int dev;	/* The figdisp display to open */
 		XSetErrorHandler (xerrorhandler);
 		fd_dispopen=1;
 		xerror=0;
+#ifndef VMS
+		figdisp_opensock(dev);
+#endif
 	}
 	return(1);
 }
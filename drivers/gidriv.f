@@ -44,6 +44,9 @@ C+
 * Indices 0 to 255 are supported. Each of these indices can be assigned
 * one color. Default colors for indices 0 to 15 are implemented.
 *
+* Line width: thick lines are drawn by the shared raster engine
+*   (grrast.c) rather than emulated with multiple strokes.
+*
 * Obtaining hardcopy: Use a GIF viewer or converter.
 *=
 *  1-Aug-1994 - Created by Remko Scharroo
@@ -56,6 +59,7 @@ C+
 * 28-Dec-1995 - prevent concurrent access [TJP].
 * 29-Apr-1996 - use GRCTOI to decode environment variables [TJP].
 *  2-Sep-1997 - correct a byte overflow problem
+* 17-Oct-2026 - draw lines with GRRSLN; support thick lines.
 *-----------------------------------------------------------------------
       CHARACTER*(*) LTYPE, PTYPE, DEFNAM
       INTEGER DWD, DHT, BX, BY
@@ -73,6 +77,7 @@ C
       INTEGER CTABLE(3,0:255), CDEFLT(3,0:15)
       INTEGER IER, I, L, LL, IX0, IY0, IX1, IY1, USERW, USERH, JUNK
       INTEGER GRGMEM, GRFMEM, GROFIL, GRCFIL, GRCTOI
+      REAL    LW
       CHARACTER*80 MSG, INSTR, FILENM
 C
 C Note: for 64-bit operating systems, change the following 
@@ -81,7 +86,7 @@ C
       INTEGER*8 PIXMAP, WORK
 C
       SAVE UNIT, IC, CTABLE, NPICT, MAXIDX, BX, BY, PIXMAP, FILENM
-      SAVE CDEFLT, STATE
+      SAVE CDEFLT, STATE, LW
       DATA CDEFLT /000,000,000, 255,255,255, 255,000,000, 000,255,000,
      1             000,000,255, 000,255,255, 255,000,255, 255,255,000,
      2             255,128,000, 128,255,000, 000,255,128, 000,128,255,
@@ -132,10 +137,10 @@ C
       RETURN
 C
 C--- IFUNC = 4, Return misc device info --------------------------------
-C    (This device is Hardcopy, supports rectangle fill, pixel 
-C     primitives, and query color rep.)
+C    (This device is Hardcopy, supports thick lines, rectangle fill,
+C     pixel primitives, and query color rep.)
 C
-   40 CHR = 'HNNNNRPNYN'
+   40 CHR = 'HNNNTRPNYN'
       LCHR = 10
       RETURN
 C
@@ -184,6 +189,7 @@ C     -- dimensions of plot buffer
       CALL GRGENV('GIF_HEIGHT', INSTR, L)
       LL = 1
       IF (L.GT.0) USERH = GRCTOI(INSTR(:L),LL)
+      LW = 1.0
       IF (MODE.EQ.1) THEN
 *     -- Landscape
          BX = DWD
@@ -263,7 +269,8 @@ C
       IY0=BY-NINT(RBUF(2))
       IY1=BY-NINT(RBUF(4))
       IF (PIXMAP.NE.0)
-     :     CALL GRGI01(IX0, IY0, IX1, IY1, IC, BX, BY, %VAL(PIXMAP))
+     :     CALL GRRSLN(REAL(IX0), REAL(IY0), REAL(IX1), REAL(IY1), LW,
+     :                 IC, 1, 0, BX, BY, %VAL(PIXMAP))
       RETURN
 C
 C--- IFUNC=13, Draw dot ------------------------------------------------
@@ -272,7 +279,8 @@ C
       IX0=NINT(RBUF(1))+1
       IY0=BY-NINT(RBUF(2))
       IF (PIXMAP.NE.0)
-     :     CALL GRGI01(IX0, IY0, IX0, IY0, IC, BX, BY, %VAL(PIXMAP))
+     :     CALL GRRSLN(REAL(IX0), REAL(IY0), REAL(IX0), REAL(IY0), LW,
+     :                 IC, 1, 0, BX, BY, %VAL(PIXMAP))
       RETURN
 C
 C--- IFUNC=14, End picture ---------------------------------------------
@@ -345,10 +353,11 @@ C
       RETURN
 C
 C--- IFUNC=22, Set line width. -----------------------------------------
-C    (Not implemented: should not be called)
+C    (Converted from units of 0.005 inch to pixels.)
 C
   220 CONTINUE
-      GOTO 900
+      LW = MAX(1.0, (NINT(RBUF(1))-1)*0.005*XRES + 1.0)
+      RETURN
 C
 C--- IFUNC=23, Escape --------------------------------------------------
 C    (Not implemented: ignored)
@@ -400,50 +409,6 @@ C
 C-----------------------------------------------------------------------
       END
 
-**GRGI01 -- PGPLOT GIF driver, draw line
-*+
-      SUBROUTINE GRGI01 (IX0, IY0, IX1, IY1, ICOL, BX, BY, PIXMAP)
-      INTEGER IX0, IY0, IX1, IY1
-      INTEGER ICOL, BX, BY
-      BYTE PIXMAP(BX,BY)
-*
-* Draw a straight-line segment from absolute pixel coordinates
-* (IX0, IY0) to (IX1, IY1).
-*
-* Arguments:
-*  ICOL            (input): Color index
-*  PIXMAP   (input/output): The image data buffer.
-*-----------------------------------------------------------------------
-      INTEGER IX, IY, IS
-      REAL    D
-      BYTE    VAL
-*
-      IF (ICOL.GT.127) THEN
-         VAL = ICOL-256
-      ELSE
-         VAL = ICOL
-      END IF
-      IF (IX0.EQ.IX1 .AND. IY0.EQ.IY1) THEN
-         PIXMAP(IX0,IY0)=VAL
-      ELSE IF (ABS(IY1-IY0).GT.ABS(IX1-IX0)) THEN
-         D=(IX1-IX0)/REAL(IY1-IY0)
-         IS=1
-         IF (IY1.LT.IY0) IS=-1
-         DO 10 IY=IY0,IY1,IS
-            IX=NINT(IX0+(IY-IY0)*D)
-            PIXMAP(IX,IY)=VAL
- 10      CONTINUE
-      ELSE
-         D=(IY1-IY0)/REAL(IX1-IX0)
-         IS=1
-         IF (IX1.LT.IX0) IS=-1
-         DO 20 IX=IX0,IX1,IS
-            IY=NINT(IY0+(IX-IX0)*D)
-            PIXMAP(IX,IY)=VAL
- 20      CONTINUE
-      END IF
-      END
-
 **GRGI03 -- PGPLOT GIF driver, fill rectangle
 *+
       SUBROUTINE GRGI03 (IX0, IY0, IX1, IY1, ICOL, BX, BY, PIXMAP)
@@ -0,0 +1,229 @@
+/*
+ * Compressed image data for the PostScript driver (PSDRIV).
+ *
+ * Image samples passed to GRPZPT are optionally deflated with zlib and
+ * then ASCII85-encoded; the resulting text is collected into lines that
+ * PSDRIV fetches one at a time with GRPZGT and writes to its Fortran
+ * unit. The data can be read back by PostScript with
+ *
+ *   currentfile /ASCII85Decode filter /FlateDecode filter
+ *
+ * (or without the /FlateDecode filter if zlib was not used). zlib is
+ * used only if this file is compiled with HAVE_ZLIB defined; otherwise
+ * GRPZOK reports that compression is unavailable and the data are just
+ * ASCII85-encoded.
+ *
+ * Only one stream can be active at a time, which matches PSDRIV's
+ * restriction to one open file.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef PG_PPU
+#define GRPZOK grpzok_
+#define GRPZBG grpzbg_
+#define GRPZPT grpzpt_
+#define GRPZGT grpzgt_
+#define GRPZND grpznd_
+#else
+#define GRPZOK grpzok
+#define GRPZBG grpzbg
+#define GRPZPT grpzpt
+#define GRPZGT grpzgt
+#define GRPZND grpznd
+#endif
+
+#define GRPZ_LINE 75      /* Characters per line of ASCII85 output */
+#define GRPZ_CHUNK 16384  /* Size of the deflate output buffer */
+
+static struct {
+  int flate;              /* True if the data are being deflated */
+  unsigned char tuple[4]; /* Bytes waiting to be ASCII85-encoded */
+  int ntuple;
+  int col;                /* Column of the next character in the line */
+  char *text;             /* Encoded text not yet fetched by GRPZGT */
+  size_t len, pos, size;
+#ifdef HAVE_ZLIB
+  z_stream z;
+#endif
+} grpz;
+
+/*
+ * Append n characters of encoded text, breaking lines at GRPZ_LINE.
+ * Returns 0, or -1 if out of memory.
+ */
+static int grpz_text(const char *s, int n)
+{
+  if(grpz.pos > 0) {
+    memmove(grpz.text, grpz.text + grpz.pos, grpz.len - grpz.pos);
+    grpz.len -= grpz.pos;
+    grpz.pos = 0;
+  };
+  if(grpz.len + 2*n + 2 > grpz.size) {
+    size_t size = 2*(grpz.len + 2*n + 2) + 1024;
+    char *text = (char *) realloc(grpz.text, size);
+    if(!text)
+      return -1;
+    grpz.text = text;
+    grpz.size = size;
+  };
+  while(n-- > 0) {
+    if(*s != '\n' && grpz.col >= GRPZ_LINE) {
+      grpz.text[grpz.len++] = '\n';
+      grpz.col = 0;
+    };
+    grpz.col = *s == '\n' ? 0 : grpz.col + 1;
+    grpz.text[grpz.len++] = *s++;
+  };
+  return 0;
+}
+
+/*
+ * Encode the n (1-4) bytes in grpz.tuple[] as ASCII85. A complete
+ * group of zeros is written as 'z'.
+ */
+static int grpz_tuple(int n)
+{
+  unsigned long v = 0;
+  char c[5];
+  int i;
+  for(i=0; i<4; i++)
+    v = (v << 8) | (i < n ? grpz.tuple[i] : 0);
+  if(n == 4 && v == 0)
+    return grpz_text("z", 1);
+  for(i=4; i>=0; i--) {
+    c[i] = (char) ('!' + v % 85);
+    v /= 85;
+  };
+  return grpz_text(c, n + 1);
+}
+
+static int grpz_a85(const unsigned char *data, size_t n)
+{
+  while(n-- > 0) {
+    grpz.tuple[grpz.ntuple++] = *data++;
+    if(grpz.ntuple == 4) {
+      grpz.ntuple = 0;
+      if(grpz_tuple(4))
+	return -1;
+    };
+  };
+  return 0;
+}
+
+#ifdef HAVE_ZLIB
+/*
+ * Run deflate with the given flush mode, encoding all of its output.
+ */
+static int grpz_deflate(int flush)
+{
+  unsigned char out[GRPZ_CHUNK];
+  int status;
+  do {
+    grpz.z.next_out = out;
+    grpz.z.avail_out = sizeof(out);
+    status = deflate(&grpz.z, flush);
+    if(status == Z_STREAM_ERROR)
+      return -1;
+    if(grpz_a85(out, sizeof(out) - grpz.z.avail_out))
+      return -1;
+  } while(grpz.z.avail_out == 0 ||
+	  (flush == Z_FINISH && status != Z_STREAM_END));
+  return 0;
+}
+#endif
+
+/*
+ * GRPZOK -- return 1 if image data can be compressed, 0 if not.
+ */
+int GRPZOK()
+{
+#ifdef HAVE_ZLIB
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+/*
+ * GRPZBG(FLATE) -- start a new stream of image data; if FLATE is 1
+ * (and GRPZOK returned 1) the data are deflated before encoding.
+ */
+void GRPZBG(int *flate)
+{
+  grpz.flate = 0;
+  grpz.ntuple = 0;
+  grpz.col = 0;
+  grpz.len = grpz.pos = 0;
+#ifdef HAVE_ZLIB
+  if(*flate == 1) {
+    memset(&grpz.z, 0, sizeof(grpz.z));
+    grpz.flate = deflateInit(&grpz.z, Z_DEFAULT_COMPRESSION) == Z_OK;
+  };
+#endif
+}
+
+/*
+ * GRPZPT(STR) -- add the bytes of Fortran string STR to the stream.
+ */
+void GRPZPT(char *str, int str_len)
+{
+#ifdef HAVE_ZLIB
+  if(grpz.flate) {
+    grpz.z.next_in = (unsigned char *) str;
+    grpz.z.avail_in = str_len;
+    grpz_deflate(Z_NO_FLUSH);
+    return;
+  };
+#endif
+  grpz_a85((unsigned char *) str, str_len);
+}
+
+/*
+ * GRPZND -- end the stream, adding the ASCII85 end-of-data marker "~>".
+ */
+void GRPZND()
+{
+#ifdef HAVE_ZLIB
+  if(grpz.flate) {
+    grpz.z.next_in = NULL;
+    grpz.z.avail_in = 0;
+    grpz_deflate(Z_FINISH);
+    deflateEnd(&grpz.z);
+    grpz.flate = 0;
+  };
+#endif
+  if(grpz.ntuple > 0)
+    grpz_tuple(grpz.ntuple);
+  grpz.ntuple = 0;
+  if(grpz.col + 2 > GRPZ_LINE)
+    grpz.col = GRPZ_LINE;     /* keep the marker on one line */
+  grpz_text("~>\n", 3);
+}
+
+/*
+ * GRPZGT(LINE, L) -- return the next complete line of encoded text in
+ * LINE(1:L), or L=0 if there is none yet.
+ */
+void GRPZGT(char *line, int *l, int line_len)
+{
+  char *end;
+  size_t n;
+  *l = 0;
+  if(grpz.pos >= grpz.len)
+    return;
+  end = memchr(grpz.text + grpz.pos, '\n', grpz.len - grpz.pos);
+  if(!end)
+    return;
+  n = end - (grpz.text + grpz.pos);
+  if(n > (size_t) line_len)
+    n = line_len;
+  memcpy(line, grpz.text + grpz.pos, n);
+  *l = (int) n;
+  grpz.pos = end - grpz.text + 1;
+}
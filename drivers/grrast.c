@@ -0,0 +1,730 @@
+/*GRRAST -- scanline raster engine shared by the pixmap drivers
+ * +
+ *
+ * These routines draw lines and rectangles into an in-memory pixmap.
+ * Thin lines use an integer Bresenham walk. Thick lines are drawn
+ * natively as one span per row of the "capsule" swept out by a round
+ * pen, so a driver that uses them can advertise hardware thick lines
+ * ('T' in its capability string) and receive each line once instead
+ * of the many offset strokes that GRLIN3 would otherwise send. For
+ * direct-color rasters the edges of thick lines can optionally be
+ * anti-aliased by blending with the existing pixels according to the
+ * fraction of each pixel covered by the pen.
+ *
+ * Polylines are drawn with the same Bresenham walk as single lines, but
+ * each horizontal run of pixels is filled as one span.
+ *
+ * The C drivers (PNDRIV) call the grrast_*() functions directly.
+ * Fortran drivers (GIDRIV, PPDRIV) call GRRSLN, which wraps
+ * grrast_thick_line() for a pixmap allocated with GRGMEM.
+ *
+ * The printer drivers (HJDRIV, LJDRIV, CCDRIV) keep their pages in
+ * packed bitmaps of 1, 4 or 8 bits per pixel (GrBitmap). Spans are
+ * filled a byte at a time with memset() and masks at the two ends.
+ * Lines are drawn with the same Bresenham walk as above, and each
+ * horizontal run is filled as one span. These drivers call GRBMLN,
+ * GRBMCL and GRBMRW.
+ *-------
+ * 17-Oct-2026 - new.
+ * 17-Oct-2026 - added grrast_polyline().
+ * 17-Oct-2026 - added packed bitmaps for the printer drivers.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "grrast.h"
+
+#ifdef PG_PPU
+#define GRRSLN grrsln_
+#define GRBMLN grbmln_
+#define GRBMCL grbmcl_
+#define GRBMRW grbmrw_
+#else
+#define GRRSLN grrsln
+#define GRBMLN grbmln
+#define GRBMCL grbmcl
+#define GRBMRW grbmrw
+#endif
+
+static void grrast_put ARGS((GrRaster *r, int x, int y, unsigned long val));
+static void grrast_blend ARGS((GrRaster *r, int x, int y, unsigned long val,
+			       double cover));
+static void grrast_line_spans ARGS((GrRaster *r, int x0, int y0, int x1,
+				    int y1, unsigned long val));
+static int grrast_capsule_span ARGS((double x0, double y0, double ux,
+				     double uy, double len, double rad,
+				     double y, double *xl, double *xr));
+static double grrast_seg_dist ARGS((double x0, double y0, double ux,
+				    double uy, double len,
+				    double x, double y));
+
+/*.......................................................................
+ * Convert a PGPLOT line width to pixels.
+ *
+ * Input:
+ *  lw       int    The line width in units of 0.005 inch.
+ *  ppi   double    The device resolution in pixels per inch.
+ * Output:
+ *  return double   The width of the line in pixels.
+ */
+double grrast_lw_pixels(int lw, double ppi)
+{
+  return lw > 1 ? (lw - 1) * 0.005 * ppi + 1.0 : 1.0;
+}
+
+/*.......................................................................
+ * Set one pixel, without bounds checking.
+ */
+static void grrast_put(GrRaster *r, int x, int y, unsigned long val)
+{
+  if(r->bpp == 1)
+    r->pix[(long)y * r->w + x] = (unsigned char) val;
+  else
+    ((unsigned int *) r->pix)[(long)y * r->w + x] = (unsigned int) val;
+}
+
+/*.......................................................................
+ * Mix a packed RGB value into one pixel of a direct-color raster.
+ *
+ * Input:
+ *  cover  double   The fraction (0..1) of the pixel covered.
+ */
+static void grrast_blend(GrRaster *r, int x, int y, unsigned long val,
+			 double cover)
+{
+  unsigned int *p = (unsigned int *) r->pix + (long)y * r->w + x;
+  unsigned int old = *p;
+  unsigned int mix = 0;
+  int shift;
+  for(shift=0; shift<24; shift += 8) {
+    int a = (old >> shift) & 0xff;
+    int b = (val >> shift) & 0xff;
+    mix |= (unsigned int) (a + (b - a) * cover + 0.5) << shift;
+  };
+  *p = mix;
+}
+
+/*.......................................................................
+ * Fill a horizontal run of pixels, clipped to the raster.
+ *
+ * Input:
+ *  r      GrRaster *  The raster to draw in.
+ *  y           int    The row to draw on.
+ *  x0, x1      int    The first and last pixels of the run.
+ *  val    unsigned long  The pixel value.
+ */
+void grrast_span(GrRaster *r, int y, int x0, int x1, unsigned long val)
+{
+  if(y < 0 || y >= r->h)
+    return;
+  if(x0 > x1) {
+    int tmp = x0; x0 = x1; x1 = tmp;
+  };
+  if(x0 < 0)
+    x0 = 0;
+  if(x1 >= r->w)
+    x1 = r->w - 1;
+  if(x0 > x1)
+    return;
+  if(r->bpp == 1) {
+    memset(r->pix + (long)y * r->w + x0, (int) (val & 0xff), x1 - x0 + 1);
+  } else {
+    unsigned int *p = (unsigned int *) r->pix + (long)y * r->w + x0;
+    unsigned int *end = p + (x1 - x0 + 1);
+    while(p < end)
+      *p++ = (unsigned int) val;
+  };
+}
+
+/*.......................................................................
+ * Fill a rectangle, clipped to the raster.
+ */
+void grrast_rect(GrRaster *r, int x0, int y0, int x1, int y1,
+		 unsigned long val)
+{
+  int y;
+  if(y0 > y1) {
+    int tmp = y0; y0 = y1; y1 = tmp;
+  };
+  if(y0 < 0)
+    y0 = 0;
+  if(y1 >= r->h)
+    y1 = r->h - 1;
+  for(y=y0; y<=y1; y++)
+    grrast_span(r, y, x0, x1, val);
+}
+
+/*.......................................................................
+ * Draw a one-pixel wide line with the Bresenham algorithm. Both end
+ * points are drawn. Horizontal and vertical lines are filled as
+ * rectangles.
+ */
+void grrast_line(GrRaster *r, int x0, int y0, int x1, int y1,
+		 unsigned long val)
+{
+  int dx, dy, sx, sy, err, e2;
+  if(y0 == y1 || x0 == x1) {
+    grrast_rect(r, x0, y0, x1, y1, val);
+    return;
+  };
+  dx = abs(x1 - x0);
+  dy = abs(y1 - y0);
+  sx = x0 < x1 ? 1 : -1;
+  sy = y0 < y1 ? 1 : -1;
+  err = dx - dy;
+  for(;;) {
+    if(x0 >= 0 && x0 < r->w && y0 >= 0 && y0 < r->h)
+      grrast_put(r, x0, y0, val);
+    if(x0 == x1 && y0 == y1)
+      break;
+    e2 = 2 * err;
+    if(e2 > -dy) {
+      err -= dy;
+      x0 += sx;
+    };
+    if(e2 < dx) {
+      err += dx;
+      y0 += sy;
+    };
+  };
+}
+
+/*.......................................................................
+ * Draw the same pixels as grrast_line(), filling each horizontal run
+ * with one call to grrast_span() instead of setting the pixels singly.
+ */
+static void grrast_line_spans(GrRaster *r, int x0, int y0, int x1, int y1,
+			      unsigned long val)
+{
+  int dx, dy, sx, sy, err, e2, xs;
+  if(y0 == y1 || x0 == x1) {
+    grrast_rect(r, x0, y0, x1, y1, val);
+    return;
+  };
+  dx = abs(x1 - x0);
+  dy = abs(y1 - y0);
+  sx = x0 < x1 ? 1 : -1;
+  sy = y0 < y1 ? 1 : -1;
+  err = dx - dy;
+  xs = x0;
+  for(;;) {
+    if(x0 == x1 && y0 == y1) {
+      grrast_span(r, y0, xs, x0, val);
+      break;
+    };
+    e2 = 2 * err;
+    if(e2 < dx) {
+/*
+ * The next pixel is on a new row: finish the run on this one.
+ */
+      grrast_span(r, y0, xs, x0, val);
+      if(e2 > -dy) {
+	err -= dy;
+	x0 += sx;
+      };
+      err += dx;
+      y0 += sy;
+      xs = x0;
+    } else {
+      err -= dy;
+      x0 += sx;
+    };
+  };
+}
+
+/*.......................................................................
+ * Draw a polyline.
+ *
+ * Input:
+ *  r      GrRaster *  The raster to draw in.
+ *  xy   const int *   The vertices, x1,y1,x2,y2,...
+ *  n           int    The number of vertices.
+ *  width    double    The width of the line (pixels).
+ *  val    unsigned long  The pixel value.
+ */
+void grrast_polyline(GrRaster *r, const int *xy, int n, double width,
+		     unsigned long val)
+{
+  int i;
+  for(i=1; i<n; i++, xy += 2) {
+    if(width > 1.0 || r->aa)
+      grrast_thick_line(r, xy[0], xy[1], xy[2], xy[3], width, val);
+    else
+      grrast_line_spans(r, xy[0], xy[1], xy[2], xy[3], val);
+  };
+}
+
+/*.......................................................................
+ * Find where the row y crosses the capsule of radius rad around the
+ * segment that starts at (x0,y0), runs along the unit vector (ux,uy)
+ * and has length len. The capsule is convex, so the crossing is a
+ * single interval; it is the hull of the crossings of the two end
+ * circles and of the rectangle between them.
+ *
+ * Output:
+ *  *xl, *xr  double  The left and right ends of the crossing.
+ *  return       int  0 if the row misses the capsule.
+ */
+static int grrast_capsule_span(double x0, double y0, double ux, double uy,
+			       double len, double rad, double y,
+			       double *xl, double *xr)
+{
+  double lo = 0.0, hi = 0.0;
+  double ey[2];
+  int found = 0;
+  int i;
+/*
+ * The end circles.
+ */
+  ey[0] = y - y0;
+  ey[1] = y - (y0 + uy * len);
+  for(i=0; i<2; i++) {
+    double d2 = rad * rad - ey[i] * ey[i];
+    if(d2 >= 0.0) {
+      double cx = i==0 ? x0 : x0 + ux * len;
+      double half = sqrt(d2);
+      if(!found || cx - half < lo) lo = cx - half;
+      if(!found || cx + half > hi) hi = cx + half;
+      found = 1;
+    };
+  };
+/*
+ * The rectangle: 0 <= (p-p0).u <= len and |(p-p0) x u| <= rad, each of
+ * which is linear in x along the row.
+ */
+  if(len > 0.0) {
+    double a[2], b[2], blo[2], bhi[2];
+    double rl = -HUGE_VAL, rr = HUGE_VAL;
+    int hit = 1;
+    a[0] = ux;  b[0] = ey[0] * uy;  blo[0] = 0.0;  bhi[0] = len;
+    a[1] = uy;  b[1] = -ey[0] * ux; blo[1] = -rad; bhi[1] = rad;
+    for(i=0; i<2 && hit; i++) {
+      if(fabs(a[i]) < 1.0e-9) {
+	if(b[i] < blo[i] || b[i] > bhi[i])
+	  hit = 0;
+      } else {
+	double t0 = (blo[i] - b[i]) / a[i] + x0;
+	double t1 = (bhi[i] - b[i]) / a[i] + x0;
+	if(t0 > t1) {
+	  double tmp = t0; t0 = t1; t1 = tmp;
+	};
+	if(t0 > rl) rl = t0;
+	if(t1 < rr) rr = t1;
+      };
+    };
+    if(hit && rl <= rr) {
+      if(!found || rl < lo) lo = rl;
+      if(!found || rr > hi) hi = rr;
+      found = 1;
+    };
+  };
+  *xl = lo;
+  *xr = hi;
+  return found;
+}
+
+/*.......................................................................
+ * Return the distance from (x,y) to a segment given as for
+ * grrast_capsule_span().
+ */
+static double grrast_seg_dist(double x0, double y0, double ux, double uy,
+			      double len, double x, double y)
+{
+  double t = (x - x0) * ux + (y - y0) * uy;
+  if(t < 0.0)
+    t = 0.0;
+  else if(t > len)
+    t = len;
+  return hypot(x - (x0 + ux * t), y - (y0 + uy * t));
+}
+
+/*.......................................................................
+ * Draw a thick line with round end-caps, one span per row. Pixel
+ * centers lie on integer coordinates.
+ *
+ * Input:
+ *  r        GrRaster *  The raster to draw in.
+ *  x0,y0,x1,y1  double  The end points of the line.
+ *  width        double  The width of the line (pixels).
+ *  val   unsigned long  The pixel value.
+ */
+void grrast_thick_line(GrRaster *r, double x0, double y0, double x1,
+		       double y1, double width, unsigned long val)
+{
+  int aa = r->aa && r->bpp == 4;
+  double rad = 0.5 * width;
+  double dx = x1 - x0, dy = y1 - y0;
+  double len = hypot(dx, dy);
+  double ux = 1.0, uy = 0.0;
+  double edge = aa ? 0.5 : 0.0;
+  int y, ymin, ymax;
+
+  if(width <= 1.0 && !aa) {
+    grrast_line(r, (int) floor(x0 + 0.5), (int) floor(y0 + 0.5),
+		(int) floor(x1 + 0.5), (int) floor(y1 + 0.5), val);
+    return;
+  };
+  if(rad < 0.5)
+    rad = 0.5;
+  if(len > 0.0) {
+    ux = dx / len;
+    uy = dy / len;
+  };
+/*
+ * Rows that may be touched, clipped to the raster.
+ */
+  ymin = (int) ceil((y0 < y1 ? y0 : y1) - rad - edge);
+  ymax = (int) floor((y0 > y1 ? y0 : y1) + rad + edge);
+  if(ymin < 0)
+    ymin = 0;
+  if(ymax >= r->h)
+    ymax = r->h - 1;
+
+  for(y=ymin; y<=ymax; y++) {
+    double xl, xr;
+    if(!grrast_capsule_span(x0, y0, ux, uy, len, rad + edge, (double) y,
+			    &xl, &xr))
+      continue;
+    if(!aa) {
+      grrast_span(r, y, (int) ceil(xl), (int) floor(xr), val);
+    } else {
+/*
+ * Pixels inside the inner capsule are fully covered; those in the
+ * band between it and the outer one are blended by coverage.
+ */
+      double il = 0.0, ir = -1.0;
+      int ixl = (int) ceil(xl), ixr = (int) floor(xr);
+      int x;
+      if(rad > 0.5 &&
+	 grrast_capsule_span(x0, y0, ux, uy, len, rad - 0.5, (double) y,
+			     &il, &ir)) {
+	il = ceil(il);
+	ir = floor(ir);
+	grrast_span(r, y, (int) il, (int) ir, val);
+      } else {
+	il = 0.0;
+	ir = -1.0;
+      };
+      if(ixl < 0)
+	ixl = 0;
+      if(ixr >= r->w)
+	ixr = r->w - 1;
+      for(x=ixl; x<=ixr; x++) {
+	double cover;
+	if(il <= ir && x >= il && x <= ir)
+	  continue;
+	cover = rad + 0.5 - grrast_seg_dist(x0, y0, ux, uy, len,
+					    (double) x, (double) y);
+	if(cover >= 1.0)
+	  grrast_put(r, x, y, val);
+	else if(cover > 0.0)
+	  grrast_blend(r, x, y, val, cover);
+      };
+    };
+  };
+}
+
+/*.......................................................................
+ * Set a run of pixels in one row of a packed bitmap, clipped to the
+ * bitmap.
+ *
+ * Input:
+ *  b      GrBitmap *  The bitmap to draw in.
+ *  y           int    The row to draw on (0 is the first row).
+ *  x0, x1      int    The first and last pixels of the run.
+ *  val    unsigned    The pixel value.
+ */
+void grrast_bits_span(GrBitmap *b, int y, int x0, int x1, unsigned val)
+{
+  int depth = b->depth;
+  int w = b->bpl * 8 / depth;
+  unsigned char *row, *p, *end;
+  unsigned char pat;     /* val repeated across a byte */
+  unsigned char mask;
+  long b0, b1;           /* Bit offsets of x0 and of x1+1 in the row */
+  if(y < 0 || y >= b->h)
+    return;
+  if(x0 > x1) {
+    int tmp = x0; x0 = x1; x1 = tmp;
+  };
+  if(x0 < 0)
+    x0 = 0;
+  if(x1 >= w)
+    x1 = w - 1;
+  if(x0 > x1)
+    return;
+  if(depth == 8)
+    pat = (unsigned char) val;
+  else if(depth == 4)
+    pat = (unsigned char) ((val & 0xf) * 0x11);
+  else
+    pat = (val & 1) ? 0xff : 0;
+  row = b->bits + (long)y * b->bpl;
+  b0 = (long)x0 * depth;
+  b1 = (long)(x1 + 1) * depth;
+  p = row + (b0 >> 3);
+  end = row + (b1 >> 3);
+/*
+ * A run that starts and ends in the same byte.
+ */
+  if(p == end) {
+    mask = (0xff >> (b0 & 7)) & ~(0xff >> (b1 & 7));
+    *p = (*p & ~mask) | (pat & mask);
+    return;
+  };
+/*
+ * A partial first byte, whole bytes, then a partial last byte.
+ */
+  if(b0 & 7) {
+    mask = 0xff >> (b0 & 7);
+    *p = (*p & ~mask) | (pat & mask);
+    p++;
+  };
+  if(end > p)
+    memset(p, pat, end - p);
+  if(b1 & 7) {
+    mask = ~(0xff >> (b1 & 7));
+    *end = (*end & ~mask) | (pat & mask);
+  };
+}
+
+/*.......................................................................
+ * Draw a one-pixel line in a packed bitmap. Vertical lines reuse one
+ * mask for every row. Shallow lines fill each horizontal run with
+ * grrast_bits_span(), and steep lines, whose runs are mostly single
+ * pixels, set each pixel directly.
+ */
+void grrast_bits_line(GrBitmap *b, int x0, int y0, int x1, int y1,
+		      unsigned val)
+{
+  int dx, dy, sx, sy, err, e2, xs;
+  if(x0 == x1) {
+    int depth = b->depth;
+    long bit = (long)x0 * depth;
+    unsigned char mask, pat;
+    unsigned char *p;
+    int y;
+    if(x0 < 0 || x0 >= b->bpl * 8 / depth)
+      return;
+    if(y0 > y1) {
+      int tmp = y0; y0 = y1; y1 = tmp;
+    };
+    if(y0 < 0)
+      y0 = 0;
+    if(y1 >= b->h)
+      y1 = b->h - 1;
+    mask = (unsigned char) ((0xff00 >> depth) & 0xff) >> (bit & 7);
+    pat = (unsigned char) (val << (8 - depth - (bit & 7))) & mask;
+    p = b->bits + (long)y0 * b->bpl + (bit >> 3);
+    for(y=y0; y<=y1; y++, p += b->bpl)
+      *p = (*p & ~mask) | pat;
+    return;
+  };
+  if(y0 == y1) {
+    grrast_bits_span(b, y0, x0, x1, val);
+    return;
+  };
+  dx = abs(x1 - x0);
+  dy = abs(y1 - y0);
+  sx = x0 < x1 ? 1 : -1;
+  sy = y0 < y1 ? 1 : -1;
+  err = dx - dy;
+  if(dx < 2 * dy) {
+    int depth = b->depth;
+    int w = b->bpl * 8 / depth;
+    unsigned pmask = (1U << depth) - 1;
+    val &= pmask;
+/*
+ * Lines that lie wholly inside the bitmap step along y with a running
+ * bit offset and need no per-pixel clipping.
+ */
+    if(x0 >= 0 && x0 < w && x1 >= 0 && x1 < w &&
+       y0 >= 0 && y0 < b->h && y1 >= 0 && y1 < b->h && dx <= dy) {
+      long bit = (long)x0 * depth;
+      long rstep = sy * (long)b->bpl;
+      unsigned char *row = b->bits + (long)y0 * b->bpl;
+      int n;
+      err = 2 * dx - dy;
+      for(n=0; n<=dy; n++, row += rstep) {
+	int shift = 8 - depth - (int)(bit & 7);
+	unsigned char *p = row + (bit >> 3);
+	*p = (*p & ~(pmask << shift)) | (val << shift);
+	if(err > 0) {
+	  bit += sx * depth;
+	  err -= 2 * dy;
+	};
+	err += 2 * dx;
+      };
+      return;
+    };
+    for(;;) {
+      if(x0 >= 0 && x0 < w && y0 >= 0 && y0 < b->h) {
+	long bit = (long)x0 * depth;
+	int shift = 8 - depth - (int)(bit & 7);
+	unsigned char *p = b->bits + (long)y0 * b->bpl + (bit >> 3);
+	*p = (*p & ~(pmask << shift)) | (val << shift);
+      };
+      if(x0 == x1 && y0 == y1)
+	break;
+      e2 = 2 * err;
+      if(e2 > -dy) {
+	err -= dy;
+	x0 += sx;
+      };
+      if(e2 < dx) {
+	err += dx;
+	y0 += sy;
+      };
+    };
+    return;
+  };
+  xs = x0;
+  for(;;) {
+    if(x0 == x1 && y0 == y1) {
+      grrast_bits_span(b, y0, xs, x0, val);
+      break;
+    };
+    e2 = 2 * err;
+    if(e2 < dx) {
+      grrast_bits_span(b, y0, xs, x0, val);
+      if(e2 > -dy) {
+	err -= dy;
+	x0 += sx;
+      };
+      err += dx;
+      y0 += sy;
+      xs = x0;
+    } else {
+      err -= dy;
+      x0 += sx;
+    };
+  };
+}
+
+/*
+ **&GRRSLN -- draw a line into a driver pixmap
+ *+
+ *     SUBROUTINE GRRSLN (X0, Y0, X1, Y1, WIDTH, IVAL, BPP, AA,
+ *    :                   BX, BY, PIXMAP)
+ *     REAL    X0, Y0, X1, Y1, WIDTH
+ *     INTEGER IVAL, BPP, AA, BX, BY
+ *     BYTE or INTEGER PIXMAP(BX,BY)
+ *
+ * Draw a line of width WIDTH pixels from (X0,Y0) to (X1,Y1) in a
+ * pixmap of BX by BY pixels. The coordinates are Fortran array
+ * indices, i.e. PIXMAP(1,1) is the first pixel. Lines of width 1 are
+ * drawn with a Bresenham walk; wider lines have round ends. The
+ * pixmap is passed by the caller as %VAL(pointer), where the
+ * pointer was obtained from GRGMEM.
+ *
+ * Arguments:
+ *  X0, Y0, X1, Y1 (input) : the end points of the line.
+ *  WIDTH   (input) : line width in pixels (see grrast_lw_pixels).
+ *  IVAL    (input) : the pixel value (color index or packed RGB).
+ *  BPP     (input) : bytes per pixel, 1 (BYTE) or 4 (INTEGER).
+ *  AA      (input) : 1 to anti-alias the edges (BPP=4 only), else 0.
+ *  BX, BY  (input) : dimensions of PIXMAP.
+ *  PIXMAP  (in/out): the image data buffer.
+ *-
+ */
+void GRRSLN(x0, y0, x1, y1, width, ival, bpp, aa, bx, by, pixmap)
+     float *x0, *y0, *x1, *y1, *width;
+     int *ival, *bpp, *aa, *bx, *by;
+     void *pixmap;
+{
+  GrRaster r;
+  r.pix = (unsigned char *) pixmap;
+  r.w = *bx;
+  r.h = *by;
+  r.bpp = *bpp;
+  r.aa = *aa;
+  grrast_thick_line(&r, *x0 - 1.0, *y0 - 1.0, *x1 - 1.0, *y1 - 1.0,
+		    *width, (unsigned long) (unsigned int) *ival);
+}
+
+/*
+ **&GRBMLN -- draw a line into a printer driver bitmap
+ *+
+ *     SUBROUTINE GRBMLN (X0, Y0, X1, Y1, IVAL, NBITS, BX, BY, BITMAP)
+ *     REAL    X0, Y0, X1, Y1
+ *     INTEGER IVAL, NBITS, BX, BY
+ *     BYTE    BITMAP(BX,BY)
+ *
+ * Draw a one-pixel line from (X0,Y0) to (X1,Y1) in a packed bitmap of
+ * BY rows of BX bytes, with NBITS bits per pixel (see GrBitmap in
+ * grrast.h). The coordinates are device pixels measured from the
+ * bottom left of the page, and BITMAP(1,1) holds the top left pixel.
+ * The end points are rounded to the nearest pixel, so a line whose
+ * ends coincide draws a dot. Pixels outside the bitmap are ignored.
+ *
+ * Arguments:
+ *  X0, Y0, X1, Y1 (input) : the end points of the line.
+ *  IVAL    (input) : the pixel value (0 or 1 for NBITS=1).
+ *  NBITS   (input) : bits per pixel, 1, 4 or 8.
+ *  BX, BY  (input) : dimensions of BITMAP (bytes per row, rows).
+ *  BITMAP  (in/out): the bitmap, passed as %VAL(pointer).
+ *-
+ */
+void GRBMLN(x0, y0, x1, y1, ival, nbits, bx, by, bitmap)
+     float *x0, *y0, *x1, *y1;
+     int *ival, *nbits, *bx, *by;
+     void *bitmap;
+{
+  GrBitmap b;
+  b.bits = (unsigned char *) bitmap;
+  b.bpl = *bx;
+  b.h = *by;
+  b.depth = *nbits;
+  grrast_bits_line(&b, (int) floor(*x0 + 0.5),
+		   *by - 1 - (int) floor(*y0 + 0.5),
+		   (int) floor(*x1 + 0.5),
+		   *by - 1 - (int) floor(*y1 + 0.5), (unsigned) *ival);
+}
+
+/*
+ **&GRBMCL -- clear a printer driver bitmap
+ *+
+ *     SUBROUTINE GRBMCL (NBYTES, BITMAP)
+ *     INTEGER NBYTES
+ *     BYTE    BITMAP(NBYTES)
+ *
+ * Set every byte of BITMAP to zero.
+ *-
+ */
+void GRBMCL(nbytes, bitmap)
+     int *nbytes;
+     void *bitmap;
+{
+  memset(bitmap, 0, (size_t) *nbytes);
+}
+
+/*
+ **&GRBMRW -- unpack one row of a printer driver bitmap
+ *+
+ *     SUBROUTINE GRBMRW (IROW, NBITS, BX, BY, BITMAP, NX, ROW)
+ *     INTEGER IROW, NBITS, BX, BY, NX, ROW(NX)
+ *     BYTE    BITMAP(BX,BY)
+ *
+ * Copy the values of the first NX pixels of row IROW (1 is the top
+ * row) of a packed bitmap into ROW, one pixel per element.
+ *-
+ */
+void GRBMRW(irow, nbits, bx, by, bitmap, nx, row)
+     int *irow, *nbits, *bx, *by;
+     void *bitmap;
+     int *nx;
+     int *row;
+{
+  const unsigned char *p = (const unsigned char *) bitmap +
+			   (long)(*irow - 1) * *bx;
+  int depth = *nbits;
+  int mask = (1 << depth) - 1;
+  int x;
+  for(x=0; x < *nx; x++) {
+    long bit = (long)x * depth;
+    row[x] = (p[bit >> 3] >> (8 - depth - (bit & 7))) & mask;
+  };
+}
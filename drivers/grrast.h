@@ -0,0 +1,86 @@
+#ifndef grrast_h
+#define grrast_h
+
+/*
+ * The following macro must enclose all function prototype arguments.
+ * This allows pre-ANSI compilers to compile this code, by discarding
+ * the prototype arguments if __STDC__ is not set.
+ */
+#ifdef __STDC__
+#define ARGS(args) args
+#else
+#define ARGS(args) ()
+#endif
+
+/*
+ * Declare a raster descriptor. The pixels are stored row by row,
+ * w pixels per row and h rows, with pixel (x,y) at offset y*w+x.
+ * Pixels are either one byte (a color index) or four bytes (a packed
+ * R + 256*G + 65536*B value, as used by the PPM driver).
+ */
+typedef struct {
+  unsigned char *pix;  /* The pixel buffer */
+  int w, h;            /* Width and height of the raster (pixels) */
+  int bpp;             /* Bytes per pixel: 1 or 4 */
+  int aa;              /* True to anti-alias lines (bpp==4 only) */
+} GrRaster;
+
+/*
+ * Convert a PGPLOT line width (in units of 0.005 inch) to a width in
+ * pixels, for a device with ppi pixels per inch. The result matches
+ * the width of the multiple-stroke emulation done by GRLIN3.
+ */
+double grrast_lw_pixels ARGS((int lw, double ppi));
+
+/* Fill pixels x0..x1 of row y. */
+void grrast_span ARGS((GrRaster *r, int y, int x0, int x1,
+		       unsigned long val));
+
+/* Fill the rectangle with corners (x0,y0) and (x1,y1), inclusive. */
+void grrast_rect ARGS((GrRaster *r, int x0, int y0, int x1, int y1,
+		       unsigned long val));
+
+/* Draw a one-pixel line from (x0,y0) to (x1,y1), inclusive. */
+void grrast_line ARGS((GrRaster *r, int x0, int y0, int x1, int y1,
+		       unsigned long val));
+
+/*
+ * Draw a polyline through the n vertices (xy[0],xy[1]), (xy[2],xy[3]),
+ * ..., in the given width. Each segment is drawn exactly as by
+ * grrast_line() or grrast_thick_line().
+ */
+void grrast_polyline ARGS((GrRaster *r, const int *xy, int n,
+			   double width, unsigned long val));
+
+/*
+ * Draw a line of the given width (pixels) with round end-caps. A
+ * zero-length line draws a filled circle. Widths of one pixel or less
+ * are drawn with grrast_line() unless anti-aliasing is enabled.
+ */
+void grrast_thick_line ARGS((GrRaster *r, double x0, double y0,
+			     double x1, double y1, double width,
+			     unsigned long val));
+
+/*
+ * Declare a packed bitmap, as used by the printer drivers. Each row
+ * holds pixels of depth bits (1, 4 or 8) packed from the most
+ * significant end of each byte, so pixel x of a 1-bit row is bit
+ * 0x80>>(x%8) of byte x/8. Rows are bpl bytes long, and the width in
+ * pixels is bpl*8/depth.
+ */
+typedef struct {
+  unsigned char *bits; /* The pixel buffer */
+  int bpl;             /* Bytes per row */
+  int h;               /* Number of rows */
+  int depth;           /* Bits per pixel: 1, 4 or 8 */
+} GrBitmap;
+
+/* Set pixels x0..x1 of row y of a packed bitmap to val. */
+void grrast_bits_span ARGS((GrBitmap *b, int y, int x0, int x1,
+			    unsigned val));
+
+/* Draw a one-pixel line in a packed bitmap, both end points included. */
+void grrast_bits_line ARGS((GrBitmap *b, int x0, int y0, int x1, int y1,
+			    unsigned val));
+
+#endif
@@ -100,7 +100,10 @@ C                                       installed devices.
 C
       BYTE       ESC, FF
       LOGICAL    BITMAP(NDEV), INIT, PORTRAIT(NDEV), TEX
-      INTEGER    BUFFER, BX, BY, DEVICE, HC(NDEV), I, IC, IER
+      INTEGER    BX, BY, DEVICE, HC(NDEV), I, IC, IER
+C Note: for 32-bit operating systems, the following declaration
+C may be changed to INTEGER*4:
+      INTEGER*8  BUFFER
       INTEGER    GRFMEM, GRGMEM, LUN, NPICT
       INTEGER    VC(NDEV)
       REAL       MAXX(NDEV), MAXY(NDEV), RESOL(NDEV), XBUF(4)
@@ -363,7 +366,7 @@ C                                       start graphics mode.
          WRITE (LUN) ESC, '&a', MSG(1:4), 'h', MSG(5:8), 'V'
       END IF
 C                                       Zero out the plot buffer.
-      CALL GRLJ04 (BX * BY, %VAL(BUFFER))
+      CALL GRBMCL (BX * BY, %VAL(BUFFER))
       RETURN
 C
 C--- IFUNC = 12, Draw line ---------------------------------------------
@@ -508,11 +511,8 @@ C
 C Draw a straight line segment from absolute pixel coordinates (RBUF(1),
 C RBUF(2)) to (RBUF(3), RBUF(4)).  The line either overwrites (sets to
 C black) or erases (sets to white) the previous contents of the bitmap,
-C depending on the current color index. Setting bits is accomplished
-C with a VMS BISB2 instruction, expressed in Fortran as .OR.; clearing
-C bits is accomplished with a VMS BICB2 instruction, expressed in
-C Fortran as .AND. .NOT.. The line is generated with a Simple Digital
-C Differential Analyser (ref: Newman & Sproull). 
+C depending on the current color index.  The bitmap holds one bit per
+C pixel and the line is drawn by GRBMLN (grrast.c).
 C
 C Arguments:
 C
@@ -523,47 +523,16 @@ C ICOL            I I      =0 for erase, =1 for write.
 C BITMAP        I/O B      (address of) the frame buffer.
 C
 C-----------------------------------------------------------------------
-      BYTE       QMASK(0 : 7)
-      INTEGER    K, KX, KY, LENGTH
-      REAL       D, XINC, XP, YINC, YP
-      DATA       QMASK /'80'X, '40'X, '20'X, '10'X, 
-     1                  '08'X, '04'X, '02'X, '01'X/
+      INTEGER    IVAL
 C-----------------------------------------------------------------------
+      IVAL = 0
+      IF (ICOL .NE. 0) IVAL = 1
       IF (LINE .GT. 0) THEN
-         D = MAX (ABS (RBUF(3) - RBUF(1)), ABS (RBUF(4) - RBUF(2)))
-         LENGTH = D
-         IF (LENGTH .EQ. 0) THEN
-            XINC = 0.0
-            YINC = 0.0
-         ELSE
-            XINC = (RBUF(3) - RBUF(1)) / D
-            YINC = (RBUF(4) - RBUF(2)) / D
-         END IF
-      ELSE
-         LENGTH = 0
-         XINC = 0.0
-         YINC = 0.0
-      END IF
-      XP = RBUF(1) + 0.5
-      YP = RBUF(2) + 0.5
-      IF (ICOL .NE. 0) THEN
-         DO K = 0, LENGTH
-            KX = XP
-            KY = (BY - 1) - INT (YP)
-            BITMAP(KX / 8 + 1, KY + 1) = BITMAP(KX / 8 + 1, KY + 1) .OR.
-     1                                         QMASK(MOD (KX, 8))
-            XP = XP + XINC
-            YP = YP + YINC
-         END DO
+         CALL GRBMLN (RBUF(1), RBUF(2), RBUF(3), RBUF(4), IVAL, 1,
+     1                BX, BY, BITMAP)
       ELSE
-         DO K = 0,LENGTH
-            KX = XP
-            KY = (BY - 1) - INT (YP)
-            BITMAP(KX / 8 + 1, KY + 1) = BITMAP(KX / 8 + 1, KY + 1) 
-     1                                  .AND. (.NOT. QMASK(MOD (KX, 8)))
-            XP = XP + XINC
-            YP = YP + YINC
-         END DO
+         CALL GRBMLN (RBUF(1), RBUF(2), RBUF(1), RBUF(2), IVAL, 1,
+     1                BX, BY, BITMAP)
       END IF
 C-----------------------------------------------------------------------
       RETURN
@@ -844,21 +813,3 @@ C-----------------------------------------------------------------------
 C-----------------------------------------------------------------------
       RETURN
       END
-
-C*GRLJ04 -- zero fill buffer
-C+
-      SUBROUTINE GRLJ04 (BUFSIZ,BUFFER)
-C
-C Arguments:
-C
-C BUFFER (byte array, input): (address of) the buffer.
-C BUFSIZ (integer, input): number of bytes in BUFFER.
-C-----------------------------------------------------------------------
-      INTEGER  BUFSIZ, I
-      BYTE     BUFFER(BUFSIZ), FILL
-      DATA     FILL /0/
-C
-      DO 10 I=1,BUFSIZ
-          BUFFER(I) = FILL
-   10 CONTINUE
-      END
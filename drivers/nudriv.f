@@ -16,6 +16,7 @@ C Version 1.5  - 1994 Aug 31 - use image primitives.
 C Version 2.0  - 1996 Jan 22 - allow multiple active devices;
 C                              add QCR primitive.
 C Version 2.1  - 1997 Jun 13 - correctly initialize STATE.
+C Version 2.2  - 2026 Oct 17 - increase MAXDEV to 256 (as GRIMAX).
 C
 C Supported device: The ``null'' device can be used to suppress
 C all graphic output from a program.  If environment variable
@@ -54,7 +55,7 @@ C-----------------------------------------------------------------------
       CHARACTER*(*) DEVICE
       PARAMETER (DEVICE='NULL  (Null device, no output)')
       INTEGER MAXDEV, MAXD1
-      PARAMETER (MAXDEV=8)
+      PARAMETER (MAXDEV=256)
       PARAMETER (MAXD1=MAXDEV+1)
       INTEGER NOPCOD
       PARAMETER (NOPCOD=29)
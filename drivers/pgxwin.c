@@ -13,6 +13,7 @@
 #include <X11/keysym.h>
 
 #include "pgxwin.h"
+#include "xwframe.h"
 
 #define PGX_IDENT "pgxwin"
 #define PGX_IMAGE_LEN 1280  /* Length of the line-of-pixels buffer */
@@ -53,16 +54,6 @@ typedef struct {
   int ndone;       /* The number of points received so far */
 } XWpoly;
 
-/*
- * Declare a container used to record the extent of the rectangular
- * pixmap area that has been modified since the last pgx_flush().
- */
-typedef struct {
-  int modified;    /* True if 'pixmap' has been modified since last update */
-  int xmin,xmax;   /* X-axis extent of modified region (pixels) */
-  int ymin,ymax;   /* Y-axis extent of modified region (pixels) */
-} XWupdate;
-
 /*
  * Declare a cursor state container.
  */
@@ -104,10 +95,11 @@ struct PgxState {
   XWgeom geom;       /* Pixmap geometry */
   XWcolor color;     /* Colormap state descriptor */
   XWpoly poly;       /* Polygon-fill accumulation descriptor */
-  XWupdate update;   /* Descriptor of un-drawn area of pixmap */
+  PgxDamage update;  /* Areas of the pixmap modified since pgx_flush() */
   XWcursor cursor;   /* Cursor state context descriptor */
   XWworld world;     /* World-coordinate conversion descriptor */
   XWimage image;     /* Line of pixels container */
+  XWframe frame;     /* Pending lines of pixels */
   XGCValues gcv;     /* Publicly visible contents of 'gc' */
   GC gc;             /* Graphical context descriptor */
   int last_opcode;   /* Index of last opcode */
@@ -127,9 +119,13 @@ static XVisualInfo *pgx_visual_info ARGS((Display *display, int screen, \
 static int pgx_parse_visual ARGS((char *str));
 static void pgx_xy_to_XPoint ARGS((PgxWin *pgx, float *xy, XPoint *xp));
 static void pgx_XPoint_to_xy ARGS((PgxWin *pgx, XPoint *xp, float *xy));
-static void pgx_mark_modified ARGS((PgxWin *pgx, int x, int y, int diameter));
+static void pgx_mark_modified ARGS((PgxWin *pgx, int xa, int ya, int xb, \
+				     int yb, int diameter));
+static void pgx_add_damage ARGS((PgxDamage *damage, int xmin, int ymin, \
+				 int xmax, int ymax));
 static int pgx_init_colors ARGS((PgxWin *pgx));
 static int pgx_update_colors ARGS((PgxWin *pgx));
+static int pgx_flush_frame ARGS((PgxWin *pgx));
 static int pgx_flush_colors ARGS((PgxWin *pgx, int ci_start, int ncol));
 static int pgx_restore_line ARGS((PgxWin *pgx, int xa, int ya, int xb, int yb));
 static int pgx_handle_cursor ARGS((PgxWin *pgx, float *rbuf, char *key));
@@ -228,11 +224,7 @@ PgxState *pgx_open(pgx)
   state->poly.points = NULL;
   state->poly.npoint = 0;
   state->poly.ndone = 0;
-  state->update.modified = 0;
-  state->update.xmin = 0;
-  state->update.xmax = 0;
-  state->update.ymin = 0;
-  state->update.ymax = 0;
+  state->update.nrect = 0;
   state->cursor.drawn = 0;
   state->cursor.gc = NULL;
   state->cursor.type = PGX_NORM_CURSOR;
@@ -241,6 +233,7 @@ PgxState *pgx_open(pgx)
   state->world.xdiv = 1.0;
   state->world.ydiv = 1.0;
   state->image.xi = NULL;
+  xwf_init(&state->frame);
   state->gc = NULL;
   state->last_opcode = 0;
   state->flush_opcode_fn = 0;
@@ -348,6 +341,7 @@ PgxState *pgx_close(pgx)
     if(state->image.xi)
       XDestroyImage(state->image.xi);
     state->image.xi = NULL;
+    xwf_free(&state->frame);
 /*
  * Check for un-freed polygon points.
  */
@@ -450,6 +444,9 @@ static int pgx_ready(pgx, state)
  * Call this function when an Expose event is received. It will then
  * re-draw the exposed region from the pgx->pixmap, taking acount of any
  * scroll offsets in pgx->scroll. The device need not be open to PGPLOT.
+ * The areas of a sequence of Expose events are accumulated in
+ * pgx->exposed and copied when the last event of the sequence
+ * (xexpose.count==0) arrives, so overlapping areas are copied once.
  *
  * Input:
  *  pgx     PgxWin *  The PGPLOT window context.
@@ -469,11 +466,27 @@ int pgx_expose(pgx, event)
  * Device error?
  */
   if(pgx_ready(pgx, PGX_NEED_PIXMAP | PGX_NEED_WINDOW) && event->type==Expose) {
-    pgx_copy_area(pgx, (int)(event->xexpose.x + pgx->scroll.x),
-		  (int)(event->xexpose.y + pgx->scroll.y),
-		  (unsigned) event->xexpose.width,
-		  (unsigned) event->xexpose.height,
-		  event->xexpose.x, event->xexpose.y);
+    int i;
+/*
+ * Record the exposed area and wait for the rest of the sequence.
+ */
+    pgx_add_damage(&pgx->exposed, event->xexpose.x, event->xexpose.y,
+		   event->xexpose.x + event->xexpose.width - 1,
+		   event->xexpose.y + event->xexpose.height - 1);
+    if(event->xexpose.count > 0)
+      return 0;
+/*
+ * Re-draw the accumulated areas.
+ */
+    for(i=0; i<pgx->exposed.nrect && !pgx->bad_device; i++) {
+      PgxRect *r = &pgx->exposed.rect[i];
+      pgx_copy_area(pgx, (int)(r->xmin + pgx->scroll.x),
+		    (int)(r->ymin + pgx->scroll.y),
+		    (unsigned) (r->xmax - r->xmin + 1),
+		    (unsigned) (r->ymax - r->ymin + 1),
+		    r->xmin, r->ymin);
+    };
+    pgx->exposed.nrect = 0;
 /*
  * Re-draw the possibly damaged cursor augmentation.
  */
@@ -560,13 +573,17 @@ int pgx_scroll(pgx, x, y)
 		   (unsigned)(attr.height - brc.y - 1));
       };
 /*
- * Set up a fake expose event to have the new pixmap area drawn.
+ * Set up a fake expose event to have the visible part of the new pixmap
+ * area drawn.
  */
+      if(brc.x < 0 || brc.y < 0)
+	return 0;
       event.type = Expose;
       event.xexpose.x = 0;
       event.xexpose.y = 0;
-      event.xexpose.width = brc.x + 1;
-      event.xexpose.height = brc.y + 1;
+      event.xexpose.width = brc.x < attr.width ? brc.x + 1 : attr.width;
+      event.xexpose.height = brc.y < attr.height ? brc.y + 1 : attr.height;
+      event.xexpose.count = 0;
       return pgx_expose(pgx, &event);
     };
   };
@@ -1883,8 +1900,8 @@ void pgx_draw_line(pgx, rbuf)
 /*
  * Record the extent of the modified region of the pixmap.
  */
-    pgx_mark_modified(pgx, start.x, start.y, state->gcv.line_width);
-    pgx_mark_modified(pgx, end.x, end.y, state->gcv.line_width);
+    pgx_mark_modified(pgx, start.x, start.y, end.x, end.y,
+		      state->gcv.line_width);
   };
   return;
 }
@@ -1930,7 +1947,7 @@ void pgx_draw_dot(pgx, rbuf)
 /*
  * Record the extent of the modified region of the pixmap.
  */
-    pgx_mark_modified(pgx, xp.x, xp.y, state->gcv.line_width);
+    pgx_mark_modified(pgx, xp.x, xp.y, xp.x, xp.y, state->gcv.line_width);
   };
   return;
 }
@@ -1999,49 +2016,125 @@ static void pgx_XPoint_to_xy(pgx, xp, xy)
 }
 
 /*.......................................................................
- * Update the vertices of the rectangular area that has been modified
- * since the last time the window was updated from the pixmap.
+ * Record a rectangular area of the pixmap as modified since the last
+ * time the window was updated from the pixmap.
  *
  * Input:
  *  pgx    PgxWin * The PGPLOT window context.
- *  x         int   The x-axis pixel index that the rectangular update area
- *                  must be extended to include.
- *  y         int   The y-axis pixel index that the rectangular update area
- *                  must be extended to include.
+ *  xa, ya    int   The pixel coordinates of one corner of the area.
+ *  xb, yb    int   The pixel coordinates of the opposite corner. For a
+ *                  single point these are the same as xa, ya.
  *  diameter  int   The diameter of the locus in pixels. For line or
  *                  point drawing operations this is usually the line width.
  */
 #ifdef __STDC__
-static void pgx_mark_modified(PgxWin *pgx, int x, int y, int diameter)
+static void pgx_mark_modified(PgxWin *pgx, int xa, int ya, int xb, int yb,
+			      int diameter)
 #else
-static void pgx_mark_modified(pgx, x, y, diameter)
-     PgxWin *pgx; int x; int y; int diameter;
+static void pgx_mark_modified(pgx, xa, ya, xb, yb, diameter)
+     PgxWin *pgx; int xa; int ya; int xb; int yb; int diameter;
 #endif
 {
-  PgxState *state = pgx->state;
   int radius = diameter/2;
-/*
- * Expand the current rectangle to include point (x,y).
- */
-  if(state->update.modified) {
-    if(x - radius < state->update.xmin)
-      state->update.xmin = x - radius;
-    if(x + radius > state->update.xmax)
-      state->update.xmax = x + radius;
-    if(y - radius < state->update.ymin)
-      state->update.ymin = y - radius;
-    if(y + radius > state->update.ymax)
-      state->update.ymax = y + radius;
-  } else {
-    state->update.xmin = x - radius;
-    state->update.xmax = x + radius;
-    state->update.ymin = y - radius;
-    state->update.ymax = y + radius;
-    state->update.modified = 1;
+  if(xa > xb) {
+    int tmp = xa; xa = xb; xb = tmp;
+  };
+  if(ya > yb) {
+    int tmp = ya; ya = yb; yb = tmp;
   };
+  pgx_add_damage(&pgx->state->update, xa - radius, ya - radius,
+		 xb + radius, yb + radius);
   return;
 }
 
+/*.......................................................................
+ * Add a rectangle to a damage list, merging it with any entries that
+ * it overlaps or touches. If the list is full, the new rectangle is
+ * merged with the entry whose area it would enlarge least.
+ *
+ * Input:
+ *  damage  PgxDamage *  The list to add to.
+ *  xmin, ymin    int    The top left corner of the rectangle.
+ *  xmax, ymax    int    The bottom right corner of the rectangle.
+ */
+#ifdef __STDC__
+static void pgx_add_damage(PgxDamage *damage, int xmin, int ymin,
+			   int xmax, int ymax)
+#else
+static void pgx_add_damage(damage, xmin, ymin, xmax, ymax)
+     PgxDamage *damage; int xmin; int ymin; int xmax; int ymax;
+#endif
+{
+  PgxRect *r;   /* An entry of damage->rect[] */
+  int i;
+/*
+ * Consecutive drawing operations usually fall within the most recently
+ * extended entry, so check for that cheap case first.
+ */
+  if(damage->nrect > 0) {
+    r = &damage->rect[damage->nrect - 1];
+    if(xmin >= r->xmin && xmax <= r->xmax && ymin >= r->ymin &&
+       ymax <= r->ymax)
+      return;
+  };
+/*
+ * Absorb entries into the new rectangle until none overlaps or touches
+ * it. Each absorption can enlarge the rectangle, so rescan after each.
+ */
+  for(;;) {
+    for(i=0; i<damage->nrect; i++) {
+      r = &damage->rect[i];
+      if(r->xmin <= xmax+1 && r->xmax >= xmin-1 &&
+	 r->ymin <= ymax+1 && r->ymax >= ymin-1)
+	break;
+    };
+/*
+ * If nothing overlaps, append the rectangle if there is room.
+ * Otherwise absorb the entry that it would enlarge least.
+ */
+    if(i >= damage->nrect) {
+      long best = -1;  /* The least growth found so far */
+      int j;
+      if(damage->nrect < PGX_NDAMAGE) {
+	r = &damage->rect[damage->nrect++];
+	r->xmin = xmin;
+	r->xmax = xmax;
+	r->ymin = ymin;
+	r->ymax = ymax;
+	return;
+      };
+      for(j=0; j<damage->nrect; j++) {
+	PgxRect *rj = &damage->rect[j];
+	long growth = (long) ((rj->xmax > xmax ? rj->xmax : xmax) -
+			      (rj->xmin < xmin ? rj->xmin : xmin) + 1) *
+	              (long) ((rj->ymax > ymax ? rj->ymax : ymax) -
+			      (rj->ymin < ymin ? rj->ymin : ymin) + 1) -
+	              (long) (rj->xmax - rj->xmin + 1) *
+		      (long) (rj->ymax - rj->ymin + 1);
+	if(best < 0 || growth < best) {
+	  best = growth;
+	  i = j;
+	};
+      };
+      r = &damage->rect[i];
+    };
+/*
+ * Merge entry i into the new rectangle and remove it, keeping the
+ * remaining entries in order so that the newest stays last.
+ */
+    if(r->xmin < xmin)
+      xmin = r->xmin;
+    if(r->xmax > xmax)
+      xmax = r->xmax;
+    if(r->ymin < ymin)
+      ymin = r->ymin;
+    if(r->ymax > ymax)
+      ymax = r->ymax;
+    for(damage->nrect--; i<damage->nrect; i++)
+      damage->rect[i] = damage->rect[i+1];
+  };
+}
+
 /*.......................................................................
  * Flush changes in the pixmap to the window.
  *
@@ -2060,6 +2153,7 @@ int pgx_flush(pgx)
 {
   if(pgx_ready(pgx, PGX_NEED_PGOPEN | PGX_NEED_PIXMAP)) {
     PgxState *state = pgx->state;
+    int i;
 /*
  * Flush buffered opcodes if necessary.
  */
@@ -2070,34 +2164,35 @@ int pgx_flush(pgx)
 	return 1;
     };
 /*
- * Copy the modified rectangular area of the pixmap to the PGPLOT window.
+ * Copy each modified rectangular area of the pixmap to the PGPLOT window.
  */
-    if(state->update.modified) {
+    for(i=0; i<state->update.nrect && !pgx->bad_device; i++) {
+      PgxRect *r = &state->update.rect[i];
 /*
  * Enforce bounds on the area to be updated.
  */
-      if(state->update.xmin < 0)
-	state->update.xmin = 0;
-      if(state->update.ymin < 0)
-	state->update.ymin = 0;
-      if(state->update.xmax > state->geom.width - 1)
-	state->update.xmax = state->geom.width - 1;
-      if(state->update.ymax > state->geom.height - 1)
-	state->update.ymax = state->geom.height - 1;
+      if(r->xmin < 0)
+	r->xmin = 0;
+      if(r->ymin < 0)
+	r->ymin = 0;
+      if(r->xmax > (int) state->geom.width - 1)
+	r->xmax = state->geom.width - 1;
+      if(r->ymax > (int) state->geom.height - 1)
+	r->ymax = state->geom.height - 1;
 /*
  * Copy the area to be updated from the pixmap to the window.
  */
-      if(!pgx->bad_device) {
-	pgx_copy_area(pgx, state->update.xmin, state->update.ymin,
-		      (unsigned) (state->update.xmax - state->update.xmin + 1),
-		      (unsigned) (state->update.ymax - state->update.ymin + 1),
-		      (int) (state->update.xmin - pgx->scroll.x),
-		      (int) (state->update.ymin - pgx->scroll.y));
-	if(pgx->bad_device)
-	  return 1;
+      if(r->xmax >= r->xmin && r->ymax >= r->ymin) {
+	pgx_copy_area(pgx, r->xmin, r->ymin,
+		      (unsigned) (r->xmax - r->xmin + 1),
+		      (unsigned) (r->ymax - r->ymin + 1),
+		      (int) (r->xmin - pgx->scroll.x),
+		      (int) (r->ymin - pgx->scroll.y));
       };
-      state->update.modified = 0;
     };
+    state->update.nrect = 0;
+    if(pgx->bad_device)
+      return 1;
 /*
  * Redraw the potentially damaged rubber-band cursor if it is active.
  */
@@ -2190,7 +2285,6 @@ void pgx_poly_fill(pgx, rbuf)
       if(state->poly.points) {
 	XPoint *xp = &state->poly.points[state->poly.ndone];
 	pgx_xy_to_XPoint(pgx, rbuf, xp);
-	pgx_mark_modified(pgx, xp->x, xp->y, 1);
       };
 /*
  * Maintain the count of the number of points, even if no memory for the
@@ -2204,8 +2298,27 @@ void pgx_poly_fill(pgx, rbuf)
  */
       if(state->poly.ndone >= state->poly.npoint) {
 	if(state->poly.points) {
+	  XPoint *xp = state->poly.points;
+	  int xmin = xp->x, xmax = xp->x;
+	  int ymin = xp->y, ymax = xp->y;
+	  int i;
 	  XFillPolygon(pgx->display, pgx->pixmap, state->gc, state->poly.points,
 		       state->poly.npoint, Complex, CoordModeOrigin); 
+/*
+ * Record the bounding box of the polygon as modified.
+ */
+	  for(i=1; i<state->poly.npoint; i++) {
+	    xp++;
+	    if(xp->x < xmin)
+	      xmin = xp->x;
+	    else if(xp->x > xmax)
+	      xmax = xp->x;
+	    if(xp->y < ymin)
+	      ymin = xp->y;
+	    else if(xp->y > ymax)
+	      ymax = xp->y;
+	  };
+	  pgx_mark_modified(pgx, xmin, ymin, xmax, ymax, 1);
 	  free((char *)state->poly.points);
 	  state->poly.points = NULL;
 	};
@@ -2247,8 +2360,7 @@ void pgx_rect_fill(pgx, rbuf)
 /*
  * Record the extent of the modified part of the pixmap.
  */
-    pgx_mark_modified(pgx, blc.x, blc.y, 1);
-    pgx_mark_modified(pgx, trc.x, trc.y, 1);
+    pgx_mark_modified(pgx, blc.x, blc.y, trc.x, trc.y, 1);
   };
   return;
 }
@@ -2319,8 +2431,20 @@ int pgx_pix_line(pgx, rbuf, nbuf)
     XPoint start;
     pgx_xy_to_XPoint(pgx, rbuf, &start);
 /*
- * Draw up to PGX_IMAGE_LEN pixels at a time. This is the size of the
- * buffer: state->xi->data[].
+ * Where possible, store the pixels in the client-side image of the
+ * pixmap. They are sent to the pixmap by pgx_flush_frame() before the
+ * next operation of a different type.
+ */
+    if(xwf_line(&state->frame, pgx->display, pgx->color->vi, pgx->pixmap,
+		state->gc, state->geom.width, state->geom.height,
+		start.x, start.y, ncell, pgx->color->pixel, cells,
+		(unsigned char *) 0, 0) == 0) {
+      state->flush_opcode_fn = (Flush_Opcode_fn) pgx_flush_frame;
+      ncell = 0;
+    };
+/*
+ * Otherwise draw up to PGX_IMAGE_LEN pixels at a time. This is the size
+ * of the buffer: state->xi->data[].
  */
     for(ndone=0; !pgx->bad_device && ndone<ncell; ndone += PGX_IMAGE_LEN) {
       int ntodo = ncell - ndone;
@@ -2347,14 +2471,37 @@ int pgx_pix_line(pgx, rbuf, nbuf)
 /*
  * Extend the region to be updated on the next flush.
  */
-    pgx_mark_modified(pgx, start.x, start.y, 1);
-    pgx_mark_modified(pgx, start.x + ncell - 1, start.y, 1);
+    ncell = *nbuf - 2;
+    pgx_mark_modified(pgx, start.x, start.y, start.x + ncell - 1, start.y, 1);
   };
   if(pgx->bad_device)
     return 1;
   return 0;
 }
 
+/*.......................................................................
+ * Send the lines of pixels collected by pgx_pix_line() to the pixmap.
+ * This is the flush function for buffered opcode 26.
+ *
+ * Input:
+ *  pgx     PgxWin *  The PGPLOT window context.
+ * Output:
+ *  return     int    0 - OK.
+ *                    1 - Error.
+ */
+#ifdef __STDC__
+static int pgx_flush_frame(PgxWin *pgx)
+#else
+static int pgx_flush_frame(pgx)
+     PgxWin *pgx;
+#endif
+{
+  if(pgx->bad_device)
+    return 1;
+  xwf_flush(&pgx->state->frame);
+  return pgx->bad_device != 0;
+}
+
 /*.......................................................................
  * Record the latest world-coordinate conversion parameters as provided
  * by the PGPLOT driver opcode 27. Note that opcode 27 only gets invoked
@@ -2756,7 +2903,7 @@ int pgx_clear_window(pgx)
  * Mark the pixmap as unmodified.
  */
       if(pgx->state)
-	pgx->state->update.modified = 0;
+	pgx->state->update.nrect = 0;
     };
     XFlush(pgx->display);
     if(pgx->bad_device)
@@ -4142,6 +4289,7 @@ PgxWin *new_PgxWin(display, screen, context, name, resize_fn, pixmap_fn)
   pgx->clip.doclip = 0;
   pgx->clip.xmin = pgx->clip.xmax = 0;
   pgx->clip.ymin = pgx->clip.ymax = 0;
+  pgx->exposed.nrect = 0;
   pgx->resize_fn = resize_fn;
   pgx->new_pixmap_fn = pixmap_fn ? pixmap_fn : pgx_new_pixmap;
   pgx->old_handler = 0;
@@ -4757,8 +4905,7 @@ void pgx_scroll_rect(pgx, rbuf)
 /*
  * Record the extent of the modified part of the pixmap.
  */
-    pgx_mark_modified(pgx, blc.x, blc.y, 1);
-    pgx_mark_modified(pgx, trc.x, trc.y, 1);
+    pgx_mark_modified(pgx, blc.x, blc.y, trc.x, trc.y, 1);
   };
   return;
 }
@@ -80,6 +80,26 @@ typedef struct {
   int ymin, ymax;       /* Min/max Y-axis pixels excluding border */
 } PgxClip;
 
+/*
+ * Declare a list of rectangular areas that need to be copied from the
+ * pixmap to the window. Rectangles that overlap or touch are merged
+ * as they are added. When the list is full, each new rectangle is
+ * merged with the entry whose area it would enlarge least. So a few
+ * small, widely separated changes cost a few small copies rather than
+ * one copy of their combined bounding box.
+ */
+#define PGX_NDAMAGE 8
+
+typedef struct {
+  int xmin, xmax;       /* X-axis extent of the area (pixels) */
+  int ymin, ymax;       /* Y-axis extent of the area (pixels) */
+} PgxRect;
+
+typedef struct {
+  int nrect;                    /* The number of entries used in rect[] */
+  PgxRect rect[PGX_NDAMAGE];    /* The damaged areas */
+} PgxDamage;
+
 typedef struct PgxState PgxState;
 
 /*
@@ -101,6 +121,8 @@ struct PgxWin {
   PgxColor *color;          /* The visual/colormap context descriptor */
   PgxScroll scroll;         /* The pixmap scroll context descriptor */
   PgxClip clip;             /* The window clipping area */
+  PgxDamage exposed;        /* Window areas exposed by the events so far */
+                            /*  of an Expose sequence (see pgx_expose()) */
   PgxResizeWindowFn resize_fn;  /* Function to call to resize window. */
   PgxNewPixmapFn new_pixmap_fn; /* Function to call to allocate a new pixmap */
   XErrorHandler old_handler;/* Used to preserve previous X error handler */
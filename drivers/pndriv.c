@@ -17,6 +17,29 @@
   page number. This does not apply to the first page output,
   however.
 
+  By default each page is compressed and written when it is finished,
+  on the plotting thread. If the environment variable PGPLOT_PNG_THREADS
+  is set to a positive number, finished pages are instead handed to a
+  pool of that many background encoder threads, which compress bands
+  of rows in parallel; PGPAGE then returns at once, and PGCLOS waits
+  until all of the device's pages have been written. The zlib
+  compression level (0-9) can be set with PGPLOT_PNG_LEVEL, and the
+  PNG row filter with PGPLOT_PNG_FILTER (none, sub, up, avg or paeth;
+  the default is none, which usually suits palette images best).
+
+  If PGPLOT_PNG_APNG is set (to anything but 0), all pages are instead
+  written to the one file as the frames of an animated PNG, shown for
+  PGPLOT_PNG_DELAY seconds each (default 1). The colour table of the
+  first page is used throughout, and every page must be the same size
+  as the first.
+
+  Graph markers are drawn in batches (opcode 33), unless
+  PGPLOT_PNG_MARKERS is set to 0, in which case GRMKER draws them
+  stroke by stroke, as for other devices.
+
+  The pixmap is kept from one page to the next, and only the area
+  drawn on is cleared at the start of each page.
+
   For compilation, both libpng and zlib must be installed. These
   libraries are Free Software, and can be obtained at the following
   URLs:
@@ -29,11 +52,16 @@
 
 */
 
+#include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
 #include <png.h>
+#include <zlib.h>
+
+#include "grrast.h"
 
 #ifdef VMS
 #include <descrip.h>
@@ -58,7 +86,8 @@
 #define DEFAULT_WIDTH 850
 #define DEFAULT_HEIGHT 680
 #define NCOLORS 256
-#define DEVICE_CAPABILITIES "HNNNNRPNYN"
+#define DEVICE_RESOLUTION 85.0 /* pixels per inch, as in the GIF driver */
+#define DEVICE_CAPABILITIES "HNNNTRPNYNNLIP"
 #define DEFAULT_FILENAME "pgplot.png"
 
 #define boolean unsigned char
@@ -103,6 +132,29 @@ static ColorComponent base_colors[] = {
 /* each new device initially copies its colortable from here */
 static ColorComponent default_colortable[NCOLORS * 3];
 
+/* PNG row filters selectable with PGPLOT_PNG_FILTER, by filter type */
+static const char *filter_names[] = { "none", "sub", "up", "avg", "paeth" };
+static const int filter_flags[] = {
+  PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG, PNG_FILTER_PAETH
+};
+#define NFILTERS 5
+
+/* state of an animated PNG file being written (PGPLOT_PNG_APNG) */
+typedef struct {
+  FILE *fp;
+  long actl_pos; /* file offset of the acTL chunk, patched at close */
+  int w, h; /* canvas size, from the first page */
+  int nframes;
+  unsigned long seq; /* sequence number of the next fcTL or fdAT chunk */
+  unsigned int delay; /* frame delay in 1/100 s */
+  z_stream z; /* one deflate stream, reset for each frame */
+  unsigned char *row; /* filtered row */
+  unsigned char *out; /* 4-byte sequence number + compressed data */
+} ApngFile;
+
+/* size of each IDAT or fdAT chunk written to an animated PNG file */
+#define APNG_CHUNK 65536
+
 /* data for a single open device */
 typedef struct _DeviceData DeviceData, *DeviceDataPtr;
 struct _DeviceData {
@@ -115,7 +167,19 @@ struct _DeviceData {
   char *filename;
   ColorComponent ctable[NCOLORS * 3];
   ColorIndex cindex; /* current plotting color index */
+  double lwidth; /* current line width in pixels */
+  GrRaster raster; /* pixmap as seen by the shared raster engine */
   int devnum; /* this device's identifier */
+  int level; /* zlib compression level */
+  int filter; /* PNG row filter type, PNG_FILTER_VALUE_* */
+  boolean async; /* if true, pages go to the background encoder */
+  int pending; /* pages handed to the encoder but not yet written */
+  char *pagename; /* buffer for the current page's filename */
+  int dirty_x0, dirty_y0; /* bounding box of the pixels drawn since */
+  int dirty_x1, dirty_y1; /* the pixmap was last cleared */
+  ApngFile *apng; /* animated PNG output, or NULL for one file per page */
+  float *marker; /* marker shape from opcode 33, as sent by GRMKER */
+  int nmarker; /* the number of values in marker[] */
 };
 
 /* global data holding all devices */
@@ -148,8 +212,28 @@ static void get_color_rep(DeviceData *dev, int index, ColorComponent *r, ColorCo
   *b = dev->ctable[index*3+2];
 }
 
+/*
+  For multiple pages, we make a new file for each page.
+  We name them sequentially, based on the original filename
+  specified. The name is built in the device's pagename buffer,
+  which is allocated once when the device is opened.
+*/
+#define EXTRA_CHARS 16 /* allow 10^15 image files per device */
+
+static char *page_filename(DeviceData *dev) {
+  char *filename = dev->pagename;
+
+  strcpy(filename,dev->filename);
+  if (strcmp("-",filename) != 0 && dev->npages > 1) {
+	sprintf(filename,"%s_%d",dev->filename,dev->npages);
+	fprintf(stderr,"%s: writing new file as %s\n",png_ident,filename);
+  }
+  return filename;
+}
+
 /* If one were to port this driver to a new image format, then this is the
- * only routine that would need to be rewritten.
+ * only routine that would need to be rewritten (along with write_encoded_page()
+ * for the background encoder).
  */
 static void write_image_file(DeviceData *dev) {
 
@@ -173,32 +257,14 @@ static void write_image_file(DeviceData *dev) {
 	colors[i].blue = b;
   }
 
-  /*
-	For multiple pages, we make a new file for each page.
-	We name them sequentially, based on the original filename
-	specified.
-  */
-#define EXTRA_CHARS 16 /* allow 10^15 image files per device */
-
-  filename = malloc(strlen(dev->filename)+EXTRA_CHARS);
-  if (!filename) {
-	fprintf(stderr,"%s: out of memory, plotting disabled\n", png_ident);
-	dev->error = true;
-	return;
-  }
-  strcpy(filename,dev->filename);
-  if (strcmp("-",filename) != 0 && dev->npages > 1) {
-	sprintf(filename,"%s_%d",dev->filename,dev->npages);
-	fprintf(stderr,"%s: writing new file as %s\n",png_ident,filename);
-  }
+  filename = page_filename(dev);
 
   /* open the file */
   if (strcmp("-",filename) != 0) {
 	if (! (fp = fopen(filename,"wb"))) {
 	  fprintf(stderr,"%s: could not open file %s for writing, plotting disabled\n",png_ident,filename);
 	  dev->error = true;
-	  free(filename);
-	  return;
+		  return;
 	}
   } else {
 	fp = stdout;
@@ -218,7 +284,6 @@ static void write_image_file(DeviceData *dev) {
 	dev->error = true;
 	if (fp != stdout)
 	  fclose(fp);
-	free(filename);
 	return;
   }
 
@@ -229,12 +294,13 @@ static void write_image_file(DeviceData *dev) {
 	dev->error = true;
 	if (fp != stdout)
 	  fclose(fp);
-	free(filename);
 	return;
   }
 #endif
 
   png_init_io(png_ptr, fp);
+  png_set_compression_level(png_ptr, dev->level);
+  png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, filter_flags[dev->filter]);
 
   png_set_IHDR(png_ptr, info_ptr,
 			   dev->w, dev->h, 8, 
@@ -280,48 +346,557 @@ static void write_image_file(DeviceData *dev) {
   png_destroy_write_struct(&png_ptr, &info_ptr);
   if (fp != stdout)
 	fclose(fp);
-  free(filename);
 
 }
 
-static void swap_coords(int *x1, int *y1, int *x2, int *y2) {
-  int tmp;
+/*
+  The background encoder. A finished page is split into bands of rows,
+  and each band is filtered and deflated by one of the worker threads
+  into a separate piece of the zlib stream (all but the last band end
+  with a sync flush, so the pieces can simply be concatenated). The
+  worker that completes the last band of a page writes the file. Pages
+  hold their own copies of everything they need, so the device can
+  carry on plotting the next page in a fresh pixmap.
+*/
+typedef struct _EncodePage EncodePage;
+typedef struct _EncodeBand EncodeBand;
+
+struct _EncodeBand {
+  EncodePage *page;
+  int row0, nrow; /* PNG rows (counted from the top) in this band */
+  boolean last; /* true for the band that ends the zlib stream */
+  unsigned char *out; /* deflated data */
+  unsigned long nout;
+  uLong adler; /* Adler-32 of this band's uncompressed data */
+  uLong nin;
+  EncodeBand *next; /* next band in the encoder queue */
+};
 
-  tmp = *x1;
-  *x1 = *x2;
-  *x2 = tmp;
+struct _EncodePage {
+  DeviceData *dev; /* owning device; it waits for us before closing */
+  char *filename;
+  char *ident; /* for messages */
+  ColorIndex *pixmap;
+  int w, h;
+  boolean trans;
+  int level, filter;
+  ColorComponent ctable[NCOLORS * 3];
+  int nband, ndone;
+  EncodeBand *bands;
+};
 
-  tmp = *y1;
-  *y1 = *y2;
-  *y2 = tmp;
+static struct {
+  pthread_mutex_t lock;
+  pthread_cond_t work; /* signalled when bands are queued */
+  pthread_cond_t done; /* broadcast when a page has been written */
+  EncodeBand *head, *tail; /* queue of bands waiting to be encoded */
+  int nthreads;
+  int npages; /* pages queued but not yet written */
+} encoder = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+			  PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0 };
+
+/* number of unwritten pages allowed per thread before end_plot() blocks */
+#define ENCODER_PAGES_PER_THREAD 2
+
+static int paeth_predictor(int a, int b, int c) {
+  int p = a + b - c;
+  int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  if (pa <= pb && pa <= pc)
+	return a;
+  return pb <= pc ? b : c;
+}
 
+/* apply a PNG filter to one row of w one-byte pixels; prev may be NULL */
+static void filter_row(int filter, const unsigned char *cur, const unsigned char *prev, unsigned char *out, int w) {
+  int x;
+  out[0] = filter;
+  out++;
+  switch (filter) {
+  case PNG_FILTER_VALUE_SUB:
+	for (x=0; x<w; x++)
+	  out[x] = cur[x] - (x ? cur[x-1] : 0);
+	break;
+  case PNG_FILTER_VALUE_UP:
+	for (x=0; x<w; x++)
+	  out[x] = cur[x] - (prev ? prev[x] : 0);
+	break;
+  case PNG_FILTER_VALUE_AVG:
+	for (x=0; x<w; x++)
+	  out[x] = cur[x] - (((x ? cur[x-1] : 0) + (prev ? prev[x] : 0)) >> 1);
+	break;
+  case PNG_FILTER_VALUE_PAETH:
+	for (x=0; x<w; x++)
+	  out[x] = cur[x] - paeth_predictor(x ? cur[x-1] : 0,
+										prev ? prev[x] : 0,
+										(x && prev) ? prev[x-1] : 0);
+	break;
+  default:
+	memcpy(out, cur, w);
+	break;
+  }
 }
 
-static void fill_rectangle( DeviceData *dev, int x1, int y1, int x2, int y2, ColorIndex index ) {
+/* filter and deflate one band; returns false on failure */
+static boolean encode_band(EncodeBand *band) {
+  EncodePage *page = band->page;
+  int w = page->w;
+  unsigned char *row;
+  unsigned long bound;
+  z_stream z;
+  int i;
 
-  int y;
-  int npix = (x2 - x1 + 1); /* number of pixels to fill on a single line */
+  row = malloc(w + 1);
+  memset(&z, 0, sizeof(z));
+  if (!row || deflateInit2(&z, page->level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+	free(row);
+	return false;
+  }
+  bound = deflateBound(&z, (uLong)band->nrow * (w + 1)) + 16;
+  band->out = malloc(bound);
+  if (!band->out) {
+	deflateEnd(&z);
+	free(row);
+	return false;
+  }
+  z.next_out = band->out;
+  z.avail_out = bound;
+  band->adler = adler32(0L, Z_NULL, 0);
+  band->nin = 0;
+
+  for (i=0; i<band->nrow; i++) {
+	int r = band->row0 + i; /* PNG row; pixmap rows run bottom to top */
+	const unsigned char *cur = &page->pixmap[(long)(page->h - 1 - r) * w];
+	const unsigned char *prev = r > 0 ? cur + w : NULL;
+	int flush = (i == band->nrow - 1) ? (band->last ? Z_FINISH : Z_SYNC_FLUSH) : Z_NO_FLUSH;
+
+	filter_row(page->filter, cur, prev, row, w);
+	band->adler = adler32(band->adler, row, w + 1);
+	band->nin += w + 1;
+	z.next_in = row;
+	z.avail_in = w + 1;
+	if (deflate(&z, flush) == Z_STREAM_ERROR || z.avail_in != 0) {
+	  deflateEnd(&z);
+	  free(row);
+	  return false;
+	}
+  }
+  band->nout = bound - z.avail_out;
+  deflateEnd(&z);
+  free(row);
+  return true;
+}
 
-  if (dev->error == true)
+/* write a PNG chunk; returns false on a write error */
+static boolean write_chunk(FILE *fp, const char *type, const unsigned char *data, unsigned long len) {
+  unsigned char buf[4];
+  uLong crc;
+
+  buf[0] = len >> 24; buf[1] = len >> 16; buf[2] = len >> 8; buf[3] = len;
+  fwrite(buf, 1, 4, fp);
+  fwrite(type, 1, 4, fp);
+  crc = crc32(0L, (const Bytef *)type, 4);
+  if (len > 0) {
+	fwrite(data, 1, len, fp);
+	crc = crc32(crc, data, len);
+  }
+  buf[0] = crc >> 24; buf[1] = crc >> 16; buf[2] = crc >> 8; buf[3] = crc;
+  fwrite(buf, 1, 4, fp);
+  return !ferror(fp);
+}
+
+/* assemble the encoded bands of a page and write the file */
+static void write_encoded_page(EncodePage *page) {
+  static const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+  static const char software[] = "Software\0PGPLOT Graphics Subroutine Library";
+  unsigned char ihdr[13], zhead[2], ztail[4], *idat, *p;
+  unsigned long nidat;
+  uLong adler;
+  FILE *fp;
+  boolean ok;
+  int i;
+
+  for (i=0; i<page->nband; i++) {
+	if (!page->bands[i].out) {
+	  fprintf(stderr,"%s: error compressing %s, page not written\n", page->ident, page->filename);
+	  return;
+	}
+  }
+
+  /* zlib header, the deflated bands, and the combined Adler-32 */
+  zhead[0] = 0x78;
+  if (page->level < 0 || page->level == 6)
+	zhead[1] = 0x9c;
+  else
+	zhead[1] = page->level == 0 ? 0x01 : page->level < 6 ? 0x5e : 0xda;
+  adler = page->bands[0].adler;
+  nidat = sizeof(zhead) + sizeof(ztail) + page->bands[0].nout;
+  for (i=1; i<page->nband; i++) {
+	adler = adler32_combine(adler, page->bands[i].adler, page->bands[i].nin);
+	nidat += page->bands[i].nout;
+  }
+  ztail[0] = adler >> 24; ztail[1] = adler >> 16; ztail[2] = adler >> 8; ztail[3] = adler;
+  idat = malloc(nidat);
+  if (!idat) {
+	fprintf(stderr,"%s: out of memory, %s not written\n", page->ident, page->filename);
 	return;
+  }
+  p = idat;
+  memcpy(p, zhead, sizeof(zhead));
+  p += sizeof(zhead);
+  for (i=0; i<page->nband; i++) {
+	memcpy(p, page->bands[i].out, page->bands[i].nout);
+	p += page->bands[i].nout;
+  }
+  memcpy(p, ztail, sizeof(ztail));
 
-  /* ensure coords are lower left and upper right */
-  if (x2<x1 && y2<y1)
-	swap_coords(&x1, &y1, &x2, &y2);
-  else if (y2 < y1) {
-	y = y1;
-	y1 = y2;
-	y2 = y;
+  if (! (fp = fopen(page->filename,"wb"))) {
+	fprintf(stderr,"%s: could not open file %s for writing\n", page->ident, page->filename);
+	free(idat);
+	return;
   }
-  else if (x2 < x1) {
-	y = x1;
-	x1 = x2;
-	x2 = y;
-	npix = (x2 - x1 + 1);
+  ihdr[0] = page->w >> 24; ihdr[1] = page->w >> 16; ihdr[2] = page->w >> 8; ihdr[3] = page->w;
+  ihdr[4] = page->h >> 24; ihdr[5] = page->h >> 16; ihdr[6] = page->h >> 8; ihdr[7] = page->h;
+  ihdr[8] = 8; /* bit depth */
+  ihdr[9] = PNG_COLOR_TYPE_PALETTE;
+  ihdr[10] = PNG_COMPRESSION_TYPE_DEFAULT;
+  ihdr[11] = PNG_FILTER_TYPE_DEFAULT;
+  ihdr[12] = PNG_INTERLACE_NONE;
+
+  fwrite(signature, 1, sizeof(signature), fp);
+  ok = write_chunk(fp, "IHDR", ihdr, sizeof(ihdr));
+  ok = ok && write_chunk(fp, "PLTE", page->ctable, sizeof(page->ctable));
+  if (page->trans) {
+	unsigned char alpha = 0;
+	ok = ok && write_chunk(fp, "tRNS", &alpha, 1);
   }
+  ok = ok && write_chunk(fp, "tEXt", (const unsigned char *)software, sizeof(software) - 1);
+  ok = ok && write_chunk(fp, "IDAT", idat, nidat);
+  ok = ok && write_chunk(fp, "IEND", NULL, 0);
+  if (fclose(fp) != 0 || !ok)
+	fprintf(stderr,"%s: error writing file %s\n", page->ident, page->filename);
+  free(idat);
+}
 
-  for (y=y1; y<=y2; y++)
-	memset( &dev->pixmap[ y * dev->w + x1 ], index, npix * sizeof(ColorIndex) );
+static void free_encode_page(EncodePage *page) {
+  int i;
+  for (i=0; i<page->nband; i++)
+	free(page->bands[i].out);
+  free(page->bands);
+  free(page->pixmap);
+  free(page->filename);
+  free(page);
+}
+
+static void *encoder_thread(void *arg) {
+  EncodeBand *band;
+  EncodePage *page;
+  boolean finished;
+
+  for (;;) {
+	pthread_mutex_lock(&encoder.lock);
+	while (!encoder.head)
+	  pthread_cond_wait(&encoder.work, &encoder.lock);
+	band = encoder.head;
+	encoder.head = band->next;
+	if (!encoder.head)
+	  encoder.tail = NULL;
+	pthread_mutex_unlock(&encoder.lock);
+
+	if (!encode_band(band)) {
+	  free(band->out);
+	  band->out = NULL;
+	}
+
+	page = band->page;
+	pthread_mutex_lock(&encoder.lock);
+	finished = ++page->ndone == page->nband;
+	pthread_mutex_unlock(&encoder.lock);
+	if (!finished)
+	  continue;
+
+	write_encoded_page(page);
+	pthread_mutex_lock(&encoder.lock);
+	page->dev->pending--;
+	encoder.npages--;
+	pthread_cond_broadcast(&encoder.done);
+	pthread_mutex_unlock(&encoder.lock);
+	free_encode_page(page);
+  }
+  return arg;
+}
+
+/* wait until no more than npages of dev's pages (or of all pages, if dev is NULL) are unwritten */
+static void wait_for_encoder(DeviceData *dev, int npages) {
+  pthread_mutex_lock(&encoder.lock);
+  while ((dev ? dev->pending : encoder.npages) > npages)
+	pthread_cond_wait(&encoder.done, &encoder.lock);
+  pthread_mutex_unlock(&encoder.lock);
+}
+
+static void flush_encoder_at_exit(void) {
+  wait_for_encoder(NULL, 0);
+}
+
+/* start the pool the first time an asynchronous device is opened; returns false on failure */
+static boolean start_encoder(int nthreads) {
+  pthread_t thread;
+  pthread_attr_t attr;
+
+  if (encoder.nthreads > 0)
+	return true;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  while (encoder.nthreads < nthreads && pthread_create(&thread, &attr, encoder_thread, NULL) == 0)
+	encoder.nthreads++;
+  pthread_attr_destroy(&attr);
+  if (encoder.nthreads > 0)
+	atexit(flush_encoder_at_exit);
+  return encoder.nthreads > 0;
+}
+
+/*
+  Hand the current page to the background encoder. On success the page
+  now owns the pixmap, and the device must allocate a new one for the
+  next page. Returns false if the page should be written synchronously.
+*/
+static boolean queue_image_file(DeviceData *dev) {
+  EncodePage *page;
+  int i;
+
+  page = calloc(1, sizeof(EncodePage));
+  if (!page)
+	return false;
+  page->nband = encoder.nthreads < dev->h ? encoder.nthreads : dev->h;
+  page->bands = calloc(page->nband, sizeof(EncodeBand));
+  page->filename = malloc(strlen(dev->filename)+EXTRA_CHARS);
+  if (page->filename)
+	strcpy(page->filename, page_filename(dev));
+  if (!page->bands || !page->filename) {
+	free(page->bands);
+	free(page->filename);
+	free(page);
+	return false;
+  }
+  page->dev = dev;
+  page->ident = png_ident;
+  page->pixmap = dev->pixmap;
+  page->w = dev->w;
+  page->h = dev->h;
+  page->trans = dev->trans;
+  page->level = dev->level;
+  page->filter = dev->filter;
+  memcpy(page->ctable, dev->ctable, sizeof(page->ctable));
+
+  /* bound the memory held by unwritten pages */
+  wait_for_encoder(NULL, ENCODER_PAGES_PER_THREAD * encoder.nthreads - 1);
+
+  pthread_mutex_lock(&encoder.lock);
+  for (i=0; i<page->nband; i++) {
+	EncodeBand *band = &page->bands[i];
+	band->page = page;
+	/* nband <= h, so every band gets at least one row */
+	band->row0 = (int) ((long) i * dev->h / page->nband);
+	band->nrow = (int) ((long) (i + 1) * dev->h / page->nband) - band->row0;
+	assert(band->nrow > 0);
+	band->last = (i == page->nband - 1);
+	band->next = NULL;
+	if (encoder.tail)
+	  encoder.tail->next = band;
+	else
+	  encoder.head = band;
+	encoder.tail = band;
+  }
+  dev->pending++;
+  encoder.npages++;
+  pthread_cond_broadcast(&encoder.work);
+  pthread_mutex_unlock(&encoder.lock);
+
+  dev->pixmap = NULL;
+  return true;
+}
+
+/*
+  Animated PNG output. All pages go into the one file, as frames of an
+  APNG animation; viewers without APNG support show the first page. The
+  file, the deflate stream and the row buffer are kept open from page to
+  page. The colour table is written once, with the first page, and the
+  number of frames in the acTL chunk is filled in when the device is
+  closed, so the output must be a regular file.
+*/
+static void put_uint32(unsigned char *p, unsigned long v) {
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+static void put_uint16(unsigned char *p, unsigned int v) {
+  p[0] = v >> 8; p[1] = v;
+}
+
+/* write the acTL chunk; returns false on a write error */
+static boolean write_apng_actl(ApngFile *apng) {
+  unsigned char actl[8];
+  put_uint32(actl, apng->nframes);
+  put_uint32(actl+4, 0); /* loop forever */
+  return write_chunk(apng->fp, "acTL", actl, sizeof(actl));
+}
+
+/* write out the compressed data so far as an IDAT (first frame) or fdAT chunk */
+static boolean flush_apng_data(ApngFile *apng) {
+  unsigned long n = APNG_CHUNK - apng->z.avail_out;
+  boolean ok;
+
+  if (n == 0)
+	return true;
+  if (apng->nframes == 0) {
+	ok = write_chunk(apng->fp, "IDAT", apng->out + 4, n);
+  } else {
+	put_uint32(apng->out, apng->seq++);
+	ok = write_chunk(apng->fp, "fdAT", apng->out, n + 4);
+  }
+  apng->z.next_out = apng->out + 4;
+  apng->z.avail_out = APNG_CHUNK;
+  return ok;
+}
+
+static void close_apng(DeviceData *dev) {
+  ApngFile *apng = dev->apng;
+
+  if (apng->fp) {
+	boolean ok = write_chunk(apng->fp, "IEND", NULL, 0);
+	ok = ok && fseek(apng->fp, apng->actl_pos, SEEK_SET) == 0 && write_apng_actl(apng);
+	if (fclose(apng->fp) != 0 || !ok)
+	  fprintf(stderr,"%s: error writing file %s\n", png_ident, dev->filename);
+	deflateEnd(&apng->z);
+  }
+  free(apng->row);
+  free(apng->out);
+  free(apng);
+  dev->apng = NULL;
+}
+
+/* open the file and write everything that precedes the first frame */
+static boolean open_apng(DeviceData *dev) {
+  static const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+  static const char software[] = "Software\0PGPLOT Graphics Subroutine Library";
+  ApngFile *apng = dev->apng;
+  unsigned char ihdr[13];
+  boolean ok;
+
+  apng->w = dev->w;
+  apng->h = dev->h;
+  apng->row = malloc(dev->w + 1);
+  apng->out = malloc(APNG_CHUNK + 4);
+  memset(&apng->z, 0, sizeof(apng->z));
+  if (!apng->row || !apng->out) {
+	fprintf(stderr,"%s: out of memory, plotting disabled\n", png_ident);
+	return false;
+  }
+  if (! (apng->fp = fopen(dev->filename,"wb"))) {
+	fprintf(stderr,"%s: could not open file %s for writing, plotting disabled\n", png_ident, dev->filename);
+	return false;
+  }
+  if (deflateInit(&apng->z, dev->level) != Z_OK) {
+	fprintf(stderr,"%s: error in zlib, plotting disabled\n", png_ident);
+	fclose(apng->fp);
+	apng->fp = NULL;
+	return false;
+  }
+
+  put_uint32(ihdr, dev->w);
+  put_uint32(ihdr+4, dev->h);
+  ihdr[8] = 8; /* bit depth */
+  ihdr[9] = PNG_COLOR_TYPE_PALETTE;
+  ihdr[10] = PNG_COMPRESSION_TYPE_DEFAULT;
+  ihdr[11] = PNG_FILTER_TYPE_DEFAULT;
+  ihdr[12] = PNG_INTERLACE_NONE;
+
+  fwrite(signature, 1, sizeof(signature), apng->fp);
+  ok = write_chunk(apng->fp, "IHDR", ihdr, sizeof(ihdr));
+  apng->actl_pos = ftell(apng->fp);
+  ok = ok && write_apng_actl(apng);
+  ok = ok && write_chunk(apng->fp, "PLTE", dev->ctable, sizeof(dev->ctable));
+  if (dev->trans == true) {
+	unsigned char alpha = 0;
+	ok = ok && write_chunk(apng->fp, "tRNS", &alpha, 1);
+  }
+  ok = ok && write_chunk(apng->fp, "tEXt", (const unsigned char *)software, sizeof(software) - 1);
+  if (!ok)
+	fprintf(stderr,"%s: error writing file %s, plotting disabled\n", png_ident, dev->filename);
+  return ok;
+}
+
+/* append the current page to the animated PNG file as a new frame */
+static void write_apng_frame(DeviceData *dev) {
+  ApngFile *apng = dev->apng;
+  unsigned char fctl[26];
+  boolean ok;
+  int r;
+
+  if (!apng->fp && !open_apng(dev)) {
+	dev->error = true;
+	return;
+  }
+  if (dev->w != apng->w || dev->h != apng->h) {
+	fprintf(stderr,"%s: page %d is not the size of the first page, not written\n", png_ident, dev->npages);
+	return;
+  }
+
+  put_uint32(fctl, apng->seq++);
+  put_uint32(fctl+4, dev->w);
+  put_uint32(fctl+8, dev->h);
+  put_uint32(fctl+12, 0); /* x offset */
+  put_uint32(fctl+16, 0); /* y offset */
+  put_uint16(fctl+20, apng->delay);
+  put_uint16(fctl+22, 100);
+  fctl[24] = 0; /* APNG_DISPOSE_OP_NONE */
+  fctl[25] = 0; /* APNG_BLEND_OP_SOURCE */
+  ok = write_chunk(apng->fp, "fcTL", fctl, sizeof(fctl));
+
+  deflateReset(&apng->z);
+  apng->z.next_out = apng->out + 4;
+  apng->z.avail_out = APNG_CHUNK;
+  for (r=0; ok && r<dev->h; r++) {
+	const unsigned char *cur = &dev->pixmap[(long)(dev->h - 1 - r) * dev->w];
+	int flush = (r == dev->h - 1) ? Z_FINISH : Z_NO_FLUSH;
+	int status;
+
+	filter_row(dev->filter, cur, r > 0 ? cur + dev->w : NULL, apng->row, dev->w);
+	apng->z.next_in = apng->row;
+	apng->z.avail_in = dev->w + 1;
+	do {
+	  status = deflate(&apng->z, flush);
+	  if (apng->z.avail_out == 0 || status == Z_STREAM_END)
+		ok = ok && flush_apng_data(apng);
+	} while (ok && status == Z_OK && (apng->z.avail_in > 0 || flush == Z_FINISH));
+	if (status == Z_STREAM_ERROR)
+	  ok = false;
+  }
+  if (!ok) {
+	fprintf(stderr,"%s: error writing file %s, plotting disabled\n", png_ident, dev->filename);
+	dev->error = true;
+	return;
+  }
+  apng->nframes++;
+}
+
+/* grow the dirty box to include the given rectangle, plus a margin */
+static void mark_dirty(DeviceData *dev, int x1, int y1, int x2, int y2, int margin) {
+  int t;
+
+  if (x1 > x2) { t = x1; x1 = x2; x2 = t; }
+  if (y1 > y2) { t = y1; y1 = y2; y2 = t; }
+  if (x1 - margin < dev->dirty_x0) dev->dirty_x0 = x1 - margin;
+  if (y1 - margin < dev->dirty_y0) dev->dirty_y0 = y1 - margin;
+  if (x2 + margin > dev->dirty_x1) dev->dirty_x1 = x2 + margin;
+  if (y2 + margin > dev->dirty_y1) dev->dirty_y1 = y2 + margin;
+}
+
+static void fill_rectangle( DeviceData *dev, int x1, int y1, int x2, int y2, ColorIndex index ) {
+
+  if (dev->error == true)
+	return;
+
+  mark_dirty(dev, x1, y1, x2, y2, 0);
+  grrast_rect(&dev->raster, x1, y1, x2, y2, index);
 
 }
 
@@ -330,28 +905,53 @@ static void fill_rectangle( DeviceData *dev, int x1, int y1, int x2, int y2, Col
   should be freed after the page has been written to file
 */
 static void start_plot(DeviceData *dev, int w, int h) {
-  dev->w = w;
-  dev->h = h;
-  dev->npix = dev->w * dev->h;
-  dev->pixmap = malloc( dev->npix * sizeof(ColorIndex) );
-  if (!dev->pixmap) {
-	fprintf(stderr,"%s: out of memory, plotting disabled\n",png_ident);
-	dev->error = true;
-  }
+  boolean reuse = dev->pixmap && w == dev->w && h == dev->h;
+
   dev->npages++;
-  fill_rectangle(dev, 0, 0, dev->w-1, dev->h-1, 0);
+  if (dev->error == true)
+	return;
+
+  if (!reuse) {
+	free(dev->pixmap);
+	dev->w = w;
+	dev->h = h;
+	dev->npix = dev->w * dev->h;
+	dev->pixmap = malloc( dev->npix * sizeof(ColorIndex) );
+	if (!dev->pixmap) {
+	  fprintf(stderr,"%s: out of memory, plotting disabled\n",png_ident);
+	  dev->error = true;
+	  return;
+	}
+	dev->raster.pix = dev->pixmap;
+	dev->raster.w = dev->w;
+	dev->raster.h = dev->h;
+	dev->raster.bpp = sizeof(ColorIndex);
+	dev->raster.aa = false;
+	dev->dirty_x0 = dev->dirty_y0 = 0;
+	dev->dirty_x1 = dev->w-1;
+	dev->dirty_y1 = dev->h-1;
+  }
+
+  /* the previous page's pixmap only needs clearing where it was drawn on */
+  if (dev->dirty_x0 <= dev->dirty_x1 && dev->dirty_y0 <= dev->dirty_y1)
+	grrast_rect(&dev->raster, dev->dirty_x0, dev->dirty_y0, dev->dirty_x1, dev->dirty_y1, 0);
+  dev->dirty_x0 = dev->w;
+  dev->dirty_y0 = dev->h;
+  dev->dirty_x1 = dev->dirty_y1 = -1;
   return;
 }
 
 /*
-  Called when page is done. Should write file and free
-  memory allocated in start_plot() for pixmap.
+  Called when page is done. Writes the file; the pixmap is kept for
+  the next page unless it has been handed to the background encoder.
 */
 static void end_plot(DeviceData *dev) {
   if (dev->error == true)
 	return;
-  write_image_file(dev);
-  free(dev->pixmap);
+  if (dev->apng)
+	write_apng_frame(dev);
+  else if (!dev->async || !queue_image_file(dev))
+	write_image_file(dev);
 }
 
 static void make_device_active(float devnum) {
@@ -394,51 +994,127 @@ static void get_default_dimensions( int *width, int *height) {
   return;
 }
 
+/*
+  Lines are drawn by the shared raster engine: thin lines with an
+  integer Bresenham walk, thick lines as a single round-ended span
+  per row (the device advertises hardware thick lines, so GRLIN3
+  does not emulate them with multiple strokes).
+*/
 static void draw_line(DeviceData *dev, int x1, int y1, int x2, int y2, ColorIndex index) {
 
-  int x, y;
-  float rate;
-
   if (dev->error == true)
 	return;
 
-  if (x1 == x2 || y1 == y2) { /* rate of change calculation below doesn't like this case */
-	fill_rectangle(dev,x1,y1,x2,y2,index);
+  mark_dirty(dev, x1, y1, x2, y2, (int)(dev->lwidth / 2.0) + 1);
+  if (dev->lwidth > 1.0)
+	grrast_thick_line(&dev->raster, x1, y1, x2, y2, dev->lwidth, index);
+  else
+	grrast_line(&dev->raster, x1, y1, x2, y2, index);
+}
+
+/* draw a polyline of n vertices (opcode 31), xy = x1,y1,x2,y2,... */
+static void draw_polyline(DeviceData *dev, float *xy, int n, ColorIndex index) {
+  int *ixy;
+  int i, x0, y0, x1, y1;
+
+  if (dev->error == true || n < 1)
 	return;
-  }
 
-  if (abs(y2-y1) > abs(x2-x1)) {
+  if (!(ixy = malloc(2 * n * sizeof(int)))) {
+	for (i=1; i<n; i++)
+	  draw_line(dev, (int)xy[2*i-2], (int)xy[2*i-1], (int)xy[2*i], (int)xy[2*i+1], index);
+	return;
+  }
+  x0 = x1 = ixy[0] = (int)xy[0];
+  y0 = y1 = ixy[1] = (int)xy[1];
+  for (i=1; i<n; i++) {
+	int x = ixy[2*i] = (int)xy[2*i];
+	int y = ixy[2*i+1] = (int)xy[2*i+1];
+	if (x < x0) x0 = x;
+	if (x > x1) x1 = x;
+	if (y < y0) y0 = y;
+	if (y > y1) y1 = y;
+  }
+  mark_dirty(dev, x0, y0, x1, y1, (int)(dev->lwidth / 2.0) + 1);
+  grrast_polyline(&dev->raster, ixy, n, dev->lwidth, index);
+  free(ixy);
+}
 
-	if (y1 > y2)
-	  swap_coords(&x1, &y1, &x2, &y2);
+/*
+  Draw markers (opcode 33). If rbuf[0] is 0, the rest of rbuf holds
+  the marker shape, which is saved: the number of strokes, then for
+  each stroke its number of vertices and their (x,y) offsets from the
+  center of the marker. Otherwise rbuf[1..] holds the centers (x,y) of
+  markers to be drawn in that shape. Each vertex is rounded as in
+  opcode 31, so the pixels are the same as when GRMKER draws the
+  strokes itself.
+*/
+static void draw_markers(DeviceData *dev, float *rbuf, int nbuf, ColorIndex index) {
+  int *ixy;
+  int i, j, k, n, ns, npt;
+  float *m;
 
-	rate = (x2 - x1) / (float)(y2 - y1);
+  if (dev->error == true)
+	return;
 
-	for (y=y1; y<y2; y++) {
-	  x = x1 + (y - y1) * rate;
-	  dev->pixmap[ y * dev->w + x ] = index;
+  if (rbuf[0] == 0.0) {
+	if (nbuf - 1 > dev->nmarker) {
+	  if (!(m = realloc(dev->marker, (nbuf - 1) * sizeof(float)))) {
+		dev->nmarker = 0;
+		return;
+	  }
+	  dev->marker = m;
 	}
-  } else {
-
-	if (x1 > x2)
-	  swap_coords(&x1, &y1, &x2, &y2);
+	memcpy(dev->marker, rbuf + 1, (nbuf - 1) * sizeof(float));
+	dev->nmarker = nbuf - 1;
+	return;
+  }
+  if (dev->nmarker < 1)
+	return;
 
-	rate = (float)(y2 - y1) / (float)(x2 - x1);
+  /* the vertices of the longest stroke */
+  m = dev->marker;
+  ns = (int)m[0];
+  for (k=0, j=1, npt=0; k<ns; k++) {
+	n = (int)m[j];
+	if (n > npt) npt = n;
+	j += 1 + 2*n;
+  }
+  if (npt < 2 || !(ixy = malloc(2 * npt * sizeof(int))))
+	return;
 
-	for (x=x1; x<x2; x++) {
-	  y = y1 + (x - x1) * rate;
-	  dev->pixmap[ y * dev->w + x ] = index;
+  for (i=1; i+1<nbuf; i+=2) {
+	float x = rbuf[i];
+	float y = rbuf[i+1];
+	for (k=0, j=1; k<ns; k++) {
+	  int x0, y0, x1, y1;
+	  n = (int)m[j++];
+	  x0 = x1 = ixy[0] = (int)(x + m[j]);
+	  y0 = y1 = ixy[1] = (int)(y + m[j+1]);
+	  for (j+=2, npt=1; npt<n; npt++, j+=2) {
+		int ix = ixy[2*npt] = (int)(x + m[j]);
+		int iy = ixy[2*npt+1] = (int)(y + m[j+1]);
+		if (ix < x0) x0 = ix;
+		if (ix > x1) x1 = ix;
+		if (iy < y0) y0 = iy;
+		if (iy > y1) y1 = iy;
+	  }
+	  mark_dirty(dev, x0, y0, x1, y1, (int)(dev->lwidth / 2.0) + 1);
+	  grrast_polyline(&dev->raster, ixy, n, dev->lwidth, index);
 	}
-
   }
-	 
+  free(ixy);
 }
 
-/* set a single pixel's color */
+/* set a single pixel's color, or a dot of the current line width */
 static void fill_pixel(DeviceData *dev, int x, int y, ColorIndex index) {
   if (dev->error == true)
 	return;
-  dev->pixmap[ y * dev->w + x ] = index;
+  mark_dirty(dev, x, y, x, y, (int)(dev->lwidth / 2.0) + 1);
+  if (dev->lwidth > 1.0)
+	grrast_thick_line(&dev->raster, x, y, x, y, dev->lwidth, index);
+  else
+	grrast_span(&dev->raster, y, x, x, index);
 }
 
 
@@ -450,6 +1126,62 @@ static void initialize_all_devices(void) {
 
 }
 
+/* read the PGPLOT_PNG_THREADS, _LEVEL, _FILTER, _APNG and _DELAY settings */
+static void get_encoder_options(DeviceData *dev) {
+  char *string;
+  int i, nthreads = 0;
+
+  dev->level = Z_DEFAULT_COMPRESSION;
+  dev->filter = 0;
+  dev->async = false;
+  dev->pending = 0;
+  dev->apng = NULL;
+
+  if ((string = getenv("PGPLOT_PNG_LEVEL")) && *string) {
+	i = atoi(string);
+	if (i >= 0 && i <= 9)
+	  dev->level = i;
+	else
+	  fprintf(stderr,"%s: ignoring invalid PGPLOT_PNG_LEVEL %s\n",png_ident,string);
+  }
+
+  if ((string = getenv("PGPLOT_PNG_FILTER")) && *string) {
+	for (i=0; i<NFILTERS; i++)
+	  if (!strcmp(string, filter_names[i]))
+		break;
+	if (i < NFILTERS)
+	  dev->filter = i;
+	else
+	  fprintf(stderr,"%s: ignoring invalid PGPLOT_PNG_FILTER %s\n",png_ident,string);
+  }
+
+  /* animated output needs to seek back to its acTL chunk, so not to stdout */
+  if ((string = getenv("PGPLOT_PNG_APNG")) && *string && strcmp(string, "0")) {
+	if (!strcmp(dev->filename, "-")) {
+	  fprintf(stderr,"%s: cannot write an animated PNG to stdout, writing separate images\n",png_ident);
+	} else if ((dev->apng = calloc(1, sizeof(ApngFile)))) {
+	  dev->apng->delay = 100;
+	  if ((string = getenv("PGPLOT_PNG_DELAY")) && *string) {
+		double delay = atof(string);
+		if (delay >= 0.0 && delay < 655.0)
+		  dev->apng->delay = (unsigned int)(delay * 100.0 + 0.5);
+	  }
+	  return; /* frames are written in order, so never asynchronously */
+	}
+  }
+
+  if ((string = getenv("PGPLOT_PNG_THREADS")))
+	nthreads = atoi(string);
+
+  /* output to stdout must stay in page order, so it is never asynchronous */
+  if (nthreads > 0 && strcmp(dev->filename, "-")) {
+	if (start_encoder(nthreads))
+	  dev->async = true;
+	else
+	  fprintf(stderr,"%s: could not start encoder threads, writing pages synchronously\n",png_ident);
+  }
+}
+
 static void open_new_device(char *file, int length, float *id, float *err, int mode) {
 
   DeviceDataPtr *tmp;
@@ -492,8 +1224,11 @@ static void open_new_device(char *file, int length, float *id, float *err, int m
   }
 
   all_devices.devices[devnum]->filename = malloc(length+1);
-  if (! all_devices.devices[devnum]->filename) {
+  all_devices.devices[devnum]->pagename = malloc(length+EXTRA_CHARS);
+  if (! all_devices.devices[devnum]->filename || ! all_devices.devices[devnum]->pagename) {
 	fprintf(stderr,"%s: out of memory\n",png_ident);
+	free(all_devices.devices[devnum]->filename);
+	free(all_devices.devices[devnum]->pagename);
 	free(all_devices.devices[devnum]);
 	all_devices.devices[devnum] = NULL;
 	return;
@@ -504,6 +1239,9 @@ static void open_new_device(char *file, int length, float *id, float *err, int m
 
   ACTIVE_DEVICE->error  = false;
   ACTIVE_DEVICE->pixmap = 0x0;
+  ACTIVE_DEVICE->lwidth = 1.0;
+  ACTIVE_DEVICE->marker = NULL;
+  ACTIVE_DEVICE->nmarker = 0;
 
   ACTIVE_DEVICE->filename[length] = '\0';
   strncpy(ACTIVE_DEVICE->filename,file,length);
@@ -517,6 +1255,8 @@ static void open_new_device(char *file, int length, float *id, float *err, int m
   else
 	ACTIVE_DEVICE->trans = false;
 
+  get_encoder_options(ACTIVE_DEVICE);
+
   *id = (float)devnum;
   *err = 1.0;
 
@@ -526,6 +1266,13 @@ static void open_new_device(char *file, int length, float *id, float *err, int m
 static void close_device( DeviceData *dev ) {
   int devnum = dev->devnum;
 
+  if (dev->async)
+	wait_for_encoder(dev, 0);
+  if (dev->apng)
+	close_apng(dev);
+  free(dev->pixmap);
+  free(dev->marker);
+  free(dev->pagename);
   if (dev->filename)
 	free(dev->filename);
   free(all_devices.devices[devnum]);
@@ -588,8 +1335,8 @@ void PNDRIV(int *opcode, float *rbuf, int *nbuf, char *chr, int *lchr, int *mode
 
 	/* return device scale */
   case 3:
-	rbuf[0] = 85.0; /* same as used in GIF drivers */
-	rbuf[1] = 85.0;
+	rbuf[0] = DEVICE_RESOLUTION;
+	rbuf[1] = DEVICE_RESOLUTION;
 	rbuf[2] = 1.0;
 	*nbuf = 3;
 	break;
@@ -598,6 +1345,8 @@ void PNDRIV(int *opcode, float *rbuf, int *nbuf, char *chr, int *lchr, int *mode
   case 4:
 	*lchr = strlen(DEVICE_CAPABILITIES);
 	strncpy(chr,DEVICE_CAPABILITIES,*lchr);
+	if (getenv("PGPLOT_PNG_MARKERS") && !strcmp(getenv("PGPLOT_PNG_MARKERS"), "0"))
+	  chr[13] = 'N'; /* no opcode 33: GRMKER draws markers stroke by stroke */
 	break;
 
 	/* return default device filename */
@@ -659,6 +1408,16 @@ void PNDRIV(int *opcode, float *rbuf, int *nbuf, char *chr, int *lchr, int *mode
 			  );
 	break;
 
+	/* draw a polyline */
+  case 31:
+	draw_polyline(ACTIVE_DEVICE, rbuf, *nbuf / 2, ACTIVE_DEVICE->cindex);
+	break;
+
+	/* draw markers */
+  case 33:
+	draw_markers(ACTIVE_DEVICE, rbuf, *nbuf, ACTIVE_DEVICE->cindex);
+	break;
+
 	/* fill dot */
   case 13:
 	fill_pixel(ACTIVE_DEVICE, (int)rbuf[0], (int)rbuf[1], ACTIVE_DEVICE->cindex);
@@ -692,6 +1451,11 @@ void PNDRIV(int *opcode, float *rbuf, int *nbuf, char *chr, int *lchr, int *mode
 				  );
 	break;
 
+	/* set line width */
+  case 22:
+	ACTIVE_DEVICE->lwidth = grrast_lw_pixels((int)(rbuf[0] + 0.5), DEVICE_RESOLUTION);
+	break;
+
 	/* escape function */
   case 23:
 	break;
@@ -716,11 +1480,49 @@ void PNDRIV(int *opcode, float *rbuf, int *nbuf, char *chr, int *lchr, int *mode
 	  int base = ACTIVE_DEVICE->w * y + x;
 	  int i;
 
+	  if (ACTIVE_DEVICE->error == true)
+		break;
+	  mark_dirty(ACTIVE_DEVICE, x, y, x + (int)*nbuf-3, y, 0);
 	  for (i = 0; i<(int)*nbuf-2; i++)
 		ACTIVE_DEVICE->pixmap[base+i] = (ColorIndex)rbuf[i+2];
 	}
 	break;
 
+	/* line of pixels, integer color indices in chr */
+  case 32:
+	{
+	  int x = rbuf[0];
+	  int y = rbuf[1];
+	  int nb = rbuf[2];
+	  int n = *lchr / nb;
+	  const unsigned char *ci = (const unsigned char *)chr;
+	  ColorIndex *p;
+	  int i;
+
+	  if (ACTIVE_DEVICE->error == true)
+		break;
+	  if (y < 0 || y >= ACTIVE_DEVICE->h)
+		break;
+	  /* clip the row to the page */
+	  if (x < 0) {
+		ci += -x * nb;
+		n += x;
+		x = 0;
+	  }
+	  if (x + n > ACTIVE_DEVICE->w)
+		n = ACTIVE_DEVICE->w - x;
+	  if (n <= 0)
+		break;
+	  mark_dirty(ACTIVE_DEVICE, x, y, x + n-1, y, 0);
+	  p = ACTIVE_DEVICE->pixmap + ACTIVE_DEVICE->w * y + x;
+	  if (nb == 1)
+		memcpy(p, ci, n);
+	  else
+		for (i = 0; i<n; i++)
+		  p[i] = (ColorIndex)(ci[2*i] | ci[2*i+1] << 8);
+	}
+	break;
+
 	/* query color representation */
   case 29:
 	{
@@ -37,6 +37,11 @@ C+
 *   affect subsequently drawn pixels only, not previously drawn
 *   pixels. Thus the image is not limited to 256 different colors.
 *
+* Line width: thick lines are drawn by the shared raster engine
+*   (grrast.c) rather than emulated with multiple strokes. If the
+*   environment variable PGPLOT_PPM_ANTIALIAS is defined, the edges
+*   of thick lines are anti-aliased.
+*
 * Obtaining hardcopy: Use a PPM viewer or converter.
 *=
 *  9-Aug-1993 - Created by Remko Scharroo
@@ -47,6 +52,7 @@ C+
 * 16-Nov-1994 - Revised (T. Pearson).
 * 28-Dec-1995 - Prevent concurrent access [TJP].
 * 29-Apr-1996 - Use GRCTOI to decode environment variables [TJP].
+* 17-Oct-2026 - Draw lines with GRRSLN; support thick lines.
 *-----------------------------------------------------------------------
       CHARACTER*(*) LTYPE, PTYPE, DEFNAM
       INTEGER DWD, DHT
@@ -61,8 +67,9 @@ C+
 C
       INTEGER UNIT, IC, CVAL, CTABLE(3,0:255), IER, I, L, LL, NPICT
       INTEGER BX, BY, IX0, IY0, IX1, IY1, R, G, B, STATE, USERH, USERW
-      INTEGER CDEFLT(3,0:15), JUNK
+      INTEGER CDEFLT(3,0:15), JUNK, AA
       INTEGER GRGMEM, GRFMEM, GROFIL, GRCFIL, GRCTOI
+      REAL    LW
       CHARACTER*80 MSG, INSTR, FILENM
 C
 C Note: for 64-bit operating systems, change the following 
@@ -71,7 +78,7 @@ C
       INTEGER*8 PIXMAP
 C
       SAVE    UNIT, IC, CVAL, CTABLE, BX, BY, PIXMAP, NPICT, CDEFLT
-      SAVE    STATE
+      SAVE    STATE, LW, AA
       DATA CDEFLT /000,000,000, 255,255,255, 255,000,000, 000,255,000,
      1             000,000,255, 000,255,255, 255,000,255, 255,255,000,
      2             255,128,000, 128,255,000, 000,255,128, 000,128,255,
@@ -122,10 +129,10 @@ C
       RETURN
 C
 C--- IFUNC = 4, Return misc device info --------------------------------
-C    (This device is Hardcopy, supports rectangle fill, pixel 
-C     primitives, and query color rep.)
+C    (This device is Hardcopy, supports thick lines, rectangle fill,
+C     pixel primitives, and query color rep.)
 C
-   40 CHR = 'HNNNNRPNYN'
+   40 CHR = 'HNNNTRPNYN'
       LCHR = 10
       RETURN
 C
@@ -174,6 +181,10 @@ C     -- dimensions of plot buffer
       CALL GRGENV('PPM_HEIGHT', INSTR, L)
       LL = 1
       IF (L.GT.0) USERH = GRCTOI(INSTR(:L),LL)
+      CALL GRGENV('PPM_ANTIALIAS', INSTR, L)
+      AA = 0
+      IF (L.GT.0) AA = 1
+      LW = 1.0
       IF (MODE.EQ.1) THEN
 *     -- Landscape
          BX = DWD
@@ -254,7 +265,8 @@ C
       IY0=BY-NINT(RBUF(2))
       IY1=BY-NINT(RBUF(4))
       IF (PIXMAP.NE.0) 
-     :     CALL GRPP01(IX0, IY0, IX1, IY1, CVAL, BX, BY, %VAL(PIXMAP))
+     :     CALL GRRSLN(REAL(IX0), REAL(IY0), REAL(IX1), REAL(IY1), LW,
+     :                 CVAL, 4, AA, BX, BY, %VAL(PIXMAP))
       RETURN
 C
 C--- IFUNC=13, Draw dot ------------------------------------------------
@@ -263,7 +275,8 @@ C
       IX0=NINT(RBUF(1))+1
       IY0=BY-NINT(RBUF(2))
       IF (PIXMAP.NE.0) 
-     :     CALL GRPP01(IX0, IY0, IX0, IY0, CVAL, BX, BY, %VAL(PIXMAP))
+     :     CALL GRRSLN(REAL(IX0), REAL(IY0), REAL(IX0), REAL(IY0), LW,
+     :                 CVAL, 4, AA, BX, BY, %VAL(PIXMAP))
       RETURN
 C
 C--- IFUNC=14, End picture ---------------------------------------------
@@ -334,10 +347,11 @@ C
       RETURN
 C
 C--- IFUNC=22, Set line width. -----------------------------------------
-C    (Not implemented: should not be called)
+C    (Converted from units of 0.005 inch to pixels.)
 C
   220 CONTINUE
-      GOTO 900
+      LW = MAX(1.0, (NINT(RBUF(1))-1)*0.005*XRES + 1.0)
+      RETURN
 C
 C--- IFUNC=23, Escape --------------------------------------------------
 C    (Not implemented: ignored)
@@ -390,49 +404,6 @@ C
 C-----------------------------------------------------------------------
       END
 
-**GRPP01 -- PGPLOT PPM driver, draw line
-*+
-      SUBROUTINE GRPP01 (IX0, IY0, IX1, IY1, ICOL, BX, BY, PIXMAP)
-      INTEGER IX0, IY0, IX1, IY1
-      INTEGER ICOL, BX, BY, PIXMAP(BX,BY)
-*
-* Draw a straight-line segment from absolute pixel coordinates
-* (IX0, IY0) to (IX1, IY1).
-*
-* Arguments:
-*  IX0, IY0        (input): Starting point of line.
-*  IX1, IY1        (input): End point of line.
-*  ICOL            (input): Color value.
-*  BX, BY          (input): dimensions of PIXMAP.
-*  PIXMAP   (input/output): The image data buffer.
-*-
-*  9-Aug-1994 - Recreated by Remko Scharroo from GRGI01 by Ge van Geldorp
-*               Improved algorithm.
-*-----------------------------------------------------------------------
-      INTEGER IX, IY, IS
-      REAL    D
-C
-      IF (IX0.EQ.IX1 .AND. IY0.EQ.IY1) THEN
-         PIXMAP(IX0,IY0)=ICOL
-      ELSE IF (ABS(IY1-IY0).GT.ABS(IX1-IX0)) THEN
-         D=(IX1-IX0)/REAL(IY1-IY0)
-         IS=1
-         IF (IY1.LT.IY0) IS=-1
-         DO 10 IY=IY0,IY1,IS
-            IX=NINT(IX0+(IY-IY0)*D)
-            PIXMAP(IX,IY)=ICOL
- 10      CONTINUE
-      ELSE
-         D=(IY1-IY0)/REAL(IX1-IX0)
-         IS=1
-         IF (IX1.LT.IX0) IS=-1
-         DO 20 IX=IX0,IX1,IS
-            IY=NINT(IY0+(IX-IX0)*D)
-            PIXMAP(IX,IY)=ICOL
- 20      CONTINUE
-      ENDIF
-      END
-
 **GRPP02 -- PGPLOT PPM driver, write PPM image
 *+
       SUBROUTINE GRPP02 (UNIT, BX, BY, PIXMAP)
@@ -47,6 +47,8 @@ C Version 6.5  - 1998 Feb 23 - support for real linewidth.
 C Version 6.6  - 1998 Nov 10 - provide easy way to convert color to grey.
 C Version 6.7  - 1998 Dec 12 - added #copies to header.
 C         6.8?   2006 Jul  7 - fixed PS-Adobe-3.0 header for multipage output
+C Version 6.9  - 2026 Oct 17 - optional compact encoding of polylines
+C                              and images (PGPLOT_PS_COMPACT).
 C
 C Supported device: 
 C   Any printer that accepts the PostScript page description language, 
@@ -129,6 +131,16 @@ C  PGPLOT_PS_MARKERS
 C Specify "NO" to suppress use of a PostScript font for the graph
 C markers; markers are then emulated by line-drawing. 
 C
+C  PGPLOT_PS_COMPACT
+C If this variable is set (to anything but "NO"), runs of short
+C connected line segments are written as ASCII85-encoded strings of
+C byte offsets, and color and line-width commands that would not
+C change the current state are omitted. Images are written as
+C deflated (if PGPLOT was built with zlib) and ASCII85-encoded binary
+C data instead of hexadecimal. This makes files with many short vectors
+C or large images several times smaller, but they require a PostScript
+C Level 2 interpreter, or Level 3 if the images are deflated.
+C
 C Document Structuring Conventions:
 C
 C  The PostScript files conform to Version 3.0 of the Adobe Document 
@@ -169,11 +181,21 @@ C
       SAVE         NPTS, NPAGE, IOERR, LFNAME
       INTEGER  STATE, NSEG
       SAVE     STATE, NSEG
+      INTEGER  MAXRUN
+      PARAMETER (MAXRUN=200)
+      INTEGER  NRUN, RUNX0, RUNY0, RUNX, RUNY, RUNB(2*MAXRUN)
+      SAVE     NRUN, RUNX0, RUNY0, RUNX, RUNY, RUNB
+      INTEGER  CURRGB(3)
+      SAVE     CURRGB
+      REAL     CURLW
+      SAVE     CURLW
+      LOGICAL  COMPCT, FLATE
+      SAVE     COMPCT, FLATE
       INTEGER  NXP, NYP, XORG, YORG, XLEN, YLEN, N, RGB(3)
       INTEGER  HIGH, LOW, I, K, KMAX, POSN, LD, LU
       INTEGER  BBOX(4), BB1, BB2, BB3, BB4
       SAVE     BBOX
-      INTEGER  GROPTX, GRCTOI
+      INTEGER  GROPTX, GRCTOI, GRPZOK
       LOGICAL  START, LANDSC, COLOR, STDOUT
       SAVE     START,         COLOR, STDOUT
       REAL     LW
@@ -397,6 +419,11 @@ C        -- machine-dependent!
       LASTJ = -1
       LW = 1
       NPTS = 0
+      NRUN = 0
+      CALL GRGENV('PS_COMPACT', INSTR, L)
+      COMPCT = L.GT.0
+      IF (L.EQ.2) COMPCT = INSTR(1:2).NE.'NO' .AND. INSTR(1:2).NE.'no'
+      FLATE = COMPCT .AND. GRPZOK().EQ.1
       CALL GRGENV('PS_EOF', INSTR, L)
       IF (L.GT.0) CALL GRPS02(IOERR, UNIT, CHAR(4))
 C     --  CUPS doesn't seem to like the EPSF-3.0
@@ -422,7 +449,13 @@ C           actual dimensions
          CALL GRPS02(IOERR, UNIT, '%%BoundingBox: (atend)')
       END IF
       CALL GRPS02(IOERR, UNIT, '%%DocumentFonts: (atend)')
-      CALL GRPS02(IOERR, UNIT, '%%LanguageLevel: 1')
+      IF (FLATE) THEN
+         CALL GRPS02(IOERR, UNIT, '%%LanguageLevel: 3')
+      ELSE IF (COMPCT) THEN
+         CALL GRPS02(IOERR, UNIT, '%%LanguageLevel: 2')
+      ELSE
+         CALL GRPS02(IOERR, UNIT, '%%LanguageLevel: 1')
+      END IF
       LANDSC = MODE.EQ.1 .OR. MODE.EQ.3
       IF (LANDSC) THEN
           CALL GRPS02(IOERR, UNIT, '%%Orientation: Landscape')
@@ -438,6 +471,27 @@ C           actual dimensions
      1  '/C {rlineto currentpoint stroke moveto} bind def')
       CALL GRPS02(IOERR, UNIT, 
      1  '/D {moveto 0 0 rlineto currentpoint stroke moveto} bind def')
+      IF (COMPCT) THEN
+C        -- x y <~...~> R: stroke a run of byte offsets ending at (x,y),
+C           drawn backwards from the end point
+         CALL GRPS02(IOERR, UNIT, '/R {dup length 2 idiv /Rn exch def'//
+     1     ' 3 1 roll moveto {dup 127 gt {256 sub} if} forall')
+         CALL GRPS02(IOERR, UNIT,
+     1     ' Rn {neg exch neg exch rlineto} repeat stroke} bind def')
+C        -- image data source: the filters are drained after the image
+C           so that reading resumes after the end-of-data marker
+         IF (FLATE) THEN
+            CALL GRPS02(IOERR, UNIT, '/ZS {currentfile /ASCII85Decode'//
+     1        ' filter dup /ZA exch def /FlateDecode filter} bind def')
+         ELSE
+            CALL GRPS02(IOERR, UNIT, '/ZS {currentfile /ASCII85Decode'//
+     1        ' filter dup /ZA exch def} bind def')
+         END IF
+         CALL GRPS02(IOERR, UNIT, '/ZI {ZS dup /ZF exch def image'//
+     1        ' ZF flushfile ZA flushfile} bind def')
+         CALL GRPS02(IOERR, UNIT, '/ZC {ZS dup /ZF exch def false 3'//
+     1        ' colorimage ZF flushfile ZA flushfile} bind def')
+      END IF
       CALL GRPS02(IOERR, UNIT, '/LW {5 mul setlinewidth} bind def')
       CALL GRPS02(IOERR, UNIT, '/BP {newpath moveto} bind def')
       CALL GRPS02(IOERR, UNIT, '/LP /rlineto load def')
@@ -535,6 +589,8 @@ C
           MARKER(NSYM) = 0
   111 CONTINUE
       MFAC = 0.0
+      CURRGB(1) = -1
+      CURLW = 1
       BBXMIN = WIDTH
       BBYMIN = HEIGHT
       BBXMAX = 0.0
@@ -548,6 +604,43 @@ C
       J0 = NINT(RBUF(2))
       I1 = NINT(RBUF(3))
       J1 = NINT(RBUF(4))
+      IF (COMPCT) THEN
+C        -- suppress zero-length continuation segment
+         IF (I1.EQ.I0 .AND. J1.EQ.J0) THEN
+            IF (NRUN.GT.0 .AND. I0.EQ.RUNX .AND. J0.EQ.RUNY) RETURN
+            IF (I0.EQ.LASTI .AND. J0.EQ.LASTJ) RETURN
+         END IF
+         IF (NRUN.GT.0 .AND. (I0.NE.RUNX .OR. J0.NE.RUNY .OR.
+     1       NRUN.GE.MAXRUN)) THEN
+            CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1                  RUNX0, RUNY0, RUNX, RUNY)
+            LASTI = -1
+         END IF
+         IF (ABS(I1-I0).LE.127 .AND. ABS(J1-J0).LE.127) THEN
+C           -- add a short segment to the current run
+            IF (NRUN.EQ.0) THEN
+               RUNX0 = I0
+               RUNY0 = J0
+               LASTI = -1
+            END IF
+            NRUN = NRUN+1
+            RUNB(2*NRUN-1) = MOD(I1-I0+256, 256)
+            RUNB(2*NRUN) = MOD(J1-J0+256, 256)
+            RUNX = I1
+            RUNY = J1
+            BBXMIN = MIN(BBXMIN, I0-LW*5.0, I1-LW*5.0)
+            BBXMAX = MAX(BBXMAX, I0+LW*5.0, I1+LW*5.0)
+            BBYMIN = MIN(BBYMIN, J0-LW*5.0, J1-LW*5.0)
+            BBYMAX = MAX(BBYMAX, J0+LW*5.0, J1+LW*5.0)
+            RETURN
+         END IF
+C        -- long segments are written as text
+         IF (NRUN.GT.0) THEN
+            CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1                  RUNX0, RUNY0, RUNX, RUNY)
+            LASTI = -1
+         END IF
+      END IF
       IF (I0.EQ.LASTI .AND. J0.EQ.LASTJ) THEN
 C        -- suppress zero-length continuation segment
          IF (I0.EQ.I1 .AND. J0.EQ.J1) RETURN
@@ -569,6 +662,11 @@ C
 C--- IFUNC=13, Draw dot. -----------------------------------------------
 C
   130 CONTINUE
+      IF (NRUN.GT.0) THEN
+         CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+         LASTI = -1
+      END IF
       I1 = NINT(RBUF(1))
       J1 = NINT(RBUF(2))
       CALL GRFAO('# # D', L, INSTR, I1, J1, 0, 0)
@@ -583,6 +681,11 @@ C
 C--- IFUNC=14, End picture. --------------------------------------------
 C
   140 CONTINUE
+      IF (NRUN.GT.0) THEN
+         CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+         LASTI = -1
+      END IF
       IF (LOBUF.NE.0) THEN
           CALL GRPS02(IOERR, UNIT, OBUF(1:LOBUF))
           LOBUF = 0
@@ -647,6 +750,20 @@ C--- IFUNC=15, Select color index. -------------------------------------
 C
   150 CONTINUE
       CI = NINT(RBUF(1))
+      IF (COMPCT) THEN
+C        -- omit the command if the color would not change
+         IF (NINT(1024.*RVALUE(CI)).EQ.CURRGB(1) .AND.
+     1       NINT(1024.*GVALUE(CI)).EQ.CURRGB(2) .AND.
+     2       NINT(1024.*BVALUE(CI)).EQ.CURRGB(3)) RETURN
+         CURRGB(1) = NINT(1024.*RVALUE(CI))
+         CURRGB(2) = NINT(1024.*GVALUE(CI))
+         CURRGB(3) = NINT(1024.*BVALUE(CI))
+         IF (NRUN.GT.0) THEN
+            CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+            LASTI = -1
+         END IF
+      END IF
       IF (COLOR) THEN
          CALL GRFAO('# # # K', L, INSTR, NINT(1024.*RVALUE(CI)), 
      :        NINT(1024.*GVALUE(CI)), NINT(1024.*BVALUE(CI)), 0)
@@ -659,6 +776,11 @@ C
 C--- IFUNC=16, Flush buffer. -------------------------------------------
 C
   160 CONTINUE
+      IF (NRUN.GT.0) THEN
+         CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+         LASTI = -1
+      END IF
       IF (LOBUF.NE.0) THEN
           CALL GRPS02(IOERR, UNIT, OBUF(1:LOBUF))
           LOBUF = 0
@@ -684,6 +806,11 @@ C
 C--- IFUNC=20, Polygon fill. -------------------------------------------
 C
   200 CONTINUE
+      IF (NRUN.GT.0) THEN
+         CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+         LASTI = -1
+      END IF
       IF (NPTS.EQ.0) THEN
           NPTS = RBUF(1)
           START = .TRUE.
@@ -735,6 +862,15 @@ C--- IFUNC=22, Set line width. -----------------------------------------
 C
   220 CONTINUE
       LW = RBUF(1)
+      IF (COMPCT) THEN
+         IF (LW.EQ.CURLW) RETURN
+         CURLW = LW
+         IF (NRUN.GT.0) THEN
+            CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+            LASTI = -1
+         END IF
+      END IF
       IF (INT(LW).EQ.LW) THEN
          CALL GRFAO('# LW', L, INSTR, INT(LW), 0, 0, 0)
       ELSE
@@ -747,6 +883,14 @@ C
 C--- IFUNC=23, Escape. -------------------------------------------------
 C
   230 CONTINUE
+      IF (NRUN.GT.0) THEN
+         CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+         LASTI = -1
+      END IF
+C     -- the escape may change the graphics state
+      CURRGB(1) = -1
+      CURLW = -1
       IF (LOBUF.NE.0) THEN
 C         -- flush buffer first
           CALL GRPS02(IOERR, UNIT, OBUF(1:LOBUF))
@@ -759,6 +903,11 @@ C
 C--- IFUNC=26, Image.---------------------------------------------------
 C
   260 CONTINUE
+      IF (NRUN.GT.0) THEN
+         CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+         LASTI = -1
+      END IF
       N = RBUF(1)
       IF (N.EQ.0) THEN
 C         -- First: setup for image
@@ -782,13 +931,25 @@ C
      :                0, 0, 0)
           CALL GRPS02(IOERR, UNIT, INSTR(:L))
 C         -- 
-          CALL GRFAO('/picstr # string def', L, INSTR, NXP, 0, 0, 0)
-          CALL GRPS02(IOERR, UNIT, INSTR(:L))
+          IF (.NOT.COMPCT) THEN
+             CALL GRFAO('/picstr # string def', L, INSTR, NXP, 0, 0, 0)
+             CALL GRPS02(IOERR, UNIT, INSTR(:L))
+          END IF
           CALL GRFAO('# # 8 [', L, INSTR, NXP, NYP, 0, 0)
           CALL GRPS02(IOERR, UNIT, INSTR(:L))
           WRITE (INSTR, '(6(1PE10.3, 1X), '']'')') (RBUF(I),I=8,13)
           CALL GRPS02(IOERR, UNIT, INSTR(:67))
-          IF (COLOR) THEN
+          IF (COMPCT) THEN
+C             -- binary data follow the ZC or ZI command
+              IF (COLOR) THEN
+                  CALL GRPS02(IOERR, UNIT, 'ZC')
+              ELSE
+                  CALL GRPS02(IOERR, UNIT, 'ZI')
+              END IF
+              K = 0
+              IF (FLATE) K = 1
+              CALL GRPZBG(K)
+          ELSE IF (COLOR) THEN
               CALL GRPS02(IOERR, UNIT, 
      :      '{currentfile picstr readhexstring pop} false 3 colorimage')
           ELSE
@@ -797,7 +958,37 @@ C         --
           END IF
       ELSE IF (N.EQ.-1) THEN
 C         -- Last: terminate image
+          IF (COMPCT) THEN
+              CALL GRPZND
+  263         CALL GRPZGT(INSTR, L)
+              IF (L.GT.0) THEN
+                  CALL GRPS02(IOERR, UNIT, INSTR(1:L))
+                  GOTO 263
+              END IF
+          END IF
           CALL GRPS02(IOERR, UNIT, 'grestore')
+      ELSE IF (COMPCT) THEN
+C         -- Middle: pass N image pixels to the encoder as bytes, and
+C            write any complete lines of encoded data
+          L = 0
+          KMAX = 1
+          IF (COLOR) KMAX = 3
+          DO 265 I=1,N
+              CI = RBUF(I+1)
+              RGB(1) = NINT(255.0*RVALUE(CI))
+              RGB(2) = NINT(255.0*GVALUE(CI))
+              RGB(3) = NINT(255.0*BVALUE(CI))
+              DO 264 K=1,KMAX
+                  L = L+1
+                  INSTR(L:L) = CHAR(RGB(K))
+ 264          CONTINUE
+ 265      CONTINUE
+          CALL GRPZPT(INSTR(1:L))
+ 266      CALL GRPZGT(INSTR, L)
+          IF (L.GT.0) THEN
+              CALL GRPS02(IOERR, UNIT, INSTR(1:L))
+              GOTO 266
+          END IF
       ELSE 
 C         -- Middle: write N image pixels; each pixel uses 6 chars
 C            in INSTR, so N must be <= 20.
@@ -825,6 +1016,11 @@ C
 C--- IFUNC=28, Marker.--------------------------------------------------
 C
   280 CONTINUE
+      IF (NRUN.GT.0) THEN
+         CALL GRPS04(IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1               RUNX0, RUNY0, RUNX, RUNY)
+         LASTI = -1
+      END IF
       NSYM = NINT(RBUF(1))
 C     -- Output code for this marker if necessary
       IF (MARKER(NSYM).EQ.0) THEN
@@ -1063,3 +1259,81 @@ C
       END IF
 C-----------------------------------------------------------------------
       END
+
+C*GRPS04 -- PGPLOT PostScript driver, write a compact polyline
+C+
+      SUBROUTINE GRPS04 (IOERR, UNIT, OBUF, LOBUF, NRUN, RUNB,
+     1                   X0, Y0, X1, Y1)
+      INTEGER IOERR, UNIT, LOBUF, NRUN, RUNB(*), X0, Y0, X1, Y1
+      CHARACTER*(*) OBUF
+C
+C Support routine for PSdriver: write a run of NRUN connected line
+C segments from (X0,Y0) to (X1,Y1), whose offsets (DX, DY) are stored
+C as bytes (two's complement) in RUNB(1...2*NRUN). A single segment is
+C added to the output buffer as an "L" command; longer runs are written
+C as an "R" command with the offsets as an ASCII85 string. On return,
+C NRUN is zero.
+C-----------------------------------------------------------------------
+      INTEGER MAXCH
+      PARAMETER (MAXCH=75)
+      CHARACTER*132 LINE
+      INTEGER I, J, K, L, N, HI, LO, T, DIG(5)
+C
+      IF (NRUN.EQ.1) THEN
+          CALL GRFAO('# # # # L', L, LINE, X1-X0, Y1-Y0, X0, Y0)
+          IF (LOBUF+L+1.GT.132) THEN
+              CALL GRPS02(IOERR, UNIT, OBUF(1:LOBUF))
+              LOBUF = 0
+          END IF
+          IF (LOBUF.GT.1) THEN
+              LOBUF = LOBUF+1
+              OBUF(LOBUF:LOBUF) = ' '
+          END IF
+          OBUF(LOBUF+1:LOBUF+L) = LINE(1:L)
+          LOBUF = LOBUF+L
+          NRUN = 0
+          RETURN
+      END IF
+      IF (LOBUF.NE.0) CALL GRPS02(IOERR, UNIT, OBUF(1:LOBUF))
+      LOBUF = 0
+      CALL GRFAO('# # <~', L, LINE, X1, Y1, 0, 0)
+C
+C Encode each group of four bytes (the last one padded with zeros) as
+C five base-85 digits, found by long division of the two 16-bit halves.
+C
+      N = 2*NRUN
+      DO 30 I=1,N,4
+          HI = RUNB(I)*256
+          IF (I+1.LE.N) HI = HI + RUNB(I+1)
+          LO = 0
+          IF (I+2.LE.N) LO = RUNB(I+2)*256
+          IF (I+3.LE.N) LO = LO + RUNB(I+3)
+          IF (HI.EQ.0 .AND. LO.EQ.0 .AND. I+3.LE.N) THEN
+              K = 0
+          ELSE
+              DO 10 J=5,1,-1
+                  T = MOD(HI,85)*65536 + LO
+                  HI = HI/85
+                  LO = T/85
+                  DIG(J) = MOD(T,85)
+   10         CONTINUE
+              K = MIN(N-I+2, 5)
+          END IF
+          IF (L+5.GT.MAXCH) THEN
+              CALL GRPS02(IOERR, UNIT, LINE(1:L))
+              L = 0
+          END IF
+          IF (K.EQ.0) THEN
+              L = L+1
+              LINE(L:L) = 'z'
+          END IF
+          DO 20 J=1,K
+              L = L+1
+              LINE(L:L) = CHAR(DIG(J)+33)
+   20     CONTINUE
+   30 CONTINUE
+      LINE(L+1:L+4) = '~> R'
+      CALL GRPS02(IOERR, UNIT, LINE(1:L+4))
+      NRUN = 0
+C-----------------------------------------------------------------------
+      END
@@ -192,7 +192,7 @@ externaldef(xapgplotclassrec) XaPgplotClassRec xaPgplotClassRec = {
     /* num_resources      */    XtNumber(resources),
     /* xrm_class          */    NULLQUARK,
     /* compress_motion    */    TRUE,
-    /* compress_exposure  */    XtExposeCompressMultiple,
+    /* compress_exposure  */    XtExposeNoCompress,
     /* compress_enterleave*/    TRUE,
     /* visible_interest   */    FALSE,
     /* destroy            */    xap_Destroy,
@@ -224,7 +224,7 @@ externaldef(xmpgplotclassrec) XmPgplotClassRec xmPgplotClassRec = {
     /* num_resources      */    XtNumber(resources),
     /* xrm_class          */    NULLQUARK,
     /* compress_motion    */    TRUE,
-    /* compress_exposure  */    XtExposeCompressMultiple,
+    /* compress_exposure  */    XtExposeNoCompress,
     /* compress_enterleave*/    TRUE,
     /* visible_interest   */    FALSE,
     /* destroy            */    xmp_Destroy,
@@ -608,13 +608,19 @@ static void xmp_Expose(Widget widget, XEvent *event, Region region)
   XmPgplotWidgetClass class = (XmPgplotWidgetClass) XtClass(widget);
   PgxWin *pgx = xmp->pgx;
 /*
- * Re-draw highlight border.
+ * Re-draw highlight border once per sequence of expose events.
  */
-  if(w->primitive.highlighted) {
-    class->primitive_class.border_highlight(widget);
-  } else {
-    class->primitive_class.border_unhighlight(widget);
+  if(event->xexpose.count == 0) {
+    if(w->primitive.highlighted) {
+      class->primitive_class.border_highlight(widget);
+    } else {
+      class->primitive_class.border_unhighlight(widget);
+    };
   };
+/*
+ * Re-draw the damaged area. pgx_expose() accumulates the areas of
+ * each expose event until the last one of the sequence arrives.
+ */
   pgx_expose(pgx, event);
   return;
 }
@@ -1693,16 +1693,22 @@ static void tkpg_EventHandler(ClientData context, XEvent *event)
  */
 static void tkpg_expose_handler(TkPgplot *tkpg, XEvent *event)
 {
+/*
+ * The borders only need to be re-drawn once per sequence of expose events.
+ */
+  if(event->xexpose.count == 0) {
 /*
  * Re-draw the focus-highlight border.
  */
-  tkpg_draw_focus_highlight(tkpg);
+    tkpg_draw_focus_highlight(tkpg);
 /*
  * Re-draw the 3D borders.
  */
-  tkpg_draw_3d_border(tkpg);
+    tkpg_draw_3d_border(tkpg);
+  };
 /*
- * Re-draw the damaged area.
+ * Re-draw the damaged area. pgx_expose() accumulates the areas of
+ * each expose event until the last one of the sequence arrives.
  */
   pgx_expose(tkpg->pgx, event);
   return;
@@ -33,6 +33,11 @@
  *                            14. Support for multiple open devices.
  *                            15. The cursor can now be moved with the
  *                                keyboard arrow keys.
+ *                            16. Lines of pixels are collected in a
+ *                                client-side image of the pixmap
+ *                                (xwframe.c), which is sent to the
+ *                                pixmap in a few large requests, using
+ *                                MIT-SHM if compiled with HAVE_XSHM.
  *
  *  Scope: This driver should work with all unix workstations running
  *         X Windows (Version 11). It also works on VMS and OpenVMS
@@ -130,6 +135,8 @@ static int vms_spawn_nowait(char *command);
 #include <X11/keysym.h>
 #include <X11/Xatom.h>
 
+#include "xwframe.h"
+
 /*
  * Record the client/server protocol revision implemented herein.
  */
@@ -153,6 +160,7 @@ static int vms_spawn_nowait(char *command);
 
 #define NCOLORS 16            /* Number of pre-defined PGPLOT colors */
 #define XW_IMAGE_LEN 1280     /* Length of the line-of-pixels buffer */
+#define XW_MAX_POLYLINE 4096  /* Max vertices per XDrawLines() request */
 #define COLORMULT 65535       /* Normalized color intensity multiplier */
 
 #define XW_IDENT "PGPLOT /xw"      /* Name to prefix messages to user */
@@ -307,6 +315,7 @@ typedef struct XWdev {
   XWupdate update;   /* Descriptor of un-drawn area of pixmap */
   XWevent event;     /* Event state container */
   XWimage image;     /* Line of pixels container */
+  XWframe frame;     /* Pending lines of pixels */
   XGCValues gcv;     /* Publicly visible contents of 'gc' */
   GC gc;             /* Graphical context descriptor */
   int last_opcode;   /* Index of last opcode */
@@ -346,6 +355,11 @@ static int xw_rgb_to_xcolor ARGS((float rgb));
 
 static int xw_next_page ARGS((XWdev *xw, unsigned int width, unsigned int height));
 static int xw_image_line ARGS((XWdev *xw, XPoint *start, float *cells, int ncell));
+static int xw_image_ci ARGS((XWdev *xw, XPoint *start, unsigned char *ci,
+			     int nbyte, int ncell));
+static int xw_frame_line ARGS((XWdev *xw, XPoint *start, float *cells,
+			       unsigned char *ci, int nbyte, int ncell));
+static int xw_flush_frame ARGS((XWdev *xw));
 static int xw_read_cursor ARGS((XWdev *xw, int mode, int posn, XPoint *ref,
 				XPoint *pos, char *key));
 static int xw_shift_cursor ARGS((XWdev *xw, KeySym keysym, \
@@ -529,7 +543,9 @@ void XWDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
     chr[8] = 'Y'; /* Can return color representation */
     chr[9] = 'N'; /* Not used */
     chr[10]= 'S'; /* Area-scroll available */
-    *lchr = 11;
+    chr[11]= 'L'; /* Polylines available */
+    chr[12]= 'I'; /* Line of integer pixels available */
+    *lchr = 13;
     break;
 
 /*--- IFUNC=5, Return default file name ---------------------------------*/
@@ -652,6 +668,35 @@ void XWDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
     };
     break;
 
+/*--- IFUNC=31, Draw polyline -------------------------------------------*/
+
+  case 31:
+    if(xw_ok(xw) && xw->pixmap!=None) {
+      int npoint = *nbuf / 2;
+      XPoint *points = (XPoint *) malloc(sizeof(XPoint) * (npoint > 0 ? npoint : 1));
+      int i;
+      if(points==NULL) {
+	fprintf(stderr, "%s: Insufficient memory for polyline points.\n",
+		XW_IDENT);
+	break;
+      };
+      for(i=0; i<npoint; i++) {
+	xw_xy_to_XPoint(xw, &rbuf[2*i], &points[i]);
+	xw_mark_modified(xw, points[i].x, points[i].y, xw->gcv.line_width);
+      };
+/*
+ * Send the polyline in pieces that fit in an X request, each one
+ * starting at the last vertex of the previous one.
+ */
+      for(i=0; i < npoint-1; i += XW_MAX_POLYLINE-1) {
+	int n = npoint-i < XW_MAX_POLYLINE ? npoint-i : XW_MAX_POLYLINE;
+	XDrawLines(xw->display, xw->pixmap, xw->gc, &points[i], n,
+		   CoordModeOrigin);
+      };
+      free((char *)points);
+    };
+    break;
+
 /*--- IFUNC=13, Draw dot ------------------------------------------------*/
 
   case 13:
@@ -826,7 +871,21 @@ void XWDRIV(ifunc, rbuf, nbuf, chr, lchr, mode, len)
     if(xw_ok(xw)) {
       XPoint start;
       xw_xy_to_XPoint(xw, rbuf, &start);
-      xw_image_line(xw, &start, &rbuf[2], *nbuf - 2);
+      if(xw_frame_line(xw, &start, &rbuf[2], NULL, 0, *nbuf - 2))
+	xw_image_line(xw, &start, &rbuf[2], *nbuf - 2);
+    };
+    break;
+
+/*--- IFUNC=32, Line of pixels (integer color indexes) ------------------*/
+
+  case 32:
+    if(xw_ok(xw)) {
+      XPoint start;
+      int nbyte = (int) (rbuf[2] + 0.5);
+      xw_xy_to_XPoint(xw, rbuf, &start);
+      if(xw_frame_line(xw, &start, NULL, (unsigned char *) chr, nbyte,
+		       *lchr / nbyte))
+	xw_image_ci(xw, &start, (unsigned char *) chr, nbyte, *lchr / nbyte);
     };
     break;
 
@@ -1830,6 +1889,7 @@ static XWdev *new_XWdev(display, mode)
   xw->event.mask = NoEventMask;
   xw->event.no_buttons = 0;
   xw->image.xi = NULL;
+  xwf_init(&xw->frame);
   xw->last_opcode = 0;
   xw->flush_opcode_fn = (Flush_Opcode_fn) 0;
 /*
@@ -2006,6 +2066,7 @@ static XWdev *del_XWdev(xw, partial)
     if(xw->image.xi)
       XDestroyImage(xw->image.xi);
     xw->image.xi = NULL;
+    xwf_free(&xw->frame);
 /*
  * Check for un-freed polygon points.
  */
@@ -2635,6 +2696,146 @@ static int xw_image_line(xw, start, cells, ncell)
   return 0;
 }
 
+/*.......................................................................
+ * Draw a horizontal line of pixels at a given location, from an array
+ * of PGPLOT color indexes of one or two bytes each (low byte first).
+ *
+ * Input:
+ *  xw      XWdev *   The PGPLOT /xw device descriptor.
+ *  start  XPoint *   The position to start the line at.
+ *  ci   unsigned char *  An array of ncell PGPLOT color indexes.
+ *  nbyte     int     The number of bytes per color index (1 or 2).
+ *  ncell     int     The number of color indexes in ci[].
+ * Output:
+ *  return    int     0 - OK.
+ *                    1 - Error.
+ */
+#ifdef __STDC__
+static int xw_image_ci(XWdev *xw, XPoint *start, unsigned char *ci,
+		       int nbyte, int ncell)
+#else
+static int xw_image_ci(xw, start, ci, nbyte, ncell)
+     XWdev *xw; XPoint *start; unsigned char *ci; int nbyte; int ncell;
+#endif
+{
+  int ndone;  /* The number of pixels drawn so far */
+  int i;
+/*
+ * Device error?
+ */
+  if(xw->bad_device)
+    return 1;
+/*
+ * Quietly ignore the call if we don't have a pixmap.
+ */
+  if(xw->pixmap != None && ncell > 0) {
+    for(ndone=0; !xw->bad_device && ndone<ncell; ndone += XW_IMAGE_LEN) {
+      int ntodo = ncell-ndone;
+      int nimage = ntodo < XW_IMAGE_LEN ? ntodo : XW_IMAGE_LEN;
+      unsigned char *c = ci + ndone * nbyte;
+/*
+ * Load the image buffer with the color cell indexes assigned to the
+ * given PGPLOT color indexes.
+ */
+      if(nbyte == 1 && xw->color.vi->depth == 8) {
+	for(i=0; i<nimage; i++)
+	  xw->image.xi->data[i] = xw->color.pixel[c[i]];
+      } else if(nbyte == 1) {
+	for(i=0; i<nimage; i++)
+	  XPutPixel(xw->image.xi, i, 0, xw->color.pixel[c[i]]);
+      } else {
+	for(i=0; i<nimage; i++)
+	  XPutPixel(xw->image.xi, i, 0,
+		    xw->color.pixel[c[2*i] | c[2*i+1] << 8]);
+      };
+/*
+ * Display the image.
+ */
+      XPutImage(xw->display, xw->pixmap, xw->gc, xw->image.xi, 0, 0,
+		start->x+ndone, start->y, (unsigned) nimage, (unsigned) 1);
+    };
+/*
+ * Extend the region to be updated on the next flush.
+ */
+    xw_mark_modified(xw, start->x, start->y, 1);
+    xw_mark_modified(xw, start->x + ncell - 1, start->y, 1);
+  };
+  if(xw->bad_device)
+    return 1;
+  return 0;
+}
+
+/*.......................................................................
+ * Add a line of pixels to the client-side image of the pixmap, to be
+ * sent to the pixmap by xw_flush_frame() before the next operation of
+ * a different type. The pixels are given either as float color
+ * indexes in cells[] or as integer color indexes in ci[], as in
+ * xw_image_line() and xw_image_ci().
+ *
+ * Input:
+ *  xw      XWdev *   The PGPLOT /xw device descriptor.
+ *  start  XPoint *   The position to start the line at.
+ *  cells   float *   An array of ncell float color indexes, or NULL.
+ *  ci   unsigned char *  An array of ncell integer color indexes.
+ *  nbyte     int     The number of bytes per index in ci[].
+ *  ncell     int     The number of pixels.
+ * Output:
+ *  return    int     0 - OK.
+ *                    1 - The image is not available; draw the line
+ *                        with xw_image_line() or xw_image_ci().
+ */
+#ifdef __STDC__
+static int xw_frame_line(XWdev *xw, XPoint *start, float *cells,
+			 unsigned char *ci, int nbyte, int ncell)
+#else
+static int xw_frame_line(xw, start, cells, ci, nbyte, ncell)
+     XWdev *xw; XPoint *start; float *cells; unsigned char *ci; int nbyte;
+     int ncell;
+#endif
+{
+  if(xw->bad_device)
+    return 0;
+/*
+ * Quietly ignore the call if we don't have a pixmap.
+ */
+  if(xw->pixmap == None || ncell < 1)
+    return 0;
+  if(xwf_line(&xw->frame, xw->display, xw->color.vi, xw->pixmap, xw->gc,
+	      xw->geom.width, xw->geom.height, start->x, start->y, ncell,
+	      xw->color.pixel, cells, ci, nbyte))
+    return 1;
+  xw->flush_opcode_fn = (Flush_Opcode_fn) xw_flush_frame;
+/*
+ * Extend the region to be updated on the next flush.
+ */
+  xw_mark_modified(xw, start->x, start->y, 1);
+  xw_mark_modified(xw, start->x + ncell - 1, start->y, 1);
+  return 0;
+}
+
+/*.......................................................................
+ * Send the lines of pixels collected by xw_frame_line() to the pixmap.
+ * This is the flush function for buffered opcodes 26 and 32.
+ *
+ * Input:
+ *  xw      XWdev *   The PGPLOT /xw device descriptor.
+ * Output:
+ *  return    int     0 - OK.
+ *                    1 - Error.
+ */
+#ifdef __STDC__
+static int xw_flush_frame(XWdev *xw)
+#else
+static int xw_flush_frame(xw)
+     XWdev *xw;
+#endif
+{
+  if(xw->bad_device)
+    return 1;
+  xwf_flush(&xw->frame);
+  return xw->bad_device != 0;
+}
+
 /*.......................................................................
  * Call this function when an Expose event is received. It will then
  * re-draw the exposed region from the xw->pixmap.
@@ -0,0 +1,364 @@
+/*
+ * Whole-pixmap images for the X-window drivers; see xwframe.h.
+ *
+ * Lines of pixels are stored into the image as they arrive, packing
+ * pixel values directly into the image data when its format is 8, 16
+ * or 32 bits per pixel in the client's byte order. The extent of the
+ * new pixels in each row is recorded, and xwf_flush() sends the pending
+ * rows to the drawable, one request for each run of rows with the same
+ * extent (Xlib itself splits requests that exceed the server's maximum
+ * request size). A new line that does not touch the pending pixels of
+ * its row causes the pending rows to be sent first, so the order of
+ * drawing is preserved.
+ *
+ * The drivers call xwf_flush() before any other drawing operation, via
+ * their buffered-opcode flush functions.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "xwframe.h"
+
+#ifdef HAVE_XSHM
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif
+
+#ifdef HAVE_XSHM
+static int xwf_xerror;      /* The last error trapped by xwf_trap() */
+
+#ifdef __STDC__
+static int xwf_trap(Display *display, XErrorEvent *event)
+#else
+static int xwf_trap(display, event)
+     Display *display; XErrorEvent *event;
+#endif
+{
+  xwf_xerror = event->error_code;
+  return 0;
+}
+
+/*.......................................................................
+ * Try to create the image in a shared memory segment.
+ *
+ * Output:
+ *  return  int   0 - OK.
+ *                1 - Shared memory is not available.
+ */
+#ifdef __STDC__
+static int xwf_get_shm(XWframe *f, XVisualInfo *vi)
+#else
+static int xwf_get_shm(f, vi)
+     XWframe *f; XVisualInfo *vi;
+#endif
+{
+  int (*handler) ARGS((Display *, XErrorEvent *));
+  if(!XShmQueryExtension(f->display))
+    return 1;
+  f->xi = XShmCreateImage(f->display, vi->visual, (unsigned) vi->depth,
+			  ZPixmap, NULL, &f->info, f->width, f->height);
+  if(!f->xi)
+    return 1;
+  f->info.shmid = shmget(IPC_PRIVATE,
+			 (size_t) f->xi->bytes_per_line * f->height,
+			 IPC_CREAT | 0600);
+  if(f->info.shmid < 0) {
+    XDestroyImage(f->xi);
+    f->xi = NULL;
+    return 1;
+  };
+  f->info.shmaddr = f->xi->data = (char *) shmat(f->info.shmid, NULL, 0);
+  f->info.readOnly = False;
+  xwf_xerror = 0;
+  if(f->info.shmaddr != (char *) -1) {
+/*
+ * Attaching fails with an X error if the server can't share memory
+ * with us, e.g. across a network.
+ */
+    handler = XSetErrorHandler(xwf_trap);
+    XShmAttach(f->display, &f->info);
+    XSync(f->display, False);
+    XSetErrorHandler(handler);
+  };
+/*
+ * The segment is removed when both sides have detached from it.
+ */
+  shmctl(f->info.shmid, IPC_RMID, NULL);
+  if(f->info.shmaddr == (char *) -1 || xwf_xerror) {
+    if(f->info.shmaddr != (char *) -1)
+      shmdt(f->info.shmaddr);
+    f->xi->data = NULL;
+    XDestroyImage(f->xi);
+    f->xi = NULL;
+    return 1;
+  };
+  f->shm = 1;
+  return 0;
+}
+#endif
+
+/*.......................................................................
+ * Create an image of the given size.
+ *
+ * Output:
+ *  return  int   0 - OK.
+ *                1 - Error.
+ */
+#ifdef __STDC__
+static int xwf_get_image(XWframe *f, Display *display, XVisualInfo *vi,
+			 unsigned width, unsigned height)
+#else
+static int xwf_get_image(f, display, vi, width, height)
+     XWframe *f; Display *display; XVisualInfo *vi;
+     unsigned width; unsigned height;
+#endif
+{
+  int one = 1;
+  int host_order = *(char *) &one ? LSBFirst : MSBFirst;
+  unsigned i;
+  f->display = display;
+  f->width = width;
+  f->height = height;
+  f->failed = 1;
+  if(width < 1 || height < 1)
+    return 1;
+  f->x0 = (int *) malloc(sizeof(int) * height);
+  f->x1 = (int *) malloc(sizeof(int) * height);
+  if(!f->x0 || !f->x1)
+    return 1;
+  for(i=0; i<height; i++) {
+    f->x0[i] = width;
+    f->x1[i] = -1;
+  };
+  f->ymin = height;
+  f->ymax = -1;
+#ifdef HAVE_XSHM
+  if(xwf_get_shm(f, vi) != 0)
+#endif
+  {
+    f->xi = XCreateImage(display, vi->visual, (unsigned) vi->depth, ZPixmap,
+			 0, NULL, width, height, 32, 0);
+    if(!f->xi)
+      return 1;
+    f->xi->data = malloc((size_t) f->xi->bytes_per_line * height);
+    if(!f->xi->data) {
+      XDestroyImage(f->xi);
+      f->xi = NULL;
+      return 1;
+    };
+  };
+/*
+ * Can pixel values be stored directly?
+ */
+  f->pack = 0;
+  switch(f->xi->bits_per_pixel) {
+  case 8:
+    f->pack = 8;
+    break;
+  case 16:
+  case 32:
+    if(f->xi->byte_order == host_order)
+      f->pack = f->xi->bits_per_pixel;
+    break;
+  };
+  f->failed = 0;
+  return 0;
+}
+
+/*.......................................................................
+ * Initialize a frame descriptor.
+ */
+#ifdef __STDC__
+void xwf_init(XWframe *f)
+#else
+void xwf_init(f)
+     XWframe *f;
+#endif
+{
+  f->display = NULL;
+  f->xi = NULL;
+  f->width = f->height = 0;
+  f->failed = 0;
+  f->pack = 0;
+  f->shm = 0;
+  f->x0 = f->x1 = NULL;
+  f->ymin = 0;
+  f->ymax = -1;
+  f->drawable = None;
+  f->gc = NULL;
+}
+
+/*.......................................................................
+ * Release the image, discarding any pending pixels.
+ */
+#ifdef __STDC__
+void xwf_free(XWframe *f)
+#else
+void xwf_free(f)
+     XWframe *f;
+#endif
+{
+  if(f->xi) {
+#ifdef HAVE_XSHM
+    if(f->shm) {
+      XShmDetach(f->display, &f->info);
+      XSync(f->display, False);
+      shmdt(f->info.shmaddr);
+      f->xi->data = NULL;
+    };
+#endif
+    XDestroyImage(f->xi);
+  };
+  if(f->x0)
+    free((char *) f->x0);
+  if(f->x1)
+    free((char *) f->x1);
+  xwf_init(f);
+}
+
+/*.......................................................................
+ * Store a line of n pixels starting at (x,y). The pixels are given as
+ * PGPLOT color indexes, either as floats in cells[], or as integers of
+ * nbyte bytes (low byte first) in ci[]; pixel[] maps them to pixel
+ * values.
+ *
+ * Output:
+ *  return  int   0 - OK.
+ *                1 - The image could not be created; the caller should
+ *                    draw the line itself.
+ */
+#ifdef __STDC__
+int xwf_line(XWframe *f, Display *display, XVisualInfo *vi,
+	     Drawable drawable, GC gc, unsigned width, unsigned height,
+	     int x, int y, int n, unsigned long *pixel,
+	     float *cells, unsigned char *ci, int nbyte)
+#else
+int xwf_line(f, display, vi, drawable, gc, width, height, x, y, n, pixel,
+	     cells, ci, nbyte)
+     XWframe *f; Display *display; XVisualInfo *vi; Drawable drawable;
+     GC gc; unsigned width; unsigned height; int x; int y; int n;
+     unsigned long *pixel; float *cells; unsigned char *ci; int nbyte;
+#endif
+{
+  char *row;
+  int skip, i;
+/*
+ * (Re)create the image if the pixmap has changed size.
+ */
+  if(f->display != display || f->width != width || f->height != height) {
+    xwf_flush(f);
+    xwf_free(f);
+    xwf_get_image(f, display, vi, width, height);
+  };
+  if(f->failed || !f->xi)
+    return 1;
+/*
+ * Pending pixels for another drawable, or that the new ones do not
+ * touch, must be sent first.
+ */
+  if(f->ymin <= f->ymax && (drawable != f->drawable || gc != f->gc))
+    xwf_flush(f);
+  f->drawable = drawable;
+  f->gc = gc;
+/*
+ * Clip the line to the image.
+ */
+  if(y < 0 || y >= (int) height)
+    return 0;
+  skip = x < 0 ? -x : 0;
+  if(x + n > (int) width)
+    n = width - x;
+  if(n <= skip)
+    return 0;
+  if(f->x0[y] <= f->x1[y] && (x + skip > f->x1[y] + 1 || x + n < f->x0[y]))
+    xwf_flush(f);
+/*
+ * Store the pixels.
+ */
+  row = f->xi->data + (size_t) y * f->xi->bytes_per_line;
+  for(i=skip; i<n; i++) {
+    unsigned long p = pixel[cells ? (int) (cells[i] + 0.5) :
+			    nbyte == 1 ? ci[i] : ci[2*i] | ci[2*i+1] << 8];
+    switch(f->pack) {
+    case 8:
+      ((unsigned char *) row)[x+i] = (unsigned char) p;
+      break;
+    case 16:
+      ((unsigned short *) row)[x+i] = (unsigned short) p;
+      break;
+    case 32:
+      ((unsigned int *) row)[x+i] = (unsigned int) p;
+      break;
+    default:
+      XPutPixel(f->xi, x+i, y, p);
+      break;
+    };
+  };
+/*
+ * Extend the pending region.
+ */
+  if(x + skip < f->x0[y])
+    f->x0[y] = x + skip;
+  if(x + n - 1 > f->x1[y])
+    f->x1[y] = x + n - 1;
+  if(y < f->ymin)
+    f->ymin = y;
+  if(y > f->ymax)
+    f->ymax = y;
+  return 0;
+}
+
+/*.......................................................................
+ * Send the pending pixels to the drawable.
+ *
+ * Output:
+ *  return  int   0 - OK.
+ *                1 - Error.
+ */
+#ifdef __STDC__
+int xwf_flush(XWframe *f)
+#else
+int xwf_flush(f)
+     XWframe *f;
+#endif
+{
+  int y, y2;
+  if(!f->xi || f->ymin > f->ymax)
+    return 0;
+  for(y=f->ymin; y<=f->ymax; y=y2) {
+    int x0 = f->x0[y];
+    int x1 = f->x1[y];
+/*
+ * Find the run of rows with the same extent.
+ */
+    for(y2=y+1; y2<=f->ymax && f->x0[y2]==x0 && f->x1[y2]==x1; y2++)
+      ;
+    if(x0 <= x1) {
+#ifdef HAVE_XSHM
+      if(f->shm)
+	XShmPutImage(f->display, f->drawable, f->gc, f->xi, x0, y, x0, y,
+		     (unsigned) (x1-x0+1), (unsigned) (y2-y), False);
+      else
+#endif
+	XPutImage(f->display, f->drawable, f->gc, f->xi, x0, y, x0, y,
+		  (unsigned) (x1-x0+1), (unsigned) (y2-y));
+    };
+  };
+  for(y=f->ymin; y<=f->ymax; y++) {
+    f->x0[y] = f->width;
+    f->x1[y] = -1;
+  };
+  f->ymin = f->height;
+  f->ymax = -1;
+/*
+ * The server must have finished reading a shared image before the
+ * client writes to it again.
+ */
+#ifdef HAVE_XSHM
+  if(f->shm)
+    XSync(f->display, False);
+#endif
+  return 0;
+}
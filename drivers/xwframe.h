@@ -0,0 +1,57 @@
+#ifndef xwframe_h
+#define xwframe_h
+
+/*
+ * A client-side image of a whole pixmap, used by the X-window drivers
+ * (xwdriv.c and pgxwin.c) to collect lines of pixels (opcodes 26 and
+ * 32) and send them to the pixmap in a few large requests instead of
+ * one XPutImage() per line. If compiled with HAVE_XSHM and the display
+ * supports it, the image is held in a MIT-SHM shared memory segment.
+ */
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+#ifdef HAVE_XSHM
+#include <X11/extensions/XShm.h>
+#endif
+
+/*
+ * The ARGS() macro allows pre-ANSI compilers to discard prototype
+ * arguments.
+ */
+#ifndef ARGS
+#ifdef __STDC__
+#define ARGS(args) args
+#else
+#define ARGS(args) ()
+#endif
+#endif
+
+typedef struct {
+  Display *display;     /* The display of the image */
+  XImage *xi;           /* The image, or NULL if not allocated */
+  unsigned width;       /* The size of the image (pixels) */
+  unsigned height;
+  int failed;           /* True if an image of this size can't be made */
+  int pack;             /* Bits per pixel if pixels can be stored */
+                        /*  directly, otherwise 0 to use XPutPixel() */
+  int shm;              /* True if the image is in shared memory */
+#ifdef HAVE_XSHM
+  XShmSegmentInfo info; /* The shared memory segment */
+#endif
+  int *x0, *x1;         /* X extent of pending pixels in each row */
+  int ymin, ymax;       /* Rows with pending pixels (ymin>ymax if none) */
+  Drawable drawable;    /* Where pending pixels are to be drawn */
+  GC gc;                /* The graphical context to draw them with */
+} XWframe;
+
+void xwf_init ARGS((XWframe *f));
+void xwf_free ARGS((XWframe *f));
+int xwf_line ARGS((XWframe *f, Display *display, XVisualInfo *vi,
+		   Drawable drawable, GC gc, unsigned width, unsigned height,
+		   int x, int y, int n, unsigned long *pixel,
+		   float *cells, unsigned char *ci, int nbyte));
+int xwf_flush ARGS((XWframe *f));
+
+#endif
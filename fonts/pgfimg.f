@@ -0,0 +1,49 @@
+      PROGRAM PGFIMG
+C-----------------------------------------------------------------------
+C Write the font image (grfont.img) for the binary font file
+C (grfont.dat) made by pgpack.
+C
+C The image holds the symbols of the font file already decoded, so
+C that PGPLOT programs can map it instead of reading and decoding the
+C font file each time they start. Its format is described in
+C sys/grsyim.c; it is private to PGPLOT and depends on the byte order
+C of the machine, so it must be made on the machine that will use it.
+C If there is no image, or it does not match the font file, PGPLOT
+C reads the font file as before.
+C
+C The font file is found in the same way as by PGPLOT: environment
+C variable PGPLOT_FONT, or grfont.dat in the PGPLOT_DIR directory.
+C The image is written next to the font file, or to the file named
+C by PGPLOT_FONT_IMAGE.
+C-----------------------------------------------------------------------
+      INTEGER MAXCHR, MAXBUF
+      PARAMETER (MAXCHR=3000)
+      PARAMETER (MAXBUF=27000)
+C
+      INTEGER   INDEX(MAXCHR)
+      INTEGER*2 BUFFER(MAXBUF)
+      INTEGER   IER, L, LI, NC1, NC2, NC3, GRSYIW, GRTRIM
+      CHARACTER*128 FF, FI
+C-----------------------------------------------------------------------
+C
+C Read the font file.
+C
+      CALL GRGFIL('FONT', FF)
+      L = GRTRIM(FF)
+      IF (L.LT.1) L = 1
+      CALL GRGENV('FONT_IMAGE', FI, LI)
+      OPEN (UNIT=2, FILE=FF(1:L), FORM='UNFORMATTED', STATUS='OLD',
+     1      IOSTAT=IER)
+      IF (IER.EQ.0) READ (UNIT=2, IOSTAT=IER) NC1,NC2,NC3,INDEX,BUFFER
+      IF (IER.NE.0) THEN
+          WRITE (6,*) '++ERROR++ Unable to read font file: ', FF(1:L)
+          STOP
+      END IF
+      CLOSE (UNIT=2)
+C
+C Write the image.
+C
+      IF (GRSYIW(FF(1:L), FI, NC1, NC2, INDEX, BUFFER).NE.1) THEN
+          WRITE (6,*) '++ERROR++ Unable to write the font image'
+      END IF
+      END
@@ -8,6 +8,7 @@
 /*  7-Aug-1991	SNS/CIT	Now deals with OpenWindows bug. */
 /* 15-Aug-1991	SNS/CIT	No longer includes vista hooks. */
 /*  8-Oct-1991	SNS/CIT	Modified for cleaner wininfo struct */
+/* 17-Oct-2026		Now removes the local data socket. */
 
 /* The X Window include files */
 #include <X11/Xlib.h>
@@ -19,6 +20,7 @@
 void cleanup()
 {
 	void restorecolors();
+	void closesock();
 
 #ifndef PGDISP
 #ifndef UNBUGGY
@@ -28,6 +30,9 @@ void cleanup()
 #endif
 #endif
 
+	/* remove the local data socket */
+	closesock();
+
 	/* Release the line graphics graphics context */
 	XFreeGC(display,linegc);
 
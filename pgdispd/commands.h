@@ -59,6 +59,7 @@
 /*			Now protected from double inclusion */
 /*  4-Nov-1992	SNS/CIT	AUTOSCALE now takes ASCII-encoded floats which range */
 /*			from 0.0 to 100.0 */
+/* 17-Oct-2026		NAME_SOCKATOM added for the local data socket. */
 
 #ifndef INC_COMMANDS_H
 #define INC_COMMANDS_H
@@ -76,6 +77,9 @@ static char commands_h_rcsid[]="@(#)$Id$";
 #define NAME_INCRATOM	"figdispincr" /* The name of the incremental atom */
 #define NAME_DATAATOM	"figdispdata" /* The name of the data atom */
 #define NAME_SELATOM	"figdispsel" /* The name of the selection atom */
+#define NAME_SOCKATOM	"figdispsock" /* The name of the property on the */
+				/* server window which holds "host:path" of */
+				/* its local data socket, if it has one. */
 
 /* The command tokens */
 #define RESET		0	/* reset the server.  Does not clear either  */
@@ -72,6 +72,7 @@
 /* 14-Oct-1992	SNS/CIT	RCS id string now only added if INC_HEADER_RCS */
 /*			#define'd.  Space for MOUSEMODE and DOBOX keys added. */
 /*			Now protected from doubel #include'sion */
+/* 17-Oct-2026		localsock added to the resource structure. */
 
 #ifndef INC_FIGDISP_H
 #define INC_FIGDISP_H
@@ -304,6 +305,8 @@ struct resource {
 			/* line graphics window. */
 	int plothist;	/* True if line plots should be in histogram form */
 	int initwrap;	/* The initial LUT wrap factor */
+	int localsock;	/* True if we should offer clients on this host a */
+			/* local socket for data instead of X selections */
 };
 
 #endif /* INC_FIGDISP_H */
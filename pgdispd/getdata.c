@@ -19,6 +19,8 @@
 /* 19-Oct-1991	SNS/CIT	No longer mistakenly resets buflen. */
 /* 14-Apr-1992	SNS/CIT	Now compiles under VMS */
 /* 27-Sep-1992	SNS/CIT	return buffer now stored in network byte order */
+/* 17-Oct-2026		Now reads the local data socket to the end before */
+/*			finishing a transfer. */
 
 /* The system include files */
 #include <stdio.h>
@@ -55,6 +57,7 @@ int *selset;	/* whether or not the selection is owned by a user program */
 	void returnbuf();		/* return data to the user process */
 	void clearcurs();		/* clear the list of cursor presses */
 	int proccom ();
+	int getsockdata ();
 
 	if (buflen == -1) buflen= (XMaxRequestSize(display)-10)<<1;
 	if (XGetWindowProperty(display, srcwin, event.property, 0L, buflen,
@@ -70,6 +73,9 @@ int *selset;	/* whether or not the selection is owned by a user program */
 	} else if (acttype == incrtype) {
 		if (!nitems)
 		{ /* all done, get the selection back */
+			/* the client closes its data socket, if it used */
+			/* one, before it sends this, so read up to the end */
+			(void)getsockdata(rbuf,rbuflen,1);
 			XSetSelectionOwner(display,selatom,lg.win,CurrentTime);
 			if (XGetSelectionOwner(display,selatom) != lg.win)
 			{
@@ -14,6 +14,7 @@
 /* 14-Oct-1992	ARC/HI	Support for box & autodisp added. */
 /* 14-Oct-1992	SNS/CIT	Now only includes RCS id string if INC_HEADER_RCS is */
 /*			#define'd. */
+/* 17-Oct-2026		sockfd and datafd added. */
 
 #ifndef INC_GLOBALS_H
 #define INC_GLOBALS_H
@@ -79,6 +80,8 @@ double autodisp_upper;	/* hi bound for LUT computed by autodisp */
 int ul_x = -1, ul_y = -1, lr_x = -1, lr_y = -1;	/* box bounds - image coords */
 int ramplo, ramphi;	/* The low and high bounds for linear scaling */
 int sendidle = 0;	/* true if the client has requested a FIGDISP_IDLE */
+int sockfd = -1;	/* The local socket clients may connect to */
+int datafd = -1;	/* The data connection accepted from sockfd */
 #else
 extern Display *display;
 extern int mousemode;
@@ -128,6 +131,8 @@ extern double autodisp_upper;
 extern int ul_x, ul_y, lr_x, lr_y;
 extern int ramplo, ramphi;
 extern int sendidle;
+extern int sockfd;
+extern int datafd;
 #endif
 
 #endif
@@ -25,6 +25,8 @@
 /*			into the color map. */
 /*  4-Oct-1992	SNS/CIT	No longer needs #ifdef KECK */
 /* 14-Oct-1992	SNS/CIT	Merged in changes from ARC/HI. */
+/* 17-Oct-2026		Return buffer moved out of handlexevent so that */
+/*			handlesock can share it. */
 
 #ifndef lint
 static char rcsid[]="@(#)$Id$";
@@ -49,6 +51,9 @@ static char rcsid[]="@(#)$Id$";
 int luttransoff=0;
 int modluttransoff=0;
 
+static short retbuf[7];		/* A buffer for return values */
+static int retbuflen=0;		/* the actual length of the buffer */
+
 int handlexevent(event,go_on)
 XEvent event;
 int *go_on;	/* whether the calling routine shoudl exit successfully */
@@ -63,8 +68,6 @@ int *go_on;	/* whether the calling routine shoudl exit successfully */
 #endif
 	int px,py;	/* The pointer X & Y position */
 	XEvent event2;	/* A second event */
-	static short retbuf[7];		/* A buffer for return values */
-	static int retbuflen=0;		/* the actual length of the buffer */
 	static int lgx= -1 ,lgy;	/* current line graphics line pos */
 	Window windum;
 	int dummy;
@@ -435,3 +438,18 @@ int *go_on;	/* whether the calling routine shoudl exit successfully */
 
 	return(SUCCEED);
 }
+
+/* The handlesock routine takes care of data waiting on the local data */
+/* socket, using the same return buffer as the X selection transfers so */
+/* that a cursor request is answered by the button press that completes it. */
+/* Return Values: */
+/* FAIL		If the data connection had to be dropped */
+/* SUCCEED	Otherwise */
+
+int handlesock()
+{
+	int getsockdata();
+
+	if (!getsockdata(&retbuf[0], &retbuflen, 0)) return(FAIL);
+	return(SUCCEED);
+}
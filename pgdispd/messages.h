@@ -17,6 +17,7 @@
 /*  9-Mar-1992	SNS/CIT	MSG_TRYRESIZE & MSG_BADRESIZE added. */
 /* 24-Jun-1992	SNS/CIT	MSG_SMALLHIST added. */
 /* 26-Jun-1992	SNS/CIT	MSG_LGWINTOOSMALL added. */
+/* 17-Oct-2026		MSG_NOSOCKET and MSG_SOCKREAD added. */
 
 /* If the screen already contains a copy of this server */
 #define MSG_ALREADYRUNNING "There is aready a display on your screen!\n"
@@ -102,3 +103,10 @@ a little wierd unless you make this window smaller\n"
 
 #define MSG_LGWINTOOSMALL \
 	"The line graphics window is too small for a plot\n"
+
+/* If the local data socket could not be set up */
+#define MSG_NOSOCKET \
+	"Could not create the local data socket; using X selections only.\n"
+
+/* If reading from the local data socket fails */
+#define MSG_SOCKREAD "Error reading the local data socket!\n"
@@ -21,6 +21,7 @@
 /* 14-Oct-1992	SNS/CIT	Now #defines INC_HEADER_RCS to include .h RCS id */
 /*			strings.  Now includes all .h files so that all RCS */
 /*			id strings get into the executable. */
+/* 17-Oct-2026		Now sets up the local data socket. */
 
 
 /* Wish list: */
@@ -75,7 +76,8 @@ char **argv;
 
 	/* Set up the resource/locking mechanism and the Atoms needed to */
 	/* communicate with applications and initialize the window */
-	if (initlock() || getvisuals() || initlgwin()) return(FAIL);
+	if (initlock() || getvisuals() || initlgwin() || initsock())
+		return(FAIL);
 
 	/* Map the window.  This is not done in initlgwin because initlgwin */
 	/* is shared with the Vista server, and the vista server is busy */
@@ -83,6 +83,13 @@
 /*			Extra arguments to XFillRectangle in SET_LG_SIZE */
 /*			removed. */
 /* 22-Aug-1994  TJP/CIT Fix bug in positioning thick dots. */
+/* 17-Oct-2026		The parser is now procstream, which leaves an */
+/*			incomplete trailing command in the caller's buffer */
+/*			so the socket reader can parse in place.  Proccom */
+/*			keeps one growing carry buffer for the selection */
+/*			transfers instead of a malloc per partial command. */
+/*			DRAW_POLY and FILL_POLY no longer run past the end */
+/*			of a partial buffer. */
 
 #ifndef lint
 static char rcsid[]="@(#)$Id$";
@@ -116,11 +123,91 @@ static char rcsid[]="@(#)$Id$";
 /* A trivial macro */
 #define min(x,y) (((x) > (y)) ? (y) : (x))
 
+static int carried=0;		/* the number of shorts carried over */
+static unsigned short *carry;	/* the carried data */
+static int carrylen=0;		/* the allocated length of carry */
+
+/* The carryroom routine makes sure the carry buffer can hold len shorts. */
+/* Return Values: */
+/* SUCCEED	If there is room */
+/* MALLOC_ERR	If the buffer could not be grown */
+
+static int carryroom(len)
+int len;	/* the number of shorts needed */
+{
+	unsigned short *newcarry;	/* the grown buffer */
+	char *malloc();
+	char *realloc();
+
+	if (len <= carrylen) return(SUCCEED);
+	if (len < 2*carrylen) len=2*carrylen;
+	if (len < 1024) len=1024;
+	if (carrylen) newcarry=(unsigned short *)realloc((char *)carry,
+		(unsigned)len*sizeof(unsigned short));
+	else newcarry=(unsigned short *)malloc(
+		(unsigned)len*sizeof(unsigned short));
+	if (!newcarry)
+	{
+		(void)fprintf(stderr,MSG_MALLOC);
+		return(MALLOC_ERR);
+	}
+	carry=newcarry;
+	carrylen=len;
+	return(SUCCEED);
+}
+
 int proccom(buf,len,retbuf,retbuflen)
 unsigned short *buf;	/* the buffer of commands and arguments */
 int len;	/* the length of the buffer */
 unsigned short *retbuf;	/* a buffer for return values */
 int *retbuflen;	/* the length of retbuf */
+{
+	int left;	/* the number of shorts procstream did not use */
+	int retval;	/* the procstream return value */
+
+	int procstream();
+
+	if (!len && carried)
+	{ /* an incomplete command was sent! */
+		carried=0;
+		return(INCCOM);
+	}
+	if (carried)
+	{ /* There's some data left over from the old command */
+		if (retval=carryroom(carried+len)) return(retval);
+		(void)memcpy((char *)(carry+carried),(char *)buf,
+			len*sizeof(short));
+		len += carried;
+		buf=carry;
+		carried=0;
+	}
+	retval=procstream(buf,len,retbuf,retbuflen,&left);
+	if (left)
+	{ /* save the incomplete command for the next call */
+		if (buf == carry)
+			(void)memmove((char *)carry,(char *)(buf+len-left),
+				left*sizeof(short));
+		else {
+			if (retval=carryroom(left)) return(retval);
+			(void)memcpy((char *)carry,(char *)(buf+len-left),
+				left*sizeof(short));
+		}
+		carried=left;
+	}
+	return(retval);
+}
+
+/* The procstream routine does the work for proccom.  It parses buf in */
+/* place and, if the last command is incomplete, leaves it at the end of */
+/* buf and returns its length in *left instead of saving a copy.  Return */
+/* values are as for proccom. */
+
+int procstream(buf,len,retbuf,retbuflen,left)
+unsigned short *buf;	/* the buffer of commands and arguments */
+int len;	/* the length of the buffer */
+unsigned short *retbuf;	/* a buffer for return values */
+int *retbuflen;	/* the length of retbuf */
+int *left;	/* returns the number of shorts not yet used */
 {
 	static short bufcont[7];	/* the buffer contents while we're */
 					/* working on things */
@@ -134,10 +221,7 @@ int *retbuflen;	/* the length of retbuf */
 	XPoint *points;	/* for drawing a poly line */
 	int minx,maxx,miny,maxy;	/* minimum and maximum x and y for */
 					/* updating an effected area */
-	static int savedshorts=0;	/* The number of saved shorts */
-	static short *olddata;		/* the saved data */
-	int usedolddata=0;	/* if we use data from a previous call */
-	unsigned short *bothbuf; /* buffer for sum of the two data parts */
+	int savedshorts=0;	/* The number of shorts left for next time */
 		/* dimensions for updating screen */
 	int cminx=lg.width,cmaxx=0,cminy=lg.height,cmaxy=0;
 	Pixmap temppixmap;	/* a pixmap used to transfer from old size to */
@@ -165,37 +249,7 @@ int *retbuflen;	/* the length of retbuf */
 
 	char *malloc();
 
-	if (!len & savedshorts)
-	{ /* an incomplete command was sent! */
-		savedshorts=0;
-		free((char *)olddata);
-		return(INCCOM);
-	}
-	if (savedshorts)
-	{ /* There's some data left over from the old command */
-		usedolddata=1;
-#ifdef lint
-		bothbuf=NULL;
-		if (!(malloc(
-#else
-		if (!(bothbuf=(unsigned short *)malloc(
-#endif
-			(unsigned)(savedshorts+len)*sizeof(unsigned short))))
-		{
-			(void)fprintf(stderr,MSG_MALLOC);
-			return(MALLOC_ERR);
-		}
-		/* first old data */
-		(void)memcpy((char *)bothbuf,(char *)olddata,
-			savedshorts*sizeof(short));
-		/* then new data */
-		(void)memcpy((char *)(bothbuf+savedshorts),(char *)buf,
-			len*sizeof(short));
-		len += savedshorts;
-		buf=bothbuf;
-		free((char *)olddata);
-		savedshorts=0;
-	}
+	*left=0;
 
 	while (len-- > 0)
 	{ /* until there are no more commands to process */
@@ -356,6 +410,7 @@ int *retbuflen;	/* the length of retbuf */
 			{
 				savedshorts=len+2;
 				buf -= 2;
+				break;
 			}
 #ifdef lint
 			points=NULL;
@@ -514,6 +569,7 @@ int *retbuflen;	/* the length of retbuf */
 			{
 				savedshorts=len+2;
 				buf -= 2;
+				break;
 			}
 #ifdef lint
 			if (!malloc((unsigned)i*sizeof(XPoint)))
@@ -1125,24 +1181,8 @@ int *retbuflen;	/* the length of retbuf */
 			len=0;
 			break;
 		}
-		/* do we need to save any values for the next call? */
-		if (savedshorts)
-		{
-			len=0;
-#ifdef lint
-			if (!(malloc(
-#else
-			if (!(olddata=(short *)malloc(
-#endif
-				(unsigned)savedshorts*sizeof(short))))
-			{
-				(void)fprintf(stderr,MSG_MALLOC);
-				return(MALLOC_ERR);
-			}
-			/* copy data */
-			for (i=0 ; i < savedshorts ; ++i) *olddata++ = *buf++;
-			olddata -= savedshorts;
-		}
+		/* the rest is an incomplete command for the next call */
+		if (savedshorts) len=0;
 	}
 
 #ifdef PGDISP
@@ -1156,8 +1196,7 @@ int *retbuflen;	/* the length of retbuf */
 	}
 #endif
 
-	/* if we used old data, free up the buffer */
-	if (usedolddata) free((char *)bothbuf);
+	*left=savedshorts;
 	if (!savedshorts && buflen)
 	{ /* if there's no incomplete command and we need to send a message */
 		for (i=0 ; i < buflen ; ++i) retbuf[i]=bufcont[i];
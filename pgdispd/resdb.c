@@ -34,6 +34,7 @@
 /* 14-Sep-1992	SNS/CIT	Modifications from ARC/HI merged in. */
 /*  4-Nov-1992	SNS/CIT	No longer includes malloc.h */
 /* 16-Nov-1992	SNS/CIT	resetLUTWrap added into resource table. */
+/* 17-Oct-2026		Now handles figdisp.localSocket. */
 
 #ifndef lint
 static char rcsid[]="@(#)$Id$";
@@ -163,6 +164,8 @@ static XrmOptionDescRec fdops[] = {
 {"-sleepTime",	".sleepTime",		XrmoptionSepArg, (char *) NULL},
 {"-forceSquare", ".forceSquare",	XrmoptionNoArg,  (char *) "True"},
 {"-noforceSquare", ".forceSquare",	XrmoptionNoArg,  (char *) "False"},
+{"-localSocket", ".localSocket",	XrmoptionNoArg,  (char *) "True"},
+{"-nolocalSocket", ".localSocket",	XrmoptionNoArg,  (char *) "False"},
 {"-saveColors",	".saveColors",		XrmoptionSepArg, (char *) NULL},
 {"-leaveColors",".leaveColors",		XrmoptionSepArg, (char *) NULL},
 {"-leftToRight", ".line.leftToRight",	XrmoptionNoArg,  (char *) "True"},
@@ -904,6 +907,17 @@ void extractops()
 			res.forcesquare=1;
 	}
 
+	/* see if clients on this host may send their data through a local */
+	/* socket instead of X selections. */
+	res.localsock=1;
+	(void)sprintf(resource, "%s.localSocket", prog);
+	if (XrmGetResource(resdb, resource, "*LocalSocket", strtype, &value)
+	    == True)
+	{
+		if (strncmp(value.addr, "False", (int)value.size) == 0)
+			res.localsock=0;
+	}
+
 	/* now get the number of colors to copy from the default colormap to */
 	/* a private color map.  This is so things like title bars will be */
 	/* the same between both color maps. */
@@ -1019,6 +1033,7 @@ static char *usemsg[]={
 "\t[-visual Vis] [-lgCrosshair] [-nolgCrosshair] [-histogram key]\n",
 "\t[-histogramGeometry WxH] [-plothist] [-noplothist] [-initLUTWrap #]\n",
 "\t[-increaseLUTWrap key] [-decreaseLUTWrap key] [-box key] [-mouseMode key]\n",
+"\t[-localSocket] [-nolocalSocket]\n",
 "",
 };
 void Usage(prog)
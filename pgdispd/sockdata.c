@@ -0,0 +1,256 @@
+/* The routines in this file handle the local data socket.  A client on the */
+/* same host as the display server may send its command buffers through */
+/* this socket instead of through X selection properties.  The X selection */
+/* is still used to lock the server, to start and end a session, and to */
+/* return replies, so only the bulk data changes path.  The server window */
+/* carries a NAME_SOCKATOM property holding "host:path" so that a client */
+/* can tell whether the socket is reachable from where it runs. */
+
+/* Created: 17-Oct-2026 */
+/* 18-Oct-2026		Bind the socket inside a private directory made */
+/*			by mkdtemp(). */
+
+/* The system include files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#ifndef VMS
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#endif
+
+/* The X Window include files */
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+
+/* The program include files */
+#include "commands.h"
+#include "figdisp.h"
+#include "globals.h"
+#include "messages.h"
+
+#ifndef VMS
+static char sockdir[32];		/* the directory holding the socket */
+static char sockpath[sizeof(((struct sockaddr_un *)0)->sun_path)];
+				/* the path the socket is bound to */
+static unsigned short *sbuf;	/* the buffer data are read into */
+static int sbuflen=0;		/* the size of sbuf in bytes */
+static int sbufused=0;		/* the number of bytes in sbuf */
+#endif
+
+/* The initsock routine creates the local socket and advertises it on the */
+/* line graphics window.  The socket is bound inside a new directory that */
+/* mkdtemp() creates with mode 0700, so no other user can reach it and no */
+/* existing file is ever replaced.  Failure is not fatal: clients then */
+/* fall back to X selections. */
+/* Return Value: */
+/* SUCCEED	Always */
+
+int initsock()
+{
+#ifndef VMS
+	struct sockaddr_un addr;	/* the socket address */
+	char name[256+sizeof(sockpath)+1];	/* atom name, then the */
+					/* property value */
+	Atom sockatom;			/* the atom of the property */
+	int len;
+
+	void closesock();
+
+	if (!res.localsock) return(SUCCEED);
+
+	(void)sprintf(sockdir, "/tmp/.%s-XXXXXX", NAME_PROG);
+	if (mkdtemp(sockdir) == NULL)
+	{
+		(void)fprintf(stderr, MSG_NOSOCKET);
+		sockdir[0]='\0';
+		return(SUCCEED);
+	}
+	(void)sprintf(sockpath, "%s/sock", sockdir);
+	(void)memset((char *)&addr, 0, sizeof(addr));
+	addr.sun_family=AF_UNIX;
+	(void)strcpy(addr.sun_path, sockpath);
+	if ((sockfd=socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+	    bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(sockfd, 1) < 0)
+	{
+		(void)fprintf(stderr, MSG_NOSOCKET);
+		closesock();
+		return(SUCCEED);
+	}
+	/* waitevent only polls this, so never let accept block */
+	(void)fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFL, 0) | O_NONBLOCK);
+
+	(void)sprintf(name, "%s_%d_%d", NAME_SOCKATOM, screen, res.id);
+	if ((sockatom=XInternAtom(display, name, False)) == None)
+	{
+		closesock();
+		return(SUCCEED);
+	}
+	if (gethostname(name, 256) < 0)
+		name[0]='\0';
+	name[255]='\0';
+	len=strlen(name);
+	name[len++]=':';
+	(void)strcpy(name+len, sockpath);
+	XChangeProperty(display, lg.win, sockatom, XA_STRING, 8,
+		PropModeReplace, (unsigned char *)name, (int)strlen(name));
+#endif
+	return(SUCCEED);
+}
+
+/* The closedata routine drops the current data connection, if any. */
+
+void closedata()
+{
+#ifndef VMS
+	if (datafd >= 0)
+	{
+		(void)close(datafd);
+		datafd= -1;
+	}
+	sbufused=0;
+#endif
+	return;
+}
+
+/* The closesock routine shuts down the local socket and removes it, */
+/* together with the directory initsock made for it. */
+
+void closesock()
+{
+#ifndef VMS
+	closedata();
+	if (sockfd >= 0)
+	{
+		(void)close(sockfd);
+		sockfd= -1;
+	}
+	if (sockpath[0]) (void)unlink(sockpath);
+	if (sockdir[0]) (void)rmdir(sockdir);
+	sockpath[0]='\0';
+	sockdir[0]='\0';
+#endif
+	return;
+}
+
+/* The getsockdata routine reads whatever is waiting on the data */
+/* connection, accepting a pending connection first if there is none, and */
+/* hands it to procstream without copying it.  Only the incomplete command */
+/* at the end of a read, if any, is moved to the front of the buffer.  If */
+/* block is true it keeps reading until the client closes the connection; */
+/* getdata uses this so that all socket data are handled before the end of */
+/* the session. */
+/* Return Value: */
+/* 1	If everything went fine */
+/* 0	If something happened and the connection was dropped */
+
+int getsockdata(rbuf,rbuflen,block)
+short *rbuf;	/* a return buffer, if needed */
+int *rbuflen;	/* the length of the return buffer */
+int block;	/* true to read until the client closes the connection */
+{
+#ifndef VMS
+	int nread;	/* the number of bytes just read */
+	int nshort;	/* the number of complete shorts in sbuf */
+	int left;	/* the number of shorts procstream did not use */
+	unsigned short *newbuf;	/* for growing sbuf */
+	fd_set fds;	/* for polling the listening socket */
+	struct timeval timeout;
+
+	char *malloc();
+	char *realloc();
+	void returnbuf();
+	int procstream();
+
+	if (datafd < 0)
+	{
+		if (sockfd < 0) return(1);
+		if (block)
+		{ /* a connect precedes the end message, so never wait here */
+			FD_ZERO(&fds);
+			FD_SET(sockfd, &fds);
+			timeout.tv_sec=0;
+			timeout.tv_usec=0;
+			if (select(sockfd+1, &fds, (fd_set *)NULL,
+				(fd_set *)NULL, &timeout) <= 0) return(1);
+		}
+		if ((datafd=accept(sockfd, (struct sockaddr *)NULL,
+			(socklen_t *)NULL)) < 0)
+		{
+			datafd= -1;
+			return(1);
+		}
+		/* the listening socket is non-blocking; this one must not be */
+		(void)fcntl(datafd, F_SETFL,
+			fcntl(datafd, F_GETFL, 0) & ~O_NONBLOCK);
+		if (!block) return(1);
+	}
+
+	do {
+		/* a single command may be larger than the buffer */
+		if (sbufused == sbuflen)
+		{
+			if (sbuflen) newbuf=(unsigned short *)realloc(
+				(char *)sbuf, (unsigned)sbuflen*2);
+			else newbuf=(unsigned short *)malloc(
+				(unsigned)XMaxRequestSize(display)*4);
+			if (!newbuf)
+			{
+				(void)fprintf(stderr,MSG_MALLOC);
+				closedata();
+				return(0);
+			}
+			sbuflen= sbuflen ? sbuflen*2 : XMaxRequestSize(display)*4;
+			sbuf=newbuf;
+		}
+		if ((nread=read(datafd, (char *)sbuf+sbufused,
+			sbuflen-sbufused)) < 0)
+		{
+			if (errno == EINTR) continue;
+			(void)fprintf(stderr,MSG_SOCKREAD);
+			closedata();
+			return(0);
+		}
+		if (!nread)
+		{ /* the client has finished with the connection */
+			if (sbufused)
+				(void)fprintf(stderr,
+					"Incomplete command on data socket!\n");
+			closedata();
+			break;
+		}
+		sbufused += nread;
+		nshort=sbufused>>1;
+		if (procstream(sbuf,nshort,rbuf,rbuflen,&left))
+		{
+			closedata();
+			return(0);
+		}
+		/* keep the incomplete command, if any, for the next read */
+		if (left < nshort)
+		{
+			sbufused -= (nshort-left)<<1;
+			(void)memmove((char *)sbuf, (char *)(sbuf+nshort-left),
+				sbufused);
+		}
+
+		/* send requested information back to the client */
+		if (*rbuflen && ntohs(*rbuf) != LG_CURS &&
+		    ntohs(*rbuf) != BM_GET_CURS)
+		{
+			returnbuf(rbuf,*rbuflen,srcwin);
+			*rbuflen=0;
+		}
+	} while (block);
+#endif
+	return(1);
+}
@@ -24,6 +24,10 @@
 /* 30-Jan-1992	SNS/CIT	Now uses the XEventsQueued call to determine if an */
 /*			event is pending.  This means we don't have to push */
 /*			events back on the list. */
+/* 17-Oct-2026		Now also waits on the local data socket and hands */
+/*			its data to handlesock.  The client check is skipped */
+/*			while data are arriving, since the client is plainly */
+/*			still there. */
 
 /*
  * On AIX systems we need to define _BSD before including sys/types.h,
@@ -78,13 +82,19 @@ int waitevent()
 #endif
 #ifdef SELECT
 	struct timeval timeout;
+	fd_set fds;	/* the descriptors to wait on */
+	int xfd;	/* the X connection */
+	int maxfd;	/* the largest descriptor in fds */
 #endif
+	int busy=0;	/* if we just handled socket data */
+
+	void closedata();
 
 	while (!XEventsQueued(display,QueuedAlready))
 	{
 		XFlush(display);
 		/* if the selection is not owned we need to grab it again */
-		if (XGetSelectionOwner(display,selatom) == None)
+		if (!busy && XGetSelectionOwner(display,selatom) == None)
 		{
 			XSetSelectionOwner(display,selatom,lg.win,CurrentTime);
 			if (XGetSelectionOwner(display,selatom) != lg.win)
@@ -93,9 +103,11 @@ int waitevent()
 				return(-1);
 			}
 			XUngrabKeyboard(display,CurrentTime);
+			closedata();
 			(void)proccom((short *)NULL,0,(short *)NULL,(int *)0);
 			return(0);	/* the selection owner was reset */
 		}
+		busy=0;
 		/* give the idle message if the user's asked for it */
 		if (sendidle)
 		{
@@ -113,8 +125,35 @@ int waitevent()
 #ifdef SELECT
 		timeout.tv_sec = 0;
 		timeout.tv_usec = res.sleeptime;
-		select (0, (fd_set *)NULL, (fd_set *)NULL, (fd_set *)NULL,
-			&timeout);
+		if (sockfd < 0)
+		{
+			select (0, (fd_set *)NULL, (fd_set *)NULL,
+				(fd_set *)NULL, &timeout);
+			continue;
+		}
+		/* wake up for X events as well as socket data */
+		FD_ZERO(&fds);
+		xfd = ConnectionNumber(display);
+		FD_SET(xfd, &fds);
+		maxfd = xfd;
+		if (datafd >= 0)
+		{
+			FD_SET(datafd, &fds);
+			if (datafd > maxfd) maxfd = datafd;
+		} else {
+			FD_SET(sockfd, &fds);
+			if (sockfd > maxfd) maxfd = sockfd;
+		}
+		if (select (maxfd+1, &fds, (fd_set *)NULL, (fd_set *)NULL,
+			&timeout) <= 0) continue;
+		if (datafd >= 0 && FD_ISSET(datafd, &fds) ||
+		    datafd < 0 && FD_ISSET(sockfd, &fds))
+		{
+			(void)handlesock();
+			busy=1;
+		}
+		if (FD_ISSET(xfd, &fds))
+			(void)XEventsQueued(display,QueuedAfterReading);
 #endif
 	}
 
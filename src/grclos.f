@@ -19,6 +19,7 @@ C  5-Aug-1986 - add GREXEC support [AFT].
 C 21-Feb-1987 - modify END_PICTURE sequence [AFT].
 C 11-Jun-1987 - remove built-ins [TJP].
 C 31-Aug-1987 - do not eject blank page [TJP].
+C 17-Oct-2026 - update GRFREE.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
       REAL    RBUF(6)
@@ -46,6 +47,7 @@ C This plot identifier is no longer in use.
 C Set state to "workstation closed".
 C
       GRSTAT(GRCIDE) = 0
+      GRFREE = MIN(GRFREE, GRCIDE)
       GRCIDE = 0
 C
 C Close workstation.
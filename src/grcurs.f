@@ -92,6 +92,7 @@ C         -- position cursor?
           RBUF(6) = POSN
           NBUF = 6
           LCHR = 0
+          CALL GRLIN4
           CALL GREXEC(GRGTYP,17,RBUF,NBUF,CHR,LCHR)
           IX = RBUF(1)
           IY = RBUF(2)
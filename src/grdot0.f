@@ -46,6 +46,7 @@ C
           RBUF(1)=X
           RBUF(2)=Y
           NBUF=2
+          CALL GRLIN4
           CALL GREXEC(GRGTYP,13,RBUF,NBUF,CHR,LCHR)
       END IF
       END
@@ -23,6 +23,7 @@ C
 C Begin picture if necessary.
 C
       IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+      CALL GRLIN4
 C
 C Loop for points: driver support.
 C
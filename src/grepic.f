@@ -22,6 +22,7 @@ C
       IF (GRPLTD(GRCIDE)) THEN
             RBUF(1) = 1.
             NBUF = 1
+            CALL GRLIN4
             CALL GREXEC(GRGTYP,14,RBUF,NBUF,CHR,LCHR)
       END IF
       GRPLTD(GRCIDE) = .FALSE.
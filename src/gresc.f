@@ -25,6 +25,7 @@ C If no device is currently selected, do nothing.
 C
       IF (GRCIDE.GT.0) THEN
           IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+          CALL GRLIN4
           NBUF = 0
           CALL GREXEC(GRGTYP,23,RBUF,NBUF,TEXT,LEN(TEXT))
       END IF
@@ -19,9 +19,7 @@ C point is within the polygon; otherwise it is outside. If the
 C straight line passes a polygon vertex tangentially, the
 C intersection  count is not affected. The only attribute which applies
 C to FILL AREA is color index: line-width and line-style are ignored.
-C There is a limitation on the complexity of the polygon: GFA will
-C fail if any horizontal line intersects more than 32 edges of the
-C polygon.
+C There is no limit on the complexity of the polygon.
 C
 C Arguments:
 C
@@ -41,15 +39,16 @@ C               [S.C.Allendorf/TJP].
 C  4-Dec-1995 - remove use of real variable as do-loop variable [TJP].
 C 20-Mar-1996 - use another do loop 40 to avoid gaps between adjacent
 C               polygons [RS]
+C 17-Oct-2026 - use the scan converter GRFAS0/GRFAS1, which has no
+C               limit on the number of intersections.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
       INTEGER MAXSEC
-      PARAMETER (MAXSEC=32)
-      INTEGER I, J, NSECT, LW, LS, NBUF, LCHR, LINE
-      REAL    RBUF(6)
+      PARAMETER (MAXSEC=256)
+      INTEGER I, NSECT, LW, LS, NBUF, LCHR, LINE, L1, L2, IER
+      REAL    RBUF(6), TR(6)
       CHARACTER*32 CHR
-      REAL    X(MAXSEC), Y, YMIN, YMAX, DY, YD, TEMP, S1, S2, T1, T2
-      LOGICAL FORWD
+      REAL    X(MAXSEC), Y, YMIN, YMAX, DY, YD
 C
       IF (GRCIDE.LT.1) RETURN
       IF (N.LT.3) THEN
@@ -61,6 +60,7 @@ C Devices with polygon fill capability.
 C
       IF(GRGCAP(GRCIDE)(4:4).EQ.'A') THEN
          IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+         CALL GRLIN4
          RBUF(1) = N
          CALL GREXEC(GRGTYP,20,RBUF,NBUF,CHR,LCHR)
          DO 10 I=1,N
@@ -92,60 +92,34 @@ C
       CALL GREXEC(GRGTYP, 3,RBUF,NBUF,CHR,LCHR)
       DY = ABS(RBUF(3))
 C
-C Find intersections of edges with current raster line.
-C
-      FORWD = .TRUE.
-      S1 = PX(N)*GRXSCL(GRCIDE) + GRXORG(GRCIDE)
-      T1 = PY(N)*GRYSCL(GRCIDE) + GRYORG(GRCIDE)
-C
-      DO 40 LINE = NINT(YMIN/DY),NINT(YMAX/DY)
-         Y = LINE * DY
-         NSECT = 0
-         DO 30 I=1,N
-            S2 = PX(I)*GRXSCL(GRCIDE) + GRXORG(GRCIDE)
-            T2 = PY(I)*GRYSCL(GRCIDE) + GRYORG(GRCIDE)
-            IF ((T1.LT.Y .AND. Y.LE.T2).OR.
-     :          (T1.GE.Y .AND. Y.GT.T2)) THEN
-               NSECT = NSECT+1
-               IF (NSECT.GT.MAXSEC) THEN
-                  CALL GRWARN('GRFA - polygon is too complex.')
-                  RETURN
-               END IF
-               X(NSECT)=(S1+(S2-S1)*((Y-T1)/(T2-T1)))
-            END IF
-            S1 = S2
-            T1 = T2
- 30      CONTINUE
-C
-C Sort the intersections into increasing x order.
-C
-         DO 34 I=2,NSECT
-            DO 32 J=1,I
-               IF (X(J).GT.X(I)) THEN
-                  TEMP = X(J)
-                  X(J) = X(I)
-                  X(I) = TEMP
-               END IF
- 32         CONTINUE
- 34      CONTINUE
-C
-C Draw the horizontal line-segments.
-C
-         GRYPRE(GRCIDE) = Y
-         IF (FORWD) THEN
+C Find the spans of each raster line that are inside the polygon, and
+C draw them. Alternate lines are returned in opposite directions.
+C
+      TR(1) = GRXORG(GRCIDE)
+      TR(2) = GRXSCL(GRCIDE)
+      TR(3) = 0.0
+      TR(4) = GRYORG(GRCIDE)
+      TR(5) = 0.0
+      TR(6) = GRYSCL(GRCIDE)
+      L1 = NINT(YMIN/DY)
+      L2 = NINT(YMAX/DY)
+      CALL GRFAS0(N, PX, PY, TR, DY, L1, L2, IER)
+      IF (IER.NE.0) THEN
+         CALL GRWARN('GRFA - not enough memory.')
+      ELSE
+C        -- DO WHILE (NSECT.GT.0)
+   30    CALL GRFAS1(LINE, X, MAXSEC, NSECT)
+         IF (NSECT.GT.0) THEN
+            Y = LINE * DY
+            GRYPRE(GRCIDE) = Y
             DO 36 I=1,NSECT-1,2
                GRXPRE(GRCIDE) = X(I)
                CALL GRLIN0(X(I+1),Y)
- 36         CONTINUE
-            FORWD = .FALSE.
-         ELSE
-            DO 38 I=NSECT,2,-2
-               GRXPRE(GRCIDE) = X(I)
-               CALL GRLIN0(X(I-1),Y)
- 38         CONTINUE
-            FORWD = .TRUE.
+   36       CONTINUE
+            GOTO 30
          END IF
- 40   CONTINUE
+C        -- end DO WHILE
+      END IF
 C
 C Restore attributes.
 C
@@ -45,6 +45,7 @@ C
 C Send setup info to driver.
 C
       IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+      CALL GRLIN4
       CALL GRTERM
       NBUF = 13
       LCHR = 0
@@ -10,15 +10,26 @@ C
 C (This routine is called by GRIMG0.)
 C--
 C 7-Sep-1994  New routine [TJP].
+C 17-Oct-2026 Rows wider than the buffer are sent in several pieces
+C             instead of being truncated; the intensity mapping is
+C             done a buffer at a time by GRIMG4.
+C 17-Oct-2026 Send integer color indices (GRPXIR) if the device
+C             accepts them.
+C 18-Oct-2026 Buffer a whole row (up to NSIZE pixels) and map it
+C             straight to integer color indices.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
-      INTEGER  I,IV,IX,IX1,IX2,IY,IY1,IY2,J, NPIX, LCHR
-      REAL     DEN, AV, SFAC, SFACL
+      INTEGER  NSIZE
+      PARAMETER (NSIZE=16384)
+      INTEGER  I,IX,IX1,IX2,IY,IY1,IY2,J,K, NPIX, LCHR
+      INTEGER  IBUF(NSIZE)
+      LOGICAL  INTIDX
+      REAL     DEN
       REAL     XXAA,XXBB,YYAA,YYBB,XYAA,XYBB,YXAA,YXBB,XYAAIY,YXAAIY
-      REAL     BUFFER(1026)
+      REAL     BUFFER(NSIZE+2)
       CHARACTER*1 CHR
-      INTRINSIC NINT, LOG
-      PARAMETER (SFAC=65000.0)
+      INTRINSIC NINT
+      SAVE     IBUF, BUFFER
 C-----------------------------------------------------------------------
 C
 C Location of current window in device coordinates.
@@ -43,14 +54,28 @@ C
 C Start a new page if necessary.
 C
       IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+      CALL GRLIN4
+      INTIDX = GRGCAP(GRCIDE)(13:13).EQ.'I'
 C
 C Run through every device pixel (IX, IY) in the current window and
-C determine which array pixel (I,J) it falls in.
+C determine which array pixel (I,J) it falls in. The pixels that fall
+C inside the array form a single run on each row; their values are
+C collected in BUFFER, converted to color indices in IBUF by GRIMG4,
+C and the run is sent to the device in one call. Only a run longer
+C than NSIZE pixels is sent in pieces, each piece starting where the
+C previous one ended.
 C
-      SFACL = LOG(1.0+SFAC)
       DO 120 IY=IY1,IY2
           XYAAIY = XXAA-XYAA-XYBB*IY
           YXAAIY = YYAA+YYBB*IY-YXAA
+C
+C         -- if the image is not rotated, J is the same for the whole
+C            row and rows outside the array can be skipped.
+C
+          IF (YXBB.EQ.0.0) THEN
+              J = NINT(YXAAIY)
+              IF (J.LT.J1.OR.J.GT.J2) GOTO 120
+          END IF
           NPIX = 0
           BUFFER(2) = IY
           DO 110 IX=IX1,IX2
@@ -58,36 +83,37 @@ C
             IF (I.LT.I1.OR.I.GT.I2) GOTO 110
             J = NINT(YXAAIY-YXBB*IX)
             IF (J.LT.J1.OR.J.GT.J2) GOTO 110
-C
-C           -- determine color index IV of this pixel
-C
-            AV = A(I,J)
-            IF (A2.GT.A1) THEN
-                AV = MIN(A2, MAX(A1,AV))
-            ELSE
-                AV = MIN(A1, MAX(A2,AV))
-            END IF
-            IF (MODE.EQ.0) THEN
-                IV = NINT((MININD*(A2-AV) + MAXIND*(AV-A1))/(A2-A1))
-            ELSE IF (MODE.EQ.1) THEN
-                IV = MININD + NINT((MAXIND-MININD)*
-     :               LOG(1.0+SFAC*ABS((AV-A1)/(A2-A1)))/SFACL)
-            ELSE IF (MODE.EQ.2) THEN
-                IV = MININD + NINT((MAXIND-MININD)*
-     :                             SQRT(ABS((AV-A1)/(A2-A1))))
-            ELSE
-                IV = MININD
-            END IF
-C
-            IF (NPIX.LE.1024) THEN
-C               -- drop pixels if buffer too small (to be fixed!)
-                NPIX = NPIX+1
-                IF (NPIX.EQ.1) BUFFER(1) = IX
-                BUFFER(NPIX+2) = IV
+            NPIX = NPIX+1
+            IF (NPIX.EQ.1) BUFFER(1) = IX
+            BUFFER(NPIX+2) = A(I,J)
+            IF (NPIX.EQ.NSIZE) THEN
+                CALL GRIMG4(NPIX, BUFFER(3), IBUF, A1, A2, MININD,
+     :                      MAXIND, MODE)
+                IF (INTIDX) THEN
+                    CALL GRPXIR(BUFFER(1), BUFFER(2), 1.0, NPIX, IBUF,
+     :                          MININD, MAXIND)
+                ELSE
+                    DO 105 K=1,NPIX
+                        BUFFER(K+2) = IBUF(K)
+  105               CONTINUE
+                    CALL GREXEC(GRGTYP, 26, BUFFER, NPIX+2, CHR, LCHR)
+                END IF
+                NPIX = 0
             END IF
   110     CONTINUE
-          IF (NPIX.GT.0) CALL 
-     :                   GREXEC(GRGTYP, 26, BUFFER, NPIX+2, CHR, LCHR)
+          IF (NPIX.GT.0) THEN
+              CALL GRIMG4(NPIX, BUFFER(3), IBUF, A1, A2, MININD,
+     :                    MAXIND, MODE)
+              IF (INTIDX) THEN
+                  CALL GRPXIR(BUFFER(1), BUFFER(2), 1.0, NPIX, IBUF,
+     :                        MININD, MAXIND)
+              ELSE
+                  DO 115 K=1,NPIX
+                      BUFFER(K+2) = IBUF(K)
+  115             CONTINUE
+                  CALL GREXEC(GRGTYP, 26, BUFFER, NPIX+2, CHR, LCHR)
+              END IF
+          END IF
   120 CONTINUE
 C-----------------------------------------------------------------------
       END
@@ -0,0 +1,65 @@
+C*GRIMG4 -- convert a run of array values to color indices
+C+
+      SUBROUTINE GRIMG4 (N, BUF, ICOL, A1, A2, MININD, MAXIND, MODE)
+      INTEGER N, ICOL(N), MININD, MAXIND, MODE
+      REAL    BUF(N), A1, A2
+C
+C Find the color index that each array value in BUF maps to. The
+C mapping is the same as that used by GRIMG1: values are clamped to
+C the range A1..A2 and then mapped linearly (MODE=0), logarithmically
+C (MODE=1) or by square root (MODE=2) onto MININD..MAXIND. The test on
+C MODE is made once per call rather than once per pixel so that the
+C inner loops are simple enough for the compiler to vectorize.
+C
+C (This routine is called by GRIMG2.)
+C
+C Arguments:
+C  N      (input)  : number of values in BUF.
+C  BUF    (input)  : array values.
+C  ICOL   (output) : color indices.
+C  A1, A2 (input)  : the array values which are to appear with
+C                    color indices MININD and MAXIND.
+C  MININD, MAXIND (input) : range of color indices.
+C  MODE   (input)  : transfer function.
+C--
+C 17-Oct-2026 - new routine, split out of GRIMG2.
+C 18-Oct-2026 - return the color indices as INTEGERs in ICOL.
+C-----------------------------------------------------------------------
+      INTEGER  K, NCOL
+      REAL     AV, AMIN, AMAX, SFAC, SFACL
+      INTRINSIC NINT, LOG, SQRT, ABS, MIN, MAX
+      PARAMETER (SFAC=65000.0)
+C-----------------------------------------------------------------------
+      IF (A2.GT.A1) THEN
+          AMIN = A1
+          AMAX = A2
+      ELSE
+          AMIN = A2
+          AMAX = A1
+      END IF
+      NCOL = MAXIND-MININD
+C
+      IF (MODE.EQ.0) THEN
+          DO 10 K=1,N
+              AV = MIN(AMAX, MAX(AMIN,BUF(K)))
+              ICOL(K) = NINT((MININD*(A2-AV) + MAXIND*(AV-A1))/(A2-A1))
+   10     CONTINUE
+      ELSE IF (MODE.EQ.1) THEN
+          SFACL = LOG(1.0+SFAC)
+          DO 20 K=1,N
+              AV = MIN(AMAX, MAX(AMIN,BUF(K)))
+              ICOL(K) = MININD + NINT(NCOL*
+     :                 LOG(1.0+SFAC*ABS((AV-A1)/(A2-A1)))/SFACL)
+   20     CONTINUE
+      ELSE IF (MODE.EQ.2) THEN
+          DO 30 K=1,N
+              AV = MIN(AMAX, MAX(AMIN,BUF(K)))
+              ICOL(K) = MININD + NINT(NCOL*SQRT(ABS((AV-A1)/(A2-A1))))
+   30     CONTINUE
+      ELSE
+          DO 40 K=1,N
+              ICOL(K) = MININD
+   40     CONTINUE
+      END IF
+C-----------------------------------------------------------------------
+      END
@@ -6,6 +6,8 @@ C Initialize GRPCKG and read font file. Called by GROPEN, but may be
 C called explicitly if needed.
 C--
 C 29-Apr-1996 - new routine [TJP].
+C 17-Oct-2026 - empty the polyline buffer.
+C 17-Oct-2026 - initialize GRFREE.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
       INTEGER   I
@@ -17,6 +19,8 @@ C
          DO 10 I=1,GRIMAX
             GRSTAT(I) = 0
  10      CONTINUE
+         GRFREE = 1
+         GRPLN = 0
          CALL GRSY00
          INIT = .FALSE.
       END IF
@@ -7,14 +7,17 @@ C--
 C (3-Mar-1983)
 C 19-Jan-1988 - remove unused label [TJP].
 C  9-Sep-1989 - standardize [TJP].
+C 17-Oct-2026 - take the layout of the string from the cache (GRTXC0);
+C               remove the limit of 256 characters.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
-      LOGICAL UNUSED
-      INTEGER XYGRID(300)
-      INTEGER LIST(256)
+      INTEGER MAXE
+      PARAMETER (MAXE=256)
+      INTEGER KIND(MAXE)
       CHARACTER*(*) STRING
-      REAL FACTOR, COSA, SINA, DX, D, RATIO, FNTBAS, FNTFAC
-      INTEGER I, IFNTLV, LX, NLIST
+      REAL FACTOR, COSA, SINA, DX, D, RATIO, FNTFAC
+      REAL A(MAXE), B(MAXE), BOX(4)
+      INTEGER I, IFNTLV, K, N, IPLOT, IER
       INTRINSIC ABS, LEN
 C
       D = 0.0
@@ -26,34 +29,36 @@ C-----------------------------------------------------------------------
       RATIO = GRPXPI(GRCIDE)/GRPYPI(GRCIDE)
       COSA = FACTOR
       SINA = 0.0
-      FNTBAS = 0.0
       FNTFAC = 1.0
       IFNTLV = 0
 C
-C               Convert string to symbol numbers:
-C               \u and \d escape sequences are converted to -1,-2
+C               Get the layout of the string (see GRTXC0):
+C               \u and \d escape sequences are entries -1,-2,
+C               and the width of each symbol is in an entry 0
 C
-      CALL GRSYDS(LIST,NLIST,STRING,GRCFNT(GRCIDE))
+      CALL GRTXC0(STRING, GRCFNT(GRCIDE), BOX, IPLOT, IER)
+      IF (IER.NE.0) THEN
+          CALL GRWARN('GRLEN - not enough memory.')
+          RETURN
+      END IF
 C
-C               Plot the string of characters
+C               Add up the widths of the characters
 C
-      DO 380 I = 1,NLIST
-          IF (LIST(I).LT.0) THEN
-              IF (LIST(I).EQ.-1) THEN
-                  IFNTLV = IFNTLV+1
-                  FNTBAS = FNTBAS + 16.0*FNTFAC
-                  FNTFAC = 0.6**ABS(IFNTLV)
-              ELSE IF (LIST(I).EQ.-2) THEN
-                  IFNTLV = IFNTLV-1
-                  FNTFAC = 0.6**ABS(IFNTLV)
-                  FNTBAS = FNTBAS - 16.0*FNTFAC
-              END IF
-              GOTO 380
+      K = 0
+  300 CALL GRTXC1(K, MAXE, KIND, A, B, N)
+      DO 380 I = 1,N
+          IF (KIND(I).EQ.-1) THEN
+              IFNTLV = IFNTLV+1
+              FNTFAC = 0.6**ABS(IFNTLV)
+          ELSE IF (KIND(I).EQ.-2) THEN
+              IFNTLV = IFNTLV-1
+              FNTFAC = 0.6**ABS(IFNTLV)
+          ELSE IF (KIND(I).EQ.0) THEN
+              DX = COSA*A(I)*RATIO
+              D = D + DX*FNTFAC
           END IF
-          CALL GRSYXD(LIST(I),XYGRID,UNUSED)
-          LX = XYGRID(5)-XYGRID(4)
-          DX = COSA*LX*RATIO
-          D = D + DX*FNTFAC
   380 CONTINUE
+      K = K+N
+      IF (N.GT.0) GOTO 300
 C
       END
@@ -8,12 +8,18 @@ C to the nearest integer and passed to the appropriate device-specific
 C routine. It is assumed that the entire line-segment lies within the
 C view surface, and that the physical device coordinates are
 C non-negative.
+C
+C If the device accepts whole polylines (capability 12 = 'L'), the
+C segment is instead added to the polyline buffer: it extends the
+C buffered polyline if it starts where that ends, otherwise the buffer
+C is sent to the device (GRLIN4) and a new polyline is started.
 C--
 C (1-Jun-1984)
 C 19-Oct-1984 - rewritten for speed [TJP].
 C 29-Jan-1985 - add HP2648 device [KS/TJP].
 C  5-Aug-1986 - add GREXEC support [AFT].
 C 21-Feb-1987 - If needed, calls begin picture [AFT].
+C 17-Oct-2026 - buffer polylines for devices with capability 'L'.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
       REAL    X0,Y0,X1,Y1
@@ -25,6 +31,24 @@ C- If this is first thing plotted then set something plotted flag
 C- and for a GREXEC device call BEGIN_PICTURE.
 C
       IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+C---
+      IF (GRGCAP(GRCIDE)(12:12).EQ.'L') THEN
+         IF (GRPLN.GT.0) THEN
+            IF (GRPLID.NE.GRCIDE .OR. GRPLN.GE.GRPLMX .OR.
+     1          X0.NE.GRPLBF(2*GRPLN-1) .OR.
+     2          Y0.NE.GRPLBF(2*GRPLN)) CALL GRLIN4
+         END IF
+         IF (GRPLN.EQ.0) THEN
+            GRPLID = GRCIDE
+            GRPLBF(1) = X0
+            GRPLBF(2) = Y0
+            GRPLN = 1
+         END IF
+         GRPLN = GRPLN+1
+         GRPLBF(2*GRPLN-1) = X1
+         GRPLBF(2*GRPLN) = Y1
+         RETURN
+      END IF
 C---
       RBUF(1)=X0
       RBUF(2)=Y0
@@ -0,0 +1,26 @@
+C*GRLIN4 -- send buffered polyline to device
+C+
+      SUBROUTINE GRLIN4
+C
+C GRPCKG (internal routine): if GRLIN2 has buffered a polyline for a
+C device that accepts whole polylines, send it to the device (opcode
+C 31) and empty the buffer. This must be done before anything else is
+C sent to the device that could change or depend on what has been
+C drawn, and before another device is selected or opened.
+C
+C Arguments: none.
+C--
+C 17-Oct-2026 - new routine.
+C-----------------------------------------------------------------------
+      INCLUDE 'grpckg1.inc'
+      INTEGER NBUF, LCHR
+      CHARACTER CHR
+C
+      IF (GRPLN.LT.2) THEN
+         GRPLN = 0
+         RETURN
+      END IF
+      NBUF = 2*GRPLN
+      GRPLN = 0
+      CALL GREXEC(GRTYPE(GRPLID),31,GRPLBF,NBUF,CHR,LCHR)
+      END
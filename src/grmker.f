@@ -32,22 +32,40 @@ C 12-Jun-1992 - [TJP]
 C 22-Sep-1992 - add support for hardware markers [TJP].
 C  1-Sep-1994 - suppress driver call [TJP].
 C 15-Feb-1994 - fix bug (expanding viewport!) [TJP].
+C 17-Oct-2026 - keep the symbol scaled to device offsets from one call
+C               to the next; send markers that lie wholly on the view
+C               surface in batches to devices that accept opcode 33
+C               (capability 14 = 'P').
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
+      INTEGER  MAXPT, MAXBUF
+      PARAMETER (MAXPT=150, MAXBUF=1024)
       INTEGER  SYMBOL
       INTEGER  C 
-      LOGICAL  ABSXY, UNUSED, VISBLE
-      INTEGER  I, K, LSTYLE, LX, LY, LXLAST, LYLAST, N, SYMNUM, NV
+      LOGICAL  ABSXY, UNUSED, VISBLE, BATCH
+      INTEGER  I, J, K, L, LSTYLE, LX, LY, LXLAST, LYLAST, N, SYMNUM, NV
       INTEGER  XYGRID(300)
       REAL     ANGLE, COSA, SINA, FACTOR, RATIO, X(*), Y(*)
-      REAL     XCUR, YCUR, XORG, YORG
+      REAL     XORG, YORG
       REAL     THETA, XOFF(40), YOFF(40), XP(40), YP(40)
       REAL     XMIN, XMAX, YMIN, YMAX
       REAL     XMINX, XMAXX, YMINX, YMAXX
-      REAL     RBUF(4)
+      REAL     RBUF(MAXBUF)
       INTEGER  NBUF,LCHR
       CHARACTER*32 CHR
 C
+C The strokes of the last symbol drawn, as offsets (MKX,MKY) in device
+C coordinates from the center of the marker: stroke K has MKN(K)
+C vertices. MKSYM, MKFAC and MKRAT are the symbol number and scale
+C factors they were computed for; MKXMIN...MKYMAX are their extent.
+C
+      INTEGER  MKSYM, MKNS, MKN(MAXPT)
+      REAL     MKX(MAXPT), MKY(MAXPT), MKFAC, MKRAT
+      REAL     MKXMIN, MKXMAX, MKYMIN, MKYMAX
+      SAVE     MKSYM, MKNS, MKN, MKX, MKY, MKFAC, MKRAT
+      SAVE     MKXMIN, MKXMAX, MKYMIN, MKYMAX
+      DATA     MKSYM /-1/
+C
 C Check that there is something to be plotted.
 C
       IF (N.LE.0) RETURN
@@ -73,6 +91,7 @@ C
       IF (GRGCAP(GRCIDE)(10:10).EQ.'M' .AND.
      :     SYMBOL.GE.0 .AND. SYMBOL.LE.31) THEN
           IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+          CALL GRLIN4
 C         -- symbol number
           RBUF(1) = SYMBOL
 C          -- scale factor
@@ -114,7 +133,8 @@ C
       SINA = FACTOR * SIN(ANGLE)
 C
 C Convert the supplied marker number SYMBOL to a symbol number and
-C obtain the digitization.
+C obtain the digitization, scaled to device offsets, unless it is the
+C same as last time.
 C
       IF (SYMBOL.GE.0) THEN
           IF (SYMBOL.GT.127) THEN
@@ -122,41 +142,134 @@ C
           ELSE
               CALL GRSYMK(SYMBOL,GRCFNT(GRCIDE),SYMNUM)
           END IF
-          CALL GRSYXD(SYMNUM, XYGRID, UNUSED)
+          IF (SYMNUM.NE.MKSYM .OR. FACTOR.NE.MKFAC .OR.
+     :        RATIO.NE.MKRAT) THEN
+              CALL GRSYXD(SYMNUM, XYGRID, UNUSED)
+              MKSYM = SYMNUM
+              MKFAC = FACTOR
+              MKRAT = RATIO
+              MKNS = 0
+              J = 0
+              VISBLE = .FALSE.
+              K = 4
+              LXLAST = -64
+              LYLAST = -64
+  300         K = K+2
+                LX = XYGRID(K)
+                LY = XYGRID(K+1)
+                IF (LY.EQ.-64) GOTO 310
+                IF (LX.EQ.-64) THEN
+                    VISBLE = .FALSE.
+                ELSE IF ((.NOT.VISBLE) .OR. (LX.NE.LXLAST) .OR.
+     :                   (LY.NE.LYLAST)) THEN
+                    IF (.NOT.VISBLE) THEN
+C                       -- start a new stroke, replacing the last one
+C                          if it has only one vertex
+                        IF (MKNS.GT.0) THEN
+                            IF (MKN(MKNS).EQ.1) THEN
+                                MKNS = MKNS-1
+                                J = J-1
+                            END IF
+                        END IF
+                        MKNS = MKNS+1
+                        MKN(MKNS) = 0
+                    END IF
+                    J = J+1
+                    MKN(MKNS) = MKN(MKNS)+1
+                    MKX(J) = (COSA*LX - SINA*LY)*RATIO
+                    MKY(J) = (SINA*LX + COSA*LY)
+                    VISBLE = .TRUE.
+                    LXLAST = LX
+                    LYLAST = LY
+                END IF
+                GOTO 300
+  310         IF (MKNS.GT.0) THEN
+                  IF (MKN(MKNS).EQ.1) THEN
+                      MKNS = MKNS-1
+                      J = J-1
+                  END IF
+              END IF
+              MKXMIN = 0.0
+              MKXMAX = 0.0
+              MKYMIN = 0.0
+              MKYMAX = 0.0
+              DO 320 K=1,J
+                  MKXMIN = MIN(MKXMIN, MKX(K))
+                  MKXMAX = MAX(MKXMAX, MKX(K))
+                  MKYMIN = MIN(MKYMIN, MKY(K))
+                  MKYMAX = MAX(MKYMAX, MKY(K))
+  320         CONTINUE
+          END IF
+C
+C Can the device draw batches of markers itself? This requires lines
+C that are not emulated by GRLIN3.
+C
+          BATCH = GRGCAP(GRCIDE)(14:14).EQ.'P' .AND.
+     :            GRWIDT(GRCIDE).LE.1 .AND. MKNS.GT.0
+          IF (BATCH) THEN
+              IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+              CALL GRLIN4
+C             -- send the marker shape
+              RBUF(1) = 0
+              RBUF(2) = MKNS
+              NBUF = 2
+              J = 0
+              DO 340 K=1,MKNS
+                  NBUF = NBUF+1
+                  RBUF(NBUF) = MKN(K)
+                  DO 330 L=1,MKN(K)
+                      J = J+1
+                      RBUF(NBUF+1) = MKX(J)
+                      RBUF(NBUF+2) = MKY(J)
+                      NBUF = NBUF+2
+  330             CONTINUE
+  340         CONTINUE
+              LCHR = 0
+              CALL GREXEC(GRGTYP,33,RBUF,NBUF,CHR,LCHR)
+              RBUF(1) = 1
+              NBUF = 1
+          END IF
 C
-C Positive symbols.
+C Positive symbols. Markers that lie wholly inside the view surface
+C are collected in RBUF for the device; the others are drawn here.
 C
       DO 380 I=1,N
           CALL GRTXY0(ABSXY, X(I), Y(I), XORG, YORG)
           CALL GRCLIP(XORG, YORG, XMINX, XMAXX, YMINX, YMAXX, C)
           IF (C.NE.0) GOTO 380
-          VISBLE = .FALSE.
-          K = 4
-          LXLAST = -64
-          LYLAST = -64
-  320       K = K+2
-            LX = XYGRID(K)
-            LY = XYGRID(K+1)
-            IF (LY.EQ.-64) GOTO 380
-            IF (LX.EQ.-64) THEN
-                VISBLE = .FALSE.
-            ELSE
-                IF ((LX.NE.LXLAST) .OR. (LY.NE.LYLAST)) THEN
-                    XCUR = XORG + (COSA*LX - SINA*LY)*RATIO
-                    YCUR = YORG + (SINA*LX + COSA*LY)
-                    IF (VISBLE) THEN
-                        CALL GRLIN0(XCUR,YCUR)
-                    ELSE
-                        GRXPRE(GRCIDE) = XCUR
-                        GRYPRE(GRCIDE) = YCUR
-                    END IF
-                END IF
-                VISBLE = .TRUE.
-                LXLAST = LX
-                LYLAST = LY
-            END IF
-            GOTO 320
+          IF (BATCH) THEN
+              IF (XORG+MKXMIN.GT.GRXMIN(GRCIDE) .AND.
+     :            XORG+MKXMAX.LT.GRXMAX(GRCIDE) .AND.
+     :            YORG+MKYMIN.GT.GRYMIN(GRCIDE) .AND.
+     :            YORG+MKYMAX.LT.GRYMAX(GRCIDE)) THEN
+                  IF (NBUF+2.GT.MAXBUF) THEN
+                      CALL GREXEC(GRGTYP,33,RBUF,NBUF,CHR,LCHR)
+                      NBUF = 1
+                  END IF
+                  RBUF(NBUF+1) = XORG
+                  RBUF(NBUF+2) = YORG
+                  NBUF = NBUF+2
+                  GOTO 380
+              END IF
+              IF (NBUF.GT.1) THEN
+                  CALL GREXEC(GRGTYP,33,RBUF,NBUF,CHR,LCHR)
+                  NBUF = 1
+              END IF
+          END IF
+          J = 0
+          DO 360 K=1,MKNS
+              J = J+1
+              GRXPRE(GRCIDE) = XORG + MKX(J)
+              GRYPRE(GRCIDE) = YORG + MKY(J)
+              DO 350 L=2,MKN(K)
+                  J = J+1
+                  CALL GRLIN0(XORG + MKX(J), YORG + MKY(J))
+  350         CONTINUE
+  360     CONTINUE
+          IF (BATCH) CALL GRLIN4
   380 CONTINUE
+      IF (BATCH .AND. NBUF.GT.1)
+     :    CALL GREXEC(GRGTYP,33,RBUF,NBUF,CHR,LCHR)
 C
 C Negative symbols.
 C
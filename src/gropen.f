@@ -42,6 +42,9 @@ C 17-Apr-1995 - zero-length string fix [TJP].
 C  6-Jun-1995 - explicitly initialize GRSTAT [TJP].
 C 29-Apr-1996 - moved initialization into GRINIT [TJP].
 C 12-Jul-1999 - fix bug [TJP].
+C 17-Oct-2026 - start the search for a free identifier at GRFREE, so
+C               that opening many devices does not take quadratic time.
+C 18-Oct-2026 - describe the cost of the search.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
       INTEGER   IER, FTYPE, NBUF, LCHR
@@ -58,19 +61,24 @@ C Initialize GRPCKG; read font file (if necessary).
 C
       CALL GRINIT
 C
-C Allocate an identifier.
+C Allocate an identifier: the lowest one not in use. No identifier
+C below GRFREE is free, so the search starts there. In the usual cases
+C (opening devices one after another, or opening one after closing
+C one) the first identifier tried is free; otherwise the search steps
+C over identifiers that are in use, at most GRIMAX of them.
 C
-      IDENT = 1
-   10 IF (GRSTAT(IDENT).NE.0) THEN
+      IDENT = GRFREE
+   10 IF (IDENT.GT.GRIMAX) THEN
+          GRFREE = IDENT
+          CALL GRWARN('Too many active plots.')
+          GROPEN = -1
+          IDENT = 0
+          RETURN
+      ELSE IF (GRSTAT(IDENT).NE.0) THEN
           IDENT = IDENT+1
-          IF (IDENT.GT.GRIMAX) THEN
-              CALL GRWARN('Too many active plots.')
-              GROPEN = -1
-              IDENT = 0
-              RETURN
-          END IF
-      GOTO 10
+          GOTO 10
       END IF
+      GRFREE = IDENT
 C
 C Validate the device specification.
 C
@@ -106,6 +114,7 @@ C
       RBUF(3)=0
       IF (APPEND) RBUF(3)=1
       NBUF=3
+      CALL GRLIN4
       CALL GREXEC(GRGTYP, 9,RBUF,NBUF, GRFILE(IDENT),GRFNLN(IDENT))
       GROPEN=RBUF(2)
       IF (GROPEN.NE.1) THEN
@@ -116,6 +125,7 @@ C
       GRUNIT(IDENT)=RBUF(1)
       GRPLTD(IDENT) = .FALSE.
       GRSTAT(IDENT) = 1
+      GRFREE = IDENT+1
       CALL GRSLCT(IDENT)
 C
 C Install the default plot parameters
@@ -141,7 +151,7 @@ C--- Inquire default plot size.
       GRYMIN(IDENT) = RBUF(3)
       GRYMAX(IDENT) = RBUF(4)
 C--- Inquire device capabilities.
-      GRGCAP(IDENT) = 'NNNNNNNNNNN'
+      GRGCAP(IDENT) = 'NNNNNNNNNNNNNN'
       CALL GREXEC(GRGTYP, 4,RBUF,NBUF,CHR,LCHR)
       IF (LCHR.GT.LEN(GRGCAP(IDENT))) LCHR = LEN(GRGCAP(IDENT))
       GRGCAP(IDENT)(1:LCHR) = CHR(:LCHR)
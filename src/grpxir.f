@@ -0,0 +1,69 @@
+C*GRPXIR -- send a row of integer color indices to the device
+C+
+      SUBROUTINE GRPXIR (X, Y, DX, N, ICOL, IC1, IC2)
+      INTEGER N, ICOL(N), IC1, IC2
+      REAL    X, Y, DX
+C
+C GRPCKG (internal routine): draw a horizontal line of N pixels on a
+C device that accepts integer image rows (capability 13 = 'I'). This is
+C used by GRPXPX and GRIMG2 in place of opcode 26, which passes each
+C color index as a REAL. The caller passes a whole row; it is split
+C here only as far as the character buffer requires.
+C
+C The indices are sent with opcode 32: RBUF(1), RBUF(2) are the device
+C coordinates of the first pixel and RBUF(3) is the number of bytes
+C used for each index (1 if all indices are less than 256, otherwise
+C 2); CHR(1:LCHR) holds the indices, low byte first.
+C
+C Arguments:
+C  X, Y   (input)  : device coordinates of the first pixel.
+C  DX     (input)  : distance in X between pixels.
+C  N      (input)  : number of pixels.
+C  ICOL   (input)  : color indices.
+C  IC1, IC2 (input) : range of valid color indices (0-65535); indices
+C                    outside this range are drawn with color index 1.
+C--
+C 17-Oct-2026 - new routine.
+C 18-Oct-2026 - check the index range here, so that callers can pass
+C               their rows without copying them.
+C-----------------------------------------------------------------------
+      INCLUDE 'grpckg1.inc'
+      INTEGER  NCHR
+      PARAMETER (NCHR=8192)
+      INTEGER  I, K, L, M, NB, NBUF, LCHR
+      REAL     RBUF(3)
+      CHARACTER*(NCHR) CHR
+      INTRINSIC CHAR, MIN, MOD
+C
+      IF (N.LT.1) RETURN
+      NB = 1
+      IF (IC2.GT.255) NB = 2
+      RBUF(2) = Y
+      RBUF(3) = NB
+      NBUF = 3
+      I = 1
+C     -- DO WHILE (I.LE.N)
+   20 IF (I.LE.N) THEN
+         L = MIN(N-I+1, NCHR/NB)
+         IF (NB.EQ.1) THEN
+            DO 30 K=1,L
+               M = ICOL(I+K-1)
+               IF (M.LT.IC1 .OR. IC2.LT.M) M = 1
+               CHR(K:K) = CHAR(M)
+   30       CONTINUE
+         ELSE
+            DO 40 K=1,L
+               M = ICOL(I+K-1)
+               IF (M.LT.IC1 .OR. IC2.LT.M) M = 1
+               CHR(2*K-1:2*K-1) = CHAR(MOD(M,256))
+               CHR(2*K:2*K) = CHAR(M/256)
+   40       CONTINUE
+         END IF
+         RBUF(1) = X + (I-1)*DX
+         LCHR = L*NB
+         CALL GREXEC(GRGTYP, 32, RBUF, NBUF, CHR, LCHR)
+         I = I + L
+      GOTO 20
+      END IF
+C     -- end DO WHILE
+      END
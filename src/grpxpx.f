@@ -19,6 +19,9 @@ C                    (device coordinates)
 C--
 C 16-Jan-1991 - [GvG]
 *  4-Aug-1993 - Debugged by Remko Scharroo
+C 17-Oct-2026 - send integer color indices (GRPXIR) if the device
+C               accepts them.
+C 18-Oct-2026 - pass whole rows of IA to GRPXIR without copying.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
       INTEGER     NSIZE
@@ -31,12 +34,25 @@ C-----------------------------------------------------------------------
       CHARACTER*1 CHR
 
       IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+      CALL GRLIN4
 C
 C Get allowable color range and pixel width
 C
       CALL GRQCOL(IC1, IC2)
       CALL GREXEC(GRGTYP, 3, RBUF, NBUF, CHR, LCHR)
       WIDTH = RBUF(3)
+C
+C If the device accepts integer color indices, send each row of IA
+C as it stands with GRPXIR.
+C
+      IF (GRGCAP(GRCIDE)(13:13).EQ.'I') THEN
+         DO 60 J = J1, J2
+            CALL GRPXIR(X, Y + (J - J1) * WIDTH, WIDTH, I2 - I1 + 1,
+     :                  IA(I1, J), IC1, IC2)
+   60    CONTINUE
+         RETURN
+      END IF
+C
       DO 30 J = J1, J2
 C
 C Compute Y coordinate for this line
@@ -18,7 +18,7 @@ C-----------------------------------------------------------------------
 C
       IF (GRCIDE.LT.1) THEN
           CALL GRWARN('GRQCAP - no graphics device is active.')
-          STRING = 'NNNNNNNNNN'
+          STRING = 'NNNNNNNNNNNNNN'
       ELSE
           STRING = GRGCAP(GRCIDE)
       END IF
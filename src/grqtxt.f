@@ -6,18 +6,18 @@ C GRPCKG: get the bounding box of a string drawn by GRTEXT.
 C--
 C 12-Sep-1993 - [TJP].
 C  8-Nov-1994 - return something even if string is blank [TJP].
+C 17-Oct-2026 - use symbol bounding boxes from the font image.
+C 17-Oct-2026 - take the bounding box from the layout cache (GRTXC0);
+C               remove the limit of 256 characters.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
-      LOGICAL UNUSED, VISBLE, PLOT
-      INTEGER XYGRID(300)
-      INTEGER LIST(256)
       CHARACTER*(*) STRING
       REAL XBOX(4), YBOX(4)
-      REAL ANGLE, FACTOR, FNTBAS, FNTFAC, COSA, SINA, DX, DY, XORG, YORG
-      REAL ORIENT, RATIO, X0, Y0, RLX, RLY
-      REAL XG, YG, XGMIN, XGMAX, YGMIN, YGMAX
-      INTEGER I, IFNTLV,NLIST,LX,LY, K, LXLAST,LYLAST
-      INTRINSIC ABS, COS, LEN, MAX, MIN, SIN
+      REAL ANGLE, FACTOR, COSA, SINA, XORG, YORG
+      REAL ORIENT, RATIO, X0, Y0
+      REAL XGMIN, XGMAX, YGMIN, YGMAX, BOX(4)
+      INTEGER I, IPLOT, IER
+      INTRINSIC COS, LEN, SIN
 C
 C Default return values.
 C
@@ -50,80 +50,23 @@ C
       XORG = X0
       YORG = Y0
 C
-C Convert the string to a list of symbol numbers; to prevent overflow
-C of array LIST, the length of STRING is limited to 256 characters.
-C
-      CALL GRSYDS(LIST,NLIST,STRING(1:MIN(256,LEN(STRING))),
-     1             GRCFNT(GRCIDE))
-C
-C Run through the string of characters, getting bounding box
-C in character coordinates. (XG, YG) is the starting point
-C of the current character. The x/y limits of the bbox are
+C Get the bounding box of the string in character coordinates, from
+C the layout cache (see GRTXC0). The x/y limits of the bbox are
 C XGMIN...XGMAX, YGMIN...YGMAX.
 C
-      FNTBAS = 0.0
-      FNTFAC = 1.0
-      IFNTLV = 0
-      DX = 0.0
-      DY = 0.0
-      XG = 0.0
-      YG = 0.0
-      XGMIN = 1E30
-      XGMAX = -1E30
-      YGMIN = 1E30
-      YGMAX = -1E30
-      PLOT  = .FALSE.
-      DO 380 I=1,NLIST
-          IF (LIST(I).LT.0) THEN
-              IF (LIST(I).EQ.-1) THEN
-C                 ! up
-                  IFNTLV = IFNTLV+1
-                  FNTBAS = FNTBAS + 16.0*FNTFAC
-                  FNTFAC = 0.75**ABS(IFNTLV)
-              ELSE IF (LIST(I).EQ.-2) THEN
-C                 ! down
-                  IFNTLV = IFNTLV-1
-                  FNTFAC = 0.75**ABS(IFNTLV)
-                  FNTBAS = FNTBAS - 16.0*FNTFAC
-              ELSE IF (LIST(I).EQ.-3) THEN
-C                 ! backspace
-                  XG = XG - DX*FNTFAC
-              END IF
-              GOTO 380
-          END IF
-          CALL GRSYXD(LIST(I),XYGRID,UNUSED)
-          VISBLE = .FALSE.
-          DX = XYGRID(5)-XYGRID(4)
-          K = 4
-          LXLAST = -64
-          LYLAST = -64
-  320     K = K+2
-          LX = XYGRID(K)
-          LY = XYGRID(K+1)
-          IF (LY.EQ.-64) GOTO 330
-          IF (LX.EQ.-64) THEN
-              VISBLE = .FALSE.
-          ELSE
-              RLX = (LX - XYGRID(4))*FNTFAC
-              RLY = (LY - XYGRID(2))*FNTFAC + FNTBAS
-              IF ((LX.NE.LXLAST) .OR. (LY.NE.LYLAST)) THEN
-                  XGMIN = MIN(XGMIN,XG+RLX)
-                  XGMAX = MAX(XGMAX,XG+RLX)
-                  YGMIN = MIN(YGMIN,RLY)
-                  YGMAX = MAX(YGMAX,RLY)
-                  PLOT = .TRUE.
-              END IF
-              VISBLE = .TRUE.
-              LXLAST = LX
-              LYLAST = LY
-          END IF
-          GOTO 320
-  330     XG = XG + DX*FNTFAC
-  380 CONTINUE
+      CALL GRTXC0(STRING, GRCFNT(GRCIDE), BOX, IPLOT, IER)
+      IF (IER.NE.0) THEN
+          CALL GRWARN('GRQTXT - not enough memory.')
+          RETURN
+      END IF
+      XGMIN = BOX(1)
+      XGMAX = BOX(2)
+      YGMIN = BOX(3)
+      YGMAX = BOX(4)
 C
 C Check whether anything was plotted.
 C
-      IF (.NOT.PLOT) RETURN
+      IF (IPLOT.EQ.0) RETURN
 C
 C Expand the box a bit to allow for line-width.
 C
@@ -46,6 +46,7 @@ C Use hardware rectangle fill if available.
 C
       IF (GRGCAP(GRCIDE)(6:6).EQ.'R') THEN
           IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+          CALL GRLIN4
           RBUF(1) = XMIN
           RBUF(2) = YMIN
           RBUF(3) = XMAX
@@ -57,6 +58,7 @@ C Else use hardware polygon fill if available.
 C
       ELSE IF (GRGCAP(GRCIDE)(4:4).EQ.'A') THEN
           IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
+          CALL GRLIN4
           RBUF(1) = 4
           CALL GREXEC(GRGTYP,20,RBUF,NBUF,CHR,LCHR)
           RBUF(1) = XMIN
@@ -64,6 +64,7 @@ C driver.
 C
       IF (GRPLTD(GRCIDE)) THEN
           RBUF(1) = COLOR
+          CALL GRLIN4
           CALL GREXEC(GRGTYP,15,RBUF,NBUF,CHR,LCHR)
       END IF
 C
@@ -51,6 +51,7 @@ C         IF (.NOT.GRPLTD(GRCIDE)) CALL GRBPIC
           RBUF(3)=CG
           RBUF(4)=CB
           NBUF=4
+          CALL GRLIN4
           CALL GREXEC(GRGTYP,21,RBUF,NBUF,CHR,LCHR)
 C         -- If this is the current color, reselect it in the driver.
           IF (CI.EQ.GRCCOL(GRCIDE)) THEN
@@ -30,6 +30,7 @@ C
          RBUF(6) = DY
          NBUF = 6
          LCHR = 0
+         CALL GRLIN4
          CALL GREXEC(GRGTYP,30,RBUF,NBUF,CHR,LCHR)
 C
 C Otherwise, report an error.
@@ -10,25 +10,31 @@ C
 C Argument:
 C
 C IDENT (input, integer): the identifier of the plot to be selected, as
-C       returned by GROPEN.
+C       returned by GROPEN, or 0 to select no plot (this is used by the
+C       plotting contexts of the C binding).
 C--
 C (1-Feb-1983)
 C  5-Aug-1986 - add GREXEC support [AFT].
 C  4-Jun-1987 - skip action if no change in ID [TJP].
 C 26-Nov-1990 - [TJP].
+C 18-Oct-2026 - allow IDENT=0.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
       REAL     RBUF(6)
       INTEGER  IDENT, NBUF,LCHR
       CHARACTER CHR
 C
-      IF ((IDENT.LE.0) .OR. (IDENT.GT.GRIMAX) .OR.
+      IF (IDENT.EQ.0) THEN
+         CALL GRLIN4
+         GRCIDE = 0
+      ELSE IF ((IDENT.LT.0) .OR. (IDENT.GT.GRIMAX) .OR.
      1     (GRSTAT(IDENT).EQ.0)) THEN
          CALL GRWARN('GRSLCT - invalid plot identifier.')
       ELSE IF (IDENT.EQ.GRCIDE) THEN
          GRGTYP = GRTYPE(IDENT)
          RETURN
       ELSE
+         CALL GRLIN4
          GRCIDE = IDENT
          GRGTYP = GRTYPE(IDENT)
          RBUF(1)= GRCIDE
@@ -60,6 +60,7 @@ C
           IF (GRPLTD(GRCIDE)) THEN
               RBUF(1)=I
               NBUF=1
+              CALL GRLIN4
               CALL GREXEC(GRGTYP,19,RBUF,NBUF,CHR,LCHR)
           END IF
 C
@@ -63,6 +63,7 @@ C emulation.
 C
       IF (ITHICK.EQ.1 .AND. GRPLTD(GRCIDE)) THEN
           RBUF(1) = I
+          CALL GRLIN4
           CALL GREXEC(GRGTYP,22,RBUF,NBUF,CHR,LCHR)
       END IF
 C
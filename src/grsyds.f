@@ -43,6 +43,8 @@ C 29-Nov-1990 - add \m escapes [TJP].
 C 27-Nov-1991 - add \x escape [TJP].
 C 27-Jul-1995 - extend for 256-character set [TJP]
 C  7-Nov-1995 - add \. escape [TJP].
+C 18-Oct-2026 - do not read beyond the end of TEXT when it ends in an
+C               incomplete escape sequence.
 C-----------------------------------------------------------------------
       CHARACTER*8  FONTS
       CHARACTER*48 GREEK
@@ -112,7 +114,8 @@ C
                 SYMBOL(NSYMBS) = 0
                 J = J+2
 C               -- DO WHILE ('0'.LE.TEXT(J:J).AND.TEXT(J:J).LE.'9')
-   90           IF ('0'.LE.TEXT(J:J).AND.TEXT(J:J).LE.'9') THEN
+   90           IF (J.GT.LENTXT) GOTO 100
+                IF ('0'.LE.TEXT(J:J).AND.TEXT(J:J).LE.'9') THEN
                   SYMBOL(NSYMBS) = SYMBOL(NSYMBS)*10 +
      1                      ICHAR(TEXT(J:J)) - ICHAR('0')
                    J = J+1
@@ -125,13 +128,17 @@ C               -- end DO WHILE
      1               TEXT(J+1:J+1).EQ.'M') THEN
                 MARK = 0
                 J = J+2
-                IF ('0'.LE.TEXT(J:J).AND.TEXT(J:J).LE.'9') THEN
+                IF (J.LE.LENTXT) THEN
+                  IF ('0'.LE.TEXT(J:J).AND.TEXT(J:J).LE.'9') THEN
                     MARK = MARK*10 + ICHAR(TEXT(J:J)) - ICHAR('0')
                     J = J+1
+                  END IF
                 END IF
-                IF ('0'.LE.TEXT(J:J).AND.TEXT(J:J).LE.'9') THEN
+                IF (J.LE.LENTXT) THEN
+                  IF ('0'.LE.TEXT(J:J).AND.TEXT(J:J).LE.'9') THEN
                     MARK = MARK*10 + ICHAR(TEXT(J:J)) - ICHAR('0')
                     J = J+1
+                  END IF
                 END IF
                 J = J-1
                 NSYMBS = NSYMBS + 1
@@ -139,14 +146,16 @@ C               -- end DO WHILE
                 GOTO 100
             ELSE IF (TEXT(J+1:J+1).EQ.'f' .OR.
      1               TEXT(J+1:J+1).EQ.'F') THEN
-                IFONT = INDEX(FONTS, TEXT(J+2:J+2))
+                IFONT = 0
+                IF (J+2.LE.LENTXT) IFONT = INDEX(FONTS, TEXT(J+2:J+2))
                 IF (IFONT.GT.4) IFONT = IFONT-4
                 IF (IFONT.EQ.0) IFONT = 1
                 J = J+2
                 GOTO 100
             ELSE IF (TEXT(J+1:J+1).EQ.'g' .OR.
      1               TEXT(J+1:J+1).EQ.'G') THEN
-                IG = INDEX(GREEK, TEXT(J+2:J+2))
+                IG = 0
+                IF (J+2.LE.LENTXT) IG = INDEX(GREEK, TEXT(J+2:J+2))
                 NSYMBS = NSYMBS + 1
                 CALL GRSYMK(255+IG, IFONT, SYMBOL(NSYMBS))
                 J = J+2
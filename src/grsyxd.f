@@ -33,13 +33,24 @@ C do this.
 C--
 C  7-Mar-1983.
 C 15-Dec-1988 - standardize.
+C 17-Oct-2026 - take the symbol from the font image if one is mapped.
 C-----------------------------------------------------------------------
       INTEGER*2    BUFFER(27000)
       INTEGER      INDEX(3000), IX, IY, K, L, LOCBUF
-      INTEGER      NC1, NC2
+      INTEGER      NC1, NC2, N, GRSYIG
       COMMON       /GRSYMB/ NC1, NC2, INDEX, BUFFER
 C
-C Extract digitization.
+C Copy the decoded symbol from the font image, if GRSY00 mapped one.
+C
+      N = GRSYIG(SYMBOL, XYGRID)
+      IF (N.GT.0) THEN
+          UNUSED = .FALSE.
+          RETURN
+      ELSE IF (N.EQ.0) THEN
+          GOTO 3000
+      END IF
+C
+C Otherwise extract digitization.
 C
       IF (SYMBOL.LT.NC1 .OR. SYMBOL.GT.NC2) GOTO 3000
       L = SYMBOL - NC1 + 1
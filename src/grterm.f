@@ -23,6 +23,7 @@ C-----------------------------------------------------------------------
       CHARACTER CHR
 C
       IF (GRCIDE.GE.1) THEN
+          CALL GRLIN4
           CALL GREXEC(GRGTYP,16,RBUF,NBUF,CHR,LCHR)
       END IF
       END
@@ -12,8 +12,7 @@ C Arguments:
 C
 C STRING (input, character): the character string to be plotted. This
 C       may include standard escape-sequences to represent non-ASCII
-C       characters and special commands. The number of characters in
-C       STRING (i.e., LEN(STRING)) should not exceed 256.
+C       characters and special commands.
 C--
 C (3-May-1983)
 C  5-Aug-1986 - add GREXEC support [AFT].
@@ -23,19 +22,24 @@ C               defined, text strings in PS files are preceded by a
 C               comment with the text of the string plotted as vectors
 C               [TJP after D.S.Briggs].
 C  4-Feb-1997 - grexec requires an RBUF array, not a scalar [TJP].
+C 17-Oct-2026 - take the layout of the string from the cache (GRTXC0);
+C               remove the limit of 256 characters.
+C 18-Oct-2026 - send any buffered polyline (GRLIN4) before the
+C               PS_VERBOSE_TEXT comments.
 C-----------------------------------------------------------------------
       INCLUDE 'grpckg1.inc'
-      LOGICAL ABSXY,UNUSED,VISBLE,CENTER
-      INTEGER XYGRID(300)
-      INTEGER LIST(256)
+      INTEGER MAXE
+      PARAMETER (MAXE=256)
+      LOGICAL ABSXY,CENTER
+      INTEGER KIND(MAXE)
       CHARACTER*(*) STRING
-      REAL ANGLE, FACTOR, FNTBAS, FNTFAC, COSA, SINA, DX, DY, XORG, YORG
-      REAL XCUR, YCUR, ORIENT, RATIO, X0, Y0, RLX, RLY
+      REAL ANGLE, FACTOR, COSA, SINA, DX, DY, XORG, YORG
+      REAL XCUR, YCUR, ORIENT, RATIO, X0, Y0
       REAL XMIN, XMAX, YMIN, YMAX
-      REAL RBUF(6)
-      INTEGER I, IFNTLV,NLIST,LX,LY, K, LXLAST,LYLAST, LSTYLE
+      REAL RBUF(6), A(MAXE), B(MAXE), BOX(4)
+      INTEGER I, K, N, IPLOT, IER, LSTYLE
       INTEGER SLEN, GRTRIM
-      INTRINSIC ABS, COS, LEN, MIN, SIN
+      INTRINSIC COS, LEN, SIN
       CHARACTER DEVTYP*14, STEMP*258
       LOGICAL DEVINT, VTEXT
 
@@ -68,6 +72,7 @@ C
          IF (VTEXT) THEN
             SLEN = GRTRIM(STRING)
             STEMP = '% Start "' // STRING(1:SLEN) // '"'
+            CALL GRLIN4
             CALL GREXEC (GRGTYP, 23, RBUF, 0, STEMP, SLEN+10)
          END IF
       END IF
@@ -91,84 +96,61 @@ C
       COSA = FACTOR * COS(ANGLE)
       SINA = FACTOR * SIN(ANGLE)
       CALL GRTXY0(ABSXY, X0, Y0, XORG, YORG)
-      FNTBAS = 0.0
-      FNTFAC = 1.0
-      IFNTLV = 0
       DX = 0.0
       DY = 0.0
 C
-C Convert the string to a list of symbol numbers; to prevent overflow
-C of array LIST, the length of STRING is limited to 256 characters.
-C
-      CALL GRSYDS(LIST,NLIST,STRING(1:MIN(256,LEN(STRING))),
-     1             GRCFNT(GRCIDE))
-C
-C Plot the string of characters
-C
-      DO 380 I = 1,NLIST
-          IF (LIST(I).LT.0) THEN
-              IF (LIST(I).EQ.-1) THEN
-C                 ! up
-                  IFNTLV = IFNTLV+1
-                  FNTBAS = FNTBAS + 16.0*FNTFAC
-                  FNTFAC = 0.75**ABS(IFNTLV)
-              ELSE IF (LIST(I).EQ.-2) THEN
-C                 ! down
-                  IFNTLV = IFNTLV-1
-                  FNTFAC = 0.75**ABS(IFNTLV)
-                  FNTBAS = FNTBAS - 16.0*FNTFAC
-              ELSE IF (LIST(I).EQ.-3) THEN
-C                 ! backspace
-                  XORG = XORG - DX*FNTFAC
-                  YORG = YORG - DY*FNTFAC
-              END IF
-              GOTO 380
-          END IF
-          CALL GRSYXD(LIST(I),XYGRID,UNUSED)
-          VISBLE = .FALSE.
-          LX = XYGRID(5)-XYGRID(4)
-          DX = COSA*LX*RATIO
-          DY = SINA*LX
-          K = 4
-          LXLAST = -64
-          LYLAST = -64
-  320     K = K+2
-          LX = XYGRID(K)
-          LY = XYGRID(K+1)
-          IF (LY.EQ.-64) GOTO 330
-          IF (LX.EQ.-64) THEN
-              VISBLE = .FALSE.
-          ELSE
-              RLX = (LX - XYGRID(4))*FNTFAC
-              RLY = (LY - XYGRID(2))*FNTFAC + FNTBAS
-              IF ((LX.NE.LXLAST) .OR. (LY.NE.LYLAST)) THEN
-                  XCUR = XORG + (COSA*RLX - SINA*RLY)*RATIO
-                  YCUR = YORG + (SINA*RLX + COSA*RLY)
-                  IF (VISBLE) THEN
-                      CALL GRLIN0(XCUR,YCUR)
-                  ELSE
-                      GRXPRE(GRCIDE) = XCUR
-                      GRYPRE(GRCIDE) = YCUR
-                  END IF
+C Get the layout of the string: the strokes of each symbol, in
+C character units relative to the start of the symbol, and the width
+C of each symbol (see GRTXC0).
+C
+      CALL GRTXC0(STRING, GRCFNT(GRCIDE), BOX, IPLOT, IER)
+      IF (IER.NE.0) THEN
+          CALL GRWARN('GRTEXT - not enough memory.')
+          GOTO 390
+      END IF
+C
+C Plot the string of characters, fetching the layout MAXE entries at a
+C time.
+C
+      K = 0
+  300 CALL GRTXC1(K, MAXE, KIND, A, B, N)
+      DO 380 I=1,N
+          IF (KIND(I).EQ.1 .OR. KIND(I).EQ.2) THEN
+C             ! move or draw
+              XCUR = XORG + (COSA*A(I) - SINA*B(I))*RATIO
+              YCUR = YORG + (SINA*A(I) + COSA*B(I))
+              IF (KIND(I).EQ.2) THEN
+                  CALL GRLIN0(XCUR,YCUR)
+              ELSE
+                  GRXPRE(GRCIDE) = XCUR
+                  GRYPRE(GRCIDE) = YCUR
               END IF
-              VISBLE = .TRUE.
-              LXLAST = LX
-              LYLAST = LY
+          ELSE IF (KIND(I).EQ.0) THEN
+C             ! end of symbol
+              DX = COSA*A(I)*RATIO
+              DY = SINA*A(I)
+              XORG = XORG + DX*B(I)
+              YORG = YORG + DY*B(I)
+          ELSE IF (KIND(I).EQ.-3) THEN
+C             ! backspace
+              XORG = XORG - DX*B(I)
+              YORG = YORG - DY*B(I)
           END IF
-          GOTO 320
-  330     XORG = XORG + DX*FNTFAC
-          YORG = YORG + DY*FNTFAC
   380 CONTINUE
+      K = K+N
+      IF (N.GT.0) GOTO 300
 C
 C Set pen position ready for next character.
 C
       GRXPRE(GRCIDE) = XORG
       GRYPRE(GRCIDE) = YORG
+  390 CONTINUE
 C
 C Another possible device dependent section
 C
       IF (VTEXT) THEN
          STEMP = '% End "' // STRING(1:SLEN) // '"'
+         CALL GRLIN4
          CALL GREXEC(GRGTYP, 23, RBUF, 0, STEMP, SLEN+8)
       END IF
 C
@@ -39,11 +39,15 @@ C  BLANK   (input) : elements of array A that are exactly equal to
 C                    this value are ignored (blanked).
 C--
 C 21-Sep-1989 - Derived from PGCONS [TJP].
+C 17-Oct-2026 - Use GRCNS0, as PGCONS does.
 C-----------------------------------------------------------------------
-      INTEGER  I, IC, ICORN, IDELT(6), J, K, NPT
+      INTEGER  MAXP
+      PARAMETER (MAXP=200)
+      INTEGER  I, IC, ICORN, IDELT(6), IER, J, K, N, NPT
       INTEGER  IOFF(8), JOFF(8), IENC, ITMP, JTMP, ILO, ITOT
       LOGICAL  PGNOTO
       REAL     CTR, DELTA, DVAL(5), XX, YY, X(4), Y(4)
+      REAL     XP(MAXP), YP(MAXP)
       INTRINSIC ABS
       DATA     IDELT/0,-1,-1,0,0,-1/
       DATA     IOFF/-2,-2,-1,-1, 0, 0, 1, 1/
@@ -56,6 +60,31 @@ C
      1    J1.LT.1 .OR. J2.GT.JDIM .OR. J1.GE.J2) RETURN
       IF (NC.EQ.0) RETURN
       CALL PGBBUF
+C
+C Use the contouring engine GRCNS0, which returns the contours joined
+C into polylines.
+C
+      CALL GRCNS0(A, IDIM, JDIM, I1, I2, J1, J2, C, ABS(NC), TR,
+     1            BLANK, 1, IER)
+      IF (IER.EQ.0) THEN
+   10    CALL GRCNS1(XP, YP, MAXP, N)
+         IF (N.GT.0) THEN
+            CALL PGMOVE(XP(1),YP(1))
+            DO 20 K=2,N
+               CALL PGDRAW(XP(K),YP(K))
+   20       CONTINUE
+            GOTO 10
+         ELSE IF (N.LT.0) THEN
+            DO 30 K=1,-N
+               CALL PGDRAW(XP(K),YP(K))
+   30       CONTINUE
+            GOTO 10
+         END IF
+         CALL PGEBUF
+         RETURN
+      END IF
+C
+C If there is not enough memory, draw each cell separately.
 C
       DO 130 J=J1+1,J2
       DO 130 I=I1+1,I2
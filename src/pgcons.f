@@ -9,12 +9,17 @@ C
 C Draw a contour map of an array. The map is truncated if
 C necessary at the boundaries of the viewport.  Each contour line is
 C drawn with the current line attributes (color index, style, and
-C width).  This routine, unlike PGCONT, does not draw each contour as a
-C continuous line, but draws the straight line segments composing each
-C contour in a random order.  It is thus not suitable for use on pen
-C plotters, and it usually gives unsatisfactory results with dashed or
-C dotted lines.  It is, however, faster than PGCONT, especially if
-C several contour levels are drawn with one call of PGCONS.
+C width).  This routine, unlike PGCONT, does not follow each contour
+C from end to end.  The straight line segments composing the contours
+C are found cell by cell, and joined into polylines within bands of
+C rows of the array; so a contour may be drawn in several pieces, in
+C no particular order.  It is thus not suitable for use on pen
+C plotters, and dashed or dotted lines may be broken where pieces
+C meet.  It is, however, much faster than PGCONT, especially if
+C several contour levels are drawn with one call of PGCONS.  If the
+C environment variable PGPLOT_CONTOUR_THREADS is set to a number N
+C greater than 1, the bands are contoured by N threads in parallel
+C (on systems that support this).
 C
 C Arguments:
 C  A      (input)  : data array.
@@ -42,11 +47,16 @@ C 27-Aug-1984 - [TJP].
 C 21-Sep-1989 - Better treatment of the 'ambiguous' case [A. Tennant];
 C               compute world coordinates internally and eliminate
 C               dependence on common block [TJP].
+C 17-Oct-2026 - Use GRCNS0, which considers only the levels that cross
+C               each cell and joins the segments into polylines.
 C-----------------------------------------------------------------------
-      INTEGER  I, IC, ICORN, IDELT(6), J, K, NPT
+      INTEGER  MAXP
+      PARAMETER (MAXP=200)
+      INTEGER  I, IC, ICORN, IDELT(6), IER, J, K, N, NPT
       INTEGER  IOFF(8), JOFF(8), IENC, ITMP, JTMP, ILO, ITOT
       LOGICAL  PGNOTO
       REAL     CTR, DELTA, DVAL(5), XX, YY, X(4), Y(4)
+      REAL     XP(MAXP), YP(MAXP)
       INTRINSIC ABS
       DATA     IDELT/0,-1,-1,0,0,-1/
       DATA     IOFF/-2,-2,-1,-1, 0, 0, 1, 1/
@@ -59,6 +69,31 @@ C
      1    J1.LT.1 .OR. J2.GT.JDIM .OR. J1.GE.J2) RETURN
       IF (NC.EQ.0) RETURN
       CALL PGBBUF
+C
+C Use the contouring engine GRCNS0, which returns the contours joined
+C into polylines.
+C
+      CALL GRCNS0(A, IDIM, JDIM, I1, I2, J1, J2, C, ABS(NC), TR,
+     1            0.0, 0, IER)
+      IF (IER.EQ.0) THEN
+   10    CALL GRCNS1(XP, YP, MAXP, N)
+         IF (N.GT.0) THEN
+            CALL PGMOVE(XP(1),YP(1))
+            DO 20 K=2,N
+               CALL PGDRAW(XP(K),YP(K))
+   20       CONTINUE
+            GOTO 10
+         ELSE IF (N.LT.0) THEN
+            DO 30 K=1,-N
+               CALL PGDRAW(XP(K),YP(K))
+   30       CONTINUE
+            GOTO 10
+         END IF
+         CALL PGEBUF
+         RETURN
+      END IF
+C
+C If there is not enough memory, draw each cell separately.
 C
       DO 130 J=J1+1,J2
       DO 130 I=I1+1,I2
@@ -23,6 +23,11 @@ C data values should be provided for all 55 elements.  PGCONX can
 C also be used for special applications in which the height of the
 C contour affects its appearance, e.g., stereoscopic views.
 C
+C The contours are followed through the whole array, however large;
+C if the environment variable PGPLOT_CONTOUR_THREADS is set to a number
+C N greater than 1, the array is searched for contours by N threads in
+C parallel (on systems that support this).
+C
 C The map is truncated if necessary at the boundaries of the viewport.
 C Each contour line is drawn with the current line attributes (color
 C index, style, and width); except that if argument NC is positive
@@ -75,13 +80,18 @@ C 14-Nov-1985 - new routine [TJP].
 C 12-Sep-1989 - correct documentation error [TJP].
 C 22-Apr-1990 - corrected bug in panelling algorithm [TJP].
 C 13-Dec-1990 - make errors non-fatal [TJP].
+C 17-Oct-2026 - trace each level through the whole array with GRCNX1,
+C               instead of in panels of 100 by 100 with PGCNSC.
+C 18-Oct-2026 - end with GRCNX3, so that the engine does not keep A.
 C-----------------------------------------------------------------------
-      INTEGER  MAXEMX,MAXEMY
+      INTEGER  MAXEMX,MAXEMY,MAXP
       PARAMETER (MAXEMX=100)
       PARAMETER (MAXEMY=100)
-      INTEGER  I
+      PARAMETER (MAXP=200)
+      INTEGER  I, IER, IER0, K, N
       INTEGER  NNX,NNY, KX,KY, KI,KJ, IA,IB, JA,JB, LS, PX, PY
       LOGICAL  STYLE, PGNOTO
+      REAL     XP(MAXP), YP(MAXP)
 C
 C Check arguments.
 C
@@ -96,34 +106,56 @@ C
       CALL PGQLS(LS)
       CALL PGBBUF
 C
-C Divide arrays into panels not exceeding MAXEMX by MAXEMY for
-C contouring by PGCNSC.
+C Use the contour-following engine (GRCNX0, GRCNX1, GRCNX2), which
+C traces the contours of each level through the whole array and
+C returns them as polylines.
 C
-CD    write (*,*) 'PGCONX window:',i1,i2,j1,j2
-      NNX = I2-I1+1
-      NNY = J2-J1+1
-      KX = MAX(1,(NNX+MAXEMX-2)/(MAXEMX-1))
-      KY = MAX(1,(NNY+MAXEMY-2)/(MAXEMY-1))
-      PX = (NNX+KX-1)/KX
-      PY = (NNY+KY-1)/KY
-      DO 60 KI=1,KX
-          IA = I1 + (KI-1)*PX
-          IB = MIN(I2, IA + PX)
-          DO 50 KJ=1,KY
-              JA = J1 + (KJ-1)*PY
-              JB = MIN(J2, JA + PY)
+      IF (STYLE) CALL PGSLS(1)
+      CALL GRCNX0(A,IDIM,JDIM,I1,I2,J1,J2,IER0)
+      DO 60 I=1,ABS(NC)
+          IF (STYLE.AND.(C(I).LT.0.0)) CALL PGSLS(2)
+          IER = IER0
+          IF (IER.EQ.0) CALL GRCNX1(C(I),IER)
+          IF (IER.EQ.0) THEN
+   10         CALL GRCNX2(XP, YP, MAXP, N)
+              IF (N.GT.0) THEN
+                  CALL PLOT(0,XP(1),YP(1),C(I))
+                  DO 20 K=2,N
+                      CALL PLOT(1,XP(K),YP(K),C(I))
+   20             CONTINUE
+                  GOTO 10
+              ELSE IF (N.LT.0) THEN
+                  DO 30 K=1,-N
+                      CALL PLOT(1,XP(K),YP(K),C(I))
+   30             CONTINUE
+                  GOTO 10
+              END IF
+          ELSE
 C
-C             Draw the contours in one panel.
+C If there is not enough memory, divide the array into panels not
+C exceeding MAXEMX by MAXEMY for contouring by PGCNSC.
 C
-CD            write (*,*) 'PGCONX panel:',ia,ib,ja,jb
-              IF (STYLE) CALL PGSLS(1)
-              DO 40 I=1,ABS(NC)
-                  IF (STYLE.AND.(C(I).LT.0.0)) CALL PGSLS(2)
-                  CALL PGCNSC(A,IDIM,JDIM,IA,IB,JA,JB,C(I),PLOT)
-                  IF (STYLE) CALL PGSLS(1)
-   40         CONTINUE
-   50     CONTINUE
+CD            write (*,*) 'PGCONX window:',i1,i2,j1,j2
+              NNX = I2-I1+1
+              NNY = J2-J1+1
+              KX = MAX(1,(NNX+MAXEMX-2)/(MAXEMX-1))
+              KY = MAX(1,(NNY+MAXEMY-2)/(MAXEMY-1))
+              PX = (NNX+KX-1)/KX
+              PY = (NNY+KY-1)/KY
+              DO 50 KI=1,KX
+                  IA = I1 + (KI-1)*PX
+                  IB = MIN(I2, IA + PX)
+                  DO 40 KJ=1,KY
+                      JA = J1 + (KJ-1)*PY
+                      JB = MIN(J2, JA + PY)
+CD                    write (*,*) 'PGCONX panel:',ia,ib,ja,jb
+                      CALL PGCNSC(A,IDIM,JDIM,IA,IB,JA,JB,C(I),PLOT)
+   40             CONTINUE
+   50         CONTINUE
+          END IF
+          IF (STYLE) CALL PGSLS(1)
    60 CONTINUE
+      CALL GRCNX3
 C
       CALL PGSLS(LS)
       CALL PGEBUF
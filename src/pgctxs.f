@@ -0,0 +1,25 @@
+C PGCTXS -- select the device of a C plotting context (internal routine)
+C
+      SUBROUTINE PGCTXS (ID)
+      INTEGER ID
+C
+C Select the device of a plotting context of the C binding (see
+C sys/grctx.c). Unlike PGSLCT, ID may be 0, meaning that no device is
+C selected.
+C
+C Argument:
+C  ID     (input)  : the identifier of the device, or 0.
+C--
+C 17-Oct-2026 - new routine.
+C 18-Oct-2026 - deselect the GRPCKG device too when ID is 0.
+C-----------------------------------------------------------------------
+      INCLUDE 'pgplot.inc'
+C
+      CALL PGINIT
+      IF (ID.EQ.0) THEN
+         PGID = 0
+         CALL GRSLCT(0)
+      ELSE
+         CALL PGSLCT(ID)
+      END IF
+      END
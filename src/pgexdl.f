@@ -0,0 +1,27 @@
+C*PGEXDL -- determine properties of PGPLOT display list
+C%void cpgexdl(const char *file, int *npict, int *istat);
+C+
+      SUBROUTINE PGEXDL (FILE, NPICT, ISTAT)
+      CHARACTER*(*) FILE
+      INTEGER NPICT, ISTAT
+C
+C Arguments:
+C  FILE   (input)  : name of display list to read
+C  NPICT  (output) : number of pictures in display list
+C  ISTAT  (output) : receives 0 if file is read successfully; 1 if
+C                    the file cannot be opened, 2 if it is not a
+C                    PGPLOT display list
+C--
+C 17-Oct-2026 - new routine.
+C-----------------------------------------------------------------------
+C
+      CALL GRDL0(FILE, NPICT, ISTAT)
+      IF (ISTAT.EQ.1) THEN
+         CALL GRWARN('Cannot open PGPLOT display list:')
+         CALL GRWARN(FILE(1:LEN(FILE)))
+      ELSE IF (ISTAT.EQ.2) THEN
+         CALL GRWARN('File is not a PGPLOT display list:')
+         CALL GRWARN(FILE(1:LEN(FILE)))
+      END IF
+      CALL GRDL3
+      END
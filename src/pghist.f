@@ -25,7 +25,7 @@ C  DATMAX (input)  : the maximum data value for the histogram.
 C  NBIN   (input)  : the number of bins to use: the range DATMIN to
 C                    DATMAX is divided into NBIN equal bins and
 C                    the number of DATA values in each bin is
-C                    determined by PGHIST.  NBIN may not exceed 200.
+C                    determined by PGHIST.
 C  PGFLAG (input)  : if PGFLAG = 1, the histogram is plotted in the
 C                    current window and viewport; if PGFLAG = 0,
 C                    PGENV is called automatically by PGHIST to start
@@ -44,35 +44,32 @@ C The pen position is changed to (DATMAX,0.0) in world coordinates.
 C--
 C  6-Sep-83:
 C 11-Feb-92: fill options added.
+C 17-Oct-2026: no limit on NBIN; the values are binned by GRHIS0,
+C            which may use several threads (PGPLOT_HIST_THREADS).
 C-----------------------------------------------------------------------
       INTEGER  MAXBIN
       PARAMETER (MAXBIN=200)
-      INTEGER  I, IBIN, NUM(MAXBIN), NUMMAX, JUNK
+      INTEGER  IBIN, K, NUM(MAXBIN), NUMMAX, JUNK, IER
       REAL     BINSIZ, PGRND
       REAL     CUR, PREV, XLO, XHI, YLO, YHI
       LOGICAL  PGNOTO
 C
-      IF (N.LT.1 .OR. DATMAX.LE.DATMIN .OR. NBIN.LT.1 .OR.
-     1    NBIN.GT.MAXBIN) THEN
+      IF (N.LT.1 .OR. DATMAX.LE.DATMIN .OR. NBIN.LT.1) THEN
           CALL GRWARN('PGHIST: invalid arguments')
           RETURN
       END IF
       IF (PGNOTO('PGHIST')) RETURN
       CALL PGBBUF
 C
-C How many values in each bin?
+C How many values in each bin? The counts are kept by GRHIS0 and
+C fetched MAXBIN at a time into NUM.
 C
-      DO 10 IBIN=1,NBIN
-          NUM(IBIN) = 0
-   10 CONTINUE
-      DO 20 I=1,N
-          IBIN = (DATA(I)-DATMIN)/(DATMAX-DATMIN)*NBIN+1
-          IF (IBIN.GE.1 .AND. IBIN.LE.NBIN) NUM(IBIN) = NUM(IBIN)+1
-   20 CONTINUE
-      NUMMAX = 0
-      DO 30 IBIN=1,NBIN
-          NUMMAX = MAX(NUMMAX,NUM(IBIN))
-   30 CONTINUE
+      CALL GRHIS0(N, DATA, DATMIN, DATMAX, NBIN, NUMMAX, IER)
+      IF (IER.NE.0) THEN
+          CALL GRWARN('PGHIST: not enough memory')
+          CALL PGEBUF
+          RETURN
+      END IF
       BINSIZ = (DATMAX-DATMIN)/NBIN
 C
 C Boundaries of plot.
@@ -95,7 +92,9 @@ C
          XHI=DATMIN
          CALL GRMOVA(DATMIN,0.0)
          DO 40 IBIN=1,NBIN
-            CUR = NUM(IBIN)
+            K = MOD(IBIN-1,MAXBIN)+1
+            IF (K.EQ.1) CALL GRHIS1(IBIN, MIN(MAXBIN,NBIN-IBIN+1), NUM)
+            CUR = NUM(K)
             XLO=XHI
             XHI = DATMIN + IBIN*BINSIZ
             IF (CUR.EQ.0.0) THEN
@@ -115,7 +114,9 @@ C
          PREV = 0.0
          XHI = DATMIN
          DO 50 IBIN=1,NBIN
-            CUR = NUM(IBIN)
+            K = MOD(IBIN-1,MAXBIN)+1
+            IF (K.EQ.1) CALL GRHIS1(IBIN, MIN(MAXBIN,NBIN-IBIN+1), NUM)
+            CUR = NUM(K)
             XLO=XHI
             XHI = DATMIN + IBIN*BINSIZ
             IF (CUR.EQ.0.0) THEN
@@ -129,7 +130,9 @@ C
          CALL GRMOVA(DATMIN,0.0)
          XHI=DATMIN
          DO 60 IBIN=1,NBIN
-            CUR = NUM(IBIN)
+            K = MOD(IBIN-1,MAXBIN)+1
+            IF (K.EQ.1) CALL GRHIS1(IBIN, MIN(MAXBIN,NBIN-IBIN+1), NUM)
+            CUR = NUM(K)
             XLO = XHI
             XHI = DATMIN + IBIN*BINSIZ
             IF (CUR.EQ.0.0 .AND. PREV.EQ.0.0) THEN
@@ -9,10 +9,6 @@ C are drawn using the current line attributes: line style, line width,
 C and color index. Cross-hatching can be achieved by calling this
 C routine twice.
 C
-C Limitations: the hatching will not be done correctly if the
-C polygon is so complex that a hatch line intersects more than
-C 32 of its sides.
-C
 C Arguments:
 C  N      (input)  : the number of vertices of the polygonal.
 C  X,Y    (input)  : the (x,y) world-coordinates of the vertices
@@ -24,17 +20,19 @@ C Reference: I.O. Angel and G. Griffith "High-resolution computer
 C graphics using Fortran 77", Halsted Press, 1987.
 C
 C 18-Feb-1995 [TJP].
+C 17-Oct-2026 - find the intersections with the scan converter
+C               GRFAS0/GRFAS1; there is no longer a limit of 32
+C               intersections per hatch line.
 C-----------------------------------------------------------------------
 C
-C MAXP is the maximum number of intersections any hatch line may make 
-C with the sides of the polygon.
+C MAXP is the number of intersections fetched from GRFAS1 at a time.
 C
       INTEGER MAXP
-      PARAMETER (MAXP=32)
-      INTEGER NP(MAXP), I,J, II,JJ, NMIN,NMAX, NX, NI, NNP
+      PARAMETER (MAXP=256)
+      INTEGER I,J, NMIN,NMAX, NX, IER
       REAL ANGLE, SEPN, PHASE
-      REAL RMU(MAXP), DX,DY, C, CMID,CMIN,CMAX, SX,SY, EX,EY, DELTA
-      REAL QX,QY, R, RMU1, RMU2, XI,YI, BX,BY
+      REAL RMU(MAXP), DX,DY, C, CMID,CMIN,CMAX, SX,SY, TR(6)
+      REAL RMU1, RMU2, BX,BY
       REAL DH, XS1, XS2, YS1, YS2, XL, XR, YT, YB, DINDX, DINDY
 C
 C Check arguments.
@@ -104,69 +102,35 @@ C
       NMAX = INT(CMAX)
       IF (REAL(NMAX).GT.CMAX) NMAX = NMAX-1
 C
-C Each iteration of the following loop draws one hatch line.
-C
-      DO 60 J=NMIN,NMAX
-C
-C The parametric representation of this hatch line is
-C (X,Y) = (QX,QY) + RMU*(DX,DY).
-C
-         QX = BX + REAL(J)*SX
-         QY = BY + REAL(J)*SY
-C
-C Find the NX intersections of this line with the edges of the polygon.
-C
-         NX = 0
-         NI = N
-         DO 20 I=1,N
-            EX = (X(I) - X(NI))*DINDX
-            EY = (Y(I) - Y(NI))*DINDY
-            DELTA = EX*DY - EY*DX
-            IF (ABS(DELTA).LT.1E-5) THEN
-C                 -- lines are parallel
-            ELSE
-C                 -- lines intersect in (XI,YI)
-               R = ((QX-X(NI)*DINDX)*DY - (QY-Y(NI)*DINDY)*DX)/DELTA
-               IF (R.GT.0.0 .AND. R.LE.1.0) THEN
-                  IF (NX.LT.MAXP) NX = NX+1
-                  NP(NX) = NX
-                  IF (ABS(DX).GT.0.5) THEN
-                     XI = X(NI)*DINDX + R*EX
-                     RMU(NX) = (XI-QX)/DX
-                  ELSE
-                     YI = Y(NI)*DINDY + R*EY
-                     RMU(NX) = (YI-QY)/DY
-                  END IF
-               END IF
-            END IF
-            NI = I
- 20      CONTINUE
-C     
-C The RMU array now contains the intersections. Sort them into order.
-C
-         DO 40 II=1,NX-1
-            DO 30 JJ=II+1,NX
-               IF (RMU(NP(II)).LT.RMU(NP(JJ))) THEN
-                  NNP = NP(II)
-                  NP(II) = NP(JJ)
-                  NP(JJ) = NNP
-               END IF
- 30         CONTINUE
- 40      CONTINUE
-C
-C Join the intersections in pairs.
-C
-         NI = 1
-C         -- do while NI < NX
- 50      IF (NI .LT. NX) THEN
-            RMU1 = RMU(NP(NI))
-            RMU2 = RMU(NP(NI+1))
-            CALL PGMOVE((QX+RMU1*DX)/DINDX, (QY+RMU1*DY)/DINDY)
-            CALL PGDRAW((QX+RMU2*DX)/DINDX, (QY+RMU2*DY)/DINDY)
-            NI = NI+2
+C In coordinates (RMU,C-CMID), where RMU is the distance along the
+C hatch lines, the lines are C-CMID = J*DH. GRFAS1 returns the
+C intersections of each line J with the polygon, in pairs to be
+C joined; no line is returned if it does not intersect the polygon.
+C
+      TR(1) = 0.0
+      TR(2) = DX*DINDX
+      TR(3) = DY*DINDY
+      TR(4) = -CMID
+      TR(5) = (-DY)*DINDX
+      TR(6) = DX*DINDY
+      CALL GRFAS0(N, X, Y, TR, DH, NMIN, NMAX, IER)
+      IF (IER.NE.0) THEN
+         CALL GRWARN('PGHTCH - not enough memory.')
+      ELSE
+C        -- DO WHILE (NX.GT.0)
+   50    CALL GRFAS1(J, RMU, MAXP, NX)
+         IF (NX.GT.0) THEN
+            C = CMID + REAL(J)*DH
+            DO 60 I=1,NX-1,2
+               RMU1 = RMU(I)
+               RMU2 = RMU(I+1)
+               CALL PGMOVE((RMU1*DX-C*DY)/DINDX, (RMU1*DY+C*DX)/DINDY)
+               CALL PGDRAW((RMU2*DX-C*DY)/DINDX, (RMU2*DY+C*DX)/DINDY)
+   60       CONTINUE
             GOTO 50
          END IF
- 60   CONTINUE
+C        -- end DO WHILE
+      END IF
 C
 C Tidy up.
 C
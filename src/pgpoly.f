@@ -32,12 +32,11 @@ C 25-Nov-1994 - implement clipping [TJP].
 C 13-Jan-1994 - fix bug in clipping [TJP].
 C  6-Mar-1995 - add support for fill styles 3 and 4 [TJP].
 C 12-Sep-1995 - fix another bug in clipping [TJP].
+C 17-Oct-2026 - clip with GRPOCS, which has no limit on the number of
+C               vertices.
 C-----------------------------------------------------------------------
-      INTEGER MAXOUT
-      PARAMETER (MAXOUT=1000)
       LOGICAL CLIP
-      INTEGER I, N1, N2, N3, N4
-      REAL    QX(MAXOUT), QY(MAXOUT), RX(MAXOUT), RY(MAXOUT)
+      INTEGER I, IER
       REAL    XL, XH, YL, YH
       LOGICAL PGNOTO
       INCLUDE 'pgplot.inc'
@@ -87,25 +86,12 @@ C
          IF (.NOT.CLIP) THEN
             CALL GRFA(N,XPTS,YPTS)
 C     
-C Filled style, clipping required: the vertices of the clipped
-C polygon are put in temporary arrays QX,QY, RX, RY.
+C Filled style, clipping required: GRPOCS clips the polygon and
+C passes the result to GRFA.
 C     
          ELSE
-            CALL GRPOCL(N,  XPTS, YPTS, 1, XL, MAXOUT, N1, QX, QY)
-            IF (N1.GT.MAXOUT) GOTO 40
-            IF (N1.LT.3) GOTO 50
-            CALL GRPOCL(N1, QX,   QY,   2, XH, MAXOUT, N2, RX, RY)
-            IF (N2.GT.MAXOUT) GOTO 40
-            IF (N2.LT.3) GOTO 50
-            CALL GRPOCL(N2, RX,   RY,   3, YL, MAXOUT, N3, QX, QY)
-            IF (N3.GT.MAXOUT) GOTO 40
-            IF (N3.LT.3) GOTO 50
-            CALL GRPOCL(N3, QX,   QY,   4, YH, MAXOUT, N4, RX, RY)
-            IF (N4.GT.MAXOUT) GOTO 40
-            IF (N4.GT.0) CALL GRFA(N4,RX,RY)
-            GOTO 50
- 40         CALL GRWARN('PGPOLY: polygon is too complex')
- 50         CONTINUE
+            CALL GRPOCS(N, XPTS, YPTS, XL, XH, YL, YH, IER)
+            IF (IER.NE.0) CALL GRWARN('PGPOLY: not enough memory')
          END IF
       END IF
 C
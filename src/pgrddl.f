@@ -0,0 +1,92 @@
+C*PGRDDL -- read and display a picture from a PGPLOT display list
+C%void cpgrddl(const char *file, const char *opt, int npict, int *istat);
+C+
+      SUBROUTINE PGRDDL (FILE, OPT, NPICT, ISTAT)
+      CHARACTER*(*) FILE, OPT
+      INTEGER NPICT, ISTAT
+C
+C This routine reads a PGPLOT display list, written by the /PGDL
+C device, from a disk file and displays one of its pictures in the
+C current viewport. The picture is scaled to fit the viewport, keeping
+C its aspect ratio, and it is clipped to the viewport if clipping is
+C enabled (see PGSCLP). The window is changed, but the other attributes
+C are restored on return. The program that made the display list need
+C not be run again, and the same file can be displayed on any number of
+C devices of any type.
+C
+C Arguments:
+C  FILE   (input)  : name of display list to read
+C  OPT    (input)  : string of single-character options (see below)
+C  NPICT  (input)  : sequence number of picture to display
+C  ISTAT  (output) : receives 0 if file is read successfully; >0 if
+C                    an error occurs (1 if the file cannot be opened,
+C                    2 if it is not a display list, 3 if the requested
+C                    picture is not in the file)
+C
+C Options:
+C  M : display in monochrome, using color indices 0 and 1;
+C      all color information in the display list will be ignored.
+C  G : display in grey scale: colors in the display list will be
+C      converted to shades of grey.
+C--
+C 17-Oct-2026 - new routine.
+C-----------------------------------------------------------------------
+      INCLUDE 'pgplot.inc'
+      INTEGER IER, MODE, N
+      REAL    XMAX, YMAX, XPPI, YPPI, TR(4), CLIP(4), LWFAC
+      REAL    X1, X2, Y1, Y2
+      LOGICAL PGNOTO
+C
+      IF (PGNOTO('PGRDDL')) RETURN
+      MODE = 0
+      IF (INDEX(OPT,'G').NE.0 .OR. INDEX(OPT,'g').NE.0) MODE = 2
+      IF (INDEX(OPT,'M').NE.0 .OR. INDEX(OPT,'m').NE.0) MODE = 1
+C
+C Open file and check that it is a PGPLOT display list.
+C
+      CALL GRDL0(FILE, N, IER)
+      IF (IER.EQ.0) CALL GRDL1(NPICT, XMAX, YMAX, XPPI, YPPI, IER)
+      ISTAT = IER
+      IF (IER.EQ.1) THEN
+         CALL GRWARN('Cannot open PGPLOT display list:')
+      ELSE IF (IER.EQ.2) THEN
+         CALL GRWARN('File is not a PGPLOT display list:')
+      ELSE IF (IER.EQ.3) THEN
+         CALL GRWARN('Requested picture not found in PGPLOT display '//
+     :               'list:')
+      END IF
+      IF (IER.NE.0) THEN
+         CALL GRWARN(FILE(1:LEN(FILE)))
+         CALL GRDL3
+         RETURN
+      END IF
+C
+C Display this picture, using its device coordinates as world
+C coordinates.
+C
+      CALL PGBBUF
+      CALL PGSAVE
+      CALL PGWNAD(0.0, XMAX, 0.0, YMAX)
+      TR(1) = PGXORG(PGID)
+      TR(2) = PGXSCL(PGID)
+      TR(3) = PGYORG(PGID)
+      TR(4) = PGYSCL(PGID)
+      IF (PGCLP(PGID).NE.0) THEN
+         CLIP(1) = PGXOFF(PGID)
+         CLIP(2) = PGXOFF(PGID) + PGXLEN(PGID)
+         CLIP(3) = PGYOFF(PGID)
+         CLIP(4) = PGYOFF(PGID) + PGYLEN(PGID)
+      ELSE
+         CALL PGQVSZ(3, X1, X2, Y1, Y2)
+         CLIP(1) = X1
+         CLIP(2) = X2
+         CLIP(3) = Y1
+         CLIP(4) = Y2
+      END IF
+C     -- line widths are in inches, so scale them with the picture
+      LWFAC = XPPI*PGXSCL(PGID)/PGXPIN(PGID)
+      CALL GRDL2(NPICT, PGID, TR, CLIP, LWFAC, MODE)
+      CALL GRDL3
+      CALL PGUNSA
+      CALL PGEBUF
+      END
@@ -736,6 +736,8 @@ C 20-Apr-1991 - add support for new DD (day) field [nebk]
 C 10-Jun-1993 - complete rewrite & rename from PGTLAB. Fixes user given 
 C               ticks bug too [nebk]
 C 15-Jan-1995 - Add argument MOD24
+C 17-Oct-2026 - Don't use IVALZ uninitialized when the first tick
+C               is zero.
 C-----------------------------------------------------------------------
       INTEGER MAXTIK
       LOGICAL T, F
@@ -1004,6 +1006,7 @@ C  left to right without a zero (one pass)
 C
         DO 250 K = 1, 3
           IVALO(K) = IVALZ(K)
+          IF (IZERO.EQ.1) IVALO(K) = IVALF(K)
           IF (IZERO.EQ.0) THEN
             IVALO(K) = IVALL(K)
             IF (JST(I).EQ.1) IVALO(K) = IVALF(K)
@@ -0,0 +1,618 @@
+/*GRCONS -- contouring engine for PGCONS and PGCONB
+ * +
+ *
+ * GRCNS0 and GRCNS1 do the work of PGCONS and PGCONB: they find where
+ * each contour level crosses the cells of a 2D array and join the
+ * crossings into polylines, which the caller then draws.
+ *
+ *   CALL GRCNS0(A, IDIM, JDIM, I1, I2, J1, J2, C, NC, TR, BLANK,
+ *               IBLANK, IER)
+ *
+ * starts contouring A(I1:I2,J1:J2) at the NC levels in C(), using the
+ * transformation TR(6) of PGCONS. If IBLANK is 1, array elements equal
+ * to BLANK are ignored, as in PGCONB. IER is returned as 0, or 1 if
+ * there is not enough memory (the caller should then use a simpler
+ * method). Then
+ *
+ *   CALL GRCNS1(X, Y, NMAX, N)
+ *
+ * is called repeatedly to fetch up to NMAX vertices of the polylines in
+ * world coordinates. If N > 0 the points start a new polyline; if N < 0
+ * they continue the previous one (draw to each of the -N points in
+ * turn). N = 0 means that there are no more.
+ *
+ * The cells are taken one at a time, and only the levels that lie
+ * between the smallest and largest corner values of a cell (found by a
+ * binary search in a sorted copy of C) are considered. The line
+ * segments drawn in each cell, including the choice made where a level
+ * crosses all four sides of a cell, are the same as in the original
+ * cell-by-cell algorithm of PGCONS. Each crossing point is computed
+ * once and shared by the two cells either side of it, so a few points
+ * may differ from that algorithm in the last bit.
+ *
+ * The array is divided into bands of rows that are contoured
+ * independently (contours are broken at the band boundaries). If the
+ * environment variable PGPLOT_CONTOUR_THREADS is set to a number
+ * greater than 1, and POSIX threads are available (HAVE_PTHREAD), that
+ * many threads contour bands in parallel. The bands are always returned
+ * in order, so the output does not depend on the number of threads.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#ifdef PG_PPU
+#define GRCNS0 grcns0_
+#define GRCNS1 grcns1_
+#else
+#define GRCNS0 grcns0
+#define GRCNS1 grcns1
+#endif
+
+#define BAND_CELLS 262144  /* Minimum number of cells in a band */
+#define BAND_ROWS 64       /* Minimum number of rows in a band */
+#define MAX_THREADS 64
+
+/*
+ * A line segment joining the crossings of level k on two sides of a
+ * cell. The sides of a cell with corners (I-1,J-1) and (I,J) are
+ * numbered 0 (I-1), 1 (J-1), 2 (I) and 3 (J), which is the order used by
+ * PGCONS.
+ */
+typedef struct {
+  int k;                 /* Index of the level in grcn.lev[] */
+  unsigned char side[2]; /* Sides of the cell that are joined */
+  unsigned char done;    /* True once the segment has been output */
+} GrcnSeg;
+
+/*
+ * The contours of one band of rows. Cell (I,J) of the band is number
+ * (J-jlo)*ni + (I-i1-1), and its segments are seg[cell[n]...cell[n+1]-1],
+ * in order of level. The polylines are stored as vertices x[],y[] and
+ * the number of vertices in each, len[].
+ */
+typedef struct {
+  int jlo, jhi;          /* Range of J for the cells of the band */
+  int ready;             /* True when the band has been contoured */
+  int *cell; size_t ncell;
+  GrcnSeg *seg; size_t nseg, mseg;
+  float *x, *y; size_t npt, mpt;
+  int *len; size_t nline, mline;
+  int error;             /* True if memory ran out */
+} GrcnBand;
+
+static struct {
+  const float *a;        /* The data array, A(IDIM,*) */
+  int idim, i1, i2, j1, j2;
+  float *lev;            /* Sorted contour levels */
+  int nlev;
+  float tr[6];
+  int iblank;
+  float blank;
+  int rows;              /* Rows of cells per band */
+  int nband;             /* Number of bands */
+  GrcnBand *slot;        /* Band b is contoured in slot[b % nslot] */
+  int nslot;
+  int emit;              /* Band being returned by GRCNS1 */
+  size_t line;           /* Next polyline of that band to return */
+  size_t pt;             /* Index of its next vertex in x[],y[] */
+  size_t rest;           /* Vertices left in the current polyline */
+  int active;            /* True between GRCNS0 and the end of output */
+  int warned;
+#ifdef HAVE_PTHREAD
+  int work;              /* Next band to be contoured by a thread */
+  int nthread;
+  pthread_t thread[MAX_THREADS];
+#endif
+} grcn = {0};
+
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t grcn_lock = PTHREAD_MUTEX_INITIALIZER;
+/* grcn_cond is broadcast when a band is done or its slot is released */
+static pthread_cond_t grcn_cond = PTHREAD_COND_INITIALIZER;
+#endif
+
+#define A(i,j) grcn.a[(size_t)((i)-1) + (size_t)((j)-1)*grcn.idim]
+
+static int grcn_cmp(const void *p, const void *q)
+{
+  float a = *(const float *) p, b = *(const float *) q;
+  return a < b ? -1 : a > b;
+}
+
+/*
+ * Grow an array to hold at least n elements of the given size.
+ */
+static int grcn_grow(void **ptr, size_t *max, size_t n, size_t size)
+{
+  size_t m;
+  void *p;
+  if(n <= *max)
+    return 0;
+  m = *max ? *max : 1024;
+  while(m < n)
+    m *= 2;
+  p = realloc(*ptr, m * size);
+  if(!p)
+    return -1;
+  *ptr = p;
+  *max = m;
+  return 0;
+}
+
+static int grcn_isblank(float v)
+{
+  return grcn.iblank && v == grcn.blank;
+}
+
+/*
+ * Add a segment of level k joining sides s0 and s1 to band b.
+ */
+static int grcn_seg(GrcnBand *b, int k, int s0, int s1)
+{
+  GrcnSeg *s;
+  if(b->nseg >= b->mseg &&
+     grcn_grow((void **) &b->seg, &b->mseg, b->nseg + 1, sizeof(GrcnSeg)))
+    return -1;
+  s = &b->seg[b->nseg++];
+  s->k = k;
+  s->side[0] = (unsigned char) s0;
+  s->side[1] = (unsigned char) s1;
+  s->done = 0;
+  return 0;
+}
+
+/*
+ * Find the segments of every cell of band b.
+ */
+static int grcn_cells(GrcnBand *b)
+{
+  static const int ioff[8] = {-2,-2,-1,-1, 0, 0, 1, 1};
+  static const int joff[8] = { 0,-1,-2, 1,-2, 1,-1, 0};
+  int ni = grcn.i2 - grcn.i1;
+  size_t ncell = (size_t) ni * (b->jhi - b->jlo + 1);
+  size_t n = 0;
+  int i, j, k, m;
+  if(b->ncell < ncell + 1) {
+    int *cell = (int *) realloc(b->cell, (ncell + 1) * sizeof(int));
+    if(!cell)
+      return -1;
+    b->cell = cell;
+    b->ncell = ncell + 1;
+  };
+  b->nseg = 0;
+  for(j=b->jlo; j<=b->jhi; j++) {
+    for(i=grcn.i1+1; i<=grcn.i2; i++) {
+      float d[5], lo, hi;
+      int lo_k, hi_k;
+      b->cell[n++] = (int) b->nseg;
+      d[0] = A(i-1,j);
+      d[1] = A(i-1,j-1);
+      d[2] = A(i,j-1);
+      d[3] = A(i,j);
+      d[4] = d[0];
+      if(grcn_isblank(d[0]) || grcn_isblank(d[1]) ||
+	 grcn_isblank(d[2]) || grcn_isblank(d[3]))
+	continue;
+      if(d[0] != d[0] || d[1] != d[1] || d[2] != d[2] || d[3] != d[3])
+	continue;
+      lo = hi = d[0];
+      for(m=1; m<4; m++) {
+	if(d[m] < lo) lo = d[m];
+	if(d[m] > hi) hi = d[m];
+      };
+/*
+ * A level crosses the cell if lo < level <= hi. Find the first such
+ * level, k, by binary search.
+ */
+      lo_k = 0;
+      hi_k = grcn.nlev;
+      while(lo_k < hi_k) {
+	int mid = (lo_k + hi_k) / 2;
+	if(grcn.lev[mid] > lo)
+	  hi_k = mid;
+	else
+	  lo_k = mid + 1;
+      };
+      for(k=lo_k; k<grcn.nlev && grcn.lev[k] <= hi; k++) {
+	float ctr = grcn.lev[k];
+	int side[4], npt = 0;
+	for(m=0; m<4; m++) {
+	  if((d[m] < ctr && d[m+1] < ctr) || (d[m] >= ctr && d[m+1] >= ctr))
+	    continue;
+	  side[npt++] = m;
+	};
+	if(npt == 2) {
+	  if(grcn_seg(b, k, side[0], side[1]))
+	    return -1;
+	} else if(npt == 4) {
+/*
+ * The level crosses all four sides: choose between the two ways of
+ * joining them from the points just outside the cell, as PGCONS does.
+ */
+	  int itot = 0, ilo = 0, ienc;
+	  for(m=0; m<8; m++) {
+	    int it = i + ioff[m], jt = j + joff[m];
+	    float v;
+	    if(it < grcn.i1 || it > grcn.i2 || jt < grcn.j1 || jt > grcn.j2)
+	      continue;
+	    v = A(it,jt);
+	    if(grcn_isblank(v))
+	      continue;
+	    itot++;
+	    if(v < ctr)
+	      ilo++;
+	  };
+	  ienc = ilo < itot/2 ? -1 : 1;
+	  if((ienc < 0 && d[0] < ctr) || (ienc > 0 && d[0] >= ctr)) {
+	    if(grcn_seg(b, k, 0, 1) || grcn_seg(b, k, 2, 3))
+	      return -1;
+	  } else {
+	    if(grcn_seg(b, k, 0, 3) || grcn_seg(b, k, 2, 1))
+	      return -1;
+	  };
+	};
+      };
+    };
+  };
+  b->cell[n] = (int) b->nseg;
+  return 0;
+}
+
+/*
+ * Add the world coordinates of the point where level k crosses side s
+ * of cell (i,j) to the polylines of band b. The crossing is always
+ * interpolated from the corner with the smaller index, so the two cells
+ * that share a side compute the same point.
+ */
+static int grcn_point(GrcnBand *b, int i, int j, int s, int k)
+{
+  float ctr = grcn.lev[k], xx, yy;
+  if(b->npt >= b->mpt) {
+    size_t m = b->mpt;
+    if(grcn_grow((void **) &b->x, &m, b->npt + 1, sizeof(float)) ||
+       grcn_grow((void **) &b->y, &b->mpt, b->npt + 1, sizeof(float)))
+      return -1;
+  };
+  switch(s) {
+  case 0:
+  case 2:
+    if(s == 0)
+      i--;
+    xx = (float) i;
+    yy = (float) (j-1) + (ctr - A(i,j-1)) / (A(i,j) - A(i,j-1));
+    break;
+  default:
+    if(s == 3)
+      j++;
+    xx = (float) (i-1) + (ctr - A(i-1,j-1)) / (A(i,j-1) - A(i-1,j-1));
+    yy = (float) (j-1);
+    break;
+  };
+  b->x[b->npt] = grcn.tr[0] + grcn.tr[1]*xx + grcn.tr[2]*yy;
+  b->y[b->npt] = grcn.tr[3] + grcn.tr[4]*xx + grcn.tr[5]*yy;
+  b->npt++;
+  return 0;
+}
+
+/*
+ * Find the segment of level k that continues from side s of cell
+ * (*i,*j) of band b into the neighbouring cell. On success the cell
+ * and the side by which it is entered are returned in *i, *j, *s, and
+ * the segment number is returned; otherwise -1 is returned.
+ */
+static int grcn_next(GrcnBand *b, int *i, int *j, int *s, int k)
+{
+  int ni = grcn.i2 - grcn.i1;
+  int in = *i, jn = *j, sn = (*s + 2) % 4;
+  int lo, hi, n;
+  switch(*s) {
+  case 0: in--; break;
+  case 1: jn--; break;
+  case 2: in++; break;
+  default: jn++; break;
+  };
+  if(in <= grcn.i1 || in > grcn.i2 || jn < b->jlo || jn > b->jhi)
+    return -1;
+  n = (jn - b->jlo) * ni + (in - grcn.i1 - 1);
+  lo = b->cell[n];
+  hi = b->cell[n+1];
+  while(lo < hi) {
+    int mid = (lo + hi) / 2;
+    if(b->seg[mid].k < k)
+      lo = mid + 1;
+    else
+      hi = mid;
+  };
+  for(; lo < b->cell[n+1] && b->seg[lo].k == k; lo++) {
+    if(b->seg[lo].side[0] == sn || b->seg[lo].side[1] == sn) {
+      *i = in;
+      *j = jn;
+      *s = sn;
+      return lo;
+    };
+  };
+  return -1;
+}
+
+/*
+ * Contour band b: find its segments and join them into polylines.
+ */
+static int grcn_band(GrcnBand *b)
+{
+  int i, j, n, cell = 0;
+  b->npt = b->nline = 0;
+  if(grcn_cells(b))
+    return -1;
+  for(j=b->jlo; j<=b->jhi; j++) {
+    for(i=grcn.i1+1; i<=grcn.i2; i++, cell++) {
+      for(n=b->cell[cell]; n<b->cell[cell+1]; n++) {
+	GrcnSeg *seg = &b->seg[n];
+	int k = seg->k, ic = i, jc = j, s = seg->side[0], t, start = n;
+	size_t first = b->npt;
+	if(seg->done)
+	  continue;
+/*
+ * Follow the contour backwards to the start of the polyline (or
+ * round a closed loop back to this segment).
+ */
+	for(;;) {
+	  int it = ic, jt = jc;
+	  t = grcn_next(b, &it, &jt, &s, k);
+	  if(t < 0 || t == n)
+	    break;
+	  start = t;
+	  ic = it;
+	  jc = jt;
+	  s = b->seg[t].side[0] == s ? b->seg[t].side[1] : b->seg[t].side[0];
+	};
+	if(t == n) {
+	  ic = i;
+	  jc = j;
+	  start = n;
+	  s = seg->side[0];
+	};
+/*
+ * Then follow it forwards, adding a vertex on each side crossed.
+ */
+	if(grcn_point(b, ic, jc, s, k))
+	  return -1;
+	t = start;
+	for(;;) {
+	  b->seg[t].done = 1;
+	  s = b->seg[t].side[0] == s ? b->seg[t].side[1] : b->seg[t].side[0];
+	  if(grcn_point(b, ic, jc, s, k))
+	    return -1;
+	  t = grcn_next(b, &ic, &jc, &s, k);
+	  if(t < 0 || b->seg[t].done)
+	    break;
+	};
+	if(b->nline >= b->mline &&
+	   grcn_grow((void **) &b->len, &b->mline, b->nline + 1, sizeof(int)))
+	  return -1;
+	b->len[b->nline++] = (int) (b->npt - first);
+      };
+    };
+  };
+  return 0;
+}
+
+/*
+ * Contour band number k into its slot.
+ */
+static void grcn_do_band(int k)
+{
+  GrcnBand *b = &grcn.slot[k % grcn.nslot];
+  b->jlo = grcn.j1 + 1 + k * grcn.rows;
+  b->jhi = b->jlo + grcn.rows - 1;
+  if(b->jhi > grcn.j2)
+    b->jhi = grcn.j2;
+  b->error = grcn_band(b) != 0;
+}
+
+#ifdef HAVE_PTHREAD
+static void *grcn_thread(void *arg)
+{
+  for(;;) {
+    int k;
+    pthread_mutex_lock(&grcn_lock);
+    while(grcn.work < grcn.nband && grcn.work >= grcn.emit + grcn.nslot)
+      pthread_cond_wait(&grcn_cond, &grcn_lock);
+    k = grcn.work++;
+    pthread_mutex_unlock(&grcn_lock);
+    if(k >= grcn.nband)
+      return NULL;
+    grcn_do_band(k);
+    pthread_mutex_lock(&grcn_lock);
+    grcn.slot[k % grcn.nslot].ready = 1;
+    pthread_cond_broadcast(&grcn_cond);
+    pthread_mutex_unlock(&grcn_lock);
+  };
+}
+#endif
+
+/*
+ * Make band grcn.emit ready to be returned.
+ */
+static void grcn_wait(void)
+{
+  GrcnBand *b = &grcn.slot[grcn.emit % grcn.nslot];
+#ifdef HAVE_PTHREAD
+  if(grcn.nthread > 0) {
+    pthread_mutex_lock(&grcn_lock);
+    while(!b->ready)
+      pthread_cond_wait(&grcn_cond, &grcn_lock);
+    pthread_mutex_unlock(&grcn_lock);
+  } else
+#endif
+  grcn_do_band(grcn.emit);
+  if(b->error && !grcn.warned) {
+    fprintf(stderr, "%%PGPLOT, Not enough memory for contouring; some contours are missing.\n");
+    grcn.warned = 1;
+  };
+  grcn.line = grcn.pt = grcn.rest = 0;
+}
+
+/*
+ * Finish with the current band and start on the next.
+ */
+static void grcn_advance(void)
+{
+#ifdef HAVE_PTHREAD
+  if(grcn.nthread > 0) {
+    pthread_mutex_lock(&grcn_lock);
+    grcn.slot[grcn.emit % grcn.nslot].ready = 0;
+    grcn.emit++;
+    pthread_cond_broadcast(&grcn_cond);
+    pthread_mutex_unlock(&grcn_lock);
+  } else
+#endif
+  grcn.emit++;
+  if(grcn.emit < grcn.nband)
+    grcn_wait();
+}
+
+/*
+ * Stop the threads and release the memory used for contouring.
+ */
+static void grcn_end(void)
+{
+  int n;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock(&grcn_lock);
+  grcn.work = grcn.nband;
+  pthread_cond_broadcast(&grcn_cond);
+  pthread_mutex_unlock(&grcn_lock);
+  for(n=0; n<grcn.nthread; n++)
+    pthread_join(grcn.thread[n], NULL);
+  grcn.nthread = 0;
+#endif
+  for(n=0; n<grcn.nslot; n++) {
+    free(grcn.slot[n].cell);
+    free(grcn.slot[n].seg);
+    free(grcn.slot[n].x);
+    free(grcn.slot[n].y);
+    free(grcn.slot[n].len);
+  };
+  free(grcn.slot);
+  free(grcn.lev);
+  grcn.slot = NULL;
+  grcn.lev = NULL;
+  grcn.nslot = 0;
+  grcn.active = 0;
+}
+
+void GRCNS0(const float *a, int *idim, int *jdim, int *i1, int *i2,
+	    int *j1, int *j2, const float *c, int *nc, const float *tr,
+	    float *blank, int *iblank, int *ier)
+{
+  int ni = *i2 - *i1, nj = *j2 - *j1;
+  int n, nthread = 1;
+  char *string;
+  if(grcn.active)
+    grcn_end();
+  *ier = 1;
+  grcn.a = a;
+  grcn.idim = *idim;
+  grcn.i1 = *i1;
+  grcn.i2 = *i2;
+  grcn.j1 = *j1;
+  grcn.j2 = *j2;
+  memcpy(grcn.tr, tr, sizeof(grcn.tr));
+  grcn.iblank = *iblank == 1;
+  grcn.blank = *blank;
+  grcn.warned = 0;
+/*
+ * Sort the levels, discarding any that are not numbers.
+ */
+  grcn.lev = (float *) malloc((*nc > 0 ? *nc : 1) * sizeof(float));
+  if(!grcn.lev)
+    return;
+  grcn.nlev = 0;
+  for(n=0; n<*nc; n++)
+    if(c[n] == c[n])
+      grcn.lev[grcn.nlev++] = c[n];
+  qsort(grcn.lev, grcn.nlev, sizeof(float), grcn_cmp);
+/*
+ * Divide the rows into bands.
+ */
+  grcn.rows = (BAND_CELLS + ni - 1) / ni;
+  if(grcn.rows < BAND_ROWS)
+    grcn.rows = BAND_ROWS;
+  if(grcn.rows > nj)
+    grcn.rows = nj;
+  grcn.nband = (nj + grcn.rows - 1) / grcn.rows;
+  if((string = getenv("PGPLOT_CONTOUR_THREADS")) && *string)
+    nthread = atoi(string);
+  if(nthread > MAX_THREADS)
+    nthread = MAX_THREADS;
+  if(nthread > grcn.nband)
+    nthread = grcn.nband;
+  if(nthread < 1)
+    nthread = 1;
+  grcn.nslot = nthread > 1 ? 2 * nthread : 1;
+  grcn.slot = (GrcnBand *) calloc(grcn.nslot, sizeof(GrcnBand));
+  if(!grcn.slot) {
+    free(grcn.lev);
+    grcn.lev = NULL;
+    grcn.nslot = 0;
+    return;
+  };
+  grcn.active = 1;
+  grcn.emit = 0;
+#ifdef HAVE_PTHREAD
+  grcn.work = 0;
+  grcn.nthread = 0;
+  if(nthread > 1) {
+    while(grcn.nthread < nthread &&
+	  pthread_create(&grcn.thread[grcn.nthread], NULL, grcn_thread,
+			 NULL) == 0)
+      grcn.nthread++;
+/*
+ * If no threads could be started, contour on this thread instead.
+ */
+    if(grcn.nthread == 0)
+      grcn.work = grcn.nband;
+  };
+#endif
+  *ier = 0;
+  grcn_wait();
+}
+
+void GRCNS1(float *x, float *y, int *nmax, int *n)
+{
+  GrcnBand *b;
+  int start = 0;
+  size_t m;
+  *n = 0;
+  if(!grcn.active)
+    return;
+  b = &grcn.slot[grcn.emit % grcn.nslot];
+  if(grcn.rest == 0) {
+    while(grcn.line >= b->nline) {
+      grcn_advance();
+      if(grcn.emit >= grcn.nband) {
+	grcn_end();
+	return;
+      };
+      b = &grcn.slot[grcn.emit % grcn.nslot];
+    };
+    grcn.rest = (size_t) b->len[grcn.line++];
+    start = 1;
+  };
+  m = grcn.rest < (size_t) *nmax ? grcn.rest : (size_t) *nmax;
+  memcpy(x, b->x + grcn.pt, m * sizeof(float));
+  memcpy(y, b->y + grcn.pt, m * sizeof(float));
+  *n = start ? (int) m : -(int) m;
+  grcn.pt += m;
+  grcn.rest -= m;
+}
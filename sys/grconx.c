@@ -0,0 +1,941 @@
+/*GRCONX -- contour-following engine for PGCONX
+ * +
+ *
+ * GRCNX0, GRCNX1 and GRCNX2 do the work of PGCONX: they follow the
+ * contours of a 2D array through the whole array and return them as
+ * polylines, which the caller passes to its PLOT routine.
+ *
+ *   CALL GRCNX0(A, IDIM, JDIM, I1, I2, J1, J2, IER)
+ *
+ * starts contouring A(I1:I2,J1:J2). Then, for each contour level Z0,
+ *
+ *   CALL GRCNX1(Z0, IER)
+ *
+ * traces the contours at that level, and
+ *
+ *   CALL GRCNX2(X, Y, NMAX, N)
+ *
+ * is called repeatedly to fetch up to NMAX vertices of the contours, in
+ * the (I,J) coordinates of the array. If N > 0 the points start a new
+ * contour (move to the first, then draw to the others); if N < 0 they
+ * continue the previous one (draw to each of the -N points in turn).
+ * N = 0 means that there are no more. IER is returned as 0, or 1 if
+ * there is not enough memory (the caller should then use PGCNSC on
+ * smaller panels). A must not change until the last level is done.
+ * Finally
+ *
+ *   CALL GRCNX3
+ *
+ * releases the memory and forgets A, which is not referred to after
+ * that.
+ *
+ * The contours are those that PGCNSC would draw if it could take the
+ * whole array at once: the same vertices, in the same direction
+ * (anticlockwise about maxima), starting at the same points, and in the
+ * same order. That is, first the contours that end on the edges of the
+ * array, in order of their starting points along the bottom, right, top
+ * and left edges, and then the closed ones, in order of the first
+ * crossing found by a search of the horizontal grid lines with I
+ * varying slowest. This works because the rule PGCN01 uses to leave
+ * each cell, together with the direction convention, gives every
+ * crossing a unique successor that does not depend on the order in
+ * which the contours are traced. There is one exception: where PGCN01
+ * returned to the start of a closed contour through a cell that the
+ * level crosses on all four sides, it could go on round a second closed
+ * contour not yet drawn, joining the two through that cell the other
+ * way from the rule. Here each closed contour ends where it started.
+ *
+ * There is no limit on the size of the array. It is divided into bands
+ * of rows, and in each band the pieces of contour that lie within it
+ * are traced as PGCN01 does. Then the pieces are joined where they
+ * cross from one band to the next, and each closed contour is rotated
+ * to start at the right point. The bands are divided into blocks of
+ * BLOCK_COLS columns, and GRCNX0 finds the range of the values in each
+ * block, so that each level only looks at the blocks it can cross. If
+ * the environment variable PGPLOT_CONTOUR_THREADS is set to a number
+ * greater than 1, and POSIX threads are available (HAVE_PTHREAD), that
+ * many threads work on the bands in parallel. The output does not
+ * depend on the number of threads.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ * 18-Oct-2026 - Add GRCNX3.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#ifdef PG_PPU
+#define GRCNX0 grcnx0_
+#define GRCNX1 grcnx1_
+#define GRCNX2 grcnx2_
+#define GRCNX3 grcnx3_
+#else
+#define GRCNX0 grcnx0
+#define GRCNX1 grcnx1
+#define GRCNX2 grcnx2
+#define GRCNX3 grcnx3
+#endif
+
+#define BAND_CELLS 262144  /* Minimum number of cells in a band */
+#define BAND_ROWS 64       /* Minimum number of rows in a band */
+#define BLOCK_COLS 32      /* Columns of cells in a block */
+#define MAX_THREADS 64
+
+/*
+ * Directions of travel, as in PGCN01, and the flags of a grid point:
+ * H if the contour crosses the line to (I+1,J), V if it crosses the line
+ * to (I,J+1).
+ */
+#define UP 1
+#define DOWN 2
+#define LEFT 3
+#define RIGHT 4
+#define H 1
+#define V 2
+
+/*
+ * How a piece of contour starts or ends: at the edge of the array, on
+ * the bottom or top row of its band (going down or up), or by closing on
+ * itself.
+ */
+#define EDGE 0
+#define SEAM_DOWN 1
+#define SEAM_UP 2
+#define LOOP 3
+
+/*
+ * A piece of contour within one band, with vertices x[first...first+npt-1]
+ * of the band.
+ */
+typedef struct {
+  size_t first;
+  int npt;
+  int start, end;        /* How the piece starts and ends */
+  int iend;              /* I of the crossing where it ends */
+  long rank;             /* Position of the start along the edge (EDGE) */
+  int ki, kj;            /* Smallest crossing of a horizontal grid line */
+  int kpt;               /*  and its vertex (-1 if none) */
+  int next;              /* The piece that follows, in the next band */
+  int done;              /* Mark of the last pass that reached the piece */
+} GrcxPiece;
+
+/*
+ * A crossing of the bottom or top row of a band where a piece starts.
+ */
+typedef struct {
+  int i;
+  int piece;
+} GrcxSeam;
+
+/*
+ * The contours of rows ja...jb of the array. Block k of the band has
+ * cells (I,J) with I = I1+k*BLOCK_COLS ... I1+(k+1)*BLOCK_COLS-1, and the
+ * values at its corners lie between lo[k] and hi[k].
+ */
+typedef struct {
+  int ja, jb;
+  float *lo, *hi;
+  GrcxPiece *piece; size_t npiece, mpiece;
+  float *x, *y; size_t npt, mpt;
+  GrcxSeam *up; size_t nup, mup;      /* Pieces entering the bottom row */
+  GrcxSeam *down; size_t ndown, mdown; /* Pieces entering the top row */
+  int error;
+} GrcxBand;
+
+/*
+ * A run of vertices to be returned by GRCNX2.
+ */
+typedef struct {
+  int band, piece;
+  int from, to;          /* Vertices from...to of the piece */
+  int start;             /* True if the run starts a new contour */
+} GrcxRun;
+
+typedef struct {
+  long r1;
+  int r2;
+  int band, piece, kpt;
+} GrcxOrder;
+
+static struct {
+  const float *a;        /* The data array, A(IDIM,*) */
+  int idim, i1, i2, j1, j2;
+  float z0;
+  size_t ni;             /* Number of grid points in a row, I2-I1+1 */
+  int rows;              /* Rows of cells per band */
+  int nband;
+  int nblock;            /* Blocks per band */
+  GrcxBand *band;
+  GrcxRun *run; size_t nrun, mrun;
+  size_t emit;           /* Next run to return */
+  int pt;                /* Next vertex of that run */
+  int active;            /* True from GRCNX1 to the end of its output */
+  int nthread;
+  int task;              /* 0 to find the ranges of the blocks, 1 to trace */
+#ifdef HAVE_PTHREAD
+  int work;              /* Next band to be done by a thread */
+#endif
+} grcx = {0};
+
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t grcx_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+#define A(i,j) grcx.a[(size_t)((i)-1) + (size_t)((j)-1)*grcx.idim]
+#define F(i,j) f[(size_t)((j)-b->ja)*grcx.ni + (size_t)((i)-grcx.i1)]
+
+/*
+ * Grow an array to hold at least n elements of the given size.
+ */
+static int grcx_grow(void **ptr, size_t *max, size_t n, size_t size)
+{
+  size_t m;
+  void *p;
+  if(n <= *max)
+    return 0;
+  m = *max ? *max : 256;
+  while(m < n)
+    m *= 2;
+  p = realloc(*ptr, m * size);
+  if(!p)
+    return -1;
+  *ptr = p;
+  *max = m;
+  return 0;
+}
+
+/*
+ * Return true if the contour crosses the line between points with
+ * values p1 and p2 (the statement function RANGE of PGCNSC).
+ */
+static int grcx_range(float p1, float p2)
+{
+  float p = grcx.z0;
+  float lo = p1 < p2 ? p1 : p2, hi = p1 < p2 ? p2 : p1;
+  return p > lo && p <= hi && p1 != p2;
+}
+
+/*
+ * Add vertex (x,y) to piece p of band b.
+ */
+static int grcx_vertex(GrcxBand *b, GrcxPiece *p, float x, float y)
+{
+  if(b->npt >= b->mpt) {
+    size_t m = b->mpt;
+    if(grcx_grow((void **) &b->x, &m, b->npt + 1, sizeof(float)) ||
+       grcx_grow((void **) &b->y, &b->mpt, b->npt + 1, sizeof(float)))
+      return -1;
+  };
+  b->x[b->npt] = x;
+  b->y[b->npt] = y;
+  b->npt++;
+  p->npt++;
+  return 0;
+}
+
+/*
+ * Add the crossing of the grid line from (i,j) to (i+1,j) (if dir is UP
+ * or DOWN) or to (i,j+1) (if LEFT or RIGHT) to piece p of band b,
+ * computed as in PGCN01.
+ */
+static int grcx_point(GrcxBand *b, GrcxPiece *p, int i, int j, int dir)
+{
+  float x, y;
+  if(dir == UP || dir == DOWN) {
+    x = (float) i + (grcx.z0 - A(i,j)) / (A(i+1,j) - A(i,j));
+    y = (float) j;
+/*
+ * Remember the first crossing of a horizontal grid line that the
+ * search for closed contours in PGCNSC would find.
+ */
+    if(i > grcx.i1 && j > grcx.j1 && j < grcx.j2 &&
+       (p->kpt < 0 || i < p->ki || (i == p->ki && j < p->kj))) {
+      p->ki = i;
+      p->kj = j;
+      p->kpt = p->npt;
+    };
+  } else {
+    x = (float) i;
+    y = (float) j + (grcx.z0 - A(i,j)) / (A(i,j+1) - A(i,j));
+  };
+  return grcx_vertex(b, p, x, y);
+}
+
+/*
+ * Trace a piece of contour in band b, starting at the crossing of
+ * (i,j) in direction dir, and clearing the flags f of the crossings
+ * used. This follows PGCN01, except that the piece also ends when it
+ * leaves the band, and that the flag of the starting point of a closed
+ * contour is kept until the contour returns to it.
+ */
+static int grcx_trace(GrcxBand *b, unsigned char *f, int i, int j, int dir,
+		      int start, long rank)
+{
+  GrcxPiece *p;
+  size_t first;
+  int i0 = i, j0 = j, keep = start == LOOP;
+  if(grcx_grow((void **) &b->piece, &b->mpiece, b->npiece + 1,
+	       sizeof(GrcxPiece)))
+    return -1;
+  p = &b->piece[b->npiece++];
+  p->first = first = b->npt;
+  p->npt = 0;
+  p->start = start;
+  p->rank = rank;
+  p->kpt = -1;
+  p->next = -1;
+  p->done = 0;
+  if(grcx_point(b, p, i, j, dir))
+    return -1;
+  for(;;) {
+    switch(dir) {
+    case UP:
+      if(!keep)
+	F(i,j) &= ~H;
+      if(j == b->jb) {
+	p->end = j == grcx.j2 ? EDGE : SEAM_UP;
+	p->iend = i;
+	return 0;
+      } else if(F(i,j) & V) {
+	dir = LEFT;
+      } else if(F(i+1,j) & V) {
+	dir = RIGHT;
+	i++;
+      } else if(F(i,j+1) & H) {
+	j++;
+      } else {
+	dir = 0;
+      };
+      break;
+    case DOWN:
+      if(!keep)
+	F(i,j) &= ~H;
+      if(j == b->ja) {
+	p->end = j == grcx.j1 ? EDGE : SEAM_DOWN;
+	p->iend = i;
+	return 0;
+      } else if(F(i+1,j-1) & V) {
+	dir = RIGHT;
+	i++;
+	j--;
+      } else if(F(i,j-1) & V) {
+	dir = LEFT;
+	j--;
+      } else if(F(i,j-1) & H) {
+	j--;
+      } else {
+	dir = 0;
+      };
+      break;
+    case LEFT:
+      F(i,j) &= ~V;
+      if(i == grcx.i1) {
+	p->end = EDGE;
+	return 0;
+      } else if(F(i-1,j) & H) {
+	dir = DOWN;
+	i--;
+      } else if(F(i-1,j+1) & H) {
+	dir = UP;
+	i--;
+	j++;
+      } else if(F(i-1,j) & V) {
+	i--;
+      } else {
+	dir = 0;
+      };
+      break;
+    default:
+      F(i,j) &= ~V;
+      if(i == grcx.i2) {
+	p->end = EDGE;
+	return 0;
+      } else if(F(i,j+1) & H) {
+	dir = UP;
+	j++;
+      } else if(F(i,j) & H) {
+	dir = DOWN;
+      } else if(F(i+1,j) & V) {
+	i++;
+      } else {
+	dir = 0;
+      };
+      break;
+    };
+/*
+ * If the contour is back at its starting point, or there is nowhere to
+ * go, it has closed: finish it with a segment back to the starting
+ * point.
+ */
+    keep = 0;
+    if(dir == 0 || (start == LOOP && i == i0 && j == j0 &&
+		    (dir == UP || dir == DOWN))) {
+      F(i0,j0) &= ~H;
+      p->end = LOOP;
+      return grcx_vertex(b, p, b->x[first], b->y[first]);
+    };
+    if(grcx_point(b, p, i, j, dir))
+      return -1;
+  };
+}
+
+/*
+ * Record that piece n of band b starts at crossing i of its bottom (up)
+ * or top (down) row.
+ */
+static int grcx_seam(GrcxSeam **s, size_t *ns, size_t *ms, int i, int n)
+{
+  if(grcx_grow((void **) s, ms, *ns + 1, sizeof(GrcxSeam)))
+    return -1;
+  (*s)[*ns].i = i;
+  (*s)[*ns].piece = n;
+  (*ns)++;
+  return 0;
+}
+
+/*
+ * Trace the contours of band b, using f as work space for the flags.
+ */
+static int grcx_band(GrcxBand *b, unsigned char *f)
+{
+  long ni = grcx.i2 - grcx.i1, nj = grcx.j2 - grcx.j1;
+  int i, j, k, ia, ib;
+  b->npiece = b->npt = b->nup = b->ndown = 0;
+/*
+ * Set the flags, as PGCNSC does, in the blocks that the level crosses.
+ * The level cannot cross the others.
+ */
+  memset(f, 0, grcx.ni * (b->jb - b->ja + 1));
+  for(k=0; k<grcx.nblock; k++) {
+    if(!(b->lo[k] < grcx.z0 && grcx.z0 <= b->hi[k]))
+      continue;
+    ia = grcx.i1 + k * BLOCK_COLS;
+    ib = ia + BLOCK_COLS < grcx.i2 ? ia + BLOCK_COLS : grcx.i2;
+    for(j=b->ja; j<=b->jb; j++) {
+      for(i=ia; i<=ib; i++) {
+	unsigned char flag = 0;
+	if(i < ib && grcx_range(A(i,j), A(i+1,j)))
+	  flag |= H;
+	if(j < b->jb && grcx_range(A(i,j), A(i,j+1)))
+	  flag |= V;
+	F(i,j) |= flag;
+      };
+    };
+  };
+/*
+ * Trace the pieces that enter the band across its bottom row, from the
+ * edge of the array or from the band below.
+ */
+  j = b->ja;
+  for(i=grcx.i1; i<grcx.i2; i++) {
+    if((F(i,j) & H) && A(i,j) > A(i+1,j)) {
+      if(j == grcx.j1) {
+	if(grcx_trace(b, f, i, j, UP, EDGE, i - grcx.i1))
+	  return -1;
+      } else if(grcx_seam(&b->up, &b->nup, &b->mup, i, (int) b->npiece) ||
+		grcx_trace(b, f, i, j, UP, SEAM_UP, 0)) {
+	return -1;
+      };
+    };
+  };
+/*
+ * Right edge.
+ */
+  i = grcx.i2;
+  for(j=b->ja; j<b->jb; j++) {
+    if((F(i,j) & V) && A(i,j) > A(i,j+1) &&
+       grcx_trace(b, f, i, j, LEFT, EDGE, ni + (j - grcx.j1)))
+      return -1;
+  };
+/*
+ * Top row, from the edge of the array or from the band above.
+ */
+  j = b->jb;
+  for(i=grcx.i2-1; i>=grcx.i1; i--) {
+    if((F(i,j) & H) && A(i+1,j) > A(i,j)) {
+      if(j == grcx.j2) {
+	if(grcx_trace(b, f, i, j, DOWN, EDGE, ni + nj + (grcx.i2 - 1 - i)))
+	  return -1;
+      } else if(grcx_seam(&b->down, &b->ndown, &b->mdown, i,
+			    (int) b->npiece) ||
+		grcx_trace(b, f, i, j, DOWN, SEAM_DOWN, 0)) {
+	return -1;
+      };
+    };
+  };
+/*
+ * Left edge.
+ */
+  i = grcx.i1;
+  for(j=b->jb-1; j>=b->ja; j--) {
+    if((F(i,j) & V) && A(i,j+1) > A(i,j) &&
+       grcx_trace(b, f, i, j, RIGHT, EDGE,
+		  2*ni + nj + (grcx.j2 - 1 - j)))
+      return -1;
+  };
+/*
+ * The crossings that are left lie on contours that close within the
+ * band. Search for them as PGCNSC does, so that each starts at the
+ * same point.
+ */
+  for(k=0; k<grcx.nblock; k++) {
+    if(!(b->lo[k] < grcx.z0 && grcx.z0 <= b->hi[k]))
+      continue;
+    ia = grcx.i1 + k * BLOCK_COLS;
+    ib = ia + BLOCK_COLS < grcx.i2 ? ia + BLOCK_COLS : grcx.i2;
+    for(i=(ia > grcx.i1 ? ia : grcx.i1+1); i<ib; i++) {
+      for(j=b->ja+1; j<b->jb; j++) {
+	if((F(i,j) & H) &&
+	   grcx_trace(b, f, i, j, A(i+1,j) > A(i,j) ? DOWN : UP, LOOP, 0))
+	  return -1;
+      };
+    };
+  };
+  return 0;
+}
+
+/*
+ * Find the range of the values in each block of band b. Values that
+ * are not numbers are ignored, since the level cannot cross them.
+ */
+static void grcx_ranges(GrcxBand *b)
+{
+  int i, j, k, ia, ib;
+  for(k=0; k<grcx.nblock; k++) {
+    float lo = 0.0f, hi = 0.0f;
+    int any = 0;
+    ia = grcx.i1 + k * BLOCK_COLS;
+    ib = ia + BLOCK_COLS < grcx.i2 ? ia + BLOCK_COLS : grcx.i2;
+    for(j=b->ja; j<=b->jb; j++) {
+      for(i=ia; i<=ib; i++) {
+	float v = A(i,j);
+	if(v != v)
+	  continue;
+	if(!any) {
+	  lo = hi = v;
+	  any = 1;
+	} else if(v < lo) {
+	  lo = v;
+	} else if(v > hi) {
+	  hi = v;
+	};
+      };
+    };
+/*
+ * A block without numbers is given an empty range.
+ */
+    b->lo[k] = any ? lo : 1.0f;
+    b->hi[k] = any ? hi : 0.0f;
+  };
+}
+
+/*
+ * Do the current task for each band, taking the next band that is not
+ * yet done until there are none left.
+ */
+static void *grcx_work(void *arg)
+{
+  unsigned char *f = NULL;
+  if(grcx.task == 1)
+    f = (unsigned char *) malloc(grcx.ni * (grcx.rows + 1));
+  for(;;) {
+    int k;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&grcx_lock);
+    k = grcx.work++;
+    pthread_mutex_unlock(&grcx_lock);
+#else
+    k = *(int *) arg;
+    (*(int *) arg)++;
+#endif
+    if(k >= grcx.nband)
+      break;
+    if(grcx.task == 0)
+      grcx_ranges(&grcx.band[k]);
+    else
+      grcx.band[k].error = !f || grcx_band(&grcx.band[k], f) != 0;
+  };
+  free(f);
+  return NULL;
+}
+
+/*
+ * Do a task for all the bands, using grcx.nthread threads if possible.
+ */
+static void grcx_all(int task)
+{
+#ifdef HAVE_PTHREAD
+  pthread_t thread[MAX_THREADS];
+  int n, started = 0;
+  grcx.task = task;
+  grcx.work = 0;
+  for(n=1; n<grcx.nthread; n++) {
+    if(pthread_create(&thread[started], NULL, grcx_work, NULL) == 0)
+      started++;
+  };
+  grcx_work(NULL);
+  for(n=0; n<started; n++)
+    pthread_join(thread[n], NULL);
+#else
+  int k = 0;
+  grcx.task = task;
+  grcx_work(&k);
+#endif
+}
+
+/*
+ * Find the piece of band b that starts at crossing i of one of its rows.
+ */
+static int grcx_find(GrcxSeam *s, size_t ns, int i, int descending)
+{
+  size_t lo = 0, hi = ns;
+  while(lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if(s[mid].i == i)
+      return s[mid].piece;
+    if((s[mid].i < i) != (descending != 0))
+      lo = mid + 1;
+    else
+      hi = mid;
+  };
+  return -1;
+}
+
+static int grcx_cmp(const void *p, const void *q)
+{
+  const GrcxOrder *a = (const GrcxOrder *) p, *b = (const GrcxOrder *) q;
+  if(a->r1 != b->r1)
+    return a->r1 < b->r1 ? -1 : 1;
+  return a->r2 < b->r2 ? -1 : a->r2 > b->r2;
+}
+
+/*
+ * Add a run of vertices to the output.
+ */
+static int grcx_run(int band, int piece, int from, int to, int start)
+{
+  GrcxRun *r;
+  if(from > to)
+    return 0;
+  if(grcx_grow((void **) &grcx.run, &grcx.mrun, grcx.nrun + 1,
+	       sizeof(GrcxRun)))
+    return -1;
+  r = &grcx.run[grcx.nrun++];
+  r->band = band;
+  r->piece = piece;
+  r->from = from;
+  r->to = to;
+  r->start = start;
+  return 0;
+}
+
+/*
+ * Return the band of the piece that follows piece p of band k.
+ */
+static int grcx_nextband(GrcxPiece *p, int k)
+{
+  return p->end == SEAM_UP ? k + 1 : k - 1;
+}
+
+/*
+ * Output the contour that starts at vertex v of piece n of band k,
+ * following it from band to band until it ends, or (if it is closed)
+ * until it returns to that vertex. The pieces are marked with mark.
+ */
+static int grcx_follow(int k, int n, int v, int mark)
+{
+  int k0 = k, n0 = n;
+  GrcxPiece *p = &grcx.band[k].piece[n];
+  if(grcx_run(k, n, v, p->npt - 1, 1))
+    return -1;
+  p->done = mark;
+  while(p->next >= 0) {
+    k = grcx_nextband(p, k);
+    n = p->next;
+    p = &grcx.band[k].piece[n];
+    if(k == k0 && n == n0)
+      return grcx_run(k, n, 1, v, 0);
+    if(p->done == mark)
+      break;
+    p->done = mark;
+    if(grcx_run(k, n, 1, p->npt - 1, 0))
+      return -1;
+  };
+  return 0;
+}
+
+/*
+ * Join the pieces of all the bands into contours, and list the runs of
+ * vertices to be output.
+ */
+static int grcx_join(void)
+{
+  GrcxOrder *order;
+  size_t norder = 0, npiece = 0, m;
+  int k, n;
+/*
+ * Link each piece that leaves its band to the piece that continues it.
+ */
+  for(k=0; k<grcx.nband; k++) {
+    GrcxBand *b = &grcx.band[k];
+    npiece += b->npiece;
+    for(m=0; m<b->npiece; m++) {
+      GrcxPiece *p = &b->piece[m];
+      if(p->end == SEAM_UP && k+1 < grcx.nband)
+	p->next = grcx_find(grcx.band[k+1].up, grcx.band[k+1].nup,
+			    p->iend, 0);
+      else if(p->end == SEAM_DOWN && k > 0)
+	p->next = grcx_find(grcx.band[k-1].down, grcx.band[k-1].ndown,
+			    p->iend, 1);
+    };
+  };
+  order = (GrcxOrder *) malloc((npiece ? npiece : 1) * sizeof(GrcxOrder));
+  if(!order)
+    return -1;
+/*
+ * The contours that start at the edge of the array come first, in
+ * order along the edge.
+ */
+  for(k=0; k<grcx.nband; k++) {
+    for(m=0; m<grcx.band[k].npiece; m++) {
+      GrcxPiece *p = &grcx.band[k].piece[m];
+      if(p->start == EDGE) {
+	order[norder].r1 = p->rank;
+	order[norder].r2 = 0;
+	order[norder].band = k;
+	order[norder].piece = (int) m;
+	order[norder].kpt = 0;
+	norder++;
+      };
+    };
+  };
+  qsort(order, norder, sizeof(GrcxOrder), grcx_cmp);
+  for(m=0; m<norder; m++) {
+    if(grcx_follow(order[m].band, order[m].piece, 0, 1)) {
+      free(order);
+      return -1;
+    };
+  };
+/*
+ * The rest are closed. Go round each to find the crossing at which
+ * PGCNSC would start it, and output them in order of that crossing.
+ */
+  norder = 0;
+  for(k=0; k<grcx.nband; k++) {
+    for(m=0; m<grcx.band[k].npiece; m++) {
+      GrcxPiece *p = &grcx.band[k].piece[m];
+      GrcxOrder *o = &order[norder];
+      int kk = k;
+      if(p->done || p->start == EDGE)
+	continue;
+      o->band = k;
+      o->piece = (int) m;
+      o->kpt = p->kpt < 0 ? 0 : p->kpt;
+      o->r1 = p->kpt < 0 ? grcx.i2 : p->ki;
+      o->r2 = p->kpt < 0 ? grcx.j2 : p->kj;
+      p->done = 2;
+      while(p->next >= 0) {
+	kk = grcx_nextband(p, kk);
+	n = p->next;
+	p = &grcx.band[kk].piece[n];
+	if(p->done)
+	  break;
+	p->done = 2;
+	if(p->kpt >= 0 && (p->ki < o->r1 ||
+			   (p->ki == o->r1 && p->kj < o->r2))) {
+	  o->band = kk;
+	  o->piece = n;
+	  o->kpt = p->kpt;
+	  o->r1 = p->ki;
+	  o->r2 = p->kj;
+	};
+      };
+      norder++;
+    };
+  };
+  qsort(order, norder, sizeof(GrcxOrder), grcx_cmp);
+  for(m=0; m<norder; m++) {
+    GrcxPiece *p = &grcx.band[order[m].band].piece[order[m].piece];
+    if(p->start == LOOP)
+      n = grcx_run(order[m].band, order[m].piece, 0, p->npt - 1, 1);
+    else
+      n = grcx_follow(order[m].band, order[m].piece, order[m].kpt, 3);
+    if(n) {
+      free(order);
+      return -1;
+    };
+  };
+  free(order);
+  return 0;
+}
+
+/*
+ * Release the memory used for the contours of a level.
+ */
+static void grcx_done(void)
+{
+  int k;
+  for(k=0; k<grcx.nband; k++) {
+    GrcxBand *b = &grcx.band[k];
+    free(b->piece);
+    free(b->x);
+    free(b->y);
+    free(b->up);
+    free(b->down);
+    b->piece = NULL;
+    b->x = b->y = NULL;
+    b->up = b->down = NULL;
+    b->npiece = b->mpiece = b->npt = b->mpt = 0;
+    b->nup = b->mup = b->ndown = b->mdown = 0;
+  };
+  free(grcx.run);
+  grcx.run = NULL;
+  grcx.nrun = grcx.mrun = 0;
+  grcx.active = 0;
+}
+
+/*
+ * Release all the memory used for contouring, and forget the array.
+ */
+static void grcx_end(void)
+{
+  int k;
+  grcx_done();
+  for(k=0; k<grcx.nband; k++) {
+    free(grcx.band[k].lo);
+    free(grcx.band[k].hi);
+  };
+  free(grcx.band);
+  grcx.band = NULL;
+  grcx.nband = 0;
+  grcx.a = NULL;
+}
+
+void GRCNX0(const float *a, int *idim, int *jdim, int *i1, int *i2,
+	    int *j1, int *j2, int *ier)
+{
+  int ni = *i2 - *i1, nj = *j2 - *j1;
+  int k;
+  char *string;
+  grcx_end();
+  *ier = 1;
+  if(ni < 1 || nj < 1)
+    return;
+  grcx.a = a;
+  grcx.idim = *idim;
+  grcx.i1 = *i1;
+  grcx.i2 = *i2;
+  grcx.j1 = *j1;
+  grcx.j2 = *j2;
+  grcx.ni = (size_t) ni + 1;
+/*
+ * Divide the rows into bands, and the bands into blocks.
+ */
+  grcx.rows = (BAND_CELLS + ni - 1) / ni;
+  if(grcx.rows < BAND_ROWS)
+    grcx.rows = BAND_ROWS;
+  if(grcx.rows > nj)
+    grcx.rows = nj;
+  grcx.nband = (nj + grcx.rows - 1) / grcx.rows;
+  grcx.nblock = (ni + BLOCK_COLS - 1) / BLOCK_COLS;
+  grcx.band = (GrcxBand *) calloc(grcx.nband, sizeof(GrcxBand));
+  if(!grcx.band) {
+    grcx.nband = 0;
+    grcx.a = NULL;
+    return;
+  };
+  for(k=0; k<grcx.nband; k++) {
+    GrcxBand *b = &grcx.band[k];
+    b->ja = grcx.j1 + k * grcx.rows;
+    b->jb = b->ja + grcx.rows;
+    if(b->jb > grcx.j2)
+      b->jb = grcx.j2;
+    b->lo = (float *) malloc(grcx.nblock * sizeof(float));
+    b->hi = (float *) malloc(grcx.nblock * sizeof(float));
+    if(!b->lo || !b->hi) {
+      grcx_end();
+      return;
+    };
+  };
+  grcx.nthread = 1;
+  if((string = getenv("PGPLOT_CONTOUR_THREADS")) && *string)
+    grcx.nthread = atoi(string);
+  if(grcx.nthread > MAX_THREADS)
+    grcx.nthread = MAX_THREADS;
+  if(grcx.nthread > grcx.nband)
+    grcx.nthread = grcx.nband;
+  grcx_all(0);
+  *ier = 0;
+}
+
+void GRCNX1(float *z0, int *ier)
+{
+  int k;
+  grcx_done();
+  *ier = 1;
+  if(!grcx.band)
+    return;
+  grcx.z0 = *z0;
+/*
+ * Trace the bands, and join the pieces into contours.
+ */
+  grcx_all(1);
+  grcx.active = 1;
+  for(k=0; k<grcx.nband; k++) {
+    if(grcx.band[k].error) {
+      grcx_done();
+      return;
+    };
+  };
+  if(grcx_join()) {
+    grcx_done();
+    return;
+  };
+  grcx.emit = 0;
+  grcx.pt = -1;
+  *ier = 0;
+}
+
+void GRCNX2(float *x, float *y, int *nmax, int *n)
+{
+  GrcxRun *r;
+  GrcxBand *b;
+  GrcxPiece *p;
+  int start = 0, m;
+  *n = 0;
+  if(!grcx.active)
+    return;
+  if(grcx.emit >= grcx.nrun) {
+    grcx_done();
+    return;
+  };
+  r = &grcx.run[grcx.emit];
+  if(grcx.pt < 0) {
+    grcx.pt = r->from;
+    start = r->start;
+  };
+  b = &grcx.band[r->band];
+  p = &b->piece[r->piece];
+  m = r->to - grcx.pt + 1;
+  if(m > *nmax)
+    m = *nmax;
+  memcpy(x, b->x + p->first + grcx.pt, m * sizeof(float));
+  memcpy(y, b->y + p->first + grcx.pt, m * sizeof(float));
+  *n = start ? m : -m;
+  grcx.pt += m;
+  if(grcx.pt > r->to) {
+    grcx.emit++;
+    grcx.pt = -1;
+  };
+}
+
+void GRCNX3(void)
+{
+  grcx_end();
+}
@@ -0,0 +1,153 @@
+/*GRCTX -- plotting contexts for the C binding
+ * +
+ *
+ *   PGcontext *cpgnctx(void)         create a plotting context
+ *   void cpgsctx(PGcontext *ctx)     make ctx the context of the calling
+ *                                    thread (NULL for none)
+ *   PGcontext *cpgqctx(void)         return the context of the thread
+ *   void cpgdctx(PGcontext *ctx)     delete a context
+ *
+ * A plotting context remembers which PGPLOT device is selected in it.
+ * A new context has no device selected; cpgopen() then opens a device
+ * in the context, and cpgslct() and cpgclos() change its selection
+ * without affecting other contexts. All other PGPLOT state (the window,
+ * viewport, attributes, buffering level, etc.) is already kept for each
+ * device, so threads that each use their own context, and their own
+ * devices, do not disturb each other. A thread without a context uses
+ * whichever device is currently selected, as before. Deleting a
+ * context does not close its device. cpgend() closes the devices of all
+ * contexts, so a context should close its devices with cpgclos().
+ *
+ * PGPLOT itself is not reentrant: its state is held in FORTRAN COMMON
+ * blocks, and the drivers have static state of their own. Each function
+ * of the C binding therefore calls grctx_begin() and grctx_end() around
+ * its call to PGPLOT. These hold a lock on the whole library for the
+ * duration of the call, so that calls from different threads are
+ * executed one at a time, and on entry select the device of the calling
+ * thread's context. This needs POSIX threads, which the build always
+ * links. FORTRAN programs, which call PGPLOT directly, are not affected.
+ *
+ * The lock is held for the whole call, including calls that wait for
+ * the user, such as cpgcurs(), cpgband(), cpglcur(), cpgncur(),
+ * cpgolin() and cpgpage() with prompting on. It cannot be released
+ * during the wait, since PGPLOT's state belongs to the waiting call
+ * until it returns. Other threads therefore stop at their next call to
+ * PGPLOT until the user has responded.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ * 18-Oct-2026 - Always use POSIX threads. Document the cursor wait.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#ifdef PG_PPU
+#define PGQID pgqid_
+#define PGCTXS pgctxs_
+#else
+#define PGQID pgqid
+#define PGCTXS pgctxs
+#endif
+
+void PGQID(int *id);
+void PGCTXS(int *id);
+
+typedef struct PGcontext PGcontext;
+
+struct PGcontext {
+  int id;                /* The device selected in the context, or 0 */
+};
+
+/*
+ * The state of a thread.
+ */
+typedef struct {
+  PGcontext *ctx;        /* The context of the thread, or NULL */
+  int depth;             /* The nesting depth of grctx_begin() calls */
+} GrctxThread;
+
+static pthread_mutex_t grctx_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t grctx_key;
+static pthread_once_t grctx_once = PTHREAD_ONCE_INIT;
+
+static void grctx_init(void)
+{
+  pthread_key_create(&grctx_key, free);
+}
+
+/*
+ * Return the state of the calling thread, or NULL if it could not be
+ * allocated.
+ */
+static GrctxThread *grctx_thread(void)
+{
+  GrctxThread *t;
+  pthread_once(&grctx_once, grctx_init);
+  t = (GrctxThread *) pthread_getspecific(grctx_key);
+  if(!t) {
+    t = (GrctxThread *) calloc(1, sizeof(GrctxThread));
+    if(t && pthread_setspecific(grctx_key, t) != 0) {
+      free(t);
+      t = NULL;
+    };
+  };
+  return t;
+}
+
+/*
+ * Called by each function of the C binding before it calls PGPLOT.
+ */
+void grctx_begin(void)
+{
+  GrctxThread *t = grctx_thread();
+  if(!t || t->depth++ > 0)
+    return;
+  pthread_mutex_lock(&grctx_lock);
+  if(t->ctx) {
+    int id;
+    PGQID(&id);
+    if(id != t->ctx->id)
+      PGCTXS(&t->ctx->id);
+  };
+}
+
+/*
+ * Called by each function of the C binding after it calls PGPLOT.
+ */
+void grctx_end(void)
+{
+  GrctxThread *t = grctx_thread();
+  if(!t || t->depth < 1 || --t->depth > 0)
+    return;
+  if(t->ctx)
+    PGQID(&t->ctx->id);
+  pthread_mutex_unlock(&grctx_lock);
+}
+
+PGcontext *cpgnctx(void)
+{
+  return (PGcontext *) calloc(1, sizeof(PGcontext));
+}
+
+void cpgsctx(PGcontext *ctx)
+{
+  GrctxThread *t = grctx_thread();
+  if(t && t->depth == 0)
+    t->ctx = ctx;
+}
+
+PGcontext *cpgqctx(void)
+{
+  GrctxThread *t = grctx_thread();
+  return t ? t->ctx : NULL;
+}
+
+void cpgdctx(PGcontext *ctx)
+{
+  GrctxThread *t = grctx_thread();
+  if(t && t->ctx == ctx)
+    t->ctx = NULL;
+  free(ctx);
+}
@@ -0,0 +1,496 @@
+/*GRDL -- read and replay a PGPLOT display list (used by PGEXDL, PGRDDL)
+ * +
+ *
+ *   CALL GRDL0(FILE, NPICT, IER)
+ *
+ * maps display list FILE, written by the /PGDL driver (drivers/dldriv.c,
+ * which describes the format), into memory and finds the pictures in
+ * it. NPICT is returned as the number of pictures. IER is 0, or 1 if
+ * the file cannot be opened, or 2 if it is not a display list. Then
+ *
+ *   CALL GRDL1(IPICT, XMAX, YMAX, XPPI, YPPI, IER)
+ *
+ * returns the size of the view surface of picture IPICT (1...NPICT), in
+ * device units, and the resolution of the device, in units per inch.
+ * IER is 0, or 3 if there is no such picture.
+ *
+ *   CALL GRDL2(IPICT, ID, TR, CLIP, LWFAC, MODE)
+ *
+ * draws picture IPICT on GRPCKG device ID, which must be selected,
+ * using the current world coordinate transformation: the device
+ * coordinates (x,y) of the picture are used as world coordinates. The
+ * caller provides TR(1...4) = XORG, XSCALE, YORG, YSCALE, the
+ * transformation from world to device coordinates, and CLIP(1...4) =
+ * XMIN, XMAX, YMIN, YMAX, the clipping rectangle of device ID in device
+ * coordinates; these are needed to clip images as they were clipped on
+ * the device that recorded them. Line widths are multiplied by LWFAC.
+ * MODE is 0 to use the colors of the picture, 1 for monochrome (color
+ * indices 0 and 1 only, ignoring color representations), or 2 to
+ * convert the colors of the picture to grey.
+ *
+ *   CALL GRDL3
+ *
+ * unmaps the file.
+ *
+ * The primitives are drawn with the GRPCKG routines (GRVCT0, GRFA,
+ * GRRECT, GRPIXL, GRSCI, etc.), so the picture can be replayed on any
+ * device: primitives that the device cannot draw itself are emulated as
+ * they would have been had the program plotted on the device directly.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#ifdef PG_PPU
+#define GRDL0 grdl0_
+#define GRDL1 grdl1_
+#define GRDL2 grdl2_
+#define GRDL3 grdl3_
+#define GRVCT0 grvct0_
+#define GRFA grfa_
+#define GRRECT grrect_
+#define GRPIXL grpixl_
+#define GRSCI grsci_
+#define GRSCR grscr_
+#define GRSLS grsls_
+#define GRSLW grslw_
+#define GRAREA grarea_
+#else
+#define GRDL0 grdl0
+#define GRDL1 grdl1
+#define GRDL2 grdl2
+#define GRDL3 grdl3
+#define GRVCT0 grvct0
+#define GRFA grfa
+#define GRRECT grrect
+#define GRPIXL grpixl
+#define GRSCI grsci
+#define GRSCR grscr
+#define GRSLS grsls
+#define GRSLW grslw
+#define GRAREA grarea
+#endif
+
+void GRVCT0(int *mode, int *absxy, int *points, float *x, float *y);
+void GRFA(int *n, float *px, float *py);
+void GRRECT(float *x0, float *y0, float *x1, float *y1);
+void GRPIXL(int *ia, int *idim, int *jdim, int *i1, int *i2, int *j1,
+	    int *j2, float *x1, float *x2, float *y1, float *y2);
+void GRSCI(int *ic);
+void GRSCR(int *ci, float *cr, float *cg, float *cb);
+void GRSLS(int *is);
+void GRSLW(int *iw);
+void GRAREA(int *ident, float *x0, float *y0, float *xsize, float *ysize);
+
+/*
+ * The format, which must agree with drivers/dldriv.c.
+ */
+#define DL_HEADER 16       /* Bytes before the first record */
+#define DL_VERSION 1
+
+#define DL_PAGE 1
+#define DL_END 2
+#define DL_CI 3
+#define DL_CR 4
+#define DL_LS 5
+#define DL_LW 6
+#define DL_LINE 7
+#define DL_DOT 8
+#define DL_POLYGON 9
+#define DL_RECT 10
+#define DL_IMAGE 11
+#define DL_MARKER 12
+#define DL_MARKS 13
+
+static struct {
+  unsigned char *map;      /* The mapped file, or NULL */
+  size_t size;
+  size_t *page;            /* Offset of the PAGE record of each picture */
+  int npage;
+  float *x, *y;            /* Work space for vertices */
+  size_t nxy;
+  float *shape;            /* The current marker shape, or NULL */
+  size_t nshape;
+} grdl;
+
+static unsigned long grdl_word(const unsigned char *p)
+{
+  return (unsigned long) p[0] | (unsigned long) p[1] << 8 |
+    (unsigned long) p[2] << 16 | (unsigned long) p[3] << 24;
+}
+
+static long grdl_int(const unsigned char *p)
+{
+  unsigned long w = grdl_word(p);
+  return w & 0x80000000UL ? -(long) (0xffffffffUL - w) - 1 : (long) w;
+}
+
+static float grdl_real(const unsigned char *p)
+{
+  unsigned int w = (unsigned int) grdl_word(p);
+  float f;
+  memcpy(&f, &w, 4);
+  return f;
+}
+
+/*
+ * Make sure the work space holds at least n vertices.
+ */
+static int grdl_space(size_t n)
+{
+  if(n > grdl.nxy) {
+    float *x = (float *) realloc(grdl.x, n * sizeof(float));
+    float *y = x ? (float *) realloc(grdl.y, n * sizeof(float)) : NULL;
+    if(x)
+      grdl.x = x;
+    if(!y)
+      return 1;
+    grdl.y = y;
+    grdl.nxy = n;
+  };
+  return 0;
+}
+
+/*
+ * Copy n (x,y) pairs from p to the work space, offset by (x0,y0).
+ */
+static int grdl_points(const unsigned char *p, size_t n, float x0, float y0)
+{
+  size_t i;
+  if(grdl_space(n))
+    return 1;
+  for(i=0; i<n; i++, p+=8) {
+    grdl.x[i] = x0 + grdl_real(p);
+    grdl.y[i] = y0 + grdl_real(p + 4);
+  };
+  return 0;
+}
+
+/*
+ * Draw each stroke of the current marker shape at (x0,y0).
+ */
+static void grdl_marker(float x0, float y0)
+{
+  size_t k = 1, nstroke = grdl.nshape > 0 ? (size_t) grdl.shape[0] : 0;
+  int mode = 2, absxy = 0;
+  while(nstroke-- > 0 && k < grdl.nshape) {
+    int n = (int) grdl.shape[k++], i;
+    if(n < 1 || k + 2 * (size_t) n > grdl.nshape || grdl_space(n))
+      return;
+    for(i=0; i<n; i++, k+=2) {
+      grdl.x[i] = x0 + grdl.shape[k];
+      grdl.y[i] = y0 + grdl.shape[k+1];
+    };
+    GRVCT0(&mode, &absxy, &n, grdl.x, grdl.y);
+  };
+}
+
+/*
+ * Draw an image record of n words at p. Images whose pixels are
+ * aligned with the axes are drawn with GRPIXL; others are drawn one
+ * pixel at a time as filled quadrilaterals. Either way they are
+ * clipped to the intersection of the rectangle recorded with the image
+ * and the current clipping rectangle.
+ */
+static void grdl_image(const unsigned char *p, size_t n, int id, float *tr,
+		       float *clip, int mode, int ci)
+{
+  long nx = grdl_int(p), ny = grdl_int(p + 4);
+  float r[10], x0, x1, y0, y1, xsize, ysize;
+  const unsigned char *data = p + 48;
+  int i, j;
+  if(nx < 1 || ny < 1 || (size_t) (nx * ny + 1) / 2 > n - 12)
+    return;
+  for(i=0; i<10; i++)
+    r[i] = grdl_real(p + 8 + 4 * i);
+/*
+ * Clip to the recorded rectangle, r[0...3], transformed to device
+ * coordinates.
+ */
+  x0 = tr[0] + tr[1] * r[0];
+  x1 = tr[0] + tr[1] * r[1];
+  y0 = tr[2] + tr[3] * r[2];
+  y1 = tr[2] + tr[3] * r[3];
+  if(x0 > x1) { float t = x0; x0 = x1; x1 = t; };
+  if(y0 > y1) { float t = y0; y0 = y1; y1 = t; };
+  if(x0 < clip[0]) x0 = clip[0];
+  if(x1 > clip[1]) x1 = clip[1];
+  if(y0 < clip[2]) y0 = clip[2];
+  if(y1 > clip[3]) y1 = clip[3];
+  if(x0 > x1 || y0 > y1)
+    return;
+  xsize = x1 - x0;
+  ysize = y1 - y0;
+  GRAREA(&id, &x0, &y0, &xsize, &ysize);
+/*
+ * The matrix r[4...9] = [a b c d e f] maps (x,y) to pixel coordinates
+ * (a*x+c*y+e, b*x+d*y+f).
+ */
+  if(r[5] == 0.0f && r[6] == 0.0f && r[4] != 0.0f && r[7] != 0.0f) {
+    int *ia = (int *) malloc(nx * ny * sizeof(int));
+    int i1 = 1, i2 = (int) nx, j1 = 1, j2 = (int) ny;
+    float xa = -r[8] / r[4], xb = (nx - r[8]) / r[4];
+    float ya = -r[9] / r[7], yb = (ny - r[9]) / r[7];
+    if(ia) {
+      for(j=0; j<ny; j++) {
+	for(i=0; i<nx; i++) {
+	  long k = j * nx + i;
+	  int c = (int) (grdl_word(data + 4 * (k / 2)) >> (k % 2 ? 16 : 0)
+			 & 0xffff);
+	  if(mode == 1)
+	    c = c ? 1 : 0;
+/* GRPIXL draws column I1 at the left and row J1 at the bottom. */
+	  ia[(r[7] > 0.0f ? j : ny - 1 - j) * nx +
+	     (r[4] > 0.0f ? i : nx - 1 - i)] = c;
+	};
+      };
+      GRPIXL(ia, &i2, &j2, &i1, &i2, &j1, &j2,
+	     xa < xb ? &xa : &xb, xa < xb ? &xb : &xa,
+	     ya < yb ? &ya : &yb, ya < yb ? &yb : &ya);
+      free(ia);
+    };
+  } else {
+    float det = r[4] * r[7] - r[5] * r[6];
+    float px[4], py[4];
+    int four = 4, last = -1;
+    if(det != 0.0f) {
+      for(j=0; j<ny; j++) {
+	for(i=0; i<nx; i++) {
+	  long k = j * nx + i;
+	  int c = (int) (grdl_word(data + 4 * (k / 2)) >> (k % 2 ? 16 : 0)
+			 & 0xffff), v;
+	  if(mode == 1)
+	    c = c ? 1 : 0;
+	  if(c != last)
+	    GRSCI(&c);
+	  last = c;
+	  for(v=0; v<4; v++) {
+	    float u = (float) (i + (v == 1 || v == 2)) - r[8];
+	    float w = (float) (j + (v >= 2)) - r[9];
+	    px[v] = ( r[7] * u - r[6] * w) / det;
+	    py[v] = (-r[5] * u + r[4] * w) / det;
+	  };
+	  GRFA(&four, px, py);
+	};
+      };
+      GRSCI(&ci);
+    };
+  };
+  x0 = clip[0];
+  y0 = clip[2];
+  xsize = clip[1] - clip[0];
+  ysize = clip[3] - clip[2];
+  GRAREA(&id, &x0, &y0, &xsize, &ysize);
+}
+
+static void grdl_unmap(void)
+{
+  if(grdl.map)
+    munmap(grdl.map, grdl.size);
+  grdl.map = NULL;
+  grdl.size = 0;
+  free(grdl.page);
+  grdl.page = NULL;
+  grdl.npage = 0;
+}
+
+void GRDL0(const char *file, int *npict, int *ier, int file_len)
+{
+  char *name;
+  struct stat st;
+  size_t off, max = 0;
+  int fd;
+  grdl_unmap();
+  *npict = 0;
+  *ier = 1;
+  while(file_len > 0 && file[file_len-1] == ' ')
+    file_len--;
+  name = (char *) malloc(file_len + 1);
+  if(!name)
+    return;
+  memcpy(name, file, file_len);
+  name[file_len] = '\0';
+  fd = open(name, O_RDONLY);
+  free(name);
+  if(fd < 0)
+    return;
+  *ier = 2;
+  if(fstat(fd, &st) != 0 || st.st_size < DL_HEADER) {
+    close(fd);
+    return;
+  };
+  grdl.size = (size_t) st.st_size;
+  grdl.map = (unsigned char *) mmap(NULL, grdl.size, PROT_READ, MAP_SHARED,
+				    fd, 0);
+  close(fd);
+  if(grdl.map == (unsigned char *) MAP_FAILED) {
+    grdl.map = NULL;
+    return;
+  };
+  if(memcmp(grdl.map, "PGPLOTDL", 8) != 0 ||
+     grdl_word(grdl.map + 8) != DL_VERSION) {
+    grdl_unmap();
+    return;
+  };
+/*
+ * Find the pictures, checking that the records fit in the file.
+ */
+  for(off=DL_HEADER; off+8 <= grdl.size; ) {
+    unsigned long type = grdl_word(grdl.map + off);
+    unsigned long n = grdl_word(grdl.map + off + 4);
+    if(n > (grdl.size - off - 8) / 4)
+      break;
+    if(type == DL_PAGE && n >= 4) {
+      if(grdl.npage >= (int) max) {
+	size_t *page;
+	max = max ? 2 * max : 64;
+	page = (size_t *) realloc(grdl.page, max * sizeof(size_t));
+	if(!page) {
+	  grdl_unmap();
+	  *ier = 1;
+	  return;
+	};
+	grdl.page = page;
+      };
+      grdl.page[grdl.npage++] = off;
+    };
+    off += 8 + 4 * n;
+  };
+  *npict = grdl.npage;
+  *ier = 0;
+}
+
+void GRDL1(int *ipict, float *xmax, float *ymax, float *xppi, float *yppi,
+	   int *ier)
+{
+  const unsigned char *p;
+  *ier = 3;
+  if(!grdl.map || *ipict < 1 || *ipict > grdl.npage)
+    return;
+  p = grdl.map + grdl.page[*ipict - 1] + 8;
+  *xmax = grdl_real(p);
+  *ymax = grdl_real(p + 4);
+  *xppi = grdl_real(p + 8);
+  *yppi = grdl_real(p + 12);
+  *ier = 0;
+}
+
+void GRDL2(int *ipict, int *id, float *tr, float *clip, float *lwfac,
+	   int *mode)
+{
+  size_t off, end;
+  int ci = 1, absxy = 0;
+  if(!grdl.map || *ipict < 1 || *ipict > grdl.npage)
+    return;
+  off = grdl.page[*ipict - 1];
+  end = *ipict < grdl.npage ? grdl.page[*ipict] : grdl.size;
+  free(grdl.shape);
+  grdl.shape = NULL;
+  grdl.nshape = 0;
+  off += 8 + 4 * grdl_word(grdl.map + off + 4);
+  while(off + 8 <= end) {
+    const unsigned char *p = grdl.map + off + 8;
+    unsigned long type = grdl_word(grdl.map + off);
+    size_t n = grdl_word(grdl.map + off + 4), i;
+    int k, m;
+    float a[4];
+    if(n > (end - off - 8) / 4)
+      break;
+    off += 8 + 4 * n;
+    switch(type) {
+    case DL_END:
+      off = end;
+      break;
+    case DL_CI:
+      if(n < 1)
+	break;
+      ci = (int) grdl_int(p);
+      if(*mode == 1)
+	ci = ci ? 1 : 0;
+      GRSCI(&ci);
+      break;
+    case DL_CR:
+      if(n < 4 || *mode == 1)
+	break;
+      k = (int) grdl_int(p);
+      for(i=0; i<3; i++)
+	a[i] = grdl_real(p + 4 + 4 * i);
+      if(*mode == 2)
+	a[0] = a[1] = a[2] = 0.30f * a[0] + 0.59f * a[1] + 0.11f * a[2];
+      GRSCR(&k, &a[0], &a[1], &a[2]);
+      break;
+    case DL_LS:
+      if(n < 1)
+	break;
+      k = (int) grdl_int(p);
+      if(k >= 1 && k <= 5)
+	GRSLS(&k);
+      break;
+    case DL_LW:
+      if(n < 1)
+	break;
+      a[0] = (float) grdl_int(p) * *lwfac;
+      k = a[0] < 1.0f ? 1 : a[0] > 201.0f ? 201 : (int) (a[0] + 0.5f);
+      GRSLW(&k);
+      break;
+    case DL_LINE:
+    case DL_DOT:
+      m = (int) (n / 2);
+      k = type == DL_LINE ? 2 : 3;
+      if(m >= (type == DL_LINE ? 2 : 1) && !grdl_points(p, m, 0.0f, 0.0f))
+	GRVCT0(&k, &absxy, &m, grdl.x, grdl.y);
+      break;
+    case DL_POLYGON:
+      m = (int) (n / 2);
+      if(m >= 3 && !grdl_points(p, m, 0.0f, 0.0f))
+	GRFA(&m, grdl.x, grdl.y);
+      break;
+    case DL_RECT:
+      if(n < 4)
+	break;
+      for(i=0; i<4; i++)
+	a[i] = grdl_real(p + 4 * i);
+      GRRECT(&a[0], &a[1], &a[2], &a[3]);
+      break;
+    case DL_IMAGE:
+      if(n >= 12)
+	grdl_image(p, n, *id, tr, clip, *mode, ci);
+      break;
+    case DL_MARKER:
+      free(grdl.shape);
+      grdl.nshape = 0;
+      grdl.shape = (float *) malloc((n + 1) * sizeof(float));
+      if(!grdl.shape)
+	break;
+      for(i=0; i<n; i++)
+	grdl.shape[i] = grdl_real(p + 4 * i);
+      grdl.nshape = n;
+      break;
+    case DL_MARKS:
+      for(i=0; i+1<n; i+=2)
+	grdl_marker(grdl_real(p + 4 * i), grdl_real(p + 4 * i + 4));
+      break;
+    default:
+      break;
+    };
+  };
+}
+
+void GRDL3(void)
+{
+  grdl_unmap();
+  free(grdl.x);
+  free(grdl.y);
+  free(grdl.shape);
+  grdl.x = grdl.y = grdl.shape = NULL;
+  grdl.nxy = grdl.nshape = 0;
+}
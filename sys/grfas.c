@@ -0,0 +1,321 @@
+/*GRFAS -- scan conversion of polygons for GRFA and PGHTCH
+ * +
+ *
+ * GRFAS0 and GRFAS1 find the parts of a set of equally-spaced parallel
+ * lines that lie inside a polygon, for the emulated fill of GRFA and
+ * the hatching of PGHTCH.
+ *
+ *   CALL GRFAS0(N, PX, PY, TR, D, L1, L2, IER)
+ *
+ * starts scanning the polygon of N vertices (PX(I),PY(I)). The vertices
+ * are first transformed to (U,V) coordinates by
+ *
+ *   U = TR(1) + TR(2)*PX(I) + TR(3)*PY(I)
+ *   V = TR(4) + TR(5)*PX(I) + TR(6)*PY(I)
+ *
+ * and the scan lines are V = L*D for L = L1, ..., L2 (V = L*D is
+ * evaluated in single precision, as in GRFA). IER is returned as 0, or
+ * 1 if there is not enough memory. Then
+ *
+ *   CALL GRFAS1(L, U, NMAX, N)
+ *
+ * is called repeatedly to fetch the spans of scan line L that are
+ * inside the polygon, as N/2 pairs of U coordinates (U(1),U(2)), ...
+ * Lines are returned in order of increasing L, and lines with no spans
+ * are skipped. The spans of line L1 are in order of increasing U, and
+ * the direction alternates from one line to the next, so a pen can
+ * follow a zig-zag path. If a line has more than NMAX/2 spans, the rest
+ * are returned by the following calls with the same L. N = 0 means that
+ * there are no more.
+ *
+ * The inside of the polygon is defined by the even-odd rule: an edge
+ * with end points V1, V2 crosses line V if V1 < V <= V2 or V2 < V <= V1,
+ * and the crossing is at U1+(U2-U1)*((V-V1)/(V2-V1)). Spans that touch
+ * are merged. There is no limit on the number of crossings.
+ *
+ * The edges are sorted by the first line they cross, and the edges that
+ * cross the current line are kept in an active list, in order of U at
+ * the previous line. An edge is added to the list when the scan reaches
+ * its first line and dropped after its last, so each line costs time
+ * proportional to the number of edges that cross it.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef PG_PPU
+#define GRFAS0 grfas0_
+#define GRFAS1 grfas1_
+#else
+#define GRFAS0 grfas0
+#define GRFAS1 grfas1
+#endif
+
+/*
+ * An edge from (u1,v1) to (u2,v2), crossing scan lines first...last.
+ */
+typedef struct {
+  float u1, v1, u2, v2;
+  int first, last;
+} GrfaEdge;
+
+/*
+ * An edge in the active list, with its crossing of the current line.
+ */
+typedef struct {
+  float u;
+  int edge;
+} GrfaActive;
+
+static struct {
+  GrfaEdge *edge; size_t medge;
+  int *order; size_t morder;  /* Edges in order of first line */
+  GrfaActive *act; size_t mact;
+  GrfaActive *tmp; size_t mtmp;  /* Work space for merging act[] */
+  float *span; size_t mspan;  /* Span end points of the current line */
+  int nedge;
+  int next;                   /* Next entry of order[] to activate */
+  int nact;
+  int nspan, pending;         /* Points in span[], and index of the next */
+  int line, l1, l2;
+  float d;
+  int active;                 /* True between GRFAS0 and the end of output */
+} grfa = {0};
+
+/*
+ * Grow an array to hold at least n elements of the given size.
+ */
+static int grfa_grow(void **ptr, size_t *max, size_t n, size_t size)
+{
+  size_t m;
+  void *p;
+  if(n <= *max)
+    return 0;
+  m = *max ? *max : 256;
+  while(m < n)
+    m *= 2;
+  p = realloc(*ptr, m * size);
+  if(!p)
+    return -1;
+  *ptr = p;
+  *max = m;
+  return 0;
+}
+
+static int grfa_cmp(const void *p, const void *q)
+{
+  int a = grfa.edge[*(const int *) p].first;
+  int b = grfa.edge[*(const int *) q].first;
+  return a < b ? -1 : a > b;
+}
+
+static int grfa_ucmp(const void *p, const void *q)
+{
+  float a = ((const GrfaActive *) p)->u;
+  float b = ((const GrfaActive *) q)->u;
+  return a < b ? -1 : a > b;
+}
+
+/*
+ * Return the V coordinate of scan line l.
+ */
+static float grfa_v(int l)
+{
+  float v = (float) l * grfa.d;
+  return v;
+}
+
+/*
+ * Find the scan lines crossed by edge e. The estimate from lo/d is
+ * corrected so that the result agrees exactly with the single-precision
+ * test used by grfa_scan().
+ */
+static void grfa_lines(GrfaEdge *e)
+{
+  float lo = e->v1 < e->v2 ? e->v1 : e->v2;
+  float hi = e->v1 < e->v2 ? e->v2 : e->v1;
+  double f = floor((double) lo / grfa.d) + 1.0;
+  double l = floor((double) hi / grfa.d);
+/*
+ * Only lines l1...l2 are wanted.
+ */
+  if(f < grfa.l1)
+    f = grfa.l1;
+  if(f > grfa.l2 + 1.0)
+    f = grfa.l2 + 1.0;
+  if(l > grfa.l2)
+    l = grfa.l2;
+  if(l < grfa.l1 - 1.0)
+    l = grfa.l1 - 1.0;
+  e->first = (int) f;
+  e->last = (int) l;
+  while(e->first <= grfa.l2 && grfa_v(e->first) <= lo)
+    e->first++;
+  while(e->first > grfa.l1 && grfa_v(e->first - 1) > lo)
+    e->first--;
+  while(e->last >= grfa.l1 && grfa_v(e->last) > hi)
+    e->last--;
+  while(e->last < grfa.l2 && grfa_v(e->last + 1) <= hi)
+    e->last++;
+}
+
+/*
+ * Find the spans of the next line that has any, leaving them in
+ * grfa.span[]. Return 0 if there are no more lines.
+ */
+static int grfa_scan(void)
+{
+  int i, j, k, nold;
+  while(grfa.line < grfa.l2) {
+    float v;
+    grfa.line++;
+/*
+ * If no edges are active, skip to the first line of the next edge.
+ */
+    if(grfa.nact == 0) {
+      if(grfa.next >= grfa.nedge)
+	return 0;
+      if(grfa.edge[grfa.order[grfa.next]].first > grfa.line)
+	grfa.line = grfa.edge[grfa.order[grfa.next]].first;
+    };
+/*
+ * Drop the edges that ended on the previous line, and add those that
+ * start on this one.
+ */
+    for(i=j=0; i<grfa.nact; i++)
+      if(grfa.edge[grfa.act[i].edge].last >= grfa.line)
+	grfa.act[j++] = grfa.act[i];
+    grfa.nact = nold = j;
+    while(grfa.next < grfa.nedge &&
+	  grfa.edge[grfa.order[grfa.next]].first == grfa.line) {
+      grfa.act[grfa.nact].edge = grfa.order[grfa.next++];
+      grfa.act[grfa.nact++].u = 0.0f;
+    };
+/*
+ * Find the crossings and sort them. The edges carried over from the
+ * previous line are insertion sorted, since their order rarely changes,
+ * and the new ones are sorted separately and merged with them.
+ */
+    v = grfa_v(grfa.line);
+    for(i=0; i<grfa.nact; i++) {
+      GrfaEdge *e = &grfa.edge[grfa.act[i].edge];
+      grfa.act[i].u = e->u1 + (e->u2 - e->u1) * ((v - e->v1) / (e->v2 - e->v1));
+    };
+    for(i=1; i<nold; i++) {
+      GrfaActive a = grfa.act[i];
+      for(j=i; j>0 && grfa.act[j-1].u > a.u; j--)
+	grfa.act[j] = grfa.act[j-1];
+      grfa.act[j] = a;
+    };
+    if(nold < grfa.nact) {
+      qsort(grfa.act + nold, grfa.nact - nold, sizeof(GrfaActive), grfa_ucmp);
+      for(i=0, j=nold, k=0; k<grfa.nact; k++) {
+	if(j >= grfa.nact || (i < nold && grfa.act[i].u <= grfa.act[j].u))
+	  grfa.tmp[k] = grfa.act[i++];
+	else
+	  grfa.tmp[k] = grfa.act[j++];
+      };
+      for(k=0; k<grfa.nact; k++)
+	grfa.act[k] = grfa.tmp[k];
+    };
+/*
+ * Pair the crossings into spans, merging spans that touch.
+ */
+    grfa.nspan = 0;
+    for(i=0; i+1<grfa.nact; i+=2) {
+      if(grfa.nspan > 0 && grfa.span[grfa.nspan-1] == grfa.act[i].u) {
+	grfa.span[grfa.nspan-1] = grfa.act[i+1].u;
+      } else {
+	grfa.span[grfa.nspan++] = grfa.act[i].u;
+	grfa.span[grfa.nspan++] = grfa.act[i+1].u;
+      };
+    };
+    if(grfa.nspan > 0) {
+/*
+ * Reverse alternate lines.
+ */
+      if((grfa.line - grfa.l1) % 2) {
+	for(i=0, k=grfa.nspan-1; i<k; i++, k--) {
+	  float t = grfa.span[i];
+	  grfa.span[i] = grfa.span[k];
+	  grfa.span[k] = t;
+	};
+      };
+      grfa.pending = 0;
+      return 1;
+    };
+  };
+  return 0;
+}
+
+void GRFAS0(int *n, const float *px, const float *py, const float *tr,
+	    float *d, int *l1, int *l2, int *ier)
+{
+  int i, j;
+  *ier = 1;
+  grfa.active = 0;
+  if(grfa_grow((void **) &grfa.edge, &grfa.medge, (size_t) *n + 1,
+	       sizeof(GrfaEdge)) ||
+     grfa_grow((void **) &grfa.order, &grfa.morder, (size_t) *n + 1,
+	       sizeof(int)) ||
+     grfa_grow((void **) &grfa.act, &grfa.mact, (size_t) *n + 1,
+	       sizeof(GrfaActive)) ||
+     grfa_grow((void **) &grfa.tmp, &grfa.mtmp, (size_t) *n + 1,
+	       sizeof(GrfaActive)) ||
+     grfa_grow((void **) &grfa.span, &grfa.mspan, (size_t) *n + 1,
+	       sizeof(float)))
+    return;
+  grfa.d = *d;
+  grfa.l1 = *l1;
+  grfa.l2 = *l2;
+/*
+ * Build the edge table, from vertex n to vertex 1 and then in order.
+ * Horizontal edges and those that cross no line are left out.
+ */
+  grfa.nedge = 0;
+  if(grfa.d > 0.0f) {
+    for(i=0, j=*n-1; i<*n; j=i++) {
+      GrfaEdge *e = &grfa.edge[grfa.nedge];
+      e->u1 = tr[0] + tr[1]*px[j] + tr[2]*py[j];
+      e->v1 = tr[3] + tr[4]*px[j] + tr[5]*py[j];
+      e->u2 = tr[0] + tr[1]*px[i] + tr[2]*py[i];
+      e->v2 = tr[3] + tr[4]*px[i] + tr[5]*py[i];
+      if(e->v1 == e->v2)
+	continue;
+      grfa_lines(e);
+      if(e->first <= e->last) {
+	grfa.order[grfa.nedge] = grfa.nedge;
+	grfa.nedge++;
+      };
+    };
+  };
+  qsort(grfa.order, grfa.nedge, sizeof(int), grfa_cmp);
+  grfa.next = 0;
+  grfa.nact = 0;
+  grfa.nspan = grfa.pending = 0;
+  grfa.line = grfa.l1 - 1;
+  grfa.active = 1;
+  *ier = 0;
+}
+
+void GRFAS1(int *l, float *u, int *nmax, int *n)
+{
+  int m;
+  *n = 0;
+  if(!grfa.active)
+    return;
+  if(grfa.pending >= grfa.nspan && !grfa_scan()) {
+    grfa.active = 0;
+    return;
+  };
+  m = grfa.nspan - grfa.pending;
+  if(m > *nmax)
+    m = *nmax - *nmax % 2;
+  for(*n=0; *n<m; (*n)++)
+    u[*n] = grfa.span[grfa.pending++];
+  *l = grfa.line;
+}
@@ -14,6 +14,10 @@
  * 10-Nov-94 - Added GRFCH() routine to write FORTRAN CHARACTER sub-strings.
  * 19-Jun-95 - File name "-" means stdout.
  *  9-feb-2024    added string.h and unistd.h for gcc-14
+ * 17-Oct-2026 - Output is buffered per descriptor (PGPLOT_FILE_BUFFER
+ *            bytes, default 4 Mbyte, 0 for none); large writes are
+ *            coalesced with the buffer using writev(). Added GRQFIO()
+ *            to report the number of write system calls.
  *-------
  */
 
@@ -25,20 +29,183 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <fcntl.h>
+#include <errno.h>
 
 #ifdef PG_PPU
 #define GROFIL grofil_
 #define GRWFIL grwfil_
 #define GRCFIL grcfil_
 #define GRWFCH grwfch_
+#define GRQFIO grqfio_
 #else
 #define GROFIL grofil
 #define GRWFIL grwfil
 #define GRCFIL grcfil
 #define GRWFCH grwfch
+#define GRQFIO grqfio
 #endif
 
+/*
+ * Output buffering. Each descriptor opened by GROFIL gets a buffer of
+ * PGPLOT_FILE_BUFFER bytes (default DEFAULT_BUFFER); a size of 0
+ * selects the old behaviour of one write() per call. Data are written
+ * when the buffer fills, when the file is closed, and at exit. A write
+ * larger than the free space is sent together with the buffered data
+ * in a single writev(), without copying it into the buffer.
+ */
+#define DEFAULT_BUFFER (4*1024*1024)
+
+typedef struct {
+  char *buf;     /* Buffered data, or NULL if the descriptor is unbuffered */
+  size_t size;   /* Capacity of buf[] */
+  size_t used;   /* Number of bytes waiting in buf[] */
+} GrFileBuf;
+
+static GrFileBuf *grfbuf = 0;   /* Buffers, indexed by file descriptor */
+static int grfnbuf = 0;         /* Number of elements in grfbuf[] */
+static long grfncall = 0;       /* Number of write system calls */
+static double grfnbyte = 0.0;   /* Number of bytes written */
+
+/*
+ * Write all of the given pieces, retrying after partial writes and
+ * interrupts. Returns 0 on success or -1 on error.
+ */
+static int grfwritev(int fd, struct iovec *iov, int niov)
+{
+  while(niov > 0) {
+    ssize_t n = niov == 1 ? write(fd, iov[0].iov_base, iov[0].iov_len) :
+                            writev(fd, iov, niov);
+    grfncall++;
+    if(n < 0) {
+      if(errno == EINTR)
+	continue;
+      return -1;
+    };
+    grfnbyte += n;
+    while(niov > 0 && (size_t) n >= iov[0].iov_len) {
+      n -= iov[0].iov_len;
+      iov++;
+      niov--;
+    };
+    if(niov > 0) {
+      iov[0].iov_base = (char *) iov[0].iov_base + n;
+      iov[0].iov_len -= n;
+    };
+  };
+  return 0;
+}
+
+/*
+ * Write nbytes bytes to descriptor fd, through its buffer if it has
+ * one. Returns nbytes on success or -1 on error.
+ */
+static int grfput(int fd, char *data, int nbytes)
+{
+  GrFileBuf *b = (fd >= 0 && fd < grfnbuf) ? &grfbuf[fd] : 0;
+  struct iovec iov[2];
+  int nput = nbytes;
+  if(nbytes <= 0)
+    return nbytes;
+  if(!b || !b->buf) {
+    iov[0].iov_base = data;
+    iov[0].iov_len = nbytes;
+    return grfwritev(fd, iov, 1) ? -1 : nbytes;
+  };
+  if((size_t) nbytes <= b->size - b->used) {
+    memcpy(b->buf + b->used, data, nbytes);
+    b->used += nbytes;
+    if(b->used < b->size)
+      return nbytes;
+    nbytes = 0;
+  };
+/*
+ * The buffer is full, or the data do not fit: write both at once.
+ */
+  iov[0].iov_base = b->buf;
+  iov[0].iov_len = b->used;
+  iov[1].iov_base = data;
+  iov[1].iov_len = nbytes;
+  b->used = 0;
+  return grfwritev(fd, iov, nbytes > 0 ? 2 : 1) ? -1 : nput;
+}
+
+/*
+ * Write out any buffered data for descriptor fd. Returns 0 or -1.
+ */
+static int grfflush(int fd)
+{
+  GrFileBuf *b = (fd >= 0 && fd < grfnbuf) ? &grfbuf[fd] : 0;
+  struct iovec iov;
+  if(!b || !b->buf || b->used == 0)
+    return 0;
+  iov.iov_base = b->buf;
+  iov.iov_len = b->used;
+  b->used = 0;
+  return grfwritev(fd, &iov, 1);
+}
+
+/*
+ * Flush all buffers when the program exits without closing its files.
+ */
+static void grfexit()
+{
+  int fd;
+  for(fd=0; fd<grfnbuf; fd++)
+    grfflush(fd);
+}
+
+/*
+ * Give descriptor fd a buffer. If this fails, the descriptor is
+ * simply left unbuffered.
+ */
+static void grfattach(int fd)
+{
+  static int first = 1;
+  char *env;
+  long size = DEFAULT_BUFFER;
+  if(first) {
+    atexit(grfexit);
+    first = 0;
+  };
+  env = getenv("PGPLOT_FILE_BUFFER");
+  if(env && *env)
+    size = atol(env);
+  if(size <= 0)
+    return;
+  if(fd >= grfnbuf) {
+    int n = fd + 8;
+    GrFileBuf *tmp = (GrFileBuf *) realloc(grfbuf, n * sizeof(GrFileBuf));
+    if(!tmp)
+      return;
+    memset(tmp + grfnbuf, 0, (n - grfnbuf) * sizeof(GrFileBuf));
+    grfbuf = tmp;
+    grfnbuf = n;
+  };
+  grfbuf[fd].buf = (char *) malloc(size);
+  grfbuf[fd].size = grfbuf[fd].buf ? size : 0;
+  grfbuf[fd].used = 0;
+#ifdef POSIX_FADV_SEQUENTIAL
+  if(fd != 1)
+    (void) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+/*
+ * Flush and release the buffer of descriptor fd. Returns 0 or -1.
+ */
+static int grfdetach(int fd)
+{
+  int ier = grfflush(fd);
+  if(fd >= 0 && fd < grfnbuf && grfbuf[fd].buf) {
+    free(grfbuf[fd].buf);
+    grfbuf[fd].buf = 0;
+    grfbuf[fd].size = 0;
+  };
+  return ier;
+}
+
 /*
  **&GROFIL -- Open file for writing with GRFILEIO
  *+
@@ -98,6 +265,8 @@ int GROFIL(fname, fname_len)
  */
       fd = open(buff, O_WRONLY | O_CREAT | O_TRUNC, 0666);
     }
+    if(fd >= 0)
+      grfattach(fd);
     free(buff);
   } else {
     fprintf(stderr, "grofil: Insufficient memory\n");
@@ -129,10 +298,11 @@ int GROFIL(fname, fname_len)
 int GRCFIL(fd)
      int *fd;
 {
+  int ier = grfdetach(*fd);
   if ((*fd) == 1) {
-    return 0;
+    return ier;
   } else{
-    return close(*fd);
+    return close(*fd) || ier ? -1 : 0;
   }
 }
 
@@ -161,7 +331,7 @@ int GRWFIL(fd, nbytes, buf)
      int *fd, *nbytes;
      char *buf;
 {
-  return write(*fd, (void *) buf, *nbytes);
+  return grfput(*fd, buf, *nbytes);
 }
 
 /*
@@ -188,5 +358,29 @@ int GRWFCH(fd, buf, buf_len)
      char *buf;
      int buf_len;
 {
-  return write(*fd, (void *) buf, buf_len);
+  return grfput(*fd, buf, buf_len);
+}
+
+/*
+ **&GRQFIO -- Inquire GRFILEIO output statistics
+ *+
+ *     SUBROUTINE GRQFIO (NCALL, NBYTE)
+ *     INTEGER NCALL
+ *     DOUBLE PRECISION NBYTE
+ *
+ * Returns the number of write system calls made by GRFILEIO, and the
+ * number of bytes they wrote, since the program started. This is
+ * intended for profiling output performance.
+ *
+ * Arguments:
+ *  NCALL  (output) : Number of write() and writev() calls.
+ *  NBYTE  (output) : Number of bytes written.
+ *-
+ */
+void GRQFIO(ncall, nbyte)
+     int *ncall;
+     double *nbyte;
+{
+  *ncall = (int) grfncall;
+  *nbyte = grfnbyte;
 }
@@ -0,0 +1,186 @@
+/*GRHIST -- binning engine for PGHIST
+ * +
+ *
+ *   CALL GRHIS0(N, DATA, DATMIN, DATMAX, NBIN, NUMMAX, IER)
+ *
+ * counts the number of the N values DATA(1...N) that fall in each of
+ * NBIN equal bins between DATMIN and DATMAX, as PGHIST. The counts are
+ * kept in memory allocated here, so there is no limit on NBIN. NUMMAX
+ * is returned as the largest count, and IER as 0, or 1 if there is not
+ * enough memory. Then
+ *
+ *   CALL GRHIS1(IBIN, M, NUM)
+ *
+ * returns the counts of bins IBIN...IBIN+M-1 in NUM(1...M).
+ *
+ * A value is put in bin INT((DATA(I)-DATMIN)/(DATMAX-DATMIN)*NBIN+1),
+ * evaluated in single precision exactly as PGHIST always has, so values
+ * on the boundary between two bins go in the same bin as before.
+ *
+ * If the environment variable PGPLOT_HIST_THREADS is set to a number
+ * greater than 1, and POSIX threads are available (HAVE_PTHREAD), the
+ * data are divided between that many threads. Each thread counts its
+ * part into its own array, and the arrays are then added, so the
+ * result does not depend on the number of threads.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ * 18-Oct-2026 - count in one pass; finding the bins of a block first
+ *               was slower.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#ifdef PG_PPU
+#define GRHIS0 grhis0_
+#define GRHIS1 grhis1_
+#else
+#define GRHIS0 grhis0
+#define GRHIS1 grhis1
+#endif
+
+#define MIN_VALUES 65536  /* Minimum number of values per thread */
+#define MAX_THREADS 64
+
+/*
+ * The part of the data counted by one thread.
+ */
+typedef struct {
+  const float *data;
+  size_t n;
+  int *num;              /* The counts of this part */
+} GrhiPart;
+
+static struct {
+  int *num;              /* The counts of the last call to GRHIS0 */
+  size_t nbin, mbin;
+  float datmin, range;
+  float fnbin;           /* NBIN as a REAL */
+  double top;            /* NBIN+1: values must be below this */
+} grhi = {0};
+
+/*
+ * Count the n values in data[] into num[].
+ */
+static void grhi_count(const float *data, size_t n, int *num)
+{
+  const float datmin = grhi.datmin, range = grhi.range, fnbin = grhi.fnbin;
+  const double top = grhi.top;
+  size_t i;
+  for(i=0; i<n; i++) {
+    float t = (data[i] - datmin) / range * fnbin + 1.0f;
+    if(t >= 1.0f && t < top)
+      num[(int) t - 1]++;
+  };
+}
+
+#ifdef HAVE_PTHREAD
+static void *grhi_thread(void *arg)
+{
+  GrhiPart *p = (GrhiPart *) arg;
+  grhi_count(p->data, p->n, p->num);
+  return NULL;
+}
+
+/*
+ * Count the n values in data[] into grhi.num[] using nthread threads.
+ * Return 0 if OK, or 1 if the partial counts could not be allocated.
+ */
+static int grhi_parallel(const float *data, size_t n, int nthread)
+{
+  GrhiPart part[MAX_THREADS];
+  pthread_t thread[MAX_THREADS];
+  int started[MAX_THREADS];
+  size_t chunk = (n + nthread - 1) / nthread;
+  size_t b;
+  int i;
+  for(i=0; i<nthread; i++) {
+    part[i].data = data + i * chunk;
+    part[i].n = i < nthread-1 ? chunk : n - i * chunk;
+    part[i].num = i == 0 ? grhi.num :
+      (int *) calloc(grhi.nbin, sizeof(int));
+    if(!part[i].num) {
+      while(--i > 0)
+	free(part[i].num);
+      return 1;
+    };
+  };
+/*
+ * The first part is counted on this thread, and so is any part whose
+ * thread could not be started.
+ */
+  for(i=1; i<nthread; i++)
+    started[i] = pthread_create(&thread[i], NULL, grhi_thread, &part[i]) == 0;
+  grhi_count(part[0].data, part[0].n, part[0].num);
+  for(i=1; i<nthread; i++) {
+    if(started[i])
+      pthread_join(thread[i], NULL);
+    else
+      grhi_count(part[i].data, part[i].n, part[i].num);
+    for(b=0; b<grhi.nbin; b++)
+      grhi.num[b] += part[i].num[b];
+    free(part[i].num);
+  };
+  return 0;
+}
+#endif
+
+void GRHIS0(int *n, const float *data, float *datmin, float *datmax,
+	    int *nbin, int *nummax, int *ier)
+{
+  size_t b;
+  int nthread = 1, done = 0;
+  *ier = 1;
+  *nummax = 0;
+  if(*nbin < 1)
+    return;
+  grhi.nbin = (size_t) *nbin;
+  if(grhi.nbin > grhi.mbin) {
+    free(grhi.num);
+    grhi.num = (int *) malloc(grhi.nbin * sizeof(int));
+    grhi.mbin = grhi.num ? grhi.nbin : 0;
+    if(!grhi.num)
+      return;
+  };
+  memset(grhi.num, 0, grhi.nbin * sizeof(int));
+  grhi.datmin = *datmin;
+  grhi.range = *datmax - *datmin;
+  grhi.fnbin = (float) *nbin;
+  grhi.top = (double) *nbin + 1.0;
+  *ier = 0;
+  if(*n < 1)
+    return;
+#ifdef HAVE_PTHREAD
+  {
+    char *string = getenv("PGPLOT_HIST_THREADS");
+    if(string && *string)
+      nthread = atoi(string);
+    if(nthread > MAX_THREADS)
+      nthread = MAX_THREADS;
+    if(nthread > *n / MIN_VALUES)
+      nthread = *n / MIN_VALUES;
+  };
+  if(nthread > 1 && grhi_parallel(data, (size_t) *n, nthread) == 0)
+    done = 1;
+#endif
+  if(!done)
+    grhi_count(data, (size_t) *n, grhi.num);
+  for(b=0; b<grhi.nbin; b++)
+    if(grhi.num[b] > *nummax)
+      *nummax = grhi.num[b];
+}
+
+void GRHIS1(int *ibin, int *m, int *num)
+{
+  int i;
+  for(i=0; i<*m; i++) {
+    size_t b = (size_t) (*ibin - 1 + i);
+    num[i] = b < grhi.nbin ? grhi.num[b] : 0;
+  };
+}
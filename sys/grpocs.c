@@ -0,0 +1,168 @@
+/*GRPOCS -- clip a polygon to a rectangle and fill it
+ * +
+ *
+ *   CALL GRPOCS(N, PX, PY, XL, XH, YL, YH, IER)
+ *
+ * clips the polygon of N vertices (PX(I),PY(I)) to the rectangle
+ * XL <= X <= XH, YL <= Y <= YH and fills the result with GRFA. IER is
+ * returned as 0, or 1 if there is not enough memory.
+ *
+ * This is the Sutherland-Hodgman algorithm of GRPOCL, applied to the
+ * left, right, bottom and top edges in turn, but the four stages are
+ * run as a pipeline: each vertex output by one stage is passed straight
+ * on to the next, so only the final polygon is stored, in memory that
+ * grows as needed. The vertices are the same as those found by calling
+ * GRPOCL four times. As in PGPOLY, nothing is drawn if fewer than three
+ * vertices survive any of the first three stages.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef PG_PPU
+#define GRPOCS grpocs_
+#define GRFA grfa_
+#else
+#define GRPOCS grpocs
+#define GRFA grfa
+#endif
+
+void GRFA(int *n, float *px, float *py);
+
+/*
+ * The state of one clipping stage. Stage e clips against edge e: 0
+ * (X >= val), 1 (X <= val), 2 (Y >= val) or 3 (Y <= val).
+ */
+typedef struct {
+  float val;
+  int n;                 /* Vertices received so far */
+  int nout;              /* Vertices output so far */
+  float fx, fy;          /* The first vertex */
+  float sx, sy;          /* The previous vertex */
+} GrpoStage;
+
+static struct {
+  GrpoStage stage[4];
+  float *x, *y;          /* The clipped polygon */
+  size_t n, max;
+  int error;             /* True if memory ran out */
+} grpo = {{{0}}};
+
+static void grpo_vertex(int e, float px, float py);
+
+/*
+ * Append a vertex to the clipped polygon.
+ */
+static void grpo_store(float px, float py)
+{
+  if(grpo.error)
+    return;
+  if(grpo.n >= grpo.max) {
+    size_t m = grpo.max ? 2 * grpo.max : 1024;
+    float *x = (float *) realloc(grpo.x, m * sizeof(float));
+    float *y;
+    if(x)
+      grpo.x = x;
+    y = x ? (float *) realloc(grpo.y, m * sizeof(float)) : NULL;
+    if(!y) {
+      grpo.error = 1;
+      return;
+    };
+    grpo.y = y;
+    grpo.max = m;
+  };
+  grpo.x[grpo.n] = px;
+  grpo.y[grpo.n] = py;
+  grpo.n++;
+}
+
+/*
+ * Output a vertex from stage e.
+ */
+static void grpo_emit(int e, float px, float py)
+{
+  grpo.stage[e].nout++;
+  if(e < 3)
+    grpo_vertex(e + 1, px, py);
+  else
+    grpo_store(px, py);
+}
+
+/*
+ * Output the intersection of the segment from the previous vertex of
+ * stage e to (px,py) with the edge of the stage, if they intersect.
+ * The test uses the sign of the difference, as SIGN(1.0,...) in GRPOCL.
+ */
+static void grpo_cross(int e, float px, float py)
+{
+  GrpoStage *s = &grpo.stage[e];
+  float val = s->val;
+  if(e < 2) {
+    if(copysignf(1.0f, px - val) != copysignf(1.0f, s->sx - val))
+      grpo_emit(e, val, s->sy + (py - s->sy) * ((val - s->sx) / (px - s->sx)));
+  } else {
+    if(copysignf(1.0f, py - val) != copysignf(1.0f, s->sy - val))
+      grpo_emit(e, s->sx + (px - s->sx) * ((val - s->sy) / (py - s->sy)), val);
+  };
+}
+
+/*
+ * Pass vertex (px,py) to stage e.
+ */
+static void grpo_vertex(int e, float px, float py)
+{
+  GrpoStage *s = &grpo.stage[e];
+  int inside;
+  if(s->n++ == 0) {
+    s->fx = px;
+    s->fy = py;
+  } else {
+    grpo_cross(e, px, py);
+  };
+  s->sx = px;
+  s->sy = py;
+  switch(e) {
+  case 0: inside = px >= s->val; break;
+  case 1: inside = px <= s->val; break;
+  case 2: inside = py >= s->val; break;
+  default: inside = py <= s->val; break;
+  };
+  if(inside)
+    grpo_emit(e, px, py);
+}
+
+void GRPOCS(int *n, const float *px, const float *py, float *xl, float *xh,
+	    float *yl, float *yh, int *ier)
+{
+  int e, i, nvert;
+  grpo.stage[0].val = *xl;
+  grpo.stage[1].val = *xh;
+  grpo.stage[2].val = *yl;
+  grpo.stage[3].val = *yh;
+  for(e=0; e<4; e++)
+    grpo.stage[e].n = grpo.stage[e].nout = 0;
+  grpo.n = 0;
+  grpo.error = 0;
+  for(i=0; i<*n; i++)
+    grpo_vertex(0, px[i], py[i]);
+/*
+ * Close each stage in turn with the edge from its last vertex back to
+ * its first.
+ */
+  for(e=0; e<4; e++)
+    if(grpo.stage[e].n > 0)
+      grpo_cross(e, grpo.stage[e].fx, grpo.stage[e].fy);
+  *ier = grpo.error;
+  if(grpo.error)
+    return;
+  for(e=0; e<3; e++)
+    if(grpo.stage[e].nout < 3)
+      return;
+  nvert = (int) grpo.n;
+  if(nvert > 0)
+    GRFA(&nvert, grpo.x, grpo.y);
+}
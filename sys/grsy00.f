@@ -18,6 +18,12 @@ C  for symbol number N is in BUFFER(INDEX(N)), where INDEX is an
 C  integer array of 3000 elements. Not all symbols 1...3000 have
 C  a representation; if INDEX(N) = 0, the symbol is undefined.
 C
+C  If a font image made from this file is available (see
+C  sys/grsyim.c), it is mapped instead and the file is not read. The
+C  image is written when PGPLOT is installed, by program pgfimg; it
+C  is named by environment variable PGPLOT_FONT_IMAGE, or is found
+C  next to the font file.
+C
 *  PGPLOT uses the Hershey symbols for two `primitive' operations:
 *  graph markers and text.  The Hershey symbol set includes several
 *  hundred different symbols in a digitized form that allows them to
@@ -53,20 +59,27 @@ C               by environment variable PGPLOT_FONT [TJP].
 C 29-Nov-1990 - move font assignment to GRSYMK.
 C  7-Nov-1994 - look for font file in PGPLOT_DIR if PGPLOT_FONT is
 C               undefined [TJP].
+C 17-Oct-2026 - use the font image if possible.
+C 18-Oct-2026 - no longer write the font image (see fonts/pgfimg.f).
 C-----------------------------------------------------------------------
       INTEGER*2  BUFFER(27000)
       INTEGER    FNTFIL, IER, INDEX(3000), NC1, NC2, NC3
-      INTEGER    L, GRTRIM
+      INTEGER    L, LI, GRTRIM, GRSYIM
       COMMON     /GRSYMB/ NC1, NC2, INDEX, BUFFER
-      CHARACTER*128 FF
+      CHARACTER*128 FF, FI
 C
-C Read the font file. If an I/O error occurs, it is ignored; the
-C effect will be that all symbols will be undefined (treated as 
-C blank spaces).
+C Use the font image if there is one for this file.
 C
       CALL GRGFIL('FONT', FF)
       L = GRTRIM(FF)
       IF (L.LT.1) L = 1
+      CALL GRGENV('FONT_IMAGE', FI, LI)
+      IF (GRSYIM(FF(1:L), FI).EQ.1) RETURN
+C
+C Read the font file. If an I/O error occurs, it is ignored; the
+C effect will be that all symbols will be undefined (treated as 
+C blank spaces).
+C
       CALL GRGLUN(FNTFIL)
       OPEN (UNIT=FNTFIL, FILE=FF(1:L), FORM='UNFORMATTED',
      2      STATUS='OLD', IOSTAT=IER)
@@ -0,0 +1,353 @@
+/*
+ * Binary font image for the Hershey symbol routines (GRSY00, GRSYXD).
+ *
+ * The font file (grfont.dat) stores each symbol as a packed stream of
+ * IX*128+IY words that GRSYXD has to decode every time the symbol is
+ * drawn. The font image (grfont.img) holds the same symbols already
+ * decoded into the form returned by GRSYXD. It is written once, when
+ * PGPLOT is built, by program pgfimg (fonts/pgfimg.f), which calls
+ * GRSYIW. At run time GRSY00 maps the image read-only (GRSYIM), so
+ * programs do not need to read and decode the font file at all, and
+ * all processes using the same image share one copy of it in memory.
+ * The library itself never writes an image.
+ *
+ * The image is looked for next to the font file, with extension .img
+ * in place of .dat (or appended), unless environment variable
+ * PGPLOT_FONT_IMAGE names another file. If there is no usable image,
+ * GRSY00 reads the font file and GRSYXD decodes the symbols as before.
+ * Systems that do not use this file provide GRSYIM and GRSYIG stubs
+ * that always take that path.
+ *
+ * Layout (all integers 32-bit, in native byte order):
+ *
+ *   header:  magic "PGFONTIM", version, byte-order mark 0x01020304,
+ *            size of the font file it was made from, first and last
+ *            symbol numbers (NC1, NC2), and the number of bytes of
+ *            symbol data;
+ *   table:   one entry per symbol NC1..NC2: offset of its data (-1 if
+ *            the symbol is undefined) and number of values;
+ *   data:    the values returned by GRSYXD in XYGRID, one signed byte
+ *            each.
+ *
+ * An image is ignored if any of these fields do not match. The font
+ * file's modification time is not recorded, since installing the
+ * files does not preserve it; run pgfimg again after changing the
+ * font file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#ifdef PG_PPU
+#define GRSYIM grsyim_
+#define GRSYIW grsyiw_
+#define GRSYIG grsyig_
+#else
+#define GRSYIM grsyim
+#define GRSYIW grsyiw
+#define GRSYIG grsyig
+#endif
+
+#define GRSYI_VERSION 2
+#define GRSYI_ORDER 0x01020304
+#define GRSYI_NSYM 3000     /* Size of INDEX in /GRSYMB/ */
+#define GRSYI_NBUF 27000    /* Size of BUFFER in /GRSYMB/ */
+#define GRSYI_NXY 300       /* Size of XYGRID in GRSYXD */
+
+typedef struct {
+  char magic[8];
+  int version;
+  int order;
+  unsigned int srcsize;
+  int nc1, nc2;
+  int ndata;
+} GrsyiHeader;
+
+typedef struct {
+  int offset;               /* Offset of the symbol's data, or -1 */
+  int n;                    /* Number of values */
+} GrsyiSymbol;
+
+static const char grsyi_magic[8] = {'P','G','F','O','N','T','I','M'};
+
+static struct {
+  void *map;                /* The mapped image, or NULL */
+  size_t size;
+  const GrsyiHeader *hdr;
+  const GrsyiSymbol *sym;
+  const signed char *data;
+} grsyi;
+
+/*
+ * Copy a Fortran string, without trailing blanks, to a new C string.
+ */
+static char *grsyi_cstr(const char *s, int len)
+{
+  char *c;
+  while(len > 0 && s[len-1] == ' ')
+    len--;
+  c = (char *) malloc(len + 1);
+  if(c) {
+    memcpy(c, s, len);
+    c[len] = '\0';
+  };
+  return c;
+}
+
+/*
+ * Return the name of the image for font file src: img if it is not
+ * blank, otherwise src with .dat replaced by (or followed by) .img.
+ */
+static char *grsyi_name(const char *src, int src_len,
+			const char *img, int img_len)
+{
+  char *name = grsyi_cstr(img, img_len);
+  size_t n;
+  if(!name || *name)
+    return name;
+  free(name);
+  name = grsyi_cstr(src, src_len);
+  if(!name || !*name)
+    return name;
+  n = strlen(name);
+  if(n > 4 && strcmp(name + n - 4, ".dat") == 0)
+    n -= 4;
+  name = (char *) realloc(name, n + 5);
+  if(name)
+    strcpy(name + n, ".img");
+  return name;
+}
+
+static void grsyi_unmap(void)
+{
+  if(grsyi.map)
+    munmap(grsyi.map, grsyi.size);
+  grsyi.map = NULL;
+  grsyi.hdr = NULL;
+  grsyi.sym = NULL;
+  grsyi.data = NULL;
+}
+
+/*
+ * Map the image in file name, if it was made from a font file with the
+ * given status. Returns 1 on success, 0 if there is no usable image.
+ */
+static int grsyi_map(const char *name, const struct stat *src)
+{
+  const GrsyiHeader *hdr;
+  const GrsyiSymbol *sym;
+  struct stat st;
+  void *map;
+  int fd, nsym, i;
+  size_t head;
+
+  grsyi_unmap();
+  fd = open(name, O_RDONLY);
+  if(fd < 0)
+    return 0;
+  if(fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(GrsyiHeader)) {
+    close(fd);
+    return 0;
+  };
+  map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED)
+    return 0;
+/*
+ * Check the header and that every symbol lies within the file.
+ */
+  hdr = (const GrsyiHeader *) map;
+  nsym = hdr->nc2 - hdr->nc1 + 1;
+  head = sizeof(GrsyiHeader) + (nsym > 0 ? nsym : 0) * sizeof(GrsyiSymbol);
+  if(memcmp(hdr->magic, grsyi_magic, sizeof(grsyi_magic)) != 0 ||
+     hdr->version != GRSYI_VERSION || hdr->order != GRSYI_ORDER ||
+     hdr->srcsize != (unsigned int) src->st_size ||
+     nsym < 1 || nsym > GRSYI_NSYM || hdr->ndata < 0 ||
+     (size_t) st.st_size != head + (size_t) hdr->ndata) {
+    munmap(map, (size_t) st.st_size);
+    return 0;
+  };
+  sym = (const GrsyiSymbol *) (hdr + 1);
+  for(i=0; i<nsym; i++) {
+    if(sym[i].offset >= 0 &&
+       (sym[i].n < 7 || sym[i].n > GRSYI_NXY ||
+	sym[i].offset > hdr->ndata - sym[i].n)) {
+      munmap(map, (size_t) st.st_size);
+      return 0;
+    };
+  };
+  grsyi.map = map;
+  grsyi.size = (size_t) st.st_size;
+  grsyi.hdr = hdr;
+  grsyi.sym = sym;
+  grsyi.data = (const signed char *) map + head;
+  return 1;
+}
+
+/*
+ * Return the image entry for a symbol, or NULL if it is not in the
+ * image.
+ */
+static const GrsyiSymbol *grsyi_symbol(int symbol)
+{
+  const GrsyiSymbol *s;
+  if(symbol < grsyi.hdr->nc1 || symbol > grsyi.hdr->nc2)
+    return NULL;
+  s = &grsyi.sym[symbol - grsyi.hdr->nc1];
+  return s->offset < 0 ? NULL : s;
+}
+
+/*
+ * GRSYIM(SRC, IMG) -- map the font image for font file SRC (see above
+ * for IMG). Returns 1 if the image was mapped, in which case the font
+ * file need not be read, or 0 if there is no up-to-date image.
+ */
+int GRSYIM(char *src, char *img, int src_len, int img_len)
+{
+  char *srcname = grsyi_cstr(src, src_len);
+  char *name = grsyi_name(src, src_len, img, img_len);
+  struct stat st;
+  int ok = 0;
+  if(srcname && name && stat(srcname, &st) == 0)
+    ok = grsyi_map(name, &st);
+  else
+    grsyi_unmap();
+  free(srcname);
+  free(name);
+  return ok;
+}
+
+/*
+ * GRSYIW(SRC, IMG, NC1, NC2, INDEX, BUFFER) -- decode the symbols read
+ * from font file SRC (the contents of /GRSYMB/) and write them to the
+ * font image. Returns 1 on success, 0 if the image was not written.
+ * This is called only by program pgfimg.
+ */
+int GRSYIW(char *src, char *img, int *nc1, int *nc2, int *index,
+	   short *buffer, int src_len, int img_len)
+{
+  char *srcname = grsyi_cstr(src, src_len);
+  char *name = grsyi_name(src, src_len, img, img_len);
+  char *tmp = NULL;
+  char *image = NULL;
+  GrsyiHeader *hdr;
+  GrsyiSymbol *sym;
+  signed char *data;
+  struct stat st;
+  size_t head, size;
+  int nsym = *nc2 - *nc1 + 1;
+  int ndata, i, fd;
+  int ok = 0;
+
+  if(!srcname || !name || !*name || stat(srcname, &st) != 0 ||
+     nsym < 1 || nsym > GRSYI_NSYM)
+    goto done;
+  head = sizeof(GrsyiHeader) + nsym * sizeof(GrsyiSymbol);
+  image = (char *) malloc(head + (size_t) nsym * GRSYI_NXY);
+  if(!image)
+    goto done;
+  memset(image, 0, head);
+  hdr = (GrsyiHeader *) image;
+  sym = (GrsyiSymbol *) (hdr + 1);
+  data = (signed char *) image + head;
+/*
+ * Decode each symbol exactly as GRSYXD does. An image is not written
+ * if any symbol runs off the end of BUFFER, is longer than XYGRID, or
+ * has a value that does not fit in a byte.
+ */
+  ndata = 0;
+  for(i=0; i<nsym; i++) {
+    int loc = index[i];
+    int n = 0, iy;
+    signed char *xy = data + ndata;
+    sym[i].offset = -1;
+    sym[i].n = 0;
+    if(loc == 0)
+      continue;
+    if(loc < 1 || loc > GRSYI_NBUF || buffer[loc-1] < -128 ||
+       buffer[loc-1] > 127)
+      goto done;
+    xy[n++] = (signed char) buffer[loc++ - 1];
+    do {
+      int ix;
+      if(loc > GRSYI_NBUF || n + 2 > GRSYI_NXY)
+	goto done;
+      ix = buffer[loc-1] / 128;
+      iy = buffer[loc-1] - 128*ix - 64;
+      ix -= 64;
+      if(ix < -128 || ix > 127 || iy < -128 || iy > 127)
+	goto done;
+      xy[n++] = (signed char) ix;
+      xy[n++] = (signed char) iy;
+      loc++;
+    } while(iy != -64);
+    if(n < 7)
+      goto done;
+    sym[i].offset = ndata;
+    sym[i].n = n;
+    ndata += n;
+  };
+  memcpy(hdr->magic, grsyi_magic, sizeof(grsyi_magic));
+  hdr->version = GRSYI_VERSION;
+  hdr->order = GRSYI_ORDER;
+  hdr->srcsize = (unsigned int) st.st_size;
+  hdr->nc1 = *nc1;
+  hdr->nc2 = *nc2;
+  hdr->ndata = ndata;
+  size = head + ndata;
+/*
+ * Write the image to a temporary file and rename it.
+ */
+  tmp = (char *) malloc(strlen(name) + 8);
+  if(!tmp)
+    goto done;
+  sprintf(tmp, "%s.XXXXXX", name);
+  fd = mkstemp(tmp);
+  if(fd < 0)
+    goto done;
+  if(write(fd, image, size) != (ssize_t) size) {
+    close(fd);
+    unlink(tmp);
+    goto done;
+  };
+  fchmod(fd, 0644);
+  if(close(fd) != 0 || rename(tmp, name) != 0) {
+    unlink(tmp);
+    goto done;
+  };
+  ok = 1;
+done:
+  free(image);
+  free(tmp);
+  free(srcname);
+  free(name);
+  return ok;
+}
+
+/*
+ * GRSYIG(SYMBOL, XYGRID) -- copy the digitization of a symbol from the
+ * image into XYGRID, in the form described in GRSYXD. Returns the
+ * number of values copied, 0 if the symbol is undefined, or -1 if no
+ * image is mapped.
+ */
+int GRSYIG(int *symbol, int *xygrid)
+{
+  const GrsyiSymbol *s;
+  const signed char *xy;
+  int i;
+  if(!grsyi.map)
+    return -1;
+  s = grsyi_symbol(*symbol);
+  if(!s)
+    return 0;
+  xy = grsyi.data + s->offset;
+  for(i=0; i<s->n; i++)
+    xygrid[i] = xy[i];
+  return s->n;
+}
@@ -0,0 +1,281 @@
+/*GRTXC -- text layout cache for GRTEXT, GRQTXT and GRLEN
+ * +
+ *
+ *   CALL GRTXC0(STRING, FONT, BOX, PLOT, IER)
+ *
+ * finds the layout of STRING in font FONT, decoding it with GRSYDS and
+ * GRSYXD if it is not already in the cache, and makes it the current
+ * layout. BOX(1...4) is returned as the bounding box of the string in
+ * character units (XGMIN, XGMAX, YGMIN, YGMAX, as in GRQTXT), and PLOT
+ * as 1 if the string has any visible strokes, otherwise 0. IER is 0,
+ * or 1 if there is not enough memory. Then
+ *
+ *   CALL GRTXC1(K, NMAX, KIND, A, B, N)
+ *
+ * copies up to NMAX entries of the current layout, starting after
+ * entry K, into KIND(1...N), A(1...N), B(1...N); N = 0 at the end. The
+ * entries are:
+ *
+ *   KIND = -1, -2  up or down one level (\u, \d);
+ *   KIND = -3      backspace (\b), B = the size factor of the level;
+ *   KIND = 0       the end of a symbol, A = its width, B = the size
+ *                  factor of its level;
+ *   KIND = 1, 2    move or draw to (A,B), the position of a vertex
+ *                  relative to the start of its symbol, already scaled
+ *                  and shifted for the level.
+ *
+ * The layout depends only on the string and the font, not on the size
+ * or angle of the text, so it is shared by GRLEN and GRQTXT, which
+ * measure a string, and by GRTEXT, which draws it. The vertices, box
+ * and widths are computed with the same single-precision arithmetic
+ * that these routines used to apply to the output of GRSYXD, so the
+ * results are unchanged. There is no limit on the length of the string.
+ *
+ * The cache is a hash table. When it holds more than MAX_LAYOUTS
+ * strings or MAX_ENTRIES entries in all, it is emptied.
+ *
+ *-------
+ * 17-Oct-2026 - New routine.
+ *-------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PG_PPU
+#define GRTXC0 grtxc0_
+#define GRTXC1 grtxc1_
+#define GRSYDS grsyds_
+#define GRSYXD grsyxd_
+#else
+#define GRTXC0 grtxc0
+#define GRTXC1 grtxc1
+#define GRSYDS grsyds
+#define GRSYXD grsyxd
+#endif
+
+void GRSYDS(int *symbol, int *nsymbs, const char *text, int *font,
+	    int text_len);
+void GRSYXD(int *symbol, int *xygrid, int *unused);
+
+#define NBUCKET 1024      /* Number of hash buckets (a power of 2) */
+#define MAX_LAYOUTS 4096  /* Number of strings kept */
+#define MAX_ENTRIES 1000000L /* Number of entries kept */
+
+typedef struct GrtxLayout GrtxLayout;
+
+struct GrtxLayout {
+  GrtxLayout *next;      /* The next layout in the same bucket */
+  unsigned long hash;
+  int font;
+  int len;
+  char *string;
+  int n;                 /* Number of entries */
+  signed char *kind;
+  float *a, *b;
+  float box[4];
+  int plot;
+};
+
+static struct {
+  GrtxLayout *bucket[NBUCKET];
+  long nlayout, nentry;
+  GrtxLayout *current;
+} grtx = {{0}};
+
+static unsigned long grtx_hash(const char *s, int len, int font)
+{
+  unsigned long h = 2166136261UL ^ (unsigned long) font;
+  int i;
+  for(i=0; i<len; i++)
+    h = (h ^ (unsigned char) s[i]) * 16777619UL;
+  return h & 0xffffffffUL;
+}
+
+static void grtx_free(GrtxLayout *t)
+{
+  free(t->string);
+  free(t->kind);
+  free(t->a);
+  free(t->b);
+  free(t);
+}
+
+/*
+ * Empty the cache.
+ */
+static void grtx_clear(void)
+{
+  int i;
+  for(i=0; i<NBUCKET; i++) {
+    while(grtx.bucket[i]) {
+      GrtxLayout *t = grtx.bucket[i];
+      grtx.bucket[i] = t->next;
+      grtx_free(t);
+    };
+  };
+  grtx.nlayout = grtx.nentry = 0;
+  grtx.current = NULL;
+}
+
+/*
+ * X**N for integer N >= 0, evaluated as for REAL**INTEGER in FORTRAN.
+ */
+static float grtx_powi(float x, int n)
+{
+  float y = n % 2 ? x : 1.0f;
+  while(n >>= 1) {
+    x = x * x;
+    if(n % 2)
+      y = y * x;
+  };
+  return y;
+}
+
+/*
+ * Append an entry to t, whose arrays have room for max entries.
+ */
+static int grtx_add(GrtxLayout *t, int *max, int kind, float a, float b)
+{
+  if(t->n >= *max) {
+    int m = *max ? 2 * *max : 256;
+    signed char *k = (signed char *) realloc(t->kind, m);
+    float *pa, *pb;
+    if(k)
+      t->kind = k;
+    pa = k ? (float *) realloc(t->a, m * sizeof(float)) : NULL;
+    if(pa)
+      t->a = pa;
+    pb = pa ? (float *) realloc(t->b, m * sizeof(float)) : NULL;
+    if(!pb)
+      return 1;
+    t->b = pb;
+    *max = m;
+  };
+  t->kind[t->n] = (signed char) kind;
+  t->a[t->n] = a;
+  t->b[t->n] = b;
+  t->n++;
+  return 0;
+}
+
+/*
+ * Decode the string of t into its entries and bounding box.
+ */
+static int grtx_layout(GrtxLayout *t)
+{
+  int *list = (int *) malloc((t->len + 1) * sizeof(int));
+  int xygrid[300];
+  int nlist, i, max = 0, ifntlv = 0, err = 0;
+  float fntbas = 0.0f, fntfac = 1.0f;
+  float xg = 0.0f, dx = 0.0f;
+  if(!list)
+    return 1;
+  GRSYDS(list, &nlist, t->string, &t->font, t->len);
+  t->box[0] = t->box[2] = 1e30f;
+  t->box[1] = t->box[3] = -1e30f;
+  t->plot = 0;
+  for(i=0; i<nlist && !err; i++) {
+    int k, lx, ly, lxlast, lylast, visble, unused;
+    if(list[i] < 0) {
+      if(list[i] == -1) {
+	ifntlv++;
+	fntbas = fntbas + 16.0f * fntfac;
+	fntfac = grtx_powi(0.75f, abs(ifntlv));
+      } else if(list[i] == -2) {
+	ifntlv--;
+	fntfac = grtx_powi(0.75f, abs(ifntlv));
+	fntbas = fntbas - 16.0f * fntfac;
+      } else if(list[i] == -3) {
+	xg = xg - dx * fntfac;
+      };
+      err = grtx_add(t, &max, list[i], 0.0f, fntfac);
+      continue;
+    };
+    GRSYXD(&list[i], xygrid, &unused);
+    visble = 0;
+    lxlast = lylast = -64;
+    for(k=5; xygrid[k+1] != -64 && !err; k+=2) {
+      lx = xygrid[k];
+      ly = xygrid[k+1];
+      if(lx == -64) {
+	visble = 0;
+      } else {
+	float rlx = (lx - xygrid[3]) * fntfac;
+	float rly = (ly - xygrid[1]) * fntfac + fntbas;
+	if(lx != lxlast || ly != lylast) {
+	  err = grtx_add(t, &max, visble ? 2 : 1, rlx, rly);
+	  if(xg + rlx < t->box[0]) t->box[0] = xg + rlx;
+	  if(xg + rlx > t->box[1]) t->box[1] = xg + rlx;
+	  if(rly < t->box[2]) t->box[2] = rly;
+	  if(rly > t->box[3]) t->box[3] = rly;
+	  t->plot = 1;
+	};
+	visble = 1;
+	lxlast = lx;
+	lylast = ly;
+      };
+    };
+    dx = (float) (xygrid[4] - xygrid[3]);
+    err = err || grtx_add(t, &max, 0, dx, fntfac);
+    xg = xg + dx * fntfac;
+  };
+  free(list);
+  return err;
+}
+
+void GRTXC0(const char *string, int *font, float *box, int *plot, int *ier,
+	    int string_len)
+{
+  unsigned long hash = grtx_hash(string, string_len, *font);
+  GrtxLayout **bucket = &grtx.bucket[hash % NBUCKET];
+  GrtxLayout *t;
+  *ier = 1;
+  for(t = *bucket; t; t = t->next) {
+    if(t->hash == hash && t->font == *font && t->len == string_len &&
+       memcmp(t->string, string, string_len) == 0)
+      break;
+  };
+  if(!t) {
+    if(grtx.nlayout >= MAX_LAYOUTS || grtx.nentry >= MAX_ENTRIES)
+      grtx_clear();
+    t = (GrtxLayout *) calloc(1, sizeof(GrtxLayout));
+    if(!t)
+      return;
+    t->hash = hash;
+    t->font = *font;
+    t->len = string_len;
+    t->string = (char *) malloc(string_len + 1);
+    if(!t->string) {
+      grtx_free(t);
+      return;
+    };
+    memcpy(t->string, string, string_len);
+    if(grtx_layout(t)) {
+      grtx_free(t);
+      return;
+    };
+    t->next = *bucket;
+    *bucket = t;
+    grtx.nlayout++;
+    grtx.nentry += t->n;
+  };
+  grtx.current = t;
+  memcpy(box, t->box, sizeof(t->box));
+  *plot = t->plot;
+  *ier = 0;
+}
+
+void GRTXC1(int *k, int *nmax, int *kind, float *a, float *b, int *n)
+{
+  GrtxLayout *t = grtx.current;
+  int i;
+  *n = 0;
+  if(!t || *k < 0)
+    return;
+  for(i=*k; i<t->n && *n<*nmax; i++, (*n)++) {
+    kind[*n] = t->kind[i];
+    a[*n] = t->a[i];
+    b[*n] = t->b[i];
+  };
+}
@@ -0,0 +1,26 @@
+C*GRSYIM -- map the font image (stub)
+C+
+      INTEGER FUNCTION GRSYIM (SRC, IMG)
+      CHARACTER*(*) SRC, IMG
+C
+C The font image described in sys/grsyim.c is not supported on this
+C system. GRSYIM always reports that there is no image, so GRSY00
+C reads the font file; GRSYIG always reports that no image is mapped,
+C so GRSYXD decodes each symbol from /GRSYMB/.
+C--
+C 18-Oct-2026 - new routine.
+C-----------------------------------------------------------------------
+      GRSYIM = 0
+      END
+
+C*GRSYIG -- get a symbol from the font image (stub)
+C+
+      INTEGER FUNCTION GRSYIG (SYMBOL, XYGRID)
+      INTEGER SYMBOL, XYGRID(*)
+C
+C See GRSYIM.
+C--
+C 18-Oct-2026 - new routine.
+C-----------------------------------------------------------------------
+      GRSYIG = -1
+      END
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <png.h>
+
+/* ---------------------------------------------------------------------
+ * Compare the pixels of two PNG files, which may be encoded
+ * differently. Exits with status 0 if the images have the same size
+ * and the same pixels, and 1 otherwise.
+ * Usage:
+ *	pngcmp file1.png file2.png
+ *----------------------------------------------------------------------
+ */
+
+static png_bytep read_png(const char *name, png_image *image)
+{
+  png_bytep buffer;
+
+  memset(image, 0, sizeof(*image));
+  image->version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_file(image, name)) {
+    fprintf(stderr, "pngcmp: %s: %s\n", name, image->message);
+    return NULL;
+  }
+  image->format = PNG_FORMAT_RGBA;
+  buffer = malloc(PNG_IMAGE_SIZE(*image));
+  if (!buffer) {
+    fprintf(stderr, "pngcmp: out of memory\n");
+    png_image_free(image);
+    return NULL;
+  }
+  if (!png_image_finish_read(image, NULL, buffer, 0, NULL)) {
+    fprintf(stderr, "pngcmp: %s: %s\n", name, image->message);
+    free(buffer);
+    return NULL;
+  }
+  return buffer;
+}
+
+int main(int argc, char *argv[])
+{
+  png_image a, b;
+  png_bytep pa, pb;
+  png_uint_32 row, stride;
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: pngcmp file1.png file2.png\n");
+    return EXIT_FAILURE;
+  }
+  if (!(pa = read_png(argv[1], &a)) || !(pb = read_png(argv[2], &b)))
+    return EXIT_FAILURE;
+  if (a.width != b.width || a.height != b.height) {
+    printf("%s: %lux%lu, %s: %lux%lu\n", argv[1], (unsigned long) a.width,
+	   (unsigned long) a.height, argv[2], (unsigned long) b.width,
+	   (unsigned long) b.height);
+    return EXIT_FAILURE;
+  }
+  stride = PNG_IMAGE_ROW_STRIDE(a);
+  for (row=0; row<a.height; row++) {
+    if (memcmp(pa + row*stride, pb + row*stride, stride)) {
+      printf("%s and %s differ in row %lu\n", argv[1], argv[2],
+	     (unsigned long) row);
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+#include "cpgplot.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+/* ---------------------------------------------------------------------
+ * Test of the clipping of filled polygons (PGPOLY, GRPOCS). Each test
+ * polygon, of up to 200000 vertices and partly outside the window, is
+ * filled with PGPOLY in the PNG file named by the first argument, and
+ * in the file named by the second argument it is clipped by calling
+ * GRPOCL for each edge of the window in turn, as PGPOLY used to, and
+ * the result is filled with PGPOLY. "runtests" compares the pages with
+ * pngcmp. The time taken by both is reported.
+ * Usage:
+ *	tclip new.png old.png
+ *----------------------------------------------------------------------
+ */
+
+#ifdef PG_PPU
+#define GRPOCL grpocl_
+#else
+#define GRPOCL grpocl
+#endif
+
+void GRPOCL(int *n, float *px, float *py, int *edge, float *val,
+	    int *maxout, int *nout, float *qx, float *qy);
+
+#define MAXVRT 200000
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+/*
+ * Clip a polygon to the window 0...1 with GRPOCL and fill the result,
+ * as PGPOLY did before GRPOCS.
+ */
+static void poly_old(int n, float *px, float *py)
+{
+  static float qx[4*MAXVRT], qy[4*MAXVRT], rx[4*MAXVRT], ry[4*MAXVRT];
+  float val[4] = {0.0, 1.0, 0.0, 1.0};
+  int maxout = 4*MAXVRT;
+  int edge, nout;
+
+  for (edge=1; edge<=4; edge++) {
+    GRPOCL(&n, px, py, &edge, &val[edge-1], &maxout, &nout, qx, qy);
+    if (nout > maxout) {
+      printf("GRPOCL: too many vertices\n");
+      exit(EXIT_FAILURE);
+    }
+    if (edge < 4 && nout < 3)
+      return;
+    n = nout;
+    px = rx;
+    py = ry;
+    for (nout=0; nout<n; nout++) {
+      rx[nout] = qx[nout];
+      ry[nout] = qy[nout];
+    }
+  }
+  if (n >= 3)
+    cpgpoly(n, px, py);
+}
+
+/*
+ * Draw a polygon on a new page of devices id1 (with PGPOLY) and id2
+ * (clipped with GRPOCL).
+ */
+static void test(const char *name, int n, float *px, float *py,
+		 int id1, int id2)
+{
+  double t0, t[2];
+  int k;
+
+  for (k=0; k<2; k++) {
+    cpgslct(k ? id2 : id1);
+    cpgpage();
+    cpgsvp(0.1, 0.9, 0.1, 0.9);
+    cpgswin(0.0, 1.0, 0.0, 1.0);
+    cpgsci(2);
+    cpgsfs(1);
+    cpgbbuf();
+    t0 = now();
+    if (k == 0)
+      cpgpoly(n, px, py);
+    else
+      poly_old(n, px, py);
+    cpgebuf();
+    t[k] = now() - t0;
+    cpgsci(1);
+    cpgbox("BC", 0.0, 0, "BC", 0.0, 0);
+  }
+  printf("%-7s %6d vertices: clipped with GRPOCS %7.1f ms,"
+	 " with GRPOCL %7.1f ms\n", name, n, 1e3*t[0], 1e3*t[1]);
+}
+
+int main(int argc, char *argv[])
+{
+  static float px[MAXVRT], py[MAXVRT];
+  char device[300];
+  double a, r;
+  int id1, id2, i, n;
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: tclip new.png old.png\n");
+    return EXIT_FAILURE;
+  }
+  sprintf(device, "%.280s/PNG", argv[1]);
+  id1 = cpgopen(device);
+  sprintf(device, "%.280s/PNG", argv[2]);
+  id2 = cpgopen(device);
+  if (id1 <= 0 || id2 <= 0)
+    return EXIT_FAILURE;
+  cpgask(0);
+  cpgslct(id1);
+  cpgask(0);
+
+  /* a star of 20001 points, larger than the window */
+  n = 20001;
+  for (i=0; i<n; i++) {
+    a = 2.0 * M_PI * ((10000.0 * i) / n);
+    px[i] = 0.5 + 0.8 * cos(a);
+    py[i] = 0.4 + 0.8 * sin(a);
+  }
+  test("star", n, px, py, id1, id2);
+
+  /* random vertices, a quarter of them outside the window */
+  srand(1);
+  n = 12000;
+  for (i=0; i<n; i++) {
+    px[i] = 1.3 * rand() / RAND_MAX - 0.1;
+    py[i] = 1.3 * rand() / RAND_MAX - 0.1;
+  }
+  test("random", n, px, py, id1, id2);
+
+  /* a spiral of 200000 vertices that leaves and reenters the window */
+  n = MAXVRT;
+  for (i=0; i<n; i++) {
+    a = 60.0 * M_PI * i / n;
+    r = 0.05 + 0.7 * i / n + 0.02 * sin(37.0 * a);
+    px[i] = 0.45 + r * cos(a);
+    py[i] = 0.55 + r * sin(a);
+  }
+  test("spiral", n, px, py, id1, id2);
+
+  /* a square with one corner outside */
+  px[0] = 0.2; py[0] = 0.2;
+  px[1] = 1.5; py[1] = 0.3;
+  px[2] = 0.7; py[2] = 0.8;
+  px[3] = 0.1; py[3] = 0.7;
+  test("corner", 4, px, py, id1, id2);
+
+  /* a triangle wholly outside */
+  px[0] = 1.2; py[0] = 0.2;
+  px[1] = 1.5; py[1] = 0.3;
+  px[2] = 1.3; py[2] = 0.8;
+  test("outside", 3, px, py, id1, id2);
+
+  cpgend();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,427 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+/* ---------------------------------------------------------------------
+ * Test of the contour-following engine of PGCONX (GRCNX0...GRCNX3 in
+ * sys/grconx.c). Each test array is large enough to be traced in
+ * several bands of rows. For each level:
+ *  1. the contours are traced with 1 thread and with 3 and 8 threads
+ *     (PGPLOT_CONTOUR_THREADS), which must give the same polylines;
+ *  2. each polyline must be closed or end on the edges of the array,
+ *     so that no contour is broken at the seams between bands;
+ *  3. the segments of the polylines are compared with those drawn by
+ *     PGCNSC on the panels of 100 by 100 that PGCONX used before.
+ * The time taken by the engine and by the panels is reported; the
+ * engine gains most where the contours cross few blocks of the array.
+ * Usage:
+ *	tcont
+ *----------------------------------------------------------------------
+ */
+
+#ifdef PG_PPU
+#define GRCNX0 grcnx0_
+#define GRCNX1 grcnx1_
+#define GRCNX2 grcnx2_
+#define GRCNX3 grcnx3_
+#define PGCNSC pgcnsc_
+#else
+#define GRCNX0 grcnx0
+#define GRCNX1 grcnx1
+#define GRCNX2 grcnx2
+#define GRCNX3 grcnx3
+#define PGCNSC pgcnsc
+#endif
+
+void GRCNX0(const float *a, int *idim, int *jdim, int *i1, int *i2,
+	    int *j1, int *j2, int *ier);
+void GRCNX1(float *z0, int *ier);
+void GRCNX2(float *x, float *y, int *nmax, int *n);
+void GRCNX3(void);
+void PGCNSC(const float *z, int *mx, int *my, int *ia, int *ib, int *ja,
+	    int *jb, float *z0, void (*plot)(int *, float *, float *,
+					     float *));
+
+#define MAXP 200          /* vertices fetched at a time, as in PGCONX */
+#define NLEVEL 3
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+/*
+ * A list of moves (k = 0) and draws (k = 1), as passed to the PLOT
+ * routine of PGCONX.
+ */
+typedef struct {
+  int n, m;
+  int *k;
+  float *x, *y, *z;
+} Path;
+
+static Path *rec;         /* where plot() records */
+
+static void path_init(Path *p)
+{
+  p->n = 0;
+  p->m = 4096;
+  p->k = malloc(p->m * sizeof(int));
+  p->x = malloc(p->m * sizeof(float));
+  p->y = malloc(p->m * sizeof(float));
+  p->z = malloc(p->m * sizeof(float));
+}
+
+static void path_free(Path *p)
+{
+  free(p->k);
+  free(p->x);
+  free(p->y);
+  free(p->z);
+}
+
+static void plot(int *visble, float *x, float *y, float *z)
+{
+  Path *p = rec;
+  if (p->n == p->m) {
+    p->m *= 2;
+    p->k = realloc(p->k, p->m * sizeof(int));
+    p->x = realloc(p->x, p->m * sizeof(float));
+    p->y = realloc(p->y, p->m * sizeof(float));
+    p->z = realloc(p->z, p->m * sizeof(float));
+  }
+  p->k[p->n] = *visble;
+  p->x[p->n] = *x;
+  p->y[p->n] = *y;
+  p->z[p->n++] = *z;
+}
+
+/*
+ * Trace the levels with the engine, as PGCONX does.
+ */
+static void trace_new(const float *a, int idim, int jdim, int i1, int i2,
+		      int j1, int j2, const float *c, Path *p)
+{
+  float xp[MAXP], yp[MAXP], z0;
+  int ier, l, k, n, visble, nmax = MAXP;
+
+  rec = p;
+  GRCNX0(a, &idim, &jdim, &i1, &i2, &j1, &j2, &ier);
+  for (l=0; l<NLEVEL && ier == 0; l++) {
+    z0 = c[l];
+    GRCNX1(&z0, &ier);
+    while (ier == 0) {
+      GRCNX2(xp, yp, &nmax, &n);
+      if (n == 0)
+	break;
+      for (k=0; k<abs(n); k++) {
+	visble = n < 0 || k > 0;
+	plot(&visble, &xp[k], &yp[k], &z0);
+      }
+    }
+  }
+  GRCNX3();
+  if (ier != 0) {
+    printf("GRCNX0 or GRCNX1 failed\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/*
+ * Trace the levels with PGCNSC in panels, as PGCONX did before the
+ * engine.
+ */
+static void trace_old(const float *a, int idim, int jdim, int i1, int i2,
+		      int j1, int j2, const float *c, Path *p)
+{
+  float z0;
+  int nnx = i2-i1+1, nny = j2-j1+1, kx, ky, px, py, ki, kj, ia, ib, ja, jb;
+  int l;
+
+  rec = p;
+  kx = (nnx + 97) / 99;
+  ky = (nny + 97) / 99;
+  px = (nnx + kx - 1) / kx;
+  py = (nny + ky - 1) / ky;
+  for (l=0; l<NLEVEL; l++) {
+    z0 = c[l];
+    for (ki=0; ki<kx; ki++) {
+      ia = i1 + ki*px;
+      ib = ia + px < i2 ? ia + px : i2;
+      for (kj=0; kj<ky; kj++) {
+	ja = j1 + kj*py;
+	jb = ja + py < j2 ? ja + py : j2;
+	PGCNSC(a, &idim, &jdim, &ia, &ib, &ja, &jb, &z0, plot);
+      }
+    }
+  }
+}
+
+/* Count the polylines of a path. */
+static int pieces(const Path *p)
+{
+  int i, n = 0;
+  for (i=0; i<p->n; i++)
+    n += p->k[i] == 0;
+  return n;
+}
+
+/*
+ * Check that every polyline is closed or ends on the edges. Return 1 if
+ * one does not.
+ */
+static int on_edge(float x, float y, int i1, int i2, int j1, int j2)
+{
+  return x == i1 || x == i2 || y == j1 || y == j2;
+}
+
+static int check_ends(const Path *p, int i1, int i2, int j1, int j2)
+{
+  int i, k;
+
+  for (i=0; i<p->n; i=k) {
+    for (k=i+1; k<p->n && p->k[k]; k++)
+      ;
+    if (k-i > 1 && p->x[i] == p->x[k-1] && p->y[i] == p->y[k-1])
+      continue;
+    if (!on_edge(p->x[i], p->y[i], i1, i2, j1, j2) ||
+	!on_edge(p->x[k-1], p->y[k-1], i1, i2, j1, j2)) {
+      printf("contour of %d points from (%g,%g) to (%g,%g) ends inside"
+	     " the array\n", k-i, p->x[i], p->y[i], p->x[k-1], p->y[k-1]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int scmp(const void *p, const void *q)
+{
+  const float *a = p, *b = q;
+  int i;
+  for (i=0; i<5; i++)
+    if (a[i] != b[i])
+      return a[i] < b[i] ? -1 : 1;
+  return 0;
+}
+
+static int pcmp(const void *p, const void *q)
+{
+  const float *a = p, *b = q;
+  int i;
+  for (i=0; i<3; i++)
+    if (a[i] != b[i])
+      return a[i] < b[i] ? -1 : 1;
+  return 0;
+}
+
+/*
+ * Whether level z crosses the line between grid values p1 and p2, as in
+ * PGCNSC.
+ */
+static int crosses(float z, float p1, float p2)
+{
+  return p1 != p2 && z > (p1 < p2 ? p1 : p2) && z <= (p1 > p2 ? p1 : p2);
+}
+
+/*
+ * Whether a segment lies in a cell that its level crosses on all four
+ * sides. There PGCNSC could join the crossings the other way from the
+ * engine (see sys/grconx.c), so only the crossings are compared.
+ */
+static int in_saddle(const float *s, const float *a, int idim, int jdim)
+{
+  float z = s[0];
+  int i, j;
+
+#define A(i,j) a[(i)-1 + (size_t)((j)-1)*idim]
+  for (i=(int) s[1]-1; i<=(int) s[1]; i++) {
+    if (i < 1 || i >= idim || s[1] > i+1 || s[3] < i || s[3] > i+1)
+      continue;
+    for (j=(int) s[2]-1; j<=(int) s[2]; j++) {
+      if (j < 1 || j >= jdim || s[2] < j || s[2] > j+1 ||
+	  s[4] < j || s[4] > j+1)
+	continue;
+      if (crosses(z, A(i,j), A(i+1,j)) &&
+	  crosses(z, A(i+1,j), A(i+1,j+1)) &&
+	  crosses(z, A(i,j+1), A(i+1,j+1)) &&
+	  crosses(z, A(i,j), A(i,j+1)))
+	return 1;
+    }
+  }
+#undef A
+  return 0;
+}
+
+/*
+ * The segments of a path that are not in saddle cells, each as its
+ * level and then its ends, lower end first, sorted; and the ends of the
+ * segments that are, each as its level and position, sorted.
+ */
+static float *segments(const Path *p, const float *a, int idim, int jdim,
+		       int *nseg, float **ends, int *nend)
+{
+  float *s = malloc((p->n + 1) * 5 * sizeof(float));
+  float *e = malloc((p->n + 1) * 6 * sizeof(float));
+  int i, n = 0, m = 0, lo;
+
+  for (i=1; i<p->n; i++) {
+    if (!p->k[i])
+      continue;
+    lo = p->x[i-1] < p->x[i] ||
+      (p->x[i-1] == p->x[i] && p->y[i-1] <= p->y[i]) ? i-1 : i;
+    s[5*n] = p->z[i];
+    s[5*n+1] = p->x[lo]; s[5*n+2] = p->y[lo];
+    s[5*n+3] = p->x[2*i-1-lo]; s[5*n+4] = p->y[2*i-1-lo];
+    if (in_saddle(s + 5*n, a, idim, jdim)) {
+      e[3*m] = p->z[i]; e[3*m+1] = p->x[i-1]; e[3*m+2] = p->y[i-1];
+      m++;
+      e[3*m] = p->z[i]; e[3*m+1] = p->x[i]; e[3*m+2] = p->y[i];
+      m++;
+    } else {
+      n++;
+    }
+  }
+  qsort(s, n, 5 * sizeof(float), scmp);
+  qsort(e, m, 3 * sizeof(float), pcmp);
+  *nseg = n;
+  *ends = e;
+  *nend = m;
+  return s;
+}
+
+/*
+ * Contour A(i1:i2,j1:j2) all ways and compare. Return 1 if they differ.
+ */
+static int test(const char *name, const float *a, int idim, int jdim,
+		int i1, int i2, int j1, int j2, const float *c)
+{
+  static const char *threads[] = {"3", "8"};
+  Path pnew, pthr, pold;
+  float *snew, *sold, *enew, *eold;
+  double t0, t1, t2;
+  int nsnew, nsold, nenew, neold, i, bad = 0;
+
+  path_init(&pnew);
+  path_init(&pold);
+  setenv("PGPLOT_CONTOUR_THREADS", "1", 1);
+  t0 = now();
+  trace_new(a, idim, jdim, i1, i2, j1, j2, c, &pnew);
+  t1 = now();
+  trace_old(a, idim, jdim, i1, i2, j1, j2, c, &pold);
+  t2 = now();
+
+  /* 1. the same with more threads */
+  for (i=0; i<2; i++) {
+    path_init(&pthr);
+    setenv("PGPLOT_CONTOUR_THREADS", threads[i], 1);
+    trace_new(a, idim, jdim, i1, i2, j1, j2, c, &pthr);
+    if (pthr.n != pnew.n ||
+	memcmp(pthr.k, pnew.k, pnew.n * sizeof(int)) ||
+	memcmp(pthr.x, pnew.x, pnew.n * sizeof(float)) ||
+	memcmp(pthr.y, pnew.y, pnew.n * sizeof(float))) {
+      printf("%s: %s threads give different contours\n", name, threads[i]);
+      bad = 1;
+    }
+    path_free(&pthr);
+  }
+  unsetenv("PGPLOT_CONTOUR_THREADS");
+
+  /* 2. no contour ends at a seam */
+  bad |= check_ends(&pnew, i1, i2, j1, j2);
+
+  /* 3. the same segments as the panels, but in saddle cells only the
+     same crossings */
+  snew = segments(&pnew, a, idim, jdim, &nsnew, &enew, &nenew);
+  sold = segments(&pold, a, idim, jdim, &nsold, &eold, &neold);
+  if (nsnew != nsold || nenew != neold) {
+    printf("%s: %d segments and %d in saddles, expected %d and %d\n", name,
+	   nsnew, nenew/2, nsold, neold/2);
+    bad = 1;
+  } else {
+    for (i=0; i<nsnew; i++) {
+      if (scmp(snew + 5*i, sold + 5*i)) {
+	printf("%s: level %g segment (%g,%g)-(%g,%g), expected"
+	       " (%g,%g)-(%g,%g)\n", name, snew[5*i], snew[5*i+1],
+	       snew[5*i+2], snew[5*i+3], snew[5*i+4], sold[5*i+1],
+	       sold[5*i+2], sold[5*i+3], sold[5*i+4]);
+	bad = 1;
+	break;
+      }
+    }
+    for (i=0; i<nenew; i++) {
+      if (pcmp(enew + 3*i, eold + 3*i)) {
+	printf("%s: level %g crossing (%g,%g) in a saddle, expected"
+	       " (%g,%g)\n", name, enew[3*i], enew[3*i+1], enew[3*i+2],
+	       eold[3*i+1], eold[3*i+2]);
+	bad = 1;
+	break;
+      }
+    }
+  }
+  printf("%-6s %4dx%-4d %7d segments (%5d in saddles) in %6d contours:"
+	 " %6.1f ms, in %6d pieces by panels: %6.1f ms\n", name, i2-i1+1,
+	 j2-j1+1, nsnew + nenew/2, nenew/2, pieces(&pnew), 1e3*(t1-t0),
+	 pieces(&pold), 1e3*(t2-t1));
+  free(snew);
+  free(sold);
+  free(enew);
+  free(eold);
+  path_free(&pnew);
+  path_free(&pold);
+  return bad;
+}
+
+int main(void)
+{
+  static const float wave[NLEVEL] = {0.0, 0.3, -0.6};
+  static const float step[NLEVEL] = {1.0, 1.5, 2.0};
+  float *a;
+  int i, j, ni, nj, failed = 0;
+
+  a = malloc(3000 * 800 * sizeof(float));
+
+  /* waves, 3000 by 800: 10 bands of 79 rows and 30 by 9 panels */
+  ni = 3000;
+  nj = 800;
+  for (j=0; j<nj; j++)
+    for (i=0; i<ni; i++)
+      a[i + j*ni] = sin((i+1)*0.05) * cos((j+1)*0.07)
+	+ 0.3 * sin((i+1)*0.31 + (j+1)*0.17);
+  failed |= test("waves", a, ni, nj, 1, ni, 1, nj, wave);
+
+  /* the same, contouring only part of the array */
+  failed |= test("part", a, ni, nj, 7, 2900, 3, 700, wave);
+
+  /* long closed contours across many bands and panels, with noise */
+  srand(1);
+  ni = 300;
+  nj = 8000;
+  for (j=0; j<nj; j++)
+    for (i=0; i<ni; i++)
+      a[i + j*ni] = sin((i+1)*0.01) * cos((j+1)*0.0013)
+	+ 0.05 * rand() / RAND_MAX;
+  failed |= test("long", a, ni, nj, 1, ni, 1, nj, wave);
+
+  /* a few smooth contours, 1500 by 1500: most blocks are not crossed */
+  ni = 1500;
+  nj = 1500;
+  for (j=0; j<nj; j++)
+    for (i=0; i<ni; i++)
+      a[i + j*ni] = sin((i+1)*0.003) * cos((j+1)*0.0025);
+  failed |= test("smooth", a, ni, nj, 1, ni, 1, nj, wave);
+
+  /* random plateaus: equal values and many saddles */
+  ni = 2000;
+  nj = 1000;
+  for (j=0; j<nj; j++)
+    for (i=0; i<ni; i++)
+      a[i + j*ni] = (float) (rand() % 4);
+  failed |= test("steps", a, ni, nj, 1, ni, 1, nj, step);
+
+  free(a);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+#include "cpgplot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+/* ---------------------------------------------------------------------
+ * Test of the plotting contexts of the C binding. NTHREAD threads each
+ * open a PNG file in a context of their own and draw NPAGE pages into
+ * it, all at the same time. The same pages are then drawn one file at a
+ * time, without contexts. "runtests" compares the two sets of files
+ * with pngcmp. The program also checks that a context with no device
+ * does not draw on the device of another context.
+ * Usage:
+ *	tctx
+ *----------------------------------------------------------------------
+ */
+
+#define NTHREAD 8
+#define NPAGE 4
+
+static int failed = 0;
+
+static void draw(int k)
+{
+  int i, page;
+  float x[200], y[200];
+
+  for (page=0; page<NPAGE; page++) {
+    cpgenv(0.0, 1.0, 0.0, 1.0, 0, 1);
+    for (i=0; i<200; i++) {
+      x[i] = 0.5 + 0.45*sin(0.031*i*(k+1) + page);
+      y[i] = 0.5 + 0.45*cos(0.047*i*(page+1) + k);
+    }
+    cpgsci(1 + (k+page)%15);
+    cpgline(200, x, y);
+    cpgpt(200, x, y, 2 + k);
+    cpgmtxt("T", 1.0, 0.5, 0.5, "plotting context test");
+  }
+}
+
+static void *thread(void *arg)
+{
+  int k = *(int *) arg;
+  char device[40];
+  int id, qid;
+  PGcontext *ctx = cpgnctx();
+
+  cpgsctx(ctx);
+  sprintf(device, "tctx_t%d.png/PNG", k);
+  id = cpgopen(device);
+  if (id <= 0) {
+    failed = 1;
+    return NULL;
+  }
+  cpgask(0);
+  draw(k);
+  cpgqid(&qid);
+  if (qid != id) {
+    printf("thread %d: device %d selected, expected %d\n", k, qid, id);
+    failed = 1;
+  }
+  cpgclos();
+  cpgsctx(NULL);
+  cpgdctx(ctx);
+  return NULL;
+}
+
+int main()
+{
+  pthread_t threads[NTHREAD];
+  int k, ks[NTHREAD], id, qid;
+  char device[40];
+  PGcontext *ctx;
+
+  for (k=0; k<NTHREAD; k++) {
+    ks[k] = k;
+    if (pthread_create(&threads[k], NULL, thread, &ks[k]) != 0) {
+      printf("cannot create thread %d\n", k);
+      return EXIT_FAILURE;
+    }
+  }
+  for (k=0; k<NTHREAD; k++)
+    pthread_join(threads[k], NULL);
+
+  for (k=0; k<NTHREAD; k++) {
+    sprintf(device, "tctx_s%d.png/PNG", k);
+    if (cpgopen(device) <= 0)
+      return EXIT_FAILURE;
+    cpgask(0);
+    draw(k);
+    cpgclos();
+  }
+
+  /* a new context has no device, even while another device is open */
+  id = cpgopen("/NULL");
+  ctx = cpgnctx();
+  cpgsctx(ctx);
+  cpgqid(&qid);
+  if (qid != 0) {
+    printf("new context: device %d selected, expected none\n", qid);
+    failed = 1;
+  }
+  cpgsctx(NULL);
+  cpgdctx(ctx);
+  cpgslct(id);
+  cpgclos();
+
+  printf("%d threads drew %d pages each in their own contexts\n",
+	 NTHREAD, NPAGE);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
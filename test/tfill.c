@@ -0,0 +1,274 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+/* ---------------------------------------------------------------------
+ * Test of the polygon scan converter used by GRFA and PGHTCH (GRFAS0,
+ * GRFAS1 in sys/grfas.c). For each test polygon the spans returned by
+ * GRFAS1 are compared with those found by the method that GRFA used
+ * before: on every scan line, intersect every edge with the line and
+ * sort the intersections (but without GRFA's limit of 32). The
+ * polygons include self-intersecting stars with more than 32 crossings
+ * per line and a circle of 200000 vertices. The time taken by both
+ * methods is reported.
+ * Usage:
+ *	tfill
+ *----------------------------------------------------------------------
+ */
+
+#ifdef PG_PPU
+#define GRFAS0 grfas0_
+#define GRFAS1 grfas1_
+#else
+#define GRFAS0 grfas0
+#define GRFAS1 grfas1
+#endif
+
+void GRFAS0(int *n, const float *px, const float *py, const float *tr,
+	    float *d, int *l1, int *l2, int *ier);
+void GRFAS1(int *l, float *u, int *nmax, int *n);
+
+#define MAXSEC 32         /* spans fetched at a time, as in GRFA */
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+/*
+ * The spans of a polygon: for each line l1...l2, the index in u[] of
+ * its first span end point and the number of end points.
+ */
+typedef struct {
+  int l1, l2;
+  int *first, *count;
+  float *u;
+  int nu, mu;
+} Spans;
+
+static void spans_init(Spans *s, int l1, int l2)
+{
+  s->l1 = l1;
+  s->l2 = l2;
+  s->first = calloc(l2 - l1 + 1, sizeof(int));
+  s->count = calloc(l2 - l1 + 1, sizeof(int));
+  s->nu = 0;
+  s->mu = 1024;
+  s->u = malloc(s->mu * sizeof(float));
+}
+
+static void spans_free(Spans *s)
+{
+  free(s->first);
+  free(s->count);
+  free(s->u);
+}
+
+static void spans_add(Spans *s, int l, const float *u, int n)
+{
+  if (s->count[l - s->l1] == 0)
+    s->first[l - s->l1] = s->nu;
+  while (s->nu + n > s->mu) {
+    s->mu *= 2;
+    s->u = realloc(s->u, s->mu * sizeof(float));
+  }
+  memcpy(s->u + s->nu, u, n * sizeof(float));
+  s->nu += n;
+  s->count[l - s->l1] += n;
+}
+
+static int fcmp(const void *p, const void *q)
+{
+  float a = *(const float *) p, b = *(const float *) q;
+  return a < b ? -1 : a > b;
+}
+
+/*
+ * The spans found by GRFAS0/GRFAS1.
+ */
+static void scan_new(int n, const float *px, const float *py,
+		     const float *tr, float d, Spans *s)
+{
+  float u[MAXSEC];
+  int l, m, ier, nmax = MAXSEC;
+
+  GRFAS0(&n, px, py, tr, &d, &s->l1, &s->l2, &ier);
+  if (ier != 0) {
+    printf("GRFAS0 failed\n");
+    exit(EXIT_FAILURE);
+  }
+  for (;;) {
+    GRFAS1(&l, u, &nmax, &m);
+    if (m == 0)
+      break;
+    spans_add(s, l, u, m);
+  }
+}
+
+/*
+ * The spans found by intersecting every edge with every line, as GRFA
+ * did before GRFAS0 (in the same single-precision arithmetic). Spans
+ * that touch are merged and alternate lines are reversed, as GRFAS1
+ * does.
+ */
+static void scan_old(int n, const float *px, const float *py,
+		     const float *tr, float d, Spans *s)
+{
+  float *x = malloc((n + 1) * sizeof(float));
+  float *u = malloc(n * sizeof(float));
+  float *v = malloc(n * sizeof(float));
+  float y, s1, t1, s2, t2;
+  int i, k, line, nsect, nspan;
+
+  for (i=0; i<n; i++) {
+    u[i] = tr[0] + tr[1]*px[i] + tr[2]*py[i];
+    v[i] = tr[3] + tr[4]*px[i] + tr[5]*py[i];
+  }
+  for (line=s->l1; line<=s->l2; line++) {
+    y = (float) line * d;
+    nsect = 0;
+    s1 = u[n-1];
+    t1 = v[n-1];
+    for (i=0; i<n; i++) {
+      s2 = u[i];
+      t2 = v[i];
+      if ((t1 < y && y <= t2) || (t1 >= y && y > t2))
+	x[nsect++] = s1 + (s2 - s1) * ((y - t1) / (t2 - t1));
+      s1 = s2;
+      t1 = t2;
+    }
+    qsort(x, nsect, sizeof(float), fcmp);
+    nspan = 0;
+    for (i=0; i+1<nsect; i+=2) {
+      if (nspan > 0 && x[nspan-1] == x[i]) {
+	x[nspan-1] = x[i+1];
+      } else {
+	x[nspan++] = x[i];
+	x[nspan++] = x[i+1];
+      }
+    }
+    if ((line - s->l1) % 2) {
+      for (i=0, k=nspan-1; i<k; i++, k--) {
+	float t = x[i];
+	x[i] = x[k];
+	x[k] = t;
+      }
+    }
+    if (nspan > 0)
+      spans_add(s, line, x, nspan);
+  }
+  free(x);
+  free(u);
+  free(v);
+}
+
+/*
+ * Scan a polygon both ways and compare. Return 1 if they differ.
+ */
+static int test(const char *name, int n, const float *px, const float *py,
+		const float *tr, float d, int l1, int l2)
+{
+  Spans snew, sold;
+  double t0, t1, t2;
+  int l, i, most = 0, bad = 0;
+
+  spans_init(&snew, l1, l2);
+  spans_init(&sold, l1, l2);
+  t0 = now();
+  scan_new(n, px, py, tr, d, &snew);
+  t1 = now();
+  scan_old(n, px, py, tr, d, &sold);
+  t2 = now();
+  for (l=l1; l<=l2 && !bad; l++) {
+    int k = l - l1;
+    if (snew.count[k] != sold.count[k]) {
+      printf("%s: line %d has %d span ends, expected %d\n", name, l,
+	     snew.count[k], sold.count[k]);
+      bad = 1;
+      break;
+    }
+    if (sold.count[k] > most)
+      most = sold.count[k];
+    for (i=0; i<sold.count[k]; i++) {
+      if (snew.u[snew.first[k] + i] != sold.u[sold.first[k] + i]) {
+	printf("%s: line %d span end %d is %g, expected %g\n", name, l, i,
+	       snew.u[snew.first[k] + i], sold.u[sold.first[k] + i]);
+	bad = 1;
+	break;
+      }
+    }
+  }
+  printf("%-9s %6d vertices %5d lines, up to %3d span ends per line:"
+	 " %8.2f ms, every edge on every line %8.2f ms\n", name, n,
+	 l2 - l1 + 1, most, 1e3*(t1-t0), 1e3*(t2-t1));
+  spans_free(&snew);
+  spans_free(&sold);
+  return bad;
+}
+
+int main(void)
+{
+  static const float ident[6] = {0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+  float tr[6];
+  float *px, *py;
+  double a, r, c, s;
+  int i, n, failed = 0;
+
+  px = malloc(200000 * sizeof(float));
+  py = malloc(200000 * sizeof(float));
+
+  /* a star of 101 points: about 100 crossings on most lines */
+  n = 101;
+  for (i=0; i<n; i++) {
+    a = 2.0 * M_PI * ((50 * i) % n) / n;
+    px[i] = 400.0 + 380.0 * cos(a);
+    py[i] = 400.0 + 380.0 * sin(a);
+  }
+  failed |= test("star", n, px, py, ident, 1.0, 20, 780);
+
+  /* the same star scanned with rotated lines at a fractional spacing,
+     as by PGHTCH */
+  a = 30.0 * M_PI / 180.0;
+  c = cos(a);
+  s = sin(a);
+  tr[0] = 0.0; tr[1] = c;  tr[2] = s;
+  tr[3] = 0.0; tr[4] = -s; tr[5] = c;
+  failed |= test("hatch", n, px, py, tr, 2.7, -150, 300);
+
+  /* random vertices: many short spans, crossings in every order */
+  srand(1);
+  n = 3000;
+  for (i=0; i<n; i++) {
+    px[i] = 1000.0 * rand() / RAND_MAX;
+    py[i] = 1000.0 * rand() / RAND_MAX;
+  }
+  failed |= test("random", n, px, py, ident, 1.0, 0, 1000);
+
+  /* a comb whose teeth touch: spans meet end to end and are merged */
+  n = 0;
+  for (i=0; i<200; i++) {
+    px[n] = 10.0 * i;        py[n++] = 0.0;
+    px[n] = 10.0 * i;        py[n++] = 500.0 + 3.0 * (i % 7);
+    px[n] = 10.0 * i + 10.0; py[n++] = 500.0 + 3.0 * (i % 7);
+    px[n] = 10.0 * i + 10.0; py[n++] = 0.0;
+  }
+  failed |= test("comb", n, px, py, ident, 1.0, 0, 520);
+
+  /* a circle of 200000 vertices, with vertices on the scan lines */
+  n = 200000;
+  for (i=0; i<n; i++) {
+    a = 2.0 * M_PI * i / n;
+    r = 400.0 + 0.5 * (i % 2);
+    px[i] = 500.0 + r * cos(a);
+    py[i] = floor(500.0 + r * sin(a) + 0.5);
+  }
+  failed |= test("circle", n, px, py, ident, 1.0, 90, 910);
+
+  free(px);
+  free(py);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
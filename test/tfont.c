@@ -0,0 +1,82 @@
+#include "cpgplot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+/* ---------------------------------------------------------------------
+ * Test of the font image (grfont.img, see sys/grsyim.c). Draws pages of
+ * text in all four fonts, with Greek letters, symbols and markers, to
+ * the PNG file named on the command line, and reports how long the
+ * first device took to open (which is when the font is loaded) and
+ * how long the text took to draw. "runtests" runs it once with the
+ * image and once with PGPLOT_FONT_IMAGE naming a file that does not
+ * exist, so that the font file is read and decoded instead, and
+ * compares the pages with pngcmp.
+ * Usage:
+ *	tfont file.png
+ *----------------------------------------------------------------------
+ */
+
+#define NPAGE 4
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static const char *text[] = {
+  "The quick brown fox jumps over the lazy dog 0123456789",
+  "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG !?#$%&*()",
+  "\\ga\\gb\\gg\\gd\\ge \\gW\\gS\\gP x\\u2\\d + y\\d0\\u \\(2248) \\(0732)",
+  "\\fiItalic\\fn normal \\frRoman\\fn \\fsScript\\fn \\(0850)\\(2281)",
+};
+#define NTEXT (int) (sizeof(text) / sizeof(text[0]))
+
+int main(int argc, char *argv[])
+{
+  char device[300];
+  double t0, t1, t2;
+  float x, y;
+  int page, font, i, k, n = 0;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: tfont file.png\n");
+    return EXIT_FAILURE;
+  }
+  sprintf(device, "%.280s/PNG", argv[1]);
+  t0 = now();
+  if (cpgopen(device) <= 0)
+    return EXIT_FAILURE;
+  t1 = now();
+  cpgask(0);
+  for (page=0; page<NPAGE; page++) {
+    cpgpage();
+    cpgsvp(0.0, 1.0, 0.0, 1.0);
+    cpgswin(0.0, 1.0, 0.0, 1.0);
+    cpgsch(0.6 + 0.2*page);
+    for (font=1; font<=4; font++) {
+      cpgscf(font);
+      for (i=0; i<NTEXT; i++) {
+        y = 0.95 - 0.06*(NTEXT*(font-1) + i);
+        cpgptxt(0.02, y, 0.0, 0.0, text[i]);
+        n++;
+      }
+    }
+    cpgscf(1);
+    for (k=0; k<32; k++) {
+      x = 0.03 + 0.03*k;
+      y = 0.03;
+      cpgpt1(x, y, k + 8*page);
+      cpgptxt(x, 0.06, 45.0, 0.0, "\\(0850)");
+      n++;
+    }
+  }
+  cpgclos();
+  t2 = now();
+  printf("font loaded and device opened in %.1f ms\n", 1e3*(t1-t0));
+  printf("%d strings drawn in %.1f ms\n", n, 1e3*(t2-t1));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+#include "cpgplot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+/* ---------------------------------------------------------------------
+ * Test of the binning of PGHIST (GRHIS0, GRHIS1 in sys/grhist.c).
+ * Counts NDATA values, some of them on bin boundaries and some outside
+ * the range, into several numbers of bins with 1, 2 and 8 threads
+ * (PGPLOT_HIST_THREADS), and compares the counts with those of the
+ * loop that PGHIST used before, reporting the time taken by both. Then
+ * draws histograms of more than 200 bins with PGHIST in the PNG file
+ * named by the first argument, and the same histograms with the old
+ * drawing loop of PGHIST in the file named by the second argument;
+ * "runtests" compares the pages with pngcmp.
+ * Usage:
+ *	thist new.png old.png
+ *----------------------------------------------------------------------
+ */
+
+#ifdef PG_PPU
+#define GRHIS0 grhis0_
+#define GRHIS1 grhis1_
+#else
+#define GRHIS0 grhis0
+#define GRHIS1 grhis1
+#endif
+
+void GRHIS0(int *n, const float *data, float *datmin, float *datmax,
+	    int *nbin, int *nummax, int *ier);
+void GRHIS1(int *ibin, int *m, int *num);
+
+#define NDATA 3000000
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+/*
+ * Count the values in each bin as PGHIST did before GRHIS0, in single
+ * precision; the bin number is truncated as by a Fortran assignment.
+ */
+static void count_old(int n, const float *data, float datmin, float datmax,
+		      int nbin, int *num)
+{
+  int i, ibin;
+
+  for (ibin=0; ibin<nbin; ibin++)
+    num[ibin] = 0;
+  for (i=0; i<n; i++) {
+    ibin = (int) ((data[i] - datmin) / (datmax - datmin) * (float) nbin
+		  + 1.0f);
+    if (ibin >= 1 && ibin <= nbin)
+      num[ibin-1]++;
+  }
+}
+
+/*
+ * Bin the data with GRHIS0 and the old loop, and compare the counts.
+ * Return 1 if they differ.
+ */
+static int test_bins(int n, const float *data, float datmin, float datmax,
+		     int nbin, const char *threads)
+{
+  int *num = malloc(nbin * sizeof(int));
+  int *ref = malloc(nbin * sizeof(int));
+  double t0, t1, t2;
+  int ibin, nummax, refmax, ier, bad = 0;
+
+  setenv("PGPLOT_HIST_THREADS", threads, 1);
+  t0 = now();
+  GRHIS0(&n, data, &datmin, &datmax, &nbin, &nummax, &ier);
+  t1 = now();
+  count_old(n, data, datmin, datmax, nbin, ref);
+  t2 = now();
+  if (ier != 0) {
+    printf("GRHIS0 failed\n");
+    exit(EXIT_FAILURE);
+  }
+  ibin = 1;
+  GRHIS1(&ibin, &nbin, num);
+  refmax = 0;
+  for (ibin=0; ibin<nbin; ibin++) {
+    if (ref[ibin] > refmax)
+      refmax = ref[ibin];
+    if (num[ibin] != ref[ibin] && !bad) {
+      printf("%d bins: bin %d has %d values, expected %d\n", nbin, ibin+1,
+	     num[ibin], ref[ibin]);
+      bad = 1;
+    }
+  }
+  if (nummax != refmax) {
+    printf("%d bins: largest count %d, expected %d\n", nbin, nummax, refmax);
+    bad = 1;
+  }
+  printf("%7d values, %7d bins, %s thread%s: GRHIS0 %6.1f ms,"
+	 " old loop %6.1f ms\n", n, nbin, threads, threads[1] ? "s" : " ",
+	 1e3*(t1-t0), 1e3*(t2-t1));
+  free(num);
+  free(ref);
+  return bad;
+}
+
+/*
+ * Draw a histogram with the old drawing loop of PGHIST, for PGFLAG 1
+ * (outline) or 3 (filled).
+ */
+static void hist_old(int n, const float *data, float datmin, float datmax,
+		     int nbin, int pgflag)
+{
+  int *num = malloc(nbin * sizeof(int));
+  float binsiz, cur, prev, xlo, xhi;
+  int ibin;
+
+  count_old(n, data, datmin, datmax, nbin, num);
+  binsiz = (datmax - datmin) / (float) nbin;
+  prev = 0.0;
+  xhi = datmin;
+  cpgbbuf();
+  if (pgflag / 2 == 0)
+    cpgmove(datmin, 0.0);
+  for (ibin=1; ibin<=nbin; ibin++) {
+    cur = num[ibin-1];
+    xlo = xhi;
+    xhi = datmin + (float) ibin * binsiz;
+    if (pgflag / 2 == 0) {
+      if (cur == 0.0) {
+	;
+      } else if (cur <= prev) {
+	cpgmove(xlo, cur);
+	cpgdraw(xhi, cur);
+      } else {
+	cpgmove(xlo, prev);
+	cpgdraw(xlo, cur);
+	cpgdraw(xhi, cur);
+      }
+      cpgdraw(xhi, 0.0);
+      prev = cur;
+    } else if (cur != 0.0) {
+      cpgrect(xlo, xhi, 0.0, cur);
+    }
+  }
+  cpgebuf();
+  free(num);
+}
+
+int main(int argc, char *argv[])
+{
+  static const int nbins[] = {7, 200, 201, 1000, 65536, 1000000};
+  static const char *threads[] = {"1", "2", "8"};
+  float *data;
+  char device[300];
+  int id1, id2, i, j, k, failed = 0;
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: thist new.png old.png\n");
+    return EXIT_FAILURE;
+  }
+
+  /* a sum of uniform deviates, with every 10th value on a bin boundary
+     of 200 bins between -1 and 1, and every 97th outside */
+  data = malloc(NDATA * sizeof(float));
+  srand(1);
+  for (i=0; i<NDATA; i++) {
+    if (i % 10 == 0)
+      data[i] = -1.0f + (rand() % 201) * (2.0f / 200.0f);
+    else if (i % 97 == 0)
+      data[i] = (rand() % 2) ? -1.5f : 1.0f + 1.0f / (1 + rand() % 1000);
+    else
+      data[i] = ((float) rand() / RAND_MAX + (float) rand() / RAND_MAX
+		 - 1.0f) * 0.999f;
+  }
+
+  for (i=0; i<(int) (sizeof(nbins) / sizeof(nbins[0])); i++)
+    for (j=0; j<3; j++)
+      failed |= test_bins(NDATA, data, -1.0, 1.0, nbins[i], threads[j]);
+  failed |= test_bins(1000, data, -1.0, 1.0, 200, "8");
+  failed |= test_bins(NDATA, data, -0.3, 0.7, 333, "8");
+  unsetenv("PGPLOT_HIST_THREADS");
+
+  /* histograms of 201 and 1000 bins, outlined and filled */
+  sprintf(device, "%.280s/PNG", argv[1]);
+  id1 = cpgopen(device);
+  sprintf(device, "%.280s/PNG", argv[2]);
+  id2 = cpgopen(device);
+  if (id1 <= 0 || id2 <= 0)
+    return EXIT_FAILURE;
+  cpgask(0);
+  cpgslct(id1);
+  cpgask(0);
+  for (i=0; i<4; i++) {
+    int nbin = i < 2 ? 201 : 1000;
+    int pgflag = i % 2 ? 3 : 1;
+    for (k=0; k<2; k++) {
+      cpgslct(k ? id2 : id1);
+      cpgenv(-1.0, 1.0, 0.0, 4.0 * NDATA / nbin, 0, 0);
+      cpgsfs(1);
+      cpgsci(2);
+      if (k == 0)
+	cpghist(NDATA, data, -1.0, 1.0, nbin, pgflag);
+      else
+	hist_old(NDATA, data, -1.0, 1.0, nbin, pgflag);
+      cpgsci(1);
+    }
+  }
+  cpgend();
+  free(data);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+#include "cpgplot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+/* ---------------------------------------------------------------------
+ * Test of graph markers (GRMKER). Draws three pages of markers to the
+ * PNG file named on the command line and reports the time taken by
+ * each:
+ *  1. NPT markers of NSYM symbols in several sizes, one PGPT call for
+ *     each symbol and size;
+ *  2. the same markers in a shuffled order, one PGPT1 call each, so
+ *     that the symbol or size changes at almost every call;
+ *  3. markers that cross the edge of the view surface, in thick lines
+ *     and several colours.
+ * "runtests" runs it once as it is, when PNDRIV draws the markers in
+ * batches (opcode 33), and once with PGPLOT_PNG_MARKERS=0, when GRMKER
+ * draws them stroke by stroke, and compares the pages with pngcmp. It
+ * also checks that pages 1 and 2 match.
+ * Usage:
+ *	tmark file.png
+ *----------------------------------------------------------------------
+ */
+
+#define NPT 20000
+#define NSIZE 3
+
+static const int symbol[] = {1, 2, 3, 4, 5, 6, 7, 8, 12, 17, 18, 28, 31,
+			     65, 850, 2281};
+#define NSYM (int) (sizeof(symbol) / sizeof(symbol[0]))
+static const float size[NSIZE] = {0.5, 1.0, 2.3};
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static void new_page(void)
+{
+  cpgpage();
+  cpgsvp(0.0, 1.0, 0.0, 1.0);
+  cpgswin(0.0, 1.0, 0.0, 1.0);
+  cpgsch(1.0);
+  cpgslw(1);
+  cpgsci(1);
+}
+
+int main(int argc, char *argv[])
+{
+  static float x[NPT], y[NPT];
+  static int order[NPT];
+  char device[300];
+  double t0;
+  float ex, ey;
+  int i, j, k, m, n;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: tmark file.png\n");
+    return EXIT_FAILURE;
+  }
+  sprintf(device, "%.280s/PNG", argv[1]);
+  if (cpgopen(device) <= 0)
+    return EXIT_FAILURE;
+  cpgask(0);
+
+  /* marker k has symbol k%NSYM and size (k/NSYM)%NSIZE */
+  srand(1);
+  for (k=0; k<NPT; k++) {
+    x[k] = 0.02 + 0.96 * rand() / RAND_MAX;
+    y[k] = 0.02 + 0.96 * rand() / RAND_MAX;
+    order[k] = k;
+  }
+
+  /* page 1: one call for each symbol and size */
+  new_page();
+  t0 = now();
+  cpgbbuf();
+  for (i=0; i<NSYM; i++) {
+    for (j=0; j<NSIZE; j++) {
+      static float xs[NPT], ys[NPT];
+      n = 0;
+      for (k=i+NSYM*j; k<NPT; k+=NSYM*NSIZE) {
+	xs[n] = x[k];
+	ys[n++] = y[k];
+      }
+      cpgsch(size[j]);
+      cpgpt(n, xs, ys, symbol[i]);
+    }
+  }
+  cpgebuf();
+  printf("%d markers, %d calls: %.1f ms\n", NPT, NSYM*NSIZE,
+	 1e3*(now()-t0));
+
+  /* page 2: one call for each marker, in a shuffled order */
+  for (k=NPT-1; k>0; k--) {
+    m = rand() % (k + 1);
+    i = order[k];
+    order[k] = order[m];
+    order[m] = i;
+  }
+  new_page();
+  t0 = now();
+  cpgbbuf();
+  for (i=0; i<NPT; i++) {
+    k = order[i];
+    cpgsch(size[(k/NSYM) % NSIZE]);
+    cpgpt1(x[k], y[k], symbol[k % NSYM]);
+  }
+  cpgebuf();
+  printf("%d markers, one call each: %.1f ms\n", NPT, 1e3*(now()-t0));
+
+  /* page 3: markers on the edges, in colour and thick lines */
+  new_page();
+  t0 = now();
+  cpgbbuf();
+  m = 0;
+  for (i=0; i<NSYM; i++) {
+    n = 0;
+    for (j=0; j<=40; j++) {
+      ex = j / 40.0;
+      ey = (j % 4) * 0.002;
+      x[n] = ex; y[n++] = ey;
+      x[n] = ex; y[n++] = 1.0 - ey;
+      x[n] = ey; y[n++] = ex;
+      x[n] = 1.0 - ey; y[n++] = ex;
+    }
+    cpgsci(2 + i % 13);
+    cpgslw(1 + i % 5);
+    cpgsch(size[i % NSIZE]);
+    cpgpt(n, x, y, symbol[i]);
+    cpgpt(n/4, x + i, y + i, symbol[NSYM-1-i]);
+    m += n + n/4;
+  }
+  cpgebuf();
+  printf("%d markers on the edges: %.1f ms\n", m, 1e3*(now()-t0));
+
+  cpgclos();
+  return EXIT_SUCCESS;
+}
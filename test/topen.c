@@ -0,0 +1,107 @@
+#include "cpgplot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+/* ---------------------------------------------------------------------
+ * Test of plot identifier allocation (GROPEN, GRCLOS). Opens /NULL
+ * devices until PGPLOT refuses, checks that NMAX were opened and that
+ * identifiers freed by closing are reused lowest first, then cycles
+ * through many more opens and closes, with no other device open and
+ * with all but one identifier in use, and reports the time taken.
+ * Usage:
+ *	topen
+ *----------------------------------------------------------------------
+ */
+
+#define NMAX 256          /* GRIMAX in grpckg1.inc */
+#define NCYCLE 20000
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static void close_id(int id)
+{
+  cpgslct(id);
+  cpgclos();
+}
+
+/* Open and close a device NCYCLE times; return the time taken. */
+static double cycle(int expect, int *failed)
+{
+  double t0 = now();
+  int i, id;
+
+  for (i=0; i<NCYCLE; i++) {
+    id = cpgopen("/NULL");
+    if (id != expect) {
+      printf("cycle %d: opened id %d, expected %d\n", i, id, expect);
+      *failed = 1;
+      break;
+    }
+    cpgclos();
+  }
+  return now() - t0;
+}
+
+int main(void)
+{
+  int failed = 0;
+  int n, id;
+  double t;
+
+  /* open devices until GROPEN refuses */
+  for (n=0; n<NMAX+4; n++) {
+    id = cpgopen("/NULL");
+    if (id <= 0)
+      break;
+    if (id != n+1) {
+      printf("device %d was given id %d\n", n+1, id);
+      failed = 1;
+    }
+  }
+  printf("opened %d devices at once\n", n);
+  if (n != NMAX)
+    failed = 1;
+
+  /* freed identifiers are reused, lowest first */
+  close_id(10);
+  close_id(3);
+  id = cpgopen("/NULL");
+  if (id != 3) {
+    printf("reopened id %d, expected 3\n", id);
+    failed = 1;
+  }
+  id = cpgopen("/NULL");
+  if (id != 10) {
+    printf("reopened id %d, expected 10\n", id);
+    failed = 1;
+  }
+
+  /* one identifier free, at the top */
+  close_id(NMAX);
+  t = cycle(NMAX, &failed);
+  printf("%d opens and closes with %d devices open: %.1f ms\n",
+         NCYCLE, NMAX-1, 1e3*t);
+
+  /* one identifier free, at the bottom */
+  cpgopen("/NULL");
+  close_id(1);
+  t = cycle(1, &failed);
+  printf("%d opens and closes with ids 2-%d in use: %.1f ms\n",
+         NCYCLE, NMAX, 1e3*t);
+
+  /* nothing open */
+  for (id=2; id<=NMAX; id++)
+    close_id(id);
+  t = cycle(1, &failed);
+  printf("%d opens and closes with no other device: %.1f ms\n",
+         NCYCLE, 1e3*t);
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#include "cpgplot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* ---------------------------------------------------------------------
+ * Test of the PNG driver: writes a few pages, of different sizes, to
+ * the file named on the command line. "runtests" runs it with several
+ * values of PGPLOT_PNG_THREADS and compares the pages with pngcmp.
+ * Usage:
+ *	tpng file.png
+ *----------------------------------------------------------------------
+ */
+
+static void page(int k)
+{
+  int i, j;
+  float x[100], y[100], img[64*64];
+  static float tr[] = {0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+
+  cpgenv(0.0, 64.0, 0.0, 64.0, 0, 0);
+  for (j=0; j<64; j++)
+    for (i=0; i<64; i++)
+      img[i+64*j] = sin(0.1*(i+1)*(k+1)) * cos(0.13*(j+1));
+  cpgimag(img, 64, 64, 1, 64, 1, 64, -1.0, 1.0, tr);
+  for (i=0; i<100; i++) {
+    x[i] = 32.0 + 30.0*cos(0.0628*i*(k+2));
+    y[i] = 32.0 + 30.0*sin(0.0628*i*3);
+  }
+  cpgsci(2 + k%12);
+  cpgsfs(1);
+  cpgpoly(100, x, y);
+  cpgsci(1);
+  cpgslw(3);
+  cpgline(100, x, y);
+  cpgslw(1);
+  cpglab("x", "y", "PNG encoder test");
+}
+
+int main(int argc, char *argv[])
+{
+  char device[300];
+  int k;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: tpng file.png\n");
+    return EXIT_FAILURE;
+  }
+  sprintf(device, "%.280s/PNG", argv[1]);
+  if (cpgopen(device) <= 0)
+    return EXIT_FAILURE;
+  cpgask(0);
+  /* the default size, then pages with few rows and with many */
+  for (k=0; k<4; k++)
+    page(k);
+  cpgpap(2.0, 0.02);
+  page(4);
+  cpgpap(4.0, 3.0);
+  page(5);
+  cpgpap(1.0, 0.5);
+  for (k=6; k<10; k++)
+    page(k);
+  cpgclos();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,277 @@
+#include "cpgplot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+/* ---------------------------------------------------------------------
+ * Test of the text layout cache (GRTXC0 in sys/grtxc.c), which GRTEXT,
+ * GRQTXT and GRLEN share:
+ *  1. draws pages of text with every escape sequence in four fonts to
+ *     the PNG file named by the first argument, when none of the
+ *     strings is in the cache, and the same pages to the file named by
+ *     the second argument, when all of them are; "runtests" compares
+ *     the pages with pngcmp;
+ *  2. checks the bounding box of each string, and of NRAND random
+ *     strings (more than the cache holds, so that it is emptied),
+ *     against the box found from GRSYDS and GRSYXD as GRQTXT did before
+ *     the cache, both when the string is first seen and when it is
+ *     found in the cache;
+ *  3. reports the time taken to draw the pages and to measure strings
+ *     with PGQTXT and PGLEN, with the cache and by decoding each string
+ *     as before.
+ * Usage:
+ *	ttext new.png cached.png
+ *----------------------------------------------------------------------
+ */
+
+#ifdef PG_PPU
+#define GRTXC0 grtxc0_
+#define GRSYDS grsyds_
+#define GRSYXD grsyxd_
+#else
+#define GRTXC0 grtxc0
+#define GRSYDS grsyds
+#define GRSYXD grsyxd
+#endif
+
+void GRTXC0(const char *string, int *font, float *box, int *plot, int *ier,
+	    int string_len);
+void GRSYDS(int *symbol, int *nsymbs, const char *text, int *font,
+	    int text_len);
+void GRSYXD(int *symbol, int *xygrid, int *unused);
+
+#define NRAND 5000
+#define MAXLEN 1000
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static const char *text[] = {
+  "The quick brown fox jumps over the lazy dog",
+  "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789",
+  "!\"#$%&'()*+,-./:;<=>?@[]^_`{|}~",
+  "\\ga\\gb\\gg\\gd\\ge\\gz\\gy\\gh\\gi\\gk\\gl\\gm\\gn\\gc\\go\\gp\\gr\\gs",
+  "\\gA\\gB\\gG\\gD\\gE\\gZ\\gY\\gH\\gI\\gK\\gL\\gM\\gN\\gC\\gO\\gP\\gR\\gS",
+  "\\fnNormal \\frRoman \\fiItalic \\fsScript \\fnagain",
+  "x\\u2\\d + y\\d0\\u = z\\u\\gl\\u2\\d\\d e\\u-\\d\\d\\u",
+  "10\\u-3\\d \\x 5\\.2 \\A \\\\ back\\bslash",
+  "A\\b_ O\\b/ \\(0850)\\(2281)\\(2248)\\(0732)\\(0742)",
+  "\\m1\\m2\\m3\\m4\\m5\\m12\\m17\\m31",
+  "\\u\\u\\uhigh\\d\\d\\d\\d\\d\\dlow\\u\\u\\u",
+  "",
+  "   ",
+  "\\b\\b\\bstart",
+  "end\\",
+  "\\m1",
+  "A\\(228",
+  "B\\g",
+  "C\\f",
+};
+#define NTEXT (int) (sizeof(text) / sizeof(text[0]))
+
+/* pieces of random strings */
+static const char *token[] = {
+  "a", "Q", "7", " ", "\\u", "\\d", "\\b", "\\ga", "\\gW", "\\fi", "\\fs",
+  "\\fr", "\\fn", "\\(2281)", "\\x", "\\.", "\\\\", "\\m8", "g", "|", "_",
+};
+#define NTOKEN (int) (sizeof(token) / sizeof(token[0]))
+
+/*
+ * The bounding box of a string in character units, and whether it has
+ * any visible strokes, found as GRQTXT did before GRTXC0.
+ */
+static int box_old(const char *string, int font, float box[4])
+{
+  static int list[MAXLEN];
+  int xygrid[300];
+  float fntbas = 0.0, fntfac = 1.0, dx = 0.0, xg = 0.0, rlx, rly;
+  int i, k, n, lx, ly, lxlast, lylast, ifntlv = 0, unused, plot = 0;
+
+  box[0] = 1e30;
+  box[1] = -1e30;
+  box[2] = 1e30;
+  box[3] = -1e30;
+  GRSYDS(list, &n, string, &font, (int) strlen(string));
+  for (i=0; i<n; i++) {
+    if (list[i] < 0) {
+      if (list[i] == -1) {
+	ifntlv++;
+	fntbas = fntbas + 16.0f*fntfac;
+	for (fntfac=1.0, k=0; k<abs(ifntlv); k++)
+	  fntfac *= 0.75f;
+      } else if (list[i] == -2) {
+	ifntlv--;
+	for (fntfac=1.0, k=0; k<abs(ifntlv); k++)
+	  fntfac *= 0.75f;
+	fntbas = fntbas - 16.0f*fntfac;
+      } else if (list[i] == -3) {
+	xg = xg - dx*fntfac;
+      }
+      continue;
+    }
+    GRSYXD(&list[i], xygrid, &unused);
+    dx = xygrid[4] - xygrid[3];
+    lxlast = -64;
+    lylast = -64;
+    for (k=5; ; k+=2) {
+      lx = xygrid[k];
+      ly = xygrid[k+1];
+      if (ly == -64)
+	break;
+      if (lx != -64) {
+	rlx = (lx - xygrid[3])*fntfac;
+	rly = (ly - xygrid[1])*fntfac + fntbas;
+	if (lx != lxlast || ly != lylast) {
+	  if (xg+rlx < box[0]) box[0] = xg+rlx;
+	  if (xg+rlx > box[1]) box[1] = xg+rlx;
+	  if (rly < box[2]) box[2] = rly;
+	  if (rly > box[3]) box[3] = rly;
+	  plot = 1;
+	}
+	lxlast = lx;
+	lylast = ly;
+      }
+    }
+    xg = xg + dx*fntfac;
+  }
+  return plot;
+}
+
+/*
+ * Compare the box of a string from GRTXC0 with box_old(). Return 1 if
+ * they differ.
+ */
+static int check(const char *string, int font)
+{
+  float box[4], ref[4];
+  int plot, ier, refplot, i;
+
+  GRTXC0(string, &font, box, &plot, &ier, (int) strlen(string));
+  refplot = box_old(string, font, ref);
+  if (ier != 0) {
+    printf("GRTXC0 failed\n");
+    exit(EXIT_FAILURE);
+  }
+  if (plot != refplot) {
+    printf("font %d \"%s\": plot %d, expected %d\n", font, string, plot,
+	   refplot);
+    return 1;
+  }
+  for (i=0; plot && i<4; i++) {
+    if (box[i] != ref[i]) {
+      printf("font %d \"%s\": box %g %g %g %g, expected %g %g %g %g\n",
+	     font, string, box[0], box[1], box[2], box[3],
+	     ref[0], ref[1], ref[2], ref[3]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Draw every string in every font, one page for each font. */
+static double draw(int id)
+{
+  double t0;
+  int font, i;
+
+  cpgslct(id);
+  t0 = now();
+  for (font=1; font<=4; font++) {
+    cpgpage();
+    cpgsvp(0.0, 1.0, 0.0, 1.0);
+    cpgswin(0.0, 1.0, 0.0, 1.0);
+    cpgscf(font);
+    cpgsch(1.2);
+    cpgbbuf();
+    for (i=0; i<NTEXT; i++) {
+      cpgptxt(0.05, 0.97 - 0.05*i, 0.0, 0.0, text[i]);
+      cpgptxt(0.95, 0.97 - 0.05*i, 3.0*i, 1.0, text[i]);
+    }
+    cpgebuf();
+  }
+  return now() - t0;
+}
+
+int main(int argc, char *argv[])
+{
+  static char rnd[NRAND][MAXLEN/4];
+  char device[300];
+  char longtext[MAXLEN];
+  double t0, t1, t2;
+  float xbox[4], ybox[4], len;
+  int id1, id2, font, i, k, n, pass, failed = 0;
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: ttext new.png cached.png\n");
+    return EXIT_FAILURE;
+  }
+  sprintf(device, "%.280s/PNG", argv[1]);
+  id1 = cpgopen(device);
+  sprintf(device, "%.280s/PNG", argv[2]);
+  id2 = cpgopen(device);
+  if (id1 <= 0 || id2 <= 0)
+    return EXIT_FAILURE;
+  cpgask(0);
+  cpgslct(id1);
+  cpgask(0);
+
+  /* 1. the same pages, with none of the strings cached and with all */
+  t0 = draw(id1);
+  t1 = draw(id2);
+  printf("%d strings drawn: %.1f ms not cached, %.1f ms cached\n",
+	 8*NTEXT, 1e3*t0, 1e3*t1);
+
+  /* 2. boxes of the strings, random strings and a long string, first
+     seen, cached, and seen again after the cache was emptied */
+  srand(1);
+  for (i=0; i<NRAND; i++) {
+    n = 1 + rand() % 30;
+    rnd[i][0] = '\0';
+    for (k=0; k<n; k++)
+      strcat(rnd[i], token[rand() % NTOKEN]);
+  }
+  longtext[0] = '\0';
+  for (i=0; i<MAXLEN/10-1; i++)
+    strcat(longtext, i % 7 ? "abc\\u1\\d " : "\\gW\\(2281)");
+  for (pass=0; pass<2; pass++) {
+    for (font=1; font<=4; font++) {
+      for (i=0; i<NTEXT; i++) {
+	failed |= check(text[i], font);
+	failed |= check(text[i], font);
+      }
+      failed |= check(longtext, font);
+      failed |= check(longtext, font);
+    }
+    for (i=0; i<NRAND; i++)
+      failed |= check(rnd[i], 1 + i % 4);
+  }
+  printf("checked %d strings of up to %d characters, and %d random"
+	 " strings, twice\n", 4*NTEXT + 4, (int) strlen(longtext), NRAND);
+
+  /* 3. measuring strings with and without the cache */
+  cpgslct(id1);
+  t0 = now();
+  for (i=0; i<NRAND; i++) {
+    cpgscf(1 + i % 4);
+    cpgqtxt(0.5, 0.5, 30.0, 0.5, rnd[i % 100], xbox, ybox);
+    cpglen(0, rnd[i % 100], &len, &len);
+  }
+  t1 = now();
+  for (i=0; i<NRAND; i++) {
+    box_old(rnd[i % 100], 1 + i % 4, xbox);
+    box_old(rnd[i % 100], 1 + i % 4, xbox);
+  }
+  t2 = now();
+  printf("%d PGQTXT and PGLEN calls with the cache: %.1f ms;"
+	 " decoding each string: %.1f ms\n", NRAND, 1e3*(t1-t0),
+	 1e3*(t2-t1));
+
+  cpgend();
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}